@@ -0,0 +1,270 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "av_render_default.h"
+#include "esp_lcd_panel_rgb.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+
+#define LCD_WIDTH        (800)
+#define LCD_HEIGHT       (480)
+#define LCD_FB_SIZE      (LCD_WIDTH * LCD_HEIGHT * 2)
+#define LCD_FB_NUM       (3)
+#define VSYNC_PERIOD_US  (16667)
+// Driver writes back cache of frame buffer before it can be scanned out
+#define DRAW_SYNC_US     (200)
+#define DEFAULT_RUN_MS   (2000)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+// Simulated triple buffered RGB panel, frame buffer switch happens at vsync like hardware
+typedef struct {
+    uint8_t                     *fb[LCD_FB_NUM];
+    int                          scan_fb;     // Frame buffer being scanned out
+    int                          pending_fb;  // Frame buffer taken by driver, scanned out from next vsync
+    int                          writing_fb;  // Frame buffer decoder is filling
+    esp_lcd_rgb_panel_vsync_cb_t on_vsync;
+    void                        *vsync_ctx;
+    pthread_mutex_t              lock;
+    volatile bool                running;
+    uint32_t                     vsync_num;
+    uint32_t                     tear_num;
+} sim_panel_t;
+
+static sim_panel_t panel;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void *media_lib_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *media_lib_calloc(size_t num, size_t size)
+{
+    return calloc(num, size);
+}
+
+void media_lib_free(void *buf)
+{
+    free(buf);
+}
+
+void media_lib_thread_sleep(uint32_t ms)
+{
+    usleep(ms * 1000);
+}
+
+esp_err_t esp_lcd_rgb_panel_get_frame_buffer(esp_lcd_panel_handle_t handle, uint32_t fb_num, void **fb0, ...)
+{
+    va_list args;
+    va_start(args, fb0);
+    for (int i = 0; i < (int)fb_num && i < LCD_FB_NUM; i++) {
+        void **fb = i ? va_arg(args, void **) : fb0;
+        *fb = panel.fb[i];
+    }
+    va_end(args);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_rgb_panel_register_event_callbacks(esp_lcd_panel_handle_t handle,
+                                                     const esp_lcd_rgb_panel_event_callbacks_t *callbacks,
+                                                     void *user_ctx)
+{
+    pthread_mutex_lock(&panel.lock);
+    panel.on_vsync = callbacks->on_vsync;
+    panel.vsync_ctx = user_ctx;
+    pthread_mutex_unlock(&panel.lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t handle, int x_start, int y_start, int x_end, int y_end,
+                                    const void *color_data)
+{
+    for (int i = 0; i < LCD_FB_NUM; i++) {
+        if (color_data == panel.fb[i]) {
+            usleep(DRAW_SYNC_US);
+            pthread_mutex_lock(&panel.lock);
+            panel.pending_fb = i;
+            pthread_mutex_unlock(&panel.lock);
+            return ESP_OK;
+        }
+    }
+    // Not frame buffer, copy into the one being scanned out
+    int line_size = (x_end - x_start) * 2;
+    for (int y = y_start; y < y_end; y++) {
+        memcpy(panel.fb[0] + (y * LCD_WIDTH + x_start) * 2, color_data, line_size);
+        color_data = (const uint8_t *)color_data + line_size;
+    }
+    return ESP_OK;
+}
+
+static void *vsync_thread(void *arg)
+{
+    int64_t next = esp_timer_get_time();
+    while (panel.running) {
+        next += VSYNC_PERIOD_US;
+        int64_t now = esp_timer_get_time();
+        if (next > now) {
+            usleep(next - now);
+        }
+        pthread_mutex_lock(&panel.lock);
+        if (panel.pending_fb >= 0) {
+            panel.scan_fb = panel.pending_fb;
+            panel.pending_fb = -1;
+        }
+        if (panel.writing_fb >= 0 && panel.writing_fb == panel.scan_fb) {
+            panel.tear_num++;
+        }
+        panel.vsync_num++;
+        esp_lcd_rgb_panel_vsync_cb_t on_vsync = panel.on_vsync;
+        void *ctx = panel.vsync_ctx;
+        pthread_mutex_unlock(&panel.lock);
+        if (on_vsync) {
+            esp_lcd_rgb_panel_event_data_t data = {};
+            on_vsync(NULL, &data, ctx);
+        }
+    }
+    return NULL;
+}
+
+static int64_t thread_cpu_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void set_writing_fb(uint8_t *data)
+{
+    pthread_mutex_lock(&panel.lock);
+    panel.writing_fb = -1;
+    for (int i = 0; i < LCD_FB_NUM; i++) {
+        if (data == panel.fb[i]) {
+            CHECK(i != panel.scan_fb && i != panel.pending_fb, "decoder got frame buffer %d still in use", i);
+            panel.writing_fb = i;
+        }
+    }
+    pthread_mutex_unlock(&panel.lock);
+}
+
+static void run_render(bool zero_copy, int run_ms, uint32_t *fps, uint32_t *cpu_per_frame)
+{
+    panel.scan_fb = 0;
+    panel.pending_fb = panel.writing_fb = -1;
+    panel.on_vsync = NULL;
+    panel.vsync_num = panel.tear_num = 0;
+    lcd_render_cfg_t cfg = {
+        .lcd_handle = (esp_lcd_panel_handle_t)&panel,
+        .rgb_panel = true,
+        .use_frame_buffer = zero_copy,
+        .fb_num = LCD_FB_NUM,
+    };
+    video_render_handle_t render = av_render_alloc_lcd_render(&cfg);
+    CHECK(render, "alloc lcd render");
+    av_render_video_frame_info_t info = {
+        .type = AV_RENDER_VIDEO_RAW_TYPE_RGB565,
+        .width = LCD_WIDTH,
+        .height = LCD_HEIGHT,
+        .fps = 30,
+    };
+    CHECK(video_render_open(render, &info) == 0, "open render");
+    uint8_t *decode_buf = zero_copy ? NULL : malloc(LCD_FB_SIZE);
+
+    pthread_t vsync;
+    panel.running = true;
+    pthread_create(&vsync, NULL, vsync_thread, NULL);
+    int64_t start = esp_timer_get_time();
+    int64_t cpu_start = thread_cpu_us();
+    uint32_t frames = 0;
+    while (esp_timer_get_time() - start < (int64_t)run_ms * 1000) {
+        av_render_video_frame_t frame = {
+            .data = decode_buf,
+            .size = LCD_FB_SIZE,
+        };
+        if (zero_copy) {
+            av_render_frame_buffer_t fb = {};
+            CHECK(video_render_get_frame_buffer(render, &fb) == 0, "get frame buffer");
+            frame.data = fb.data;
+            set_writing_fb(fb.data);
+        }
+        // Decoder writes whole picture
+        memset(frame.data, frames & 0xFF, LCD_FB_SIZE);
+        set_writing_fb(NULL);
+        CHECK(video_render_write(render, &frame) == 0, "render write");
+        frames++;
+    }
+    int64_t cpu_used = thread_cpu_us() - cpu_start;
+    int64_t elapsed = esp_timer_get_time() - start;
+    panel.running = false;
+    pthread_join(vsync, NULL);
+
+    *fps = (uint32_t)((int64_t)frames * 1000000 / elapsed);
+    *cpu_per_frame = (uint32_t)(cpu_used / frames);
+    // Decoder is not paced, rate shows how fast render accepts frames
+    printf("%s: %d fps %dus CPU per frame vsync %d tearing %d\n", zero_copy ? "Zero copy" : "Copy", (int)*fps,
+           (int)*cpu_per_frame, (int)panel.vsync_num, (int)panel.tear_num);
+    CHECK(panel.tear_num == 0, "frame buffer written while scanned out %d times", (int)panel.tear_num);
+    video_render_close(render);
+    video_render_free_handle(render);
+    free(decode_buf);
+}
+
+int main(int argc, char *argv[])
+{
+    int run_ms = argc > 1 ? atoi(argv[1]) : DEFAULT_RUN_MS;
+    pthread_mutex_init(&panel.lock, NULL);
+    for (int i = 0; i < LCD_FB_NUM; i++) {
+        panel.fb[i] = calloc(1, LCD_FB_SIZE);
+    }
+    uint32_t copy_fps, copy_cpu;
+    uint32_t zero_fps, zero_cpu;
+    run_render(false, run_ms, &copy_fps, &copy_cpu);
+    run_render(true, run_ms, &zero_fps, &zero_cpu);
+    printf("Zero copy saves %dus CPU per frame\n", (int)copy_cpu - (int)zero_cpu);
+    for (int i = 0; i < LCD_FB_NUM; i++) {
+        free(panel.fb[i]);
+    }
+    printf("LCD render bench passed\n");
+    return 0;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+typedef void *esp_codec_dev_handle_t;
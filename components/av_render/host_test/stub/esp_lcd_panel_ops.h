@@ -0,0 +1,8 @@
+#pragma once
+#include "esp_err.h"
+
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+// Provided by simulated panel in host test
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                    const void *color_data);
@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+// Provided by host test
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,11 @@
+#pragma once
+#include <pthread.h>
+
+// Critical section maps to mutex, simulated vsync runs in its own thread
+typedef pthread_mutex_t portMUX_TYPE;
+
+#define portMUX_INITIALIZE(mux)      pthread_mutex_init(mux, NULL)
+#define portENTER_CRITICAL(mux)      pthread_mutex_lock(mux)
+#define portEXIT_CRITICAL(mux)       pthread_mutex_unlock(mux)
+#define portENTER_CRITICAL_ISR(mux)  pthread_mutex_lock(mux)
+#define portEXIT_CRITICAL_ISR(mux)   pthread_mutex_unlock(mux)
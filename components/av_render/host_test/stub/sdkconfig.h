@@ -0,0 +1,3 @@
+#pragma once
+// Host build renders through simulated RGB panel
+#define SOC_LCD_RGB_SUPPORTED 1
@@ -106,6 +106,34 @@ typedef int (*audio_render_get_frame_info_func)(audio_render_handle_t render, av
  */
 typedef int (*audio_render_set_speed_func)(audio_render_handle_t render, float speed);
 
+/**
+ * @brief  Get writable buffer from audio render callback
+ *
+ * @note  Lets producer write output directly into memory owned by render backend
+ *        Buffer must be released by `audio_render_commit_func` before next get
+ *
+ * @param[in]   render  Audio render handle
+ * @param[in]   size    Wanted buffer size
+ * @param[out]  buffer  Buffer to write into
+ *
+ * @return
+ *       - 0       On success
+ *       - Others  Fail to get buffer
+ */
+typedef int (*audio_render_get_buffer_func)(audio_render_handle_t render, int size, uint8_t **buffer);
+
+/**
+ * @brief  Commit buffer got from `audio_render_get_buffer_func` callback
+ *
+ * @param[in]  render      Audio render handle
+ * @param[in]  audio_data  Frame whose data points to got buffer, size 0 to cancel
+ *
+ * @return
+ *       - 0       On success
+ *       - Others  Fail to render
+ */
+typedef int (*audio_render_commit_func)(audio_render_handle_t render, av_render_audio_frame_t *audio_data);
+
 /**
  * @brief  Close audio render callback
  *
@@ -138,6 +166,8 @@ typedef struct {
     audio_render_latency_func        get_latency;    /*!< Get audio render latency callback */
     audio_render_get_frame_info_func get_frame_info; /*!< Get audio frame information callback */
     audio_render_set_speed_func      set_speed;      /*!< Set audio render speed callback */
+    audio_render_get_buffer_func     get_buffer;     /*!< Get render owned buffer callback (optional) */
+    audio_render_commit_func         commit;         /*!< Commit render owned buffer callback (optional) */
     audio_render_close_func          close;          /*!< Close audio render callback */
     audio_render_deinit_func         deinit;         /*!< Deinitialize audio render callback */
 } audio_render_ops_t;
@@ -186,9 +216,40 @@ int audio_render_open(audio_render_handle_t render, av_render_audio_frame_info_t
  */
 int audio_render_write(audio_render_handle_t render, av_render_audio_frame_t *audio_data);
 
+/**
+ * @brief  Get buffer to write audio data into directly
+ *
+ * @note  If render backend not support it, an internal buffer is returned and commit writes it
+ *        Each got buffer must be committed before next get
+ *
+ * @param[in]   render  Audio render handle
+ * @param[in]   size    Wanted buffer size
+ * @param[out]  buffer  Buffer to write into
+ *
+ * @return
+ *       - 0       On success
+ *       - Others  Fail to get buffer
+ */
+int audio_render_get_buffer(audio_render_handle_t render, int size, uint8_t **buffer);
+
+/**
+ * @brief  Commit buffer got from `audio_render_get_buffer`
+ *
+ * @param[in]  render      Audio render handle
+ * @param[in]  audio_data  Frame whose data points to got buffer, size 0 to cancel
+ *
+ * @return
+ *       - 0       On success
+ *       - Others  Fail to render
+ */
+int audio_render_commit(audio_render_handle_t render, av_render_audio_frame_t *audio_data);
+
 /**
  * @brief  Get audio render latency
  *
+ * @note  Latency is the buffered play time (DMA and device) measured when last write returned
+ *        AV render interpolates presentation time from it between writes
+ *
  * @param[in]   render   Audio render handle
  * @param[out]  latency  Audio latency (unit ms)
  *
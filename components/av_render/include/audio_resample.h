@@ -39,6 +39,15 @@ typedef void *audio_resample_handle_t;
  */
 typedef int (*audio_resample_frame_cb)(av_render_audio_frame_t *frame, void *ctx);
 
+/**
+ * @brief  Audio resample output buffer callback
+ *
+ * @note  Return buffer owned by consumer so that output is written into it directly
+ *        Returned buffer is passed back through `audio_resample_frame_cb`
+ *        Return NULL to let resample use its own work buffer
+ */
+typedef uint8_t *(*audio_resample_get_buffer_cb)(int size, void *ctx);
+
 /**
  * @brief  Audio resample configuration
  */
@@ -46,6 +55,7 @@ typedef struct {
     av_render_audio_frame_info_t input_info;   /*!< Input frame information */
     av_render_audio_frame_info_t output_info;  /*!< Output frame information */
     audio_resample_frame_cb      resample_cb;  /*!< Resample output callback */
+    audio_resample_get_buffer_cb get_buffer;   /*!< Output buffer callback (optional) */
     void                        *ctx;          /*!< User context */
 } audio_resample_cfg_t;
 
@@ -60,6 +60,12 @@ typedef struct {
     bool                  pause_on_first_frame;   /*!< Whether automatically pause when render receive first frame */
     void                 *ctx;                    /*!< User context */
     bool                  video_cvt_in_render;    /*!< Convert color in render*/
+    bool                  enable_plc;             /*!< Conceal lost audio frames by pts gap (16 bits decoded audio only)
+                                                       Longer gaps (DTX) are filled with comfort noise when `audio_render_fifo_size` is set */
+    bool                  video_latest_frame;     /*!< Only show newest decoded frame, older frames waiting in video render fifo are dropped
+                                                       Take effect when `video_render_fifo_size` is set */
+    uint16_t              video_latency_budget;   /*!< Skip decode of non-reference frames when decoder fifo holds more than it (unit ms)
+                                                       0 to disable */
 } av_render_cfg_t;
 
 /**
@@ -86,6 +92,14 @@ typedef struct {
     int      render_data_size; /*!< Render queue data number */
 } av_render_fifo_stat_t;
 
+/**
+ * @brief  AV render video drop statistics
+ */
+typedef struct {
+    uint32_t render_skipped; /*!< Decoded frames dropped for newer frame in render fifo */
+    uint32_t decode_skipped; /*!< Non-reference frames not decoded for exceeding latency budget */
+} av_render_video_drop_stat_t;
+
 /**
  * @brief  AV render fifo configuration
  */
@@ -289,6 +303,18 @@ int av_render_get_audio_fifo_level(av_render_handle_t render, av_render_fifo_sta
  */
 int av_render_get_video_fifo_level(av_render_handle_t render, av_render_fifo_stat_t *fifo_stat);
 
+/**
+ * @brief  Get video drop statistics of latest frame mode and latency budget
+ *
+ * @param[in]   render  AV render handle
+ * @param[out]  stat    Video drop statistics
+ *
+ * @return
+ *       - ESP_MEDIA_ERR_OK           On success
+ *       - ESP_MEDIA_ERR_INVALID_ARG  Invalid argument
+ */
+int av_render_get_video_drop_stat(av_render_handle_t render, av_render_video_drop_stat_t *stat);
+
 /**
  * @brief  Pause for AV render
  *
@@ -342,6 +368,22 @@ int av_render_flush(av_render_handle_t render);
  */
 int av_render_set_video_start_pts(av_render_handle_t render, uint32_t video_pts);
 
+/**
+ * @brief  Get audio presentation clock
+ *
+ * @note  Clock is the pts currently heard from the speaker, it accounts for buffered latency
+ *        reported by audio render and is interpolated between audio writes
+ *
+ * @param[in]   render  AV render handle
+ * @param[out]  pts     Audio presentation pts (unit ms)
+ *
+ * @return
+ *       - ESP_MEDIA_ERR_OK           On success
+ *       - ESP_MEDIA_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_MEDIA_ERR_NOT_SUPPORT  Audio not rendered yet
+ */
+int av_render_get_audio_clock(av_render_handle_t render, uint32_t *pts);
+
 /**
  * @brief  Get current render presentation time
  *
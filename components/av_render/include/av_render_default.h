@@ -25,6 +25,7 @@
 #pragma once
 
 #include "av_render_types.h"
+#include "av_render.h"
 #include "audio_render.h"
 #include "video_render.h"
 #include "esp_lcd_panel_ops.h"
@@ -57,8 +58,64 @@ typedef struct {
     bool                   rgb_panel;         /*!< Whether RGB panel */
     bool                   dsi_panel;         /*!< Whether DSI panel */
     bool                   use_frame_buffer;  /*!< Use display frame buffer */
+    uint8_t                fb_num;            /*!< Frame buffer number used when `use_frame_buffer` set, default 2
+                                                   Set to 3 for triple buffering, panel must be created with same `num_fbs`
+                                                   Decoder then writes into a free buffer while one is scanned out and one is queued */
 } lcd_render_cfg_t;
 
+/**
+ * @brief  Audio mixer handle
+ */
+typedef void *audio_mixer_handle_t;
+
+/**
+ * @brief  Audio mixer configuration
+ */
+typedef struct {
+    audio_render_handle_t        out_render;  /*!< Audio render to play mixed output */
+    av_render_audio_frame_info_t out_info;    /*!< Mixed output format, only 16 bits supported */
+    uint16_t                     frame_ms;    /*!< Mix period in milliseconds, default 10ms */
+    uint8_t                      max_inputs;  /*!< Maximum input number, default 4 */
+} audio_mixer_cfg_t;
+
+/**
+ * @brief  Audio mixer input configuration
+ */
+typedef struct {
+    audio_mixer_handle_t mixer;      /*!< Mixer to attach to */
+    uint8_t              slot;       /*!< Input slot index, must less than `max_inputs` */
+    uint8_t              priority;   /*!< Input with higher priority ducks lower ones while it has data */
+    float                gain;       /*!< Linear gain (0.0 - 1.0) */
+    float                duck_gain;  /*!< Extra gain applied when ducked (0.0 - 1.0) */
+} audio_mixer_input_cfg_t;
+
+/**
+ * @brief  Maximum players handled by `av_render_open_mixed_players`
+ */
+#define AUDIO_MIXER_MAX_PLAYERS (4)
+
+/**
+ * @brief  Mixed players configuration
+ */
+typedef struct {
+    audio_render_handle_t        out_render;  /*!< Audio render to play mixed output */
+    av_render_audio_frame_info_t out_info;    /*!< Playback format (e.g. from board settings), only 16 bits supported
+                                                   Each player resamples its source into this format */
+    uint8_t                      player_num;  /*!< Number of players, each player feeds one mixer input */
+    av_render_cfg_t             *player_cfg;  /*!< Player configuration array, `audio_render` is set to its mixer input */
+    audio_mixer_input_cfg_t     *input_cfg;   /*!< Mixer input configuration array, `mixer` and `slot` are set automatically */
+} audio_mixer_players_cfg_t;
+
+/**
+ * @brief  Mixed players
+ */
+typedef struct {
+    audio_mixer_handle_t  mixer;                             /*!< Audio mixer */
+    uint8_t               player_num;                        /*!< Number of players */
+    audio_render_handle_t inputs[AUDIO_MIXER_MAX_PLAYERS];   /*!< Mixer input of each player */
+    av_render_handle_t    players[AUDIO_MIXER_MAX_PLAYERS];  /*!< AV render of each player, index same as configuration */
+} audio_mixer_players_t;
+
 /**
  * @brief  Allocate I2S render
  *
@@ -81,6 +138,76 @@ audio_render_handle_t av_render_alloc_i2s_render(i2s_render_cfg_t *cfg);
  */
 video_render_handle_t av_render_alloc_lcd_render(lcd_render_cfg_t *cfg);
 
+/**
+ * @brief  Create audio mixer
+ *
+ * @note  Mixer reads all inputs in one thread and writes mixed data to `out_render`
+ *        Each input is an audio render, so one AV render can be attached per playback source
+ *        Input data must be in mixer output format, use `av_render_set_fixed_frame_info` on AV render
+ *
+ * @param[in]  cfg  Audio mixer configuration
+ *
+ * @return
+ *       - NULL    No memory or invalid configuration
+ *       - Others  Audio mixer instance
+ */
+audio_mixer_handle_t av_render_create_audio_mixer(audio_mixer_cfg_t *cfg);
+
+/**
+ * @brief  Allocate audio render as mixer input
+ *
+ * @param[in]  cfg  Mixer input configuration
+ *
+ * @return
+ *       - NULL    No memory or slot already used
+ *       - Others  Audio render instance
+ */
+audio_render_handle_t av_render_alloc_mixer_input(audio_mixer_input_cfg_t *cfg);
+
+/**
+ * @brief  Set gain of mixer input
+ *
+ * @param[in]  mixer  Audio mixer handle
+ * @param[in]  slot   Input slot index
+ * @param[in]  gain   Linear gain (0.0 - 1.0)
+ *
+ * @return
+ *       - 0       On success
+ *       - Others  Invalid argument
+ */
+int av_render_set_mixer_input_gain(audio_mixer_handle_t mixer, uint8_t slot, float gain);
+
+/**
+ * @brief  Destroy audio mixer
+ *
+ * @note  All mixer inputs should be freed before destroy
+ *
+ * @param[in]  mixer  Audio mixer handle
+ */
+void av_render_destroy_audio_mixer(audio_mixer_handle_t mixer);
+
+/**
+ * @brief  Open several AV render players mixed into one output render
+ *
+ * @note  Creates the mixer and one input per player, then opens each player on its input
+ *        with fixed frame info set to `out_info`
+ *
+ * @param[in]   cfg      Mixed players configuration
+ * @param[out]  players  Created mixer, inputs and players
+ *
+ * @return
+ *       - 0       On success
+ *       - Others  Invalid argument or no memory
+ */
+int av_render_open_mixed_players(audio_mixer_players_cfg_t *cfg, audio_mixer_players_t *players);
+
+/**
+ * @brief  Close players, mixer inputs and mixer opened by `av_render_open_mixed_players`
+ *
+ * @param[in]  players  Mixed players
+ */
+void av_render_close_mixed_players(audio_mixer_players_t *players);
+
 #ifdef __cplusplus
 }
 #endif
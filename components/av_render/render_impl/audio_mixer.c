@@ -0,0 +1,540 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#include <inttypes.h>
+#include "av_render_default.h"
+#include "media_lib_os.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#define TAG "AUDIO_MIXER"
+
+#define MIXER_DEFAULT_FRAME_MS (10)
+#define MIXER_DEFAULT_INPUTS   (4)
+#define MIXER_MAX_INPUTS       (8)
+/* Input ring holds this many mix periods, it bounds latency added by mixer */
+#define MIXER_RING_FRAMES      (4)
+#define MIXER_IDLE_WAIT_MS     (100)
+#define MIXER_GAIN_ONE         (32768)
+/* Wait at most frame_ms / this for input with partial period before treating it as underrun */
+#define MIXER_UNDERRUN_GRACE_DIV (2)
+
+#define MIXER_GAIN_Q15(g)      ((g) <= 0.0f ? 0 : (g) >= 1.0f ? MIXER_GAIN_ONE : (int32_t)((g) * MIXER_GAIN_ONE))
+
+typedef struct _audio_mixer audio_mixer_t;
+
+typedef struct {
+    audio_mixer_t          *mixer;
+    uint8_t                 slot;
+    uint8_t                 priority;
+    bool                    used;
+    bool                    opened;
+    int32_t                 gain;
+    int32_t                 duck_gain;
+    int32_t                 cur_gain;
+    int16_t                *ring;
+    int                     ring_samples;
+    int                     rp;
+    int                     fill;
+    media_lib_sema_handle_t space_sema;
+} mixer_input_t;
+
+struct _audio_mixer {
+    audio_mixer_cfg_t         cfg;
+    int                       frame_samples;
+    mixer_input_t            *inputs;
+    int32_t                  *acc;
+    int16_t                  *out;
+    media_lib_mutex_handle_t  lock;
+    media_lib_sema_handle_t   data_sema;
+    media_lib_sema_handle_t   exit_sema;
+    bool                      running;
+    bool                      out_opened;
+};
+
+static void mix_input(mixer_input_t *input, int32_t *acc, int samples, int32_t target)
+{
+    // Ramp gain over one frame to avoid zipper noise on gain change or ducking
+    int32_t gain = input->cur_gain;
+    int32_t step = (target - gain) / samples;
+    int rp = input->rp;
+    // Underrun input gives what it has, rest of the period stays zero
+    int avail = input->fill < samples ? input->fill : samples;
+    for (int i = 0; i < avail; i++) {
+        acc[i] += (input->ring[rp] * gain) >> 15;
+        gain += step;
+        if (++rp == input->ring_samples) {
+            rp = 0;
+        }
+    }
+    input->rp = rp;
+    input->fill -= avail;
+    input->cur_gain = target;
+}
+
+static void mixer_set_out_opened(audio_mixer_t *mixer, bool opened)
+{
+    media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    mixer->out_opened = opened;
+    media_lib_mutex_unlock(mixer->lock);
+}
+
+static void mixer_close_output(audio_mixer_t *mixer)
+{
+    if (mixer->out_opened) {
+        // Clear flag firstly so that latency query no longer touches output render
+        mixer_set_out_opened(mixer, false);
+        audio_render_close(mixer->cfg.out_render);
+    }
+}
+
+static void mixer_thread(void *arg)
+{
+    audio_mixer_t *mixer = (audio_mixer_t *)arg;
+    int64_t wait_deadline = 0;
+    ESP_LOGI(TAG, "Mixer thread started");
+    while (mixer->running) {
+        media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+        int opened = 0, ready = 0, partial = 0;
+        uint8_t top_priority = 0;
+        for (int i = 0; i < mixer->cfg.max_inputs; i++) {
+            mixer_input_t *input = &mixer->inputs[i];
+            if (input->used == false || input->opened == false) {
+                continue;
+            }
+            opened++;
+            if (input->fill >= mixer->frame_samples) {
+                ready++;
+            } else if (input->fill) {
+                partial++;
+            }
+            if (input->fill && input->priority > top_priority) {
+                top_priority = input->priority;
+            }
+        }
+        // Mix only on full period so that inputs advance together and sink gets fixed size writes
+        // Input with partial period gets a short grace, input without data is treated as underrun at once
+        uint32_t wait_ms = opened ? mixer->cfg.frame_ms : MIXER_IDLE_WAIT_MS;
+        bool do_mix = false;
+        if (ready) {
+            int64_t now = esp_timer_get_time();
+            if (partial == 0) {
+                do_mix = true;
+            } else if (wait_deadline == 0) {
+                wait_deadline = now + mixer->cfg.frame_ms * 1000 / MIXER_UNDERRUN_GRACE_DIV;
+            } else if (now >= wait_deadline) {
+                do_mix = true;
+            }
+            if (do_mix == false) {
+                wait_ms = (uint32_t)((wait_deadline - now + 999) / 1000);
+            }
+        }
+        if (do_mix == false) {
+            media_lib_mutex_unlock(mixer->lock);
+            if (opened == 0) {
+                wait_deadline = 0;
+                mixer_close_output(mixer);
+            }
+            media_lib_sema_lock(mixer->data_sema, wait_ms);
+            continue;
+        }
+        wait_deadline = 0;
+        memset(mixer->acc, 0, mixer->frame_samples * sizeof(int32_t));
+        for (int i = 0; i < mixer->cfg.max_inputs; i++) {
+            mixer_input_t *input = &mixer->inputs[i];
+            if (input->used == false || input->opened == false) {
+                continue;
+            }
+            int32_t target = input->gain;
+            if (input->priority < top_priority) {
+                target = (target * input->duck_gain) >> 15;
+            }
+            mix_input(input, mixer->acc, mixer->frame_samples, target);
+            media_lib_sema_unlock(input->space_sema);
+        }
+        media_lib_mutex_unlock(mixer->lock);
+        if (mixer->out_opened == false) {
+            if (audio_render_open(mixer->cfg.out_render, &mixer->cfg.out_info) != 0) {
+                ESP_LOGE(TAG, "Fail to open output render");
+                media_lib_thread_sleep(mixer->cfg.frame_ms);
+                continue;
+            }
+            mixer_set_out_opened(mixer, true);
+        }
+        for (int i = 0; i < mixer->frame_samples; i++) {
+            int32_t v = mixer->acc[i];
+            mixer->out[i] = (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+        }
+        av_render_audio_frame_t frame = {
+            .data = (uint8_t *)mixer->out,
+            .size = mixer->frame_samples * sizeof(int16_t),
+        };
+        // Output render blocks on DMA and paces the mixer
+        audio_render_write(mixer->cfg.out_render, &frame);
+    }
+    mixer_close_output(mixer);
+    ESP_LOGI(TAG, "Mixer thread exited");
+    media_lib_sema_unlock(mixer->exit_sema);
+    media_lib_thread_destroy(NULL);
+}
+
+static audio_render_handle_t mixer_input_init(void *cfg, int cfg_size)
+{
+    audio_mixer_input_cfg_t *in_cfg = (audio_mixer_input_cfg_t *)cfg;
+    if (cfg == NULL || cfg_size != sizeof(audio_mixer_input_cfg_t) || in_cfg->mixer == NULL) {
+        return NULL;
+    }
+    audio_mixer_t *mixer = (audio_mixer_t *)in_cfg->mixer;
+    if (in_cfg->slot >= mixer->cfg.max_inputs) {
+        return NULL;
+    }
+    mixer_input_t *input = &mixer->inputs[in_cfg->slot];
+    if (input->used) {
+        ESP_LOGE(TAG, "Slot %d already used", in_cfg->slot);
+        return NULL;
+    }
+    input->ring_samples = mixer->frame_samples * MIXER_RING_FRAMES;
+    input->ring = (int16_t *)media_lib_malloc(input->ring_samples * sizeof(int16_t));
+    media_lib_sema_create(&input->space_sema);
+    if (input->ring == NULL || input->space_sema == NULL) {
+        if (input->ring) {
+            media_lib_free(input->ring);
+            input->ring = NULL;
+        }
+        if (input->space_sema) {
+            media_lib_sema_destroy(input->space_sema);
+            input->space_sema = NULL;
+        }
+        return NULL;
+    }
+    media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    input->mixer = mixer;
+    input->slot = in_cfg->slot;
+    input->priority = in_cfg->priority;
+    input->gain = MIXER_GAIN_Q15(in_cfg->gain);
+    input->duck_gain = MIXER_GAIN_Q15(in_cfg->duck_gain);
+    input->rp = input->fill = 0;
+    input->opened = false;
+    input->used = true;
+    media_lib_mutex_unlock(mixer->lock);
+    return input;
+}
+
+static int mixer_input_open(audio_render_handle_t render, av_render_audio_frame_info_t *info)
+{
+    mixer_input_t *input = (mixer_input_t *)render;
+    if (input == NULL || info == NULL) {
+        return -1;
+    }
+    audio_mixer_t *mixer = input->mixer;
+    av_render_audio_frame_info_t *out_info = &mixer->cfg.out_info;
+    if (info->sample_rate != out_info->sample_rate || info->channel != out_info->channel ||
+        info->bits_per_sample != out_info->bits_per_sample) {
+        ESP_LOGE(TAG, "Input %d format %d/%d/%d not match mixer, set fixed frame info on AV render", input->slot,
+                 (int)info->sample_rate, info->channel, info->bits_per_sample);
+        return -1;
+    }
+    media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    input->rp = input->fill = 0;
+    // Fade in from silence on first mixed frame
+    input->cur_gain = 0;
+    input->opened = true;
+    media_lib_mutex_unlock(mixer->lock);
+    return 0;
+}
+
+static int mixer_input_write(audio_render_handle_t render, av_render_audio_frame_t *audio_data)
+{
+    mixer_input_t *input = (mixer_input_t *)render;
+    if (input == NULL || audio_data == NULL) {
+        return -1;
+    }
+    audio_mixer_t *mixer = input->mixer;
+    int16_t *data = (int16_t *)audio_data->data;
+    int samples = audio_data->size / sizeof(int16_t);
+    while (samples > 0) {
+        media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+        if (input->opened == false || mixer->running == false) {
+            media_lib_mutex_unlock(mixer->lock);
+            return -1;
+        }
+        int space = input->ring_samples - input->fill;
+        if (space == 0) {
+            media_lib_mutex_unlock(mixer->lock);
+            // Wait mixer consume, ring depth keeps added latency bounded
+            media_lib_sema_lock(input->space_sema, mixer->cfg.frame_ms * MIXER_RING_FRAMES);
+            continue;
+        }
+        int n = samples < space ? samples : space;
+        int wp = input->rp + input->fill;
+        if (wp >= input->ring_samples) {
+            wp -= input->ring_samples;
+        }
+        int first = input->ring_samples - wp;
+        if (first > n) {
+            first = n;
+        }
+        memcpy(input->ring + wp, data, first * sizeof(int16_t));
+        memcpy(input->ring, data + first, (n - first) * sizeof(int16_t));
+        input->fill += n;
+        media_lib_mutex_unlock(mixer->lock);
+        media_lib_sema_unlock(mixer->data_sema);
+        data += n;
+        samples -= n;
+    }
+    return 0;
+}
+
+static int mixer_input_get_latency(audio_render_handle_t render, uint32_t *latency)
+{
+    mixer_input_t *input = (mixer_input_t *)render;
+    if (input == NULL || latency == NULL) {
+        return -1;
+    }
+    audio_mixer_t *mixer = input->mixer;
+    av_render_audio_frame_info_t *info = &mixer->cfg.out_info;
+    uint32_t out_latency = 0;
+    media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (mixer->out_opened) {
+        audio_render_get_latency(mixer->cfg.out_render, &out_latency);
+    }
+    uint32_t fill = (uint32_t)input->fill;
+    media_lib_mutex_unlock(mixer->lock);
+    *latency = fill / info->channel * 1000 / info->sample_rate + out_latency;
+    return 0;
+}
+
+static int mixer_input_get_frame_info(audio_render_handle_t render, av_render_audio_frame_info_t *info)
+{
+    mixer_input_t *input = (mixer_input_t *)render;
+    if (input == NULL || info == NULL) {
+        return -1;
+    }
+    memcpy(info, &input->mixer->cfg.out_info, sizeof(av_render_audio_frame_info_t));
+    return 0;
+}
+
+static int mixer_input_set_speed(audio_render_handle_t render, float speed)
+{
+    if (render == NULL) {
+        return -1;
+    }
+    // Speed change is not supported per input
+    return speed == 1.0f ? 0 : -1;
+}
+
+static int mixer_input_close(audio_render_handle_t render)
+{
+    mixer_input_t *input = (mixer_input_t *)render;
+    if (input == NULL) {
+        return -1;
+    }
+    audio_mixer_t *mixer = input->mixer;
+    media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    input->opened = false;
+    input->fill = 0;
+    media_lib_mutex_unlock(mixer->lock);
+    // Wakeup writer waiting for space
+    media_lib_sema_unlock(input->space_sema);
+    return 0;
+}
+
+static void mixer_input_deinit(audio_render_handle_t render)
+{
+    mixer_input_t *input = (mixer_input_t *)render;
+    if (input == NULL) {
+        return;
+    }
+    audio_mixer_t *mixer = input->mixer;
+    media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    input->used = false;
+    input->opened = false;
+    media_lib_free(input->ring);
+    input->ring = NULL;
+    media_lib_mutex_unlock(mixer->lock);
+    media_lib_sema_destroy(input->space_sema);
+    input->space_sema = NULL;
+}
+
+audio_render_handle_t av_render_alloc_mixer_input(audio_mixer_input_cfg_t *in_cfg)
+{
+    audio_render_cfg_t cfg = {
+        .ops = {
+            .init = mixer_input_init,
+            .open = mixer_input_open,
+            .write = mixer_input_write,
+            .get_latency = mixer_input_get_latency,
+            .set_speed = mixer_input_set_speed,
+            .get_frame_info = mixer_input_get_frame_info,
+            .close = mixer_input_close,
+            .deinit = mixer_input_deinit,
+        },
+        .cfg = in_cfg,
+        .cfg_size = sizeof(audio_mixer_input_cfg_t),
+    };
+    return audio_render_alloc_handle(&cfg);
+}
+
+int av_render_set_mixer_input_gain(audio_mixer_handle_t h, uint8_t slot, float gain)
+{
+    audio_mixer_t *mixer = (audio_mixer_t *)h;
+    if (mixer == NULL || slot >= mixer->cfg.max_inputs) {
+        return -1;
+    }
+    media_lib_mutex_lock(mixer->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    mixer->inputs[slot].gain = MIXER_GAIN_Q15(gain);
+    media_lib_mutex_unlock(mixer->lock);
+    return 0;
+}
+
+void av_render_destroy_audio_mixer(audio_mixer_handle_t h)
+{
+    audio_mixer_t *mixer = (audio_mixer_t *)h;
+    if (mixer == NULL) {
+        return;
+    }
+    if (mixer->running) {
+        mixer->running = false;
+        media_lib_sema_unlock(mixer->data_sema);
+        media_lib_sema_lock(mixer->exit_sema, MEDIA_LIB_MAX_LOCK_TIME);
+    }
+    if (mixer->lock) {
+        media_lib_mutex_destroy(mixer->lock);
+    }
+    if (mixer->data_sema) {
+        media_lib_sema_destroy(mixer->data_sema);
+    }
+    if (mixer->exit_sema) {
+        media_lib_sema_destroy(mixer->exit_sema);
+    }
+    media_lib_free(mixer->inputs);
+    media_lib_free(mixer->acc);
+    media_lib_free(mixer->out);
+    media_lib_free(mixer);
+}
+
+audio_mixer_handle_t av_render_create_audio_mixer(audio_mixer_cfg_t *cfg)
+{
+    if (cfg == NULL || cfg->out_render == NULL || cfg->out_info.bits_per_sample != 16 ||
+        cfg->out_info.channel == 0 || cfg->out_info.sample_rate == 0 || cfg->max_inputs > MIXER_MAX_INPUTS) {
+        ESP_LOGE(TAG, "Invalid mixer configuration");
+        return NULL;
+    }
+    audio_mixer_t *mixer = (audio_mixer_t *)media_lib_calloc(1, sizeof(audio_mixer_t));
+    if (mixer == NULL) {
+        return NULL;
+    }
+    mixer->cfg = *cfg;
+    if (mixer->cfg.frame_ms == 0) {
+        mixer->cfg.frame_ms = MIXER_DEFAULT_FRAME_MS;
+    }
+    if (mixer->cfg.max_inputs == 0) {
+        mixer->cfg.max_inputs = MIXER_DEFAULT_INPUTS;
+    }
+    mixer->frame_samples = cfg->out_info.sample_rate * mixer->cfg.frame_ms / 1000 * cfg->out_info.channel;
+    mixer->inputs = (mixer_input_t *)media_lib_calloc(mixer->cfg.max_inputs, sizeof(mixer_input_t));
+    mixer->acc = (int32_t *)media_lib_malloc(mixer->frame_samples * sizeof(int32_t));
+    mixer->out = (int16_t *)media_lib_malloc(mixer->frame_samples * sizeof(int16_t));
+    media_lib_mutex_create(&mixer->lock);
+    media_lib_sema_create(&mixer->data_sema);
+    media_lib_sema_create(&mixer->exit_sema);
+    if (mixer->inputs == NULL || mixer->acc == NULL || mixer->out == NULL || mixer->lock == NULL ||
+        mixer->data_sema == NULL || mixer->exit_sema == NULL) {
+        av_render_destroy_audio_mixer(mixer);
+        return NULL;
+    }
+    mixer->running = true;
+    media_lib_thread_handle_t thread = NULL;
+    if (media_lib_thread_create_from_scheduler(&thread, "AMixer", mixer_thread, mixer) != 0) {
+        ESP_LOGE(TAG, "Fail to create mixer thread");
+        mixer->running = false;
+        av_render_destroy_audio_mixer(mixer);
+        return NULL;
+    }
+    return mixer;
+}
+
+void av_render_close_mixed_players(audio_mixer_players_t *players)
+{
+    if (players == NULL) {
+        return;
+    }
+    for (int i = 0; i < players->player_num; i++) {
+        if (players->players[i]) {
+            av_render_close(players->players[i]);
+            players->players[i] = NULL;
+        }
+        if (players->inputs[i]) {
+            audio_render_free_handle(players->inputs[i]);
+            players->inputs[i] = NULL;
+        }
+    }
+    if (players->mixer) {
+        av_render_destroy_audio_mixer(players->mixer);
+        players->mixer = NULL;
+    }
+    players->player_num = 0;
+}
+
+int av_render_open_mixed_players(audio_mixer_players_cfg_t *cfg, audio_mixer_players_t *players)
+{
+    if (cfg == NULL || players == NULL || cfg->player_cfg == NULL || cfg->input_cfg == NULL ||
+        cfg->player_num == 0 || cfg->player_num > AUDIO_MIXER_MAX_PLAYERS) {
+        return -1;
+    }
+    memset(players, 0, sizeof(audio_mixer_players_t));
+    audio_mixer_cfg_t mixer_cfg = {
+        .out_render = cfg->out_render,
+        .out_info = cfg->out_info,
+        .max_inputs = cfg->player_num,
+    };
+    players->mixer = av_render_create_audio_mixer(&mixer_cfg);
+    if (players->mixer == NULL) {
+        return -1;
+    }
+    players->player_num = cfg->player_num;
+    for (int i = 0; i < cfg->player_num; i++) {
+        audio_mixer_input_cfg_t input_cfg = cfg->input_cfg[i];
+        input_cfg.mixer = players->mixer;
+        input_cfg.slot = i;
+        players->inputs[i] = av_render_alloc_mixer_input(&input_cfg);
+        if (players->inputs[i] == NULL) {
+            ESP_LOGE(TAG, "Fail to create mixer input %d", i);
+            break;
+        }
+        av_render_cfg_t player_cfg = cfg->player_cfg[i];
+        player_cfg.audio_render = players->inputs[i];
+        players->players[i] = av_render_open(&player_cfg);
+        if (players->players[i] == NULL) {
+            ESP_LOGE(TAG, "Fail to open player %d", i);
+            break;
+        }
+        // Player resamples its source into mixer format
+        av_render_set_fixed_frame_info(players->players[i], &cfg->out_info);
+    }
+    if (players->players[cfg->player_num - 1] == NULL) {
+        av_render_close_mixed_players(players);
+        return -1;
+    }
+    return 0;
+}
@@ -26,6 +26,7 @@
 #include "media_lib_os.h"
 #include "esp_codec_dev.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_ae_sonic.h"
 
 #define TAG "I2S_RENDER"
@@ -44,6 +45,8 @@ typedef struct {
     bool                         sonic_enable;
     char                        *sonic_out;
     int                          sonic_out_size;
+    int64_t                      play_end_time;
+    uint32_t                     latency;
 } i2s_render_t;
 
 static audio_render_handle_t i2s_render_init(void *cfg, int cfg_size)
@@ -85,9 +88,22 @@ static int i2s_render_open(audio_render_handle_t render, av_render_audio_frame_i
     if (ret == 0) {
         memcpy(&i2s->info, info, sizeof(av_render_audio_frame_info_t));
     }
+    i2s->play_end_time = 0;
+    i2s->latency = 0;
     return ret;
 }
 
+static void i2s_render_update_latency(i2s_render_t *i2s, int size)
+{
+    // Write blocks once DMA is full, so time to play out all written data is the buffered latency
+    int64_t cur = esp_timer_get_time();
+    if (i2s->play_end_time < cur) {
+        i2s->play_end_time = cur;
+    }
+    i2s->play_end_time += (int64_t)(size / SAMPLE_SIZE(i2s->info)) * 1000000 / i2s->info.sample_rate;
+    i2s->latency = (uint32_t)((i2s->play_end_time - cur) / 1000);
+}
+
 static int i2s_render_write(audio_render_handle_t render, av_render_audio_frame_t *audio_data)
 {
     if (render == NULL || audio_data == NULL) {
@@ -115,6 +131,9 @@ static int i2s_render_write(audio_render_handle_t render, av_render_audio_frame_
                 break;
             }
             ret = esp_codec_dev_write(i2s->play_handle, out_samples.samples, out_samples.out_num * SAMPLE_SIZE(i2s->info));
+            if (ret == 0) {
+                i2s_render_update_latency(i2s, out_samples.out_num * SAMPLE_SIZE(i2s->info));
+            }
             if (ret == 0 && i2s->ref_cb) {
                 i2s->ref_cb(audio_data->data, audio_data->size, i2s->ref_ctx);
             }
@@ -124,6 +143,9 @@ static int i2s_render_write(audio_render_handle_t render, av_render_audio_frame_
         }
     } else {
         int ret = esp_codec_dev_write(i2s->play_handle, audio_data->data, audio_data->size);
+        if (ret == 0) {
+            i2s_render_update_latency(i2s, audio_data->size);
+        }
         if (ret == 0 && i2s->ref_cb) {
             i2s->ref_cb(audio_data->data, audio_data->size, i2s->ref_ctx);
         }
@@ -136,7 +158,8 @@ static int i2s_render_get_latency(audio_render_handle_t render, uint32_t *latenc
     if (render == NULL) {
         return -1;
     }
-    *latency = 0;
+    i2s_render_t *i2s = (i2s_render_t *)render;
+    *latency = i2s->latency;
     return 0;
 }
 
@@ -35,16 +35,25 @@
 #include "esp_lcd_mipi_dsi.h"
 #endif
 #include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
 
 #define TAG "LCD_RENDER"
 
+#define LCD_MAX_FB_NUM (3)
+
 typedef struct {
     av_render_video_frame_info_t info;
     esp_lcd_panel_handle_t       handle;
     bool                         rgb_panel;
     bool                         dsi_panel;
-    uint8_t                     *frame_buffer[2];
+    uint8_t                     *frame_buffer[LCD_MAX_FB_NUM];
+    uint8_t                      fb_num;
     bool                         sel;
+    volatile int8_t              front_fb;  /*!< Frame buffer being scanned out */
+    volatile int8_t              queued_fb; /*!< Frame buffer drawn, wait for vsync to scan out */
+    volatile uint32_t            vsync_num;
+    portMUX_TYPE                 fb_lock;   /*!< Keep front and queued buffer consistent against vsync ISR */
+    uint32_t                     replaced_num;
     uint32_t                     start_time;
     uint8_t                      frame_num;
     bool                         drawing;
@@ -52,6 +61,18 @@ typedef struct {
 
 static int lcd_render_close(video_render_handle_t h);
 
+static void lcd_vsync(lcd_render_t *lcd)
+{
+    // Driver switch to latest drawn frame buffer on vsync
+    portENTER_CRITICAL_ISR(&lcd->fb_lock);
+    if (lcd->queued_fb >= 0) {
+        lcd->front_fb = lcd->queued_fb;
+        lcd->queued_fb = -1;
+    }
+    lcd->vsync_num++;
+    portEXIT_CRITICAL_ISR(&lcd->fb_lock);
+}
+
 #if CONFIG_IDF_TARGET_ESP32P4
 static bool draw_finished(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t *data, void *ctx)
 {
@@ -59,8 +80,32 @@ static bool draw_finished(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_
     lcd->drawing      = false;
     return true;
 }
+
+static bool dpi_refresh_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t *data, void *ctx)
+{
+    lcd_vsync((lcd_render_t *)ctx);
+    return false;
+}
 #endif
 
+#if SOC_LCD_RGB_SUPPORTED
+static bool rgb_on_vsync(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_panel_event_data_t *data, void *ctx)
+{
+    lcd_vsync((lcd_render_t *)ctx);
+    return false;
+}
+#endif
+
+static int get_frame_buffer_index(lcd_render_t *lcd, uint8_t *data)
+{
+    for (int i = 0; i < lcd->fb_num; i++) {
+        if (lcd->frame_buffer[i] && lcd->frame_buffer[i] == data) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 static video_render_handle_t lcd_render_open(void *cfg, int size)
 {
     lcd_render_cfg_t *lcd_cfg = (lcd_render_cfg_t *)cfg;
@@ -75,28 +120,43 @@ static video_render_handle_t lcd_render_open(void *cfg, int size)
     lcd->handle = lcd_cfg->lcd_handle; // lcd_cfg->lcd_handle;
     lcd->rgb_panel = lcd_cfg->rgb_panel;
     lcd->dsi_panel = lcd_cfg->dsi_panel;
+    lcd->front_fb = lcd->queued_fb = -1;
+    portMUX_INITIALIZE(&lcd->fb_lock);
     if (lcd_cfg->use_frame_buffer) {
+        lcd->fb_num = lcd_cfg->fb_num ? lcd_cfg->fb_num : 2;
+        if (lcd->fb_num > LCD_MAX_FB_NUM) {
+            lcd->fb_num = LCD_MAX_FB_NUM;
+        }
         if (lcd->rgb_panel) {
 #if SOC_LCD_RGB_SUPPORTED
-            esp_lcd_rgb_panel_get_frame_buffer(lcd->handle, 2, (void **)&lcd->frame_buffer[0],
-                                               (void **)&lcd->frame_buffer[1]);
+            esp_lcd_rgb_panel_get_frame_buffer(lcd->handle, lcd->fb_num, (void **)&lcd->frame_buffer[0],
+                                               (void **)&lcd->frame_buffer[1], (void **)&lcd->frame_buffer[2]);
+            if (lcd->fb_num > 2) {
+                esp_lcd_rgb_panel_event_callbacks_t rgb_cb = {
+                    .on_vsync = rgb_on_vsync,
+                };
+                esp_lcd_rgb_panel_register_event_callbacks(lcd->handle, &rgb_cb, lcd);
+            }
 #endif
         }
         if (lcd->dsi_panel) {
 #if CONFIG_IDF_TARGET_ESP32P4
-            esp_lcd_dpi_panel_get_frame_buffer(lcd->handle, 2, (void **)&lcd->frame_buffer[0],
-                                               (void **)&lcd->frame_buffer[1]);
+            esp_lcd_dpi_panel_get_frame_buffer(lcd->handle, lcd->fb_num, (void **)&lcd->frame_buffer[0],
+                                               (void **)&lcd->frame_buffer[1], (void **)&lcd->frame_buffer[2]);
 #endif
         }
-        if (lcd->frame_buffer[0] == NULL) {
-            ESP_LOGE(TAG, "Fail to get frame buffer");
+        if (lcd->frame_buffer[0] == NULL || lcd->frame_buffer[lcd->fb_num - 1] == NULL) {
+            ESP_LOGE(TAG, "Fail to get %d frame buffer", lcd->fb_num);
             lcd_render_close(lcd);
             return NULL;
         }
+        // Panel starts scanning out first frame buffer
+        lcd->front_fb = 0;
     }
 #if CONFIG_IDF_TARGET_ESP32P4
     esp_lcd_dpi_panel_event_callbacks_t dpi_cb = {
         .on_color_trans_done = draw_finished,
+        .on_refresh_done = lcd->fb_num > 2 ? dpi_refresh_done : NULL,
     };
     esp_lcd_dpi_panel_register_event_callbacks(lcd->handle, &dpi_cb, lcd);
 #endif
@@ -156,10 +216,37 @@ static int lcd_render_write(video_render_handle_t h, av_render_video_frame_t *vi
     uint32_t cur_time = esp_timer_get_time();
     if (cur_time > lcd->start_time + 1000000) {
         uint32_t elapse = cur_time - lcd->start_time;
-        ESP_LOGI(TAG, "fps: %" PRIu32, lcd->frame_num * 1000000 / elapse);
+        if (lcd->fb_num > 2) {
+            ESP_LOGI(TAG, "fps: %" PRIu32 " vsync: %" PRIu32 " replaced: %" PRIu32,
+                     lcd->frame_num * 1000000 / elapse, lcd->vsync_num, lcd->replaced_num);
+            lcd->vsync_num = 0;
+            lcd->replaced_num = 0;
+        } else {
+            ESP_LOGI(TAG, "fps: %" PRIu32, lcd->frame_num * 1000000 / elapse);
+        }
         lcd->start_time = cur_time;
         lcd->frame_num = 0;
     }
+    int fb_idx = lcd->fb_num > 2 ? get_frame_buffer_index(lcd, video_data->data) : -1;
+    if (fb_idx >= 0) {
+        // Decoded into free frame buffer, queue it for next vsync without copy or wait
+        if (video_data->size < lcd->info.width * lcd->info.height * 2) {
+            return ESP_MEDIA_ERR_INVALID_ARG;
+        }
+        int ret = esp_lcd_panel_draw_bitmap(lcd->handle, 0, 0, lcd->info.width, lcd->info.height, video_data->data);
+        if (ret != 0) {
+            return ret;
+        }
+        // Mark queued only after driver takes it, else vsync before draw would report it as scanned out
+        // and old front buffer still being scanned out would be handed to decoder
+        portENTER_CRITICAL(&lcd->fb_lock);
+        if (lcd->queued_fb >= 0) {
+            lcd->replaced_num++;
+        }
+        lcd->queued_fb = fb_idx;
+        portEXIT_CRITICAL(&lcd->fb_lock);
+        return ret;
+    }
 #if CONFIG_IDF_TARGET_ESP32P4
     while (lcd->drawing) {
         media_lib_thread_sleep(10);
@@ -208,6 +295,19 @@ static int lcd_render_get_frame_buffer(video_render_handle_t h, av_render_frame_
         return ESP_MEDIA_ERR_NOT_SUPPORT;
     }
     uint8_t *frame_buffer = lcd->frame_buffer[lcd->sel];
+    if (lcd->fb_num > 2) {
+        // Neither scanning out nor waiting for vsync
+        portENTER_CRITICAL(&lcd->fb_lock);
+        int8_t front = lcd->front_fb;
+        int8_t queued = lcd->queued_fb;
+        portEXIT_CRITICAL(&lcd->fb_lock);
+        for (int i = 0; i < lcd->fb_num; i++) {
+            if (i != front && i != queued) {
+                frame_buffer = lcd->frame_buffer[i];
+                break;
+            }
+        }
+    }
     if (frame_buffer == NULL) {
         frame_buffer = lcd->frame_buffer[0];
     }
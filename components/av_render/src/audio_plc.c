@@ -0,0 +1,297 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+#include "audio_plc.h"
+#include "media_lib_os.h"
+#include "esp_log.h"
+
+#define TAG "AUDIO_PLC"
+
+/* Gaps longer than this are treated as discontinuity (DTX or sender pause) and not filled
+ * so that buffering latency does not grow, render thread plays comfort noise for them instead
+ */
+#define AUDIO_PLC_MAX_CONCEAL_MS (120)
+/* Concealment fades from repeated waveform to comfort noise over this many frames */
+#define AUDIO_PLC_FADE_FRAMES    (3)
+#define AUDIO_PLC_FADE_IN_MS     (5)
+#define AUDIO_PLC_MAX_NOISE      (600)
+#define AUDIO_PLC_GAIN_ONE       (32768)
+#define AUDIO_PLC_MAX_CN_COEF    (29491)
+
+typedef struct {
+    av_render_audio_frame_info_t info;
+    int                          sample_size;
+    bool                         has_last;
+    uint32_t                     next_pts;
+    uint32_t                     last_in_pts;
+    int16_t                     *last;
+    int                          last_size;
+    int                          last_cap;
+    int16_t                     *conceal;
+    int                          conceal_cap;
+    bool                         need_fade_in;
+    int32_t                      noise_level;
+    uint32_t                     seed;
+    int32_t                      cn_level;
+    int32_t                      cn_coef;
+} audio_plc_t;
+
+static int plc_ensure_size(int16_t **buf, int *cap, int size)
+{
+    if (size <= *cap) {
+        return 0;
+    }
+    int16_t *new_buf = (int16_t *)media_lib_realloc(*buf, size);
+    if (new_buf == NULL) {
+        return ESP_MEDIA_ERR_NO_MEM;
+    }
+    *buf = new_buf;
+    *cap = size;
+    return 0;
+}
+
+static inline int16_t plc_noise(audio_plc_t *plc)
+{
+    plc->seed = plc->seed * 1664525 + 1013904223;
+    // Uniform noise with mean absolute value equal to noise level
+    return (int16_t)(((int32_t)(int16_t)(plc->seed >> 16) * plc->noise_level * 2) >> 15);
+}
+
+static void plc_update_noise(audio_plc_t *plc, int16_t *data, int samples)
+{
+    if (samples == 0) {
+        return;
+    }
+    int64_t sum = 0;
+    for (int i = 0; i < samples; i++) {
+        sum += data[i] >= 0 ? data[i] : -data[i];
+    }
+    int32_t level = (int32_t)(sum / samples);
+    // Track noise floor: follow decrease quickly, increase slowly
+    if (level < plc->noise_level) {
+        plc->noise_level = level;
+    } else {
+        plc->noise_level += (level - plc->noise_level) >> 6;
+    }
+    if (plc->noise_level > AUDIO_PLC_MAX_NOISE) {
+        plc->noise_level = AUDIO_PLC_MAX_NOISE;
+    }
+}
+
+static int32_t plc_isqrt(uint64_t v)
+{
+    uint64_t r = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (int32_t)r;
+}
+
+static void plc_update_cn_shape(audio_plc_t *plc, int16_t *data, int frames)
+{
+    // Level and spectral tilt of last frame (first channel), comfort noise follows them during DTX
+    int channel = plc->info.channel;
+    int64_t r0 = 0, r1 = 0;
+    for (int n = 0; n < frames; n++) {
+        int32_t v = data[n * channel];
+        r0 += v * v;
+        if (n) {
+            r1 += v * data[(n - 1) * channel];
+        }
+    }
+    if (frames == 0 || r0 == 0) {
+        plc->cn_level = 0;
+        return;
+    }
+    int32_t level = plc_isqrt((uint64_t)(r0 / frames));
+    plc->cn_level = level > AUDIO_PLC_MAX_NOISE ? AUDIO_PLC_MAX_NOISE : level;
+    int32_t coef = r1 <= 0 ? 0 : (int32_t)(r1 * AUDIO_PLC_GAIN_ONE / r0);
+    plc->cn_coef = coef > AUDIO_PLC_MAX_CN_COEF ? AUDIO_PLC_MAX_CN_COEF : coef;
+}
+
+static void plc_make_conceal(audio_plc_t *plc, int idx)
+{
+    int channel = plc->info.channel;
+    int frames = plc->last_size / plc->sample_size;
+    // Alternate forward and reversed repeat so that waveform stays continuous at frame boundary
+    bool reverse = (idx & 1) == 0;
+    int32_t g0 = AUDIO_PLC_GAIN_ONE * (AUDIO_PLC_FADE_FRAMES - idx) / AUDIO_PLC_FADE_FRAMES;
+    int32_t g1 = AUDIO_PLC_GAIN_ONE * (AUDIO_PLC_FADE_FRAMES - idx - 1) / AUDIO_PLC_FADE_FRAMES;
+    if (g0 < 0) {
+        g0 = 0;
+    }
+    if (g1 < 0) {
+        g1 = 0;
+    }
+    int16_t *out = plc->conceal;
+    for (int n = 0; n < frames; n++) {
+        int32_t g = g0 + (g1 - g0) * n / frames;
+        int src = reverse ? frames - 1 - n : n;
+        for (int c = 0; c < channel; c++) {
+            int32_t v = plc->last[src * channel + c];
+            *out++ = (int16_t)((v * g + plc_noise(plc) * (AUDIO_PLC_GAIN_ONE - g)) >> 15);
+        }
+    }
+}
+
+static void plc_fade_in(audio_plc_t *plc, int16_t *data, int frames)
+{
+    int fade = plc->info.sample_rate * AUDIO_PLC_FADE_IN_MS / 1000;
+    if (fade > frames) {
+        fade = frames;
+    }
+    for (int n = 0; n < fade; n++) {
+        for (int c = 0; c < plc->info.channel; c++) {
+            int32_t v = data[n * plc->info.channel + c];
+            data[n * plc->info.channel + c] = (int16_t)(v * n / fade);
+        }
+    }
+}
+
+audio_plc_handle_t audio_plc_open(av_render_audio_frame_info_t *info)
+{
+    if (info->bits_per_sample != 16 || info->channel == 0 || info->sample_rate == 0) {
+        return NULL;
+    }
+    audio_plc_t *plc = (audio_plc_t *)media_lib_calloc(1, sizeof(audio_plc_t));
+    if (plc == NULL) {
+        return NULL;
+    }
+    plc->info = *info;
+    plc->sample_size = info->channel * sizeof(int16_t);
+    plc->noise_level = AUDIO_PLC_MAX_NOISE;
+    plc->seed = 0x12345678;
+    return plc;
+}
+
+int audio_plc_process(audio_plc_handle_t h, av_render_audio_frame_t *frame, audio_plc_frame_cb cb, void *ctx)
+{
+    audio_plc_t *plc = (audio_plc_t *)h;
+    if (plc == NULL || frame->size == 0 || frame->eos) {
+        return cb(frame, ctx);
+    }
+    int frames = frame->size / plc->sample_size;
+    uint32_t duration = (uint32_t)((uint64_t)frames * 1000 / plc->info.sample_rate);
+    // One packet may decode into several frames sharing same pts
+    uint32_t pts = frame->pts;
+    if (plc->has_last && pts == plc->last_in_pts) {
+        pts = plc->next_pts;
+    }
+    plc->last_in_pts = frame->pts;
+    if (plc->has_last && plc->last_size) {
+        uint32_t last_duration = (uint32_t)((uint64_t)(plc->last_size / plc->sample_size) * 1000 / plc->info.sample_rate);
+        int32_t gap = (int32_t)(pts - plc->next_pts);
+        if (last_duration && gap > (int32_t)(last_duration / 2)) {
+            if (gap <= AUDIO_PLC_MAX_CONCEAL_MS && plc_ensure_size(&plc->conceal, &plc->conceal_cap, plc->last_size) == 0) {
+                int num = (gap + last_duration / 2) / last_duration;
+                ESP_LOGD(TAG, "Conceal %d frames for gap %d", num, (int)gap);
+                for (int i = 0; i < num; i++) {
+                    plc_make_conceal(plc, i);
+                    av_render_audio_frame_t conceal = {
+                        .pts = plc->next_pts + i * last_duration,
+                        .data = (uint8_t *)plc->conceal,
+                        .size = plc->last_size,
+                    };
+                    cb(&conceal, ctx);
+                }
+            }
+            plc->need_fade_in = true;
+        }
+    }
+    if (plc->need_fade_in) {
+        plc_fade_in(plc, (int16_t *)frame->data, frames);
+        plc->need_fade_in = false;
+    }
+    plc_update_noise(plc, (int16_t *)frame->data, frames * plc->info.channel);
+    plc_update_cn_shape(plc, (int16_t *)frame->data, frames);
+    if (plc_ensure_size(&plc->last, &plc->last_cap, frame->size) == 0) {
+        memcpy(plc->last, frame->data, frame->size);
+        plc->last_size = frame->size;
+    } else {
+        plc->last_size = 0;
+    }
+    plc->has_last = true;
+    plc->next_pts = pts + duration;
+    return cb(frame, ctx);
+}
+
+void audio_plc_get_cn_shape(audio_plc_handle_t h, int32_t *level, int32_t *coef)
+{
+    audio_plc_t *plc = (audio_plc_t *)h;
+    *level = plc ? plc->cn_level : 0;
+    *coef = plc ? plc->cn_coef : 0;
+}
+
+void audio_plc_make_comfort_noise(audio_plc_cn_t *cn, int16_t *data, int frames, int channel)
+{
+    int32_t coef = cn->coef;
+    // Low pass lowers level by sqrt((1 - a) / (1 + a)), compensate it, uniform noise RMS is peak / sqrt(3)
+    int32_t peak = (int32_t)((int64_t)cn->level * 1774 / 1024);
+    int32_t comp = plc_isqrt((uint64_t)(AUDIO_PLC_GAIN_ONE + coef) * AUDIO_PLC_GAIN_ONE / (AUDIO_PLC_GAIN_ONE - coef));
+    peak = (int32_t)((int64_t)peak * comp / 181);
+    for (int n = 0; n < frames; n++) {
+        cn->seed = cn->seed * 1664525 + 1013904223;
+        int32_t w = ((int32_t)(int16_t)(cn->seed >> 16) * peak) >> 15;
+        cn->mem = (int32_t)(((int64_t)cn->mem * coef + (int64_t)w * (AUDIO_PLC_GAIN_ONE - coef)) >> 15);
+        int32_t v = cn->mem > INT16_MAX ? INT16_MAX : (cn->mem < INT16_MIN ? INT16_MIN : cn->mem);
+        for (int c = 0; c < channel; c++) {
+            *data++ = (int16_t)v;
+        }
+    }
+}
+
+void audio_plc_reset(audio_plc_handle_t h)
+{
+    audio_plc_t *plc = (audio_plc_t *)h;
+    if (plc) {
+        plc->has_last = false;
+        plc->need_fade_in = false;
+    }
+}
+
+void audio_plc_close(audio_plc_handle_t h)
+{
+    audio_plc_t *plc = (audio_plc_t *)h;
+    if (plc == NULL) {
+        return;
+    }
+    if (plc->last) {
+        media_lib_free(plc->last);
+    }
+    if (plc->conceal) {
+        media_lib_free(plc->conceal);
+    }
+    media_lib_free(plc);
+}
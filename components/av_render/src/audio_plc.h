@@ -0,0 +1,76 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef AUDIO_PLC_H
+#define AUDIO_PLC_H
+
+#include "av_render_types.h"
+
+typedef void *audio_plc_handle_t;
+
+/**
+ * @brief  Output callback for both concealed and received frames
+ */
+typedef int (*audio_plc_frame_cb)(av_render_audio_frame_t *frame, void *ctx);
+
+/**
+ * @brief  Open packet loss concealment for 16 bits PCM, return NULL if format not supported
+ */
+audio_plc_handle_t audio_plc_open(av_render_audio_frame_info_t *info);
+
+/**
+ * @brief  Check pts gap before decoded frame, output concealment frames then the frame itself
+ *
+ * @note  Frame data may be modified in place to fade in after loss
+ */
+int audio_plc_process(audio_plc_handle_t h, av_render_audio_frame_t *frame, audio_plc_frame_cb cb, void *ctx);
+
+/**
+ * @brief  Comfort noise generator state
+ */
+typedef struct {
+    int32_t  level;  /*!< Target RMS level */
+    int32_t  coef;   /*!< One pole low pass coefficient (Q15) */
+    int32_t  mem;    /*!< Filter memory */
+    uint32_t seed;   /*!< Noise seed */
+} audio_plc_cn_t;
+
+/**
+ * @brief  Get comfort noise level and spectral tilt measured from last decoded frame
+ */
+void audio_plc_get_cn_shape(audio_plc_handle_t h, int32_t *level, int32_t *coef);
+
+/**
+ * @brief  Generate 16 bits comfort noise, same value is written to every channel
+ */
+void audio_plc_make_comfort_noise(audio_plc_cn_t *cn, int16_t *data, int frames, int channel);
+
+/**
+ * @brief  Reset loss detection state, used after flush or seek
+ */
+void audio_plc_reset(audio_plc_handle_t h);
+
+void audio_plc_close(audio_plc_handle_t h);
+
+#endif
@@ -31,6 +31,8 @@ typedef struct {
     audio_render_handle_t render_handle;
     bool                  is_open;
     int                   ref_count;
+    uint8_t              *stage_buf;
+    int                   stage_size;
 } audio_render_t;
 
 static void try_free(audio_render_t *a_render)
@@ -43,6 +45,9 @@ static void try_free(audio_render_t *a_render)
             a_render->render_ops.deinit(a_render->render_handle);
             a_render->render_handle = NULL;
         }
+        if (a_render->stage_buf) {
+            media_lib_free(a_render->stage_buf);
+        }
         media_lib_free(a_render);
     }
 }
@@ -90,6 +95,43 @@ int audio_render_write(audio_render_handle_t render, av_render_audio_frame_t *au
     return a_render->render_ops.write(a_render->render_handle, audio_data);
 }
 
+int audio_render_get_buffer(audio_render_handle_t render, int size, uint8_t **buffer)
+{
+    audio_render_t *a_render = render;
+    if (buffer == NULL || size <= 0 || a_render == NULL || a_render->is_open == false) {
+        return -1;
+    }
+    if (a_render->render_ops.get_buffer && a_render->render_ops.commit) {
+        return a_render->render_ops.get_buffer(a_render->render_handle, size, buffer);
+    }
+    // Backend only supports write, stage into internal buffer
+    if (size > a_render->stage_size) {
+        uint8_t *new_buf = (uint8_t *)media_lib_realloc(a_render->stage_buf, size);
+        if (new_buf == NULL) {
+            return ESP_MEDIA_ERR_NO_MEM;
+        }
+        a_render->stage_buf = new_buf;
+        a_render->stage_size = size;
+    }
+    *buffer = a_render->stage_buf;
+    return 0;
+}
+
+int audio_render_commit(audio_render_handle_t render, av_render_audio_frame_t *audio_data)
+{
+    audio_render_t *a_render = render;
+    if (audio_data == NULL || a_render == NULL || a_render->is_open == false) {
+        return -1;
+    }
+    if (a_render->render_ops.get_buffer && a_render->render_ops.commit) {
+        return a_render->render_ops.commit(a_render->render_handle, audio_data);
+    }
+    if (audio_data->size == 0) {
+        return 0;
+    }
+    return a_render->render_ops.write(a_render->render_handle, audio_data);
+}
+
 int audio_render_get_latency(audio_render_handle_t render, uint32_t *latency)
 {
     audio_render_t *a_render = render;
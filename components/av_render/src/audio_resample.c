@@ -51,9 +51,16 @@
 #include "esp_ae_bit_cvt.h"
 #include "media_lib_os.h"
 #include "esp_log.h"
+#include <math.h>
 
 #define TAG "RESAMPLE"
 
+/* Fused path handles 16bits input, integer up-sample ratio and mono/stereo */
+#define FUSED_TAPS_PER_PHASE (8)
+#define FUSED_MAX_RATIO      (6)
+#define FUSED_HIST_NUM       (FUSED_TAPS_PER_PHASE - 1)
+#define FUSED_COEF_SHIFT     (15)
+
 #define ELEMS(a) (sizeof(a) / sizeof(a[0]))
 
 #define SAMPLE_SIZE(info) (info.channel * (info.bits_per_sample >> 3))
@@ -71,8 +78,20 @@ typedef enum {
     RESAMPLE_OPS_RATE_CVT,
 } resample_ops_t;
 
+typedef struct {
+    bool    enable;
+    uint8_t ratio;                                          /*!< Output rate / input rate */
+    uint8_t in_ch;
+    uint8_t out_ch;
+    uint8_t filter_ch;                                      /*!< Channels go through filter */
+    uint8_t out_bytes;
+    int16_t coef[FUSED_MAX_RATIO][FUSED_TAPS_PER_PHASE];    /*!< Polyphase coefficients in Q15 */
+    int16_t hist[2][FUSED_HIST_NUM * 2];                    /*!< Filter history followed by head of input */
+} fused_cvt_t;
+
 typedef struct {
     audio_resample_cfg_t     cfg;
+    fused_cvt_t              fused;
     esp_ae_ch_cvt_handle_t   ch_cvt_handle;
     esp_ae_rate_cvt_handle_t rate_cvt_handle;
     esp_ae_bit_cvt_handle_t  bit_cvt_handle;
@@ -132,6 +151,23 @@ static void release_work_buf(work_buf_t *buf)
     }
 }
 
+static uint8_t *get_out_buffer(resample_t *resample, int size)
+{
+    if (resample->cfg.get_buffer) {
+        uint8_t *out = resample->cfg.get_buffer(size, resample->cfg.ctx);
+        if (out) {
+            return out;
+        }
+    }
+    work_buf_t *buf = alloc_work_buf(resample, size);
+    if (buf == NULL) {
+        return NULL;
+    }
+    // Output is consumed in callback before next write
+    release_work_buf(buf);
+    return buf->data;
+}
+
 static int get_need_size(resample_t *resample, resample_ops_t op, uint32_t *sample, av_render_audio_frame_info_t *info)
 {
     if (op == RESAMPLE_OPS_CH_CVT) {
@@ -149,6 +185,151 @@ static int get_need_size(resample_t *resample, resample_ops_t op, uint32_t *samp
     return 0;
 }
 
+static bool fused_cvt_init(fused_cvt_t *fused, audio_resample_cfg_t *cfg)
+{
+    av_render_audio_frame_info_t *in = &cfg->input_info;
+    av_render_audio_frame_info_t *out = &cfg->output_info;
+    if (in->bits_per_sample != 16 || (out->bits_per_sample != 16 && out->bits_per_sample != 32)) {
+        return false;
+    }
+    if (in->channel == 0 || in->channel > 2 || out->channel == 0 || out->channel > 2) {
+        return false;
+    }
+    if (in->sample_rate == 0 || out->sample_rate < in->sample_rate || out->sample_rate % in->sample_rate) {
+        return false;
+    }
+    uint32_t ratio = out->sample_rate / in->sample_rate;
+    if (ratio > FUSED_MAX_RATIO) {
+        return false;
+    }
+    fused->ratio = (uint8_t)ratio;
+    fused->in_ch = in->channel;
+    fused->out_ch = out->channel;
+    fused->filter_ch = in->channel < out->channel ? in->channel : out->channel;
+    fused->out_bytes = out->bits_per_sample >> 3;
+    // Windowed sinc low pass at input nyquist, each phase normalized to unity gain
+    int taps = ratio * FUSED_TAPS_PER_PHASE;
+    float center = (taps - 1) / 2.0f;
+    for (int p = 0; p < ratio; p++) {
+        float h[FUSED_TAPS_PER_PHASE];
+        float sum = 0;
+        for (int k = 0; k < FUSED_TAPS_PER_PHASE; k++) {
+            float t = (p + k * ratio - center) / ratio;
+            float sinc = (t == 0) ? 1.0f : sinf((float)M_PI * 0.9f * t) / ((float)M_PI * 0.9f * t);
+            float win = 0.42f - 0.5f * cosf(2 * (float)M_PI * (p + k * ratio + 0.5f) / taps)
+                        + 0.08f * cosf(4 * (float)M_PI * (p + k * ratio + 0.5f) / taps);
+            h[k] = sinc * win;
+            sum += h[k];
+        }
+        for (int k = 0; k < FUSED_TAPS_PER_PHASE; k++) {
+            fused->coef[p][k] = (int16_t)lrintf(h[k] / sum * ((1 << FUSED_COEF_SHIFT) - 1));
+        }
+    }
+    fused->enable = true;
+    return true;
+}
+
+static inline void fused_put(fused_cvt_t *fused, uint8_t *out, int32_t v)
+{
+    // v is Q15 scaled 16 bits sample
+    if (fused->out_bytes == 2) {
+        v >>= FUSED_COEF_SHIFT;
+        if (v > 32767) {
+            v = 32767;
+        } else if (v < -32768) {
+            v = -32768;
+        }
+        int16_t *o = (int16_t *)out;
+        o[0] = (int16_t)v;
+        if (fused->out_ch > fused->filter_ch) {
+            o[1] = (int16_t)v;
+        }
+    } else {
+        int64_t w = (int64_t)v << (16 - FUSED_COEF_SHIFT);
+        if (w > INT32_MAX) {
+            w = INT32_MAX;
+        } else if (w < INT32_MIN) {
+            w = INT32_MIN;
+        }
+        int32_t *o = (int32_t *)out;
+        o[0] = (int32_t)w;
+        if (fused->out_ch > fused->filter_ch) {
+            o[1] = (int32_t)w;
+        }
+    }
+}
+
+/* Filter one channel of interleaved input, x[n] = in[n * step] (+ in[n * step + 1] when down-mix) */
+static void fused_filter_channel(fused_cvt_t *fused, const int16_t *in, int step, bool mix, int sample_num,
+                                 int16_t *hist, uint8_t *out, int out_stride)
+{
+    int ratio = fused->ratio;
+    if (ratio == 1) {
+        // Only channel and bits convert
+        for (int n = 0; n < sample_num; n++) {
+            int32_t v = mix ? ((in[n * step] + in[n * step + 1]) >> 1) : in[n * step];
+            fused_put(fused, out, v << FUSED_COEF_SHIFT);
+            out += out_stride;
+        }
+        return;
+    }
+    int head = sample_num < FUSED_HIST_NUM ? sample_num : FUSED_HIST_NUM;
+    // Head samples need history, join them into one line
+    for (int n = 0; n < head; n++) {
+        hist[FUSED_HIST_NUM + n] = mix ? (int16_t)((in[n * step] + in[n * step + 1]) >> 1) : in[n * step];
+    }
+    for (int n = 0; n < head; n++) {
+        const int16_t *x = hist + FUSED_HIST_NUM + n;
+        for (int p = 0; p < ratio; p++) {
+            const int16_t *c = fused->coef[p];
+            int32_t acc = 0;
+            for (int k = 0; k < FUSED_TAPS_PER_PHASE; k++) {
+                acc += c[k] * x[-k];
+            }
+            fused_put(fused, out, acc);
+            out += out_stride;
+        }
+    }
+    for (int n = head; n < sample_num; n++) {
+        const int16_t *x = in + n * step;
+        for (int p = 0; p < ratio; p++) {
+            const int16_t *c = fused->coef[p];
+            int32_t acc = 0;
+            if (mix) {
+                for (int k = 0; k < FUSED_TAPS_PER_PHASE; k++) {
+                    acc += c[k] * ((x[-k * step] + x[-k * step + 1]) >> 1);
+                }
+            } else {
+                for (int k = 0; k < FUSED_TAPS_PER_PHASE; k++) {
+                    acc += c[k] * x[-k * step];
+                }
+            }
+            fused_put(fused, out, acc);
+            out += out_stride;
+        }
+    }
+    // Keep last samples as history for next frame
+    if (sample_num >= FUSED_HIST_NUM) {
+        for (int k = 0; k < FUSED_HIST_NUM; k++) {
+            int n = sample_num - FUSED_HIST_NUM + k;
+            hist[k] = mix ? (int16_t)((in[n * step] + in[n * step + 1]) >> 1) : in[n * step];
+        }
+    } else {
+        memmove(hist, hist + sample_num, FUSED_HIST_NUM * sizeof(int16_t));
+    }
+}
+
+static int fused_cvt_process(fused_cvt_t *fused, const int16_t *in, int sample_num, uint8_t *out)
+{
+    bool mix = fused->in_ch > fused->out_ch;
+    int frame_out = fused->out_ch * fused->out_bytes;
+    for (int ch = 0; ch < fused->filter_ch; ch++) {
+        fused_filter_channel(fused, in + ch, fused->in_ch, mix, sample_num, fused->hist[ch],
+                             out + ch * fused->out_bytes, frame_out);
+    }
+    return sample_num * fused->ratio * frame_out;
+}
+
 audio_resample_handle_t audio_resample_open(audio_resample_cfg_t *cfg)
 {
     resample_t *resample = (resample_t *)media_lib_calloc(1, sizeof(resample_t));
@@ -156,6 +337,15 @@ audio_resample_handle_t audio_resample_open(audio_resample_cfg_t *cfg)
         if (resample == NULL) {
             break;
         }
+        // Common up-sample cases are converted in one pass without AE chain
+        if (memcmp(&cfg->input_info, &cfg->output_info, sizeof(av_render_audio_frame_info_t)) &&
+            fused_cvt_init(&resample->fused, cfg)) {
+            ESP_LOGI(TAG, "Use fused convert ratio:%d ch:%d->%d bits:%d->%d", resample->fused.ratio,
+                     cfg->input_info.channel, cfg->output_info.channel,
+                     cfg->input_info.bits_per_sample, cfg->output_info.bits_per_sample);
+            resample->cfg = *cfg;
+            return resample;
+        }
         sort_resample_ops(resample, cfg);
         av_render_audio_frame_info_t cur_info = cfg->input_info;
         esp_ae_err_t ret = ESP_AE_ERR_OK;
@@ -217,48 +407,70 @@ audio_resample_handle_t audio_resample_open(audio_resample_cfg_t *cfg)
 int audio_resample_write(audio_resample_handle_t h, av_render_audio_frame_t *data)
 {
     resample_t *resample = (resample_t *)h;
+    if (data->size && resample->fused.enable) {
+        fused_cvt_t *fused = &resample->fused;
+        int sample_num = data->size / SAMPLE_SIZE(resample->cfg.input_info);
+        int out_size = sample_num * fused->ratio * SAMPLE_SIZE(resample->cfg.output_info);
+        uint8_t *out = get_out_buffer(resample, out_size);
+        if (out == NULL) {
+            return ESP_MEDIA_ERR_NO_MEM;
+        }
+        av_render_audio_frame_t new_frame = *data;
+        new_frame.data = out;
+        new_frame.size = fused_cvt_process(fused, (int16_t *)data->data, sample_num, out);
+        resample->cfg.resample_cb(&new_frame, resample->cfg.ctx);
+        return ESP_MEDIA_ERR_OK;
+    }
     // Bypass or size is 0
     if (data->size == 0 || resample->ops[0] == RESAMPLE_OPS_NONE) {
         resample->cfg.resample_cb(data, resample->cfg.ctx);
         return ESP_MEDIA_ERR_OK;
     }
     av_render_audio_frame_info_t cur_info = resample->cfg.input_info;
-    work_buf_t *cur = NULL;
     work_buf_t *last = NULL;
+    uint8_t *in_data = data->data;
     uint32_t sample_num = data->size / SAMPLE_SIZE(cur_info);
     int need_size = 0;
-    for (int i = 0; i < ELEMS(resample->ops); i++) {
-        if (resample->ops[i] == RESAMPLE_OPS_NONE) {
-            break;
-        }
+    int op_num = 0;
+    while (op_num < ELEMS(resample->ops) && resample->ops[op_num] != RESAMPLE_OPS_NONE) {
+        op_num++;
+    }
+    for (int i = 0; i < op_num; i++) {
         uint32_t out_sample = sample_num;
         need_size = get_need_size(resample, resample->ops[i], &out_sample, &cur_info);
-        cur = alloc_work_buf(resample, need_size);
-        if (cur == NULL) {
+        // Last stage writes into output buffer directly
+        work_buf_t *cur = NULL;
+        uint8_t *out = NULL;
+        if (i == op_num - 1) {
+            out = get_out_buffer(resample, need_size);
+        } else {
+            cur = alloc_work_buf(resample, need_size);
+            out = cur ? cur->data : NULL;
+        }
+        if (out == NULL) {
             release_work_buf(last);
             return ESP_MEDIA_ERR_NO_MEM;
         }
-        esp_ae_sample_t in_sample = (esp_ae_sample_t)(last ? last->data : data->data);
+        esp_ae_sample_t in_sample = (esp_ae_sample_t)in_data;
         if (resample->ops[i] == RESAMPLE_OPS_CH_CVT) {
-            esp_ae_ch_cvt_process(resample->ch_cvt_handle, sample_num, in_sample, (esp_ae_sample_t)cur->data);
+            esp_ae_ch_cvt_process(resample->ch_cvt_handle, sample_num, in_sample, (esp_ae_sample_t)out);
             cur_info.channel = resample->cfg.output_info.channel;
         } else if (resample->ops[i] == RESAMPLE_OPS_RATE_CVT) {
-            esp_ae_rate_cvt_process(resample->rate_cvt_handle, in_sample, sample_num, (esp_ae_sample_t)cur->data, &out_sample);
+            esp_ae_rate_cvt_process(resample->rate_cvt_handle, in_sample, sample_num, (esp_ae_sample_t)out, &out_sample);
             need_size = out_sample * SAMPLE_SIZE(cur_info);
             cur_info.sample_rate = resample->cfg.output_info.sample_rate;
             sample_num = out_sample;
         } else if (resample->ops[i] == RESAMPLE_OPS_BIT_CVT) {
-            esp_ae_bit_cvt_process(resample->bit_cvt_handle, sample_num, in_sample, (esp_ae_sample_t)cur->data);
+            esp_ae_bit_cvt_process(resample->bit_cvt_handle, sample_num, in_sample, (esp_ae_sample_t)out);
             cur_info.bits_per_sample = resample->cfg.output_info.bits_per_sample;
         }
-        if (last) {
-            release_work_buf(last);
-        }
+        release_work_buf(last);
         last = cur;
+        in_data = out;
     }
-    release_work_buf(cur);
+    release_work_buf(last);
     av_render_audio_frame_t new_frame = *data;
-    new_frame.data = cur->data;
+    new_frame.data = in_data;
     new_frame.size = need_size;
     resample->cfg.resample_cb(&new_frame, resample->cfg.ctx);
     return ESP_MEDIA_ERR_OK;
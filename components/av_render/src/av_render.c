@@ -31,6 +31,7 @@
 #include "audio_decoder.h"
 #include "video_decoder.h"
 #include "audio_render.h"
+#include "audio_plc.h"
 #include "video_render.h"
 #include "audio_resample.h"
 #include "esp_timer.h"
@@ -55,6 +56,13 @@
 #define VIDEO_ERR_FRAME_TOLERANCE (5)
 #define AUDIO_ERR_FRAME_TOLERANCE (10)
 
+/* Render thread plays comfort noise when no audio arrives for longer than PLC conceals (DTX)
+ * Noise stops after `AUDIO_CN_MAX_DURATION` as sender is regarded as paused
+ */
+#define AUDIO_CN_START_TIME   (120)
+#define AUDIO_CN_MAX_DURATION (2000)
+#define AUDIO_CN_FRAME_MS     (10)
+
 typedef enum {
     AV_RENDER_MSG_NONE,
     AV_RENDER_MSG_PAUSE,
@@ -98,10 +106,27 @@ typedef struct {
     color_convert_table_t       *vid_convert;
     uint8_t                     *vid_convert_out;
     int                          vid_convert_out_size;
+    av_render_video_codec_t      codec;
+    uint32_t                     in_pts;
+    uint32_t                     decode_skip_num;
 } av_render_vdec_res_t;
 
 struct _av_render;
 
+#define AV_SYNC_STAT_BUCKETS         (7)
+#define AV_SYNC_STAT_REPORT_INTERVAL (10000)
+
+/**
+ * @brief  A/V offset distribution, bucket edges are -80, -40, -20, 20, 40, 80 ms
+ */
+typedef struct {
+    uint32_t count[AV_SYNC_STAT_BUCKETS];
+    int32_t  min_offset;
+    int32_t  max_offset;
+    int64_t  sum_offset;
+    uint32_t total;
+} av_render_sync_stat_t;
+
 typedef struct {
     av_render_thread_res_t       thread_res;
     bool                         audio_packet_reached;
@@ -109,11 +134,24 @@ typedef struct {
     av_render_audio_frame_info_t audio_frame_info;
     av_render_audio_frame_info_t out_frame_info;
     audio_resample_handle_t      resample_handle;
+    audio_plc_handle_t           plc;
+    uint8_t                     *direct_buf;
+    bool                         direct_commit;
     bool                         need_resample;
     uint32_t                     audio_send_pts;
+    uint32_t                     audio_clock_pts;
+    uint32_t                     audio_clock_time;
+    bool                         audio_clock_valid;
     bool                         decode_in_sync;
     bool                         audio_is_pcm;
     bool                         a_render_in_sync;
+    audio_plc_cn_t               cn;
+    uint8_t                     *cn_buf;
+    int                          cn_buf_size;
+    bool                         cn_allowed;
+    bool                         underrun;
+    uint32_t                     underrun_time;
+    uint32_t                     cn_sent;
 } av_render_audio_res_t;
 
 typedef struct {
@@ -123,6 +161,7 @@ typedef struct {
     av_render_video_frame_info_t video_frame_info;
     bool                         decode_in_sync;
     bool                         use_fb;
+    bool                         render_fb;
     uint32_t                     video_send_pts;
     bool                         v_render_in_sync;
     bool                         video_is_raw;
@@ -131,6 +170,9 @@ typedef struct {
     uint32_t                     video_start_pts;
     uint32_t                     video_last_pts;
     int                          sync_tolerance;
+    av_render_sync_stat_t        sync_stat;
+    uint32_t                     sync_report_time;
+    uint32_t                     render_skip_num;
 } av_render_video_res_t;
 
 typedef struct _av_render {
@@ -497,6 +539,47 @@ static int decode_video(av_render_vdec_res_t *vdec_res, av_render_video_data_t *
     return ret;
 }
 
+static bool video_frame_droppable(av_render_video_codec_t codec, uint8_t *data, int size)
+{
+    if (codec == AV_RENDER_VIDEO_CODEC_MJPEG) {
+        return true;
+    }
+    if (codec != AV_RENDER_VIDEO_CODEC_H264) {
+        return false;
+    }
+    // Droppable only when all slices have nal_ref_idc equal 0
+    bool has_slice = false;
+    for (int i = 0; i + 3 < size; i++) {
+        if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1) {
+            continue;
+        }
+        uint8_t nal = data[i + 3];
+        uint8_t nal_type = nal & 0x1F;
+        if (nal_type == 1 || nal_type == 5) {
+            if (nal & 0x60) {
+                return false;
+            }
+            has_slice = true;
+        }
+        i += 3;
+    }
+    return has_slice;
+}
+
+static bool video_over_latency_budget(av_render_vdec_res_t *vdec_res, av_render_video_data_t *data)
+{
+    av_render_t *render = vdec_res->thread_res.render;
+    if (render->cfg.video_latency_budget == 0 || data->eos) {
+        return false;
+    }
+    // Queued duration from current frame to newest received one
+    int32_t queued = (int32_t)(vdec_res->in_pts - data->pts);
+    if (queued <= render->cfg.video_latency_budget) {
+        return false;
+    }
+    return video_frame_droppable(vdec_res->codec, data->data, (int)data->size);
+}
+
 static int vdec_body(av_render_thread_res_t *res, bool drop)
 {
     av_render_video_data_t data;
@@ -509,6 +592,10 @@ static int vdec_body(av_render_thread_res_t *res, bool drop)
     if (data.size || data.eos) {
         bool skip = false;
         video_sync_control_before_decode(res->render, data.pts, q_num, &skip);
+        if (skip == false && video_over_latency_budget(vdec_res, &data)) {
+            vdec_res->decode_skip_num++;
+            skip = true;
+        }
         if (drop == false && (skip == false || data.eos)) {
             decode_video(vdec_res, &data);
         }
@@ -528,6 +615,36 @@ static int vdec_body(av_render_thread_res_t *res, bool drop)
     return 0;
 }
 
+static void av_sync_stat_add(av_render_video_res_t *v_render, int32_t offset)
+{
+    static const int16_t edges[AV_SYNC_STAT_BUCKETS - 1] = {-80, -40, -20, 20, 40, 80};
+    av_render_sync_stat_t *stat = &v_render->sync_stat;
+    int i = 0;
+    while (i < AV_SYNC_STAT_BUCKETS - 1 && offset >= edges[i]) {
+        i++;
+    }
+    stat->count[i]++;
+    if (stat->total == 0 || offset < stat->min_offset) {
+        stat->min_offset = offset;
+    }
+    if (stat->total == 0 || offset > stat->max_offset) {
+        stat->max_offset = offset;
+    }
+    stat->sum_offset += offset;
+    stat->total++;
+    uint32_t cur = get_cur_time();
+    if (cur - v_render->sync_report_time < AV_SYNC_STAT_REPORT_INTERVAL) {
+        return;
+    }
+    v_render->sync_report_time = cur;
+    // Offset is video minus audio presentation time, positive means video ahead
+    ESP_LOGI(TAG, "AV offset avg:%d min:%d max:%d <-80:%d <-40:%d <-20:%d in20:%d >20:%d >40:%d >80:%d",
+             (int)(stat->sum_offset / stat->total), (int)stat->min_offset, (int)stat->max_offset,
+             (int)stat->count[0], (int)stat->count[1], (int)stat->count[2], (int)stat->count[3],
+             (int)stat->count[4], (int)stat->count[5], (int)stat->count[6]);
+    memset(stat, 0, sizeof(av_render_sync_stat_t));
+}
+
 static int video_sync_control_before_render(av_render_t *render, uint32_t video_pts, bool *skip)
 {
     av_render_video_res_t *v_render = render->v_render_res;
@@ -547,6 +664,9 @@ static int video_sync_control_before_render(av_render_t *render, uint32_t video_
     if (v_render->sent_frame_num) {
         uint32_t video_cur_pts = 0;
         av_render_get_video_pts(render, &video_cur_pts);
+        if (render->cfg.sync_mode == AV_RENDER_SYNC_FOLLOW_AUDIO) {
+            av_sync_stat_add(v_render, (int32_t)(video_cur_pts - audio_pts));
+        }
         bool in_sync = false;
         for (int i = 0; i < 2; i++) {
             if (video_cur_pts < now + v_render->sync_tolerance && video_cur_pts + v_render->sync_tolerance > now) {
@@ -593,8 +713,35 @@ static int video_sync_control_before_render(av_render_t *render, uint32_t video_
     return 0;
 }
 
+static void audio_clock_update(av_render_audio_res_t *a_render, av_render_audio_frame_t *audio_frame)
+{
+    // Rendered data is in output format when resample is used
+    av_render_audio_frame_info_t *info = a_render->resample_handle ? &a_render->out_frame_info
+                                                                   : &a_render->audio_frame_info;
+    int sample_size = info->channel * info->bits_per_sample >> 3;
+    if (sample_size == 0 || info->sample_rate == 0) {
+        return;
+    }
+    // Clock anchors at end of written frame, time when audio_render_write returns
+    uint32_t duration = (uint32_t)((uint64_t)(audio_frame->size / sample_size) * 1000 / info->sample_rate);
+    a_render->audio_clock_pts = audio_frame->pts + duration;
+    a_render->audio_clock_time = get_cur_time();
+    a_render->audio_clock_valid = true;
+}
+
+static void audio_render_cancel_direct(av_render_t *render, bool direct)
+{
+    if (direct) {
+        av_render_audio_frame_t empty = { 0 };
+        audio_render_commit(render->cfg.audio_render, &empty);
+    }
+}
+
 static int _render_write_audio(av_render_thread_res_t *res, av_render_audio_frame_t *audio_frame)
 {
+    // Data already in render owned buffer, commit instead of write
+    bool direct = res->render->a_render_res->direct_commit;
+    res->render->a_render_res->direct_commit = false;
     if (res->render->a_render_res->audio_rendered == false) {
         if (res->render->event_cb) {
             res->render->event_cb(AV_RENDER_EVENT_AUDIO_RENDERED, res->render->event_ctx);
@@ -606,17 +753,25 @@ static int _render_write_audio(av_render_thread_res_t *res, av_render_audio_fram
         res->render->a_render_res->audio_rendered = true;
     }
     if (res->paused) {
+        audio_render_cancel_direct(res->render, direct);
         return 0;
     }
     // Update send pts
     res->render->a_render_res->audio_send_pts = audio_frame->pts;
     int ret = 0;
-    if (res->flushing == false) {
-        ret = audio_render_write(res->render->cfg.audio_render, audio_frame);
+    if (res->flushing) {
+        audio_render_cancel_direct(res->render, direct);
+    } else {
+        if (direct) {
+            ret = audio_render_commit(res->render->cfg.audio_render, audio_frame);
+        } else {
+            ret = audio_render_write(res->render->cfg.audio_render, audio_frame);
+        }
         if (ret != 0) {
             ESP_LOGE(TAG, "Fail to render audio ret %d", ret);
             return ret;
         }
+        audio_clock_update(res->render->a_render_res, audio_frame);
     }
     if (audio_frame->eos) {
         if (res->render->event_cb) {
@@ -679,11 +834,86 @@ static int _render_write_video(av_render_thread_res_t *res, av_render_video_fram
     return ret;
 }
 
+static int write_comfort_noise(av_render_audio_res_t *a_render, audio_render_handle_t audio_render)
+{
+    // Render is opened with output format when resampled
+    av_render_audio_frame_info_t *info = a_render->resample_handle ? &a_render->out_frame_info : &a_render->audio_frame_info;
+    if (info->bits_per_sample != 16 || info->channel == 0) {
+        return -1;
+    }
+    int frames = info->sample_rate * AUDIO_CN_FRAME_MS / 1000;
+    int size = frames * info->channel * sizeof(int16_t);
+    if (a_render->cn_buf_size < size) {
+        uint8_t *buf = (uint8_t *)media_lib_realloc(a_render->cn_buf, size);
+        if (buf == NULL) {
+            return -1;
+        }
+        a_render->cn_buf = buf;
+        a_render->cn_buf_size = size;
+    }
+    audio_plc_make_comfort_noise(&a_render->cn, (int16_t *)a_render->cn_buf, frames, info->channel);
+    av_render_audio_frame_t frame = {
+        .pts = a_render->audio_send_pts,
+        .data = a_render->cn_buf,
+        .size = size,
+    };
+    return audio_render_write(audio_render, &frame);
+}
+
+static bool a_render_fill_dtx(av_render_thread_res_t *res)
+{
+    av_render_audio_res_t *a_render = res->render->a_render_res;
+    if (a_render->plc == NULL || a_render->cn_allowed == false || res->flushing) {
+        return false;
+    }
+    if (data_queue_have_data(res->data_q)) {
+        a_render->underrun = false;
+        return false;
+    }
+    uint32_t cur = get_cur_time();
+    if (a_render->underrun == false) {
+        a_render->underrun = true;
+        a_render->underrun_time = cur;
+        a_render->cn_sent = 0;
+        // Shape noise after last decoded frame, DTX frames from sender carry the background noise
+        audio_plc_get_cn_shape(a_render->plc, &a_render->cn.level, &a_render->cn.coef);
+    }
+    uint32_t idle = cur - a_render->underrun_time;
+    if (a_render->cn.level == 0 || idle >= AUDIO_CN_START_TIME + AUDIO_CN_MAX_DURATION) {
+        // Block on queue till sender resumes
+        return false;
+    }
+    // Wait for audio till next noise frame is due, so that arriving frame is rendered at once
+    // Noise is paced with wall clock so that it never builds up latency
+    uint32_t wait_ms = 0;
+    if (idle < AUDIO_CN_START_TIME) {
+        wait_ms = AUDIO_CN_START_TIME - idle;
+    } else if (a_render->cn_sent > idle - AUDIO_CN_START_TIME) {
+        wait_ms = a_render->cn_sent - (idle - AUDIO_CN_START_TIME);
+    }
+    if (wait_ms) {
+        // Let reader report quit
+        return data_queue_wait_data_timeout(res->data_q, wait_ms) >= 0;
+    }
+    if (write_comfort_noise(a_render, res->render->cfg.audio_render) != 0) {
+        a_render->cn_allowed = false;
+        return false;
+    }
+    a_render->cn_sent += AUDIO_CN_FRAME_MS;
+    return true;
+}
+
 static int a_render_body(av_render_thread_res_t *res, bool drop)
 {
+    if (a_render_fill_dtx(res)) {
+        return 0;
+    }
     av_render_audio_frame_t data;
     int ret = read_for_a_render(res->data_q, &data);
     RETURN_ON_FAIL(ret);
+    res->render->a_render_res->underrun = false;
+    // Comfort noise only fills gaps inside a stream
+    res->render->a_render_res->cn_allowed = data.eos == false && drop == false;
     bool skip = false;
     if (data.size) {
         int q_num = 0, q_size = 0;
@@ -709,6 +939,15 @@ static int v_render_body(av_render_thread_res_t *res, bool drop)
     av_render_video_frame_t data;
     int ret = read_for_v_render(res->data_q, &data);
     RETURN_ON_FAIL(ret);
+    if (res->render->cfg.video_latest_frame && drop == false && data.eos == false && data.size && res->paused == false) {
+        int q_num = 0, q_size = 0;
+        data_queue_query(res->data_q, &q_num, &q_size);
+        // Newer frame already decoded, show it instead
+        if (q_num >= 2) {
+            res->render->v_render_res->render_skip_num++;
+            drop = true;
+        }
+    }
     if (drop == false && (data.size || data.eos)) {
         av_render_vdec_res_t *vdec_res = res->render->vdec_res;
         if (vdec_res && vdec_res->vid_convert) {
@@ -913,22 +1152,68 @@ static bool video_need_render_in_sync(av_render_t *render)
     return false;
 }
 
+static uint8_t *audio_render_get_out_buffer(int size, void *ctx)
+{
+    av_render_audio_res_t *a_render = (av_render_audio_res_t *)ctx;
+    uint8_t *b = NULL;
+    if (a_render->audio_packet_reached == false) {
+        return NULL;
+    }
+    if (a_render->thread_res.thread) {
+        // Reserve render queue item so that resample output lands in queue without copy
+        int head_size = sizeof(av_render_audio_frame_t);
+        b = (uint8_t *)data_queue_get_buffer(a_render->thread_res.data_q, head_size + size);
+        if (b) {
+            b += head_size;
+        }
+    } else if (audio_render_get_buffer(a_render->thread_res.render->cfg.audio_render, size, &b) != 0) {
+        b = NULL;
+    }
+    a_render->direct_buf = b;
+    return b;
+}
+
+static int commit_to_a_render(data_queue_t *q, av_render_audio_frame_t *data)
+{
+    int head_size = sizeof(av_render_audio_frame_t);
+    uint8_t *b = data->data - head_size;
+    memcpy(b, data, head_size);
+    return data_queue_send_buffer(q, head_size + data->size);
+}
+
 int audio_render_frame_reached(av_render_audio_frame_t *frame, void *ctx)
 {
     av_render_audio_res_t *a_render = (av_render_audio_res_t *)ctx;
     int ret = -1;
+    bool direct = (frame->data && frame->data == a_render->direct_buf);
+    a_render->direct_buf = NULL;
     dump_data(AV_RENDER_DUMP_ARENDER_DATA, frame->data, frame->size);
     if (a_render->audio_packet_reached) {
         // Write to audio render queue or write to audio render directly
         if (a_render->thread_res.thread) {
-            ret = put_to_a_render(a_render->thread_res.data_q, frame);
+            if (direct) {
+                ret = commit_to_a_render(a_render->thread_res.data_q, frame);
+            } else {
+                ret = put_to_a_render(a_render->thread_res.data_q, frame);
+            }
         } else {
+            a_render->direct_commit = direct;
             ret = _render_write_audio(&a_render->thread_res, frame);
         }
     }
     return ret;
 }
 
+static int audio_frame_output(av_render_audio_frame_t *frame, void *ctx)
+{
+    av_render_audio_res_t *a_render = (av_render_audio_res_t *)ctx;
+    if (a_render->resample_handle) {
+        // write to resample
+        return audio_resample_write(a_render->resample_handle, frame);
+    }
+    return audio_render_frame_reached(frame, a_render);
+}
+
 static int av_render_audio_frame_reached(av_render_audio_frame_t *frame, void *ctx)
 {
     av_render_t *render = (av_render_t *)ctx;
@@ -961,6 +1246,7 @@ static int av_render_audio_frame_reached(av_render_audio_frame_t *frame, void *c
                 .input_info = a_render->audio_frame_info,
                 .output_info = a_render->out_frame_info,
                 .resample_cb = audio_render_frame_reached,
+                .get_buffer = audio_render_get_out_buffer,
                 .ctx = a_render,
             };
             a_render->resample_handle = audio_resample_open(&resample_cfg);
@@ -979,6 +1265,14 @@ static int av_render_audio_frame_reached(av_render_audio_frame_t *frame, void *c
             ESP_LOGE(TAG, "Fail to create audio render");
             return ret;
         }
+        if (a_render->plc) {
+            audio_plc_close(a_render->plc);
+            a_render->plc = NULL;
+        }
+        // Decoded stream may lose packets, PCM input is trusted
+        if (render->cfg.enable_plc && a_render->audio_is_pcm == false) {
+            a_render->plc = audio_plc_open(&a_render->audio_frame_info);
+        }
         a_render->audio_packet_reached = true;
         a_render->a_render_in_sync = true;
         a_render->thread_res.render = render;
@@ -992,11 +1286,10 @@ static int av_render_audio_frame_reached(av_render_audio_frame_t *frame, void *c
             }
         }
     }
-    if (a_render->resample_handle) {
-        // write to resample
-        ret = audio_resample_write(a_render->resample_handle, frame);
+    if (a_render->plc) {
+        ret = audio_plc_process(a_render->plc, frame, audio_frame_output, a_render);
     } else {
-        ret = audio_render_frame_reached(frame, a_render);
+        ret = audio_frame_output(frame, a_render);
     }
     return ret;
 }
@@ -1113,7 +1406,8 @@ static int av_render_video_frame_reached(av_render_video_frame_t *frame, void *c
         // Tolerance for 3 frame later
         v_render->sync_tolerance = 600;
         v_render->thread_res.render = render;
-        if (v_render->use_fb == false && video_need_render_in_sync(render) == false && v_render->thread_res.thread == NULL) {
+        if (v_render->use_fb == false && v_render->render_fb == false && video_need_render_in_sync(render) == false &&
+            v_render->thread_res.thread == NULL) {
             ret = create_thread_res(&v_render->thread_res, "VRender", v_render_body, render->cfg.video_render_fifo_size,
                                     V_RENDER_CLOSED_BITS);
             if (ret != 0) {
@@ -1276,6 +1570,7 @@ int av_render_add_audio_stream(av_render_handle_t h, av_render_audio_info_t *aud
         }
         // Clear frame number
         a_render->audio_packet_reached = false;
+        a_render->audio_clock_valid = false;
         a_render->audio_rendered = false;
         // Create new decoder if needed
         a_render->audio_is_pcm = (audio_info->codec == AV_RENDER_AUDIO_CODEC_PCM);
@@ -1420,6 +1715,12 @@ int av_render_add_video_stream(av_render_handle_t h, av_render_video_info_t *vid
         av_render_video_res_t *v_render = render->v_render_res;
         // TODO here force to use fetch decode output data
         v_render->use_fb = true;
+        // Render owns frame buffers, decode into them and render in decoder thread without copy
+        av_render_frame_buffer_t render_fb = { 0 };
+        v_render->render_fb = (video_render_get_frame_buffer(render->cfg.video_render, &render_fb) == 0);
+        if (v_render->render_fb) {
+            v_render->use_fb = false;
+        }
         // Close old decoder
         if (render->vdec_res) {
             av_render_vdec_res_t *vdec_res = render->vdec_res;
@@ -1458,6 +1759,7 @@ int av_render_add_video_stream(av_render_handle_t h, av_render_video_info_t *vid
                 }
             }
             av_render_vdec_res_t *vdec_res = render->vdec_res;
+            vdec_res->codec = video_info->codec;
             vdec_cfg_t cfg = {
                 .video_info = *video_info,
                 .frame_cb = av_render_video_frame_reached,
@@ -1613,6 +1915,9 @@ int av_render_add_video_data(av_render_handle_t h, av_render_video_data_t *video
         av_render_vdec_res_t *vdec = render->vdec_res;
         // If decode async send to decode queue
         if (vdec->thread_res.thread) {
+            if (video_data->eos == false) {
+                vdec->in_pts = video_data->pts;
+            }
             media_lib_mutex_unlock(render->api_lock);
             ret = put_to_vdec(vdec->thread_res.data_q, video_data, vdec->thread_res.use_pool);
             if (ret != 0) {
@@ -1740,6 +2045,24 @@ int av_render_get_video_fifo_level(av_render_handle_t h, av_render_fifo_stat_t *
     return 0;
 }
 
+int av_render_get_video_drop_stat(av_render_handle_t h, av_render_video_drop_stat_t *stat)
+{
+    av_render_t *render = (av_render_t *)h;
+    if (render == NULL || stat == NULL) {
+        return ESP_MEDIA_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(render->api_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    memset(stat, 0, sizeof(av_render_video_drop_stat_t));
+    if (render->v_render_res) {
+        stat->render_skipped = render->v_render_res->render_skip_num;
+    }
+    if (render->vdec_res) {
+        stat->decode_skipped = render->vdec_res->decode_skip_num;
+    }
+    media_lib_mutex_unlock(render->api_lock);
+    return ESP_MEDIA_ERR_OK;
+}
+
 int render_pause(av_render_t *render, bool pause)
 {
     av_render_msg_t msg = {
@@ -1829,6 +2152,9 @@ static int render_flush(av_render_t *render)
     }
     if (render->a_render_res) {
         render->a_render_res->audio_rendered = false;
+        render->a_render_res->audio_clock_valid = false;
+        render->a_render_res->cn_allowed = false;
+        audio_plc_reset(render->a_render_res->plc);
     }
     return 0;
 }
@@ -1892,11 +2218,17 @@ static int av_render_get_audio_pts(av_render_t *render, uint32_t *out_pts)
     if (a_render && a_render->audio_packet_reached) {
         uint32_t audio_pts = a_render->audio_send_pts;
         uint32_t latency = 0;
-        int ret = audio_render_get_latency(render->cfg.audio_render, &latency);
-        if (ret == 0) {
-            if (audio_pts >= latency) {
-                audio_pts -= latency;
-            }
+        if (audio_render_get_latency(render->cfg.audio_render, &latency) != 0) {
+            latency = 0;
+        }
+        if (a_render->audio_clock_valid) {
+            // Interpolate from last write, presentation can not run ahead of written data
+            uint32_t elapse = get_cur_time() - a_render->audio_clock_time;
+            audio_pts = a_render->audio_clock_pts;
+            latency = elapse > latency ? 0 : latency - elapse;
+        }
+        if (audio_pts >= latency) {
+            audio_pts -= latency;
         }
         *out_pts = audio_pts;
         return 0;
@@ -1969,8 +2301,9 @@ int av_render_query(av_render_handle_t h)
             data_queue_query(q, &q_num, &q_size);
         }
         ESP_LOGI(TAG, "Video decoder fifo size %d items %d err:%d", q_size, q_num, render->vdec_res->video_err_cnt);
-        ESP_LOGI(TAG, "Video decoder status flashing: %d paused: %d",
-                 render->vdec_res->thread_res.flushing, render->vdec_res->thread_res.paused);
+        ESP_LOGI(TAG, "Video decoder status flashing: %d paused: %d skipped: %" PRIu32,
+                 render->vdec_res->thread_res.flushing, render->vdec_res->thread_res.paused,
+                 render->vdec_res->decode_skip_num);
     }
     if (render->v_render_res) {
         data_queue_t *q = render->v_render_res->thread_res.data_q;
@@ -1981,7 +2314,8 @@ int av_render_query(av_render_handle_t h)
         ESP_LOGI(TAG, "Video render fifo size %d items %d", q_size, q_num);
         ESP_LOGI(TAG, "Video render status flashing: %d paused: %d",
                  render->v_render_res->thread_res.flushing, render->v_render_res->thread_res.paused);
-        ESP_LOGI(TAG, "Video render pts %" PRIu32, render->v_render_res->video_send_pts);
+        ESP_LOGI(TAG, "Video render pts %" PRIu32 " skipped %" PRIu32, render->v_render_res->video_send_pts,
+                 render->v_render_res->render_skip_num);
     }
     media_lib_mutex_unlock(render->api_lock);
     return 0;
@@ -1996,6 +2330,18 @@ void av_render_dump(av_render_handle_t h, uint8_t mask)
     }
 }
 
+int av_render_get_audio_clock(av_render_handle_t h, uint32_t *out_pts)
+{
+    av_render_t *render = (av_render_t *)h;
+    if (render == NULL || out_pts == NULL) {
+        return ESP_MEDIA_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(render->api_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    int ret = av_render_get_audio_pts(render, out_pts);
+    media_lib_mutex_unlock(render->api_lock);
+    return ret == 0 ? ESP_MEDIA_ERR_OK : ESP_MEDIA_ERR_NOT_SUPPORT;
+}
+
 int av_render_get_render_pts(av_render_handle_t h, uint32_t *out_pts)
 {
     av_render_t *render = (av_render_t *)h;
@@ -2101,6 +2447,13 @@ int av_render_reset(av_render_handle_t h)
             audio_resample_close(render->a_render_res->resample_handle);
             render->a_render_res->resample_handle = NULL;
         }
+        if (render->a_render_res->plc) {
+            audio_plc_close(render->a_render_res->plc);
+            render->a_render_res->plc = NULL;
+        }
+        if (render->a_render_res->cn_buf) {
+            media_lib_free(render->a_render_res->cn_buf);
+        }
         media_lib_free(render->a_render_res);
         render->a_render_res = NULL;
     }
@@ -114,7 +114,7 @@ int video_render_get_frame_buffer(video_render_handle_t render, av_render_frame_
     if (buffer == NULL || v_render == NULL) {
         return -1;
     }
-    if (v_render->render_ops.get_frame_info == NULL) {
+    if (v_render->render_ops.get_frame_buffer == NULL) {
         return ESP_MEDIA_ERR_NOT_SUPPORT;
     }
     return v_render->render_ops.get_frame_buffer(v_render->render_handle, buffer);
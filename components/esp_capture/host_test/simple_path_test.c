@@ -0,0 +1,415 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_capture_path_simple.h"
+#include "esp_timer.h"
+#include "media_lib_adapter.h"
+
+#define SRC_WIDTH      (320)
+#define SRC_HEIGHT     (240)
+#define SRC_FPS        (30)
+#define SRC_FRAMES     (90)
+#define LOW_WIDTH      (160)
+#define LOW_HEIGHT     (120)
+#define LOW_FPS        (15)
+#define FRAME_INTERVAL (1000 / SRC_FPS)
+// Primary frames around which user does not return secondary frames
+#define HOLD_START     (40)
+#define HOLD_END       (60)
+#define MAX_HELD       (8)
+#define KEY_REQ_FRAME  (20)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+// Encoded frame of fake encoder
+typedef struct {
+    uint8_t  key_frame;
+    uint16_t width;
+    uint16_t height;
+    uint32_t pts;
+} test_frame_t;
+
+typedef struct {
+    esp_capture_venc_if_t    base;
+    esp_capture_video_info_t info;
+    int                      starts;
+    int                      bitrate;
+    bool                     started;
+    bool                     key_pending;
+} test_venc_t;
+
+typedef struct {
+    int                        frames;
+    int                        key_frames;
+    bool                       stopped;
+    uint32_t                   last_pts;
+    esp_capture_stream_frame_t held[MAX_HELD];
+    int                        held_num;
+    int                        max_held;
+} test_sink_t;
+
+static esp_capture_path_if_t *path;
+static uint8_t               *src_frame;
+static int                    src_seq;
+static test_venc_t            primary_venc;
+static test_venc_t            secondary_venc;
+static test_sink_t            sinks[2];
+static volatile bool          all_stopped;
+static int                    error_events;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Packed YUV420 as host video encoder input: lines alternate U Y Y and V Y Y for each 2 pixels
+static uint8_t src_luma(int x, int y)
+{
+    return (uint8_t)(x * 7 + y * 13);
+}
+
+static uint8_t src_chroma(int group, int y)
+{
+    return (uint8_t)((y & 1 ? 0xC0 : 0x40) | (group & 0x3F));
+}
+
+static void fill_source(uint8_t *data)
+{
+    for (int y = 0; y < SRC_HEIGHT; y++) {
+        for (int x = 0; x < SRC_WIDTH; x += 2) {
+            data[0] = src_chroma(x / 2, y);
+            data[1] = src_luma(x, y);
+            data[2] = src_luma(x + 1, y);
+            data += 3;
+        }
+    }
+}
+
+static void verify_scaled(uint8_t *data, int width, int height)
+{
+    // Half size nearest neighbor keeps line parity so that U and V lines stay in place
+    for (int y = 0; y < height; y++) {
+        int sy = ((y * SRC_HEIGHT / height) & ~1) | (y & 1);
+        for (int x = 0; x < width; x += 2) {
+            int sx = x * SRC_WIDTH / width;
+            CHECK(data[0] == src_chroma(sx / 2, sy), "chroma mismatch at %d,%d", x, y);
+            CHECK(data[1] == src_luma(sx, sy), "luma mismatch at %d,%d", x, y);
+            CHECK(data[2] == src_luma((x + 1) * SRC_WIDTH / width, sy), "luma mismatch at %d,%d", x + 1, y);
+            data += 3;
+        }
+    }
+}
+
+static int venc_get_support_codecs(esp_capture_venc_if_t *h, const esp_capture_codec_type_t **codecs, uint8_t *num)
+{
+    static esp_capture_codec_type_t vcodecs[] = {
+        ESP_CAPTURE_CODEC_TYPE_H264,
+    };
+    *codecs = vcodecs;
+    *num = 1;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int venc_get_input_codecs(esp_capture_venc_if_t *h, esp_capture_codec_type_t out_codec,
+                                 const esp_capture_codec_type_t **codecs, uint8_t *num)
+{
+    static esp_capture_codec_type_t inputs[] = {
+        ESP_CAPTURE_CODEC_TYPE_YUV420,
+    };
+    *codecs = out_codec == ESP_CAPTURE_CODEC_TYPE_H264 ? inputs : NULL;
+    *num = out_codec == ESP_CAPTURE_CODEC_TYPE_H264 ? 1 : 0;
+    return *num ? ESP_CAPTURE_ERR_OK : ESP_CAPTURE_ERR_NOT_SUPPORTED;
+}
+
+static int venc_start(esp_capture_venc_if_t *h, esp_capture_codec_type_t src_codec, esp_capture_video_info_t *info)
+{
+    test_venc_t *venc = (test_venc_t *)h;
+    CHECK(src_codec == ESP_CAPTURE_CODEC_TYPE_YUV420, "unexpected source codec %d", src_codec);
+    CHECK(venc->started == false, "encoder started twice");
+    venc->info = *info;
+    venc->started = true;
+    venc->key_pending = true;
+    venc->starts++;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int venc_get_frame_size(esp_capture_venc_if_t *h, int *in_frame_size, int *out_frame_size)
+{
+    test_venc_t *venc = (test_venc_t *)h;
+    *in_frame_size = venc->info.width * venc->info.height * 3 / 2;
+    *out_frame_size = 256;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int venc_set_bitrate(esp_capture_venc_if_t *h, int bitrate)
+{
+    ((test_venc_t *)h)->bitrate = bitrate;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int venc_encode_frame(esp_capture_venc_if_t *h, esp_capture_stream_frame_t *raw, esp_capture_stream_frame_t *encoded)
+{
+    test_venc_t *venc = (test_venc_t *)h;
+    CHECK(venc->started, "encode before start");
+    CHECK(raw->size == (int)(venc->info.width * venc->info.height * 3 / 2), "input size %d for %dx%d", raw->size,
+          (int)venc->info.width, (int)venc->info.height);
+    if (venc == &secondary_venc) {
+        verify_scaled(raw->data, venc->info.width, venc->info.height);
+    } else {
+        CHECK(raw->data == src_frame, "primary not fed with source frame");
+    }
+    test_frame_t info = {
+        .key_frame = venc->key_pending,
+        .width = venc->info.width,
+        .height = venc->info.height,
+        .pts = raw->pts,
+    };
+    venc->key_pending = false;
+    memcpy(encoded->data, &info, sizeof(info));
+    encoded->size = sizeof(info);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int venc_stop(esp_capture_venc_if_t *h)
+{
+    ((test_venc_t *)h)->started = false;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static void init_venc(test_venc_t *venc)
+{
+    memset(venc, 0, sizeof(test_venc_t));
+    venc->base.get_support_codecs = venc_get_support_codecs;
+    venc->base.get_input_codecs = venc_get_input_codecs;
+    venc->base.start = venc_start;
+    venc->base.get_frame_size = venc_get_frame_size;
+    venc->base.set_bitrate = venc_set_bitrate;
+    venc->base.encode_frame = venc_encode_frame;
+    venc->base.stop = venc_stop;
+}
+
+static int src_acquire(void *src, esp_capture_stream_frame_t *frame, bool no_wait)
+{
+    if (src_seq == SRC_FRAMES) {
+        // Stop frame
+        frame->data = NULL;
+        frame->size = 0;
+        return ESP_CAPTURE_ERR_OK;
+    }
+    frame->pts = src_seq * FRAME_INTERVAL;
+    frame->data = src_frame;
+    frame->size = SRC_WIDTH * SRC_HEIGHT * 3 / 2;
+    src_seq++;
+    usleep(1000);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int src_release(void *src, esp_capture_stream_frame_t *frame)
+{
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int src_nego_video(void *src, esp_capture_video_info_t *in_cap, esp_capture_video_info_t *out_caps)
+{
+    // Raw camera only
+    if (in_cap->codec != ESP_CAPTURE_CODEC_TYPE_YUV420) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    *out_caps = *in_cap;
+    out_caps->width = SRC_WIDTH;
+    out_caps->height = SRC_HEIGHT;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int frame_processed(void *src, esp_capture_path_type_t sel, esp_capture_stream_frame_t *frame)
+{
+    CHECK(frame->stream_type == ESP_CAPTURE_STREAM_TYPE_VIDEO, "unexpected stream %d", frame->stream_type);
+    CHECK(sel == ESP_CAPTURE_PATH_PRIMARY || sel == ESP_CAPTURE_PATH_SECONDARY, "unexpected path %d", sel);
+    test_sink_t *sink = &sinks[sel];
+    if (frame->size == 0) {
+        sink->stopped = true;
+        path->return_frame(path, sel, frame);
+        all_stopped = sinks[0].stopped && sinks[1].stopped;
+        return ESP_CAPTURE_ERR_OK;
+    }
+    test_frame_t info;
+    CHECK(frame->size == sizeof(info), "unexpected frame size %d", frame->size);
+    memcpy(&info, frame->data, sizeof(info));
+    if (sink->frames) {
+        CHECK(info.pts > sink->last_pts, "path %d pts %d after %d", sel, (int)info.pts, (int)sink->last_pts);
+    } else {
+        CHECK(info.key_frame, "path %d started from non key frame", sel);
+    }
+    if (sel == ESP_CAPTURE_PATH_PRIMARY) {
+        CHECK(info.width == SRC_WIDTH && info.height == SRC_HEIGHT, "primary %dx%d", info.width, info.height);
+    } else {
+        CHECK(info.width == LOW_WIDTH && info.height == LOW_HEIGHT, "secondary %dx%d", info.width, info.height);
+    }
+    sink->last_pts = info.pts;
+    sink->frames++;
+    sink->key_frames += info.key_frame;
+    int seq = info.pts / FRAME_INTERVAL;
+    if (sel == ESP_CAPTURE_PATH_SECONDARY && seq >= HOLD_START && seq < HOLD_END) {
+        // Slow secondary user keeps frames, primary must not be blocked by it
+        CHECK(sink->held_num < MAX_HELD, "too many secondary frames held");
+        sink->held[sink->held_num++] = *frame;
+        if (sink->held_num > sink->max_held) {
+            sink->max_held = sink->held_num;
+        }
+        return ESP_CAPTURE_ERR_OK;
+    }
+    path->return_frame(path, sel, frame);
+    if (sel == ESP_CAPTURE_PATH_PRIMARY) {
+        if (seq == KEY_REQ_FRAME) {
+            CHECK(path->set(path, ESP_CAPTURE_PATH_SECONDARY, ESP_CAPTURE_PATH_SET_TYPE_KEY_FRAME, NULL, 0) == ESP_CAPTURE_ERR_OK,
+                  "request secondary key frame");
+        }
+        if (seq == HOLD_END) {
+            test_sink_t *low = &sinks[ESP_CAPTURE_PATH_SECONDARY];
+            for (int i = 0; i < low->held_num; i++) {
+                path->return_frame(path, ESP_CAPTURE_PATH_SECONDARY, &low->held[i]);
+            }
+            low->held_num = 0;
+        }
+    }
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int event_cb(void *src, esp_capture_path_type_t sel, esp_capture_path_event_type_t event)
+{
+    printf("Path %d event %d\n", sel, event);
+    error_events++;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static esp_capture_path_if_t *open_path(bool with_secondary)
+{
+    init_venc(&primary_venc);
+    init_venc(&secondary_venc);
+    esp_capture_simple_path_cfg_t simple_cfg = {
+        .venc = &primary_venc.base,
+        .venc_frame_count = 8,
+        .secondary_venc = with_secondary ? &secondary_venc.base : NULL,
+    };
+    esp_capture_path_if_t *p = esp_capture_build_simple_path(&simple_cfg);
+    CHECK(p, "build simple path");
+    esp_capture_path_cfg_t cfg = {
+        .acquire_src_frame = src_acquire,
+        .release_src_frame = src_release,
+        .nego_video = src_nego_video,
+        .frame_processed = frame_processed,
+        .event_cb = event_cb,
+    };
+    CHECK(p->open(p, &cfg) == ESP_CAPTURE_ERR_OK, "open simple path");
+    esp_capture_sink_cfg_t sink = {
+        .video_info = {
+            .codec = ESP_CAPTURE_CODEC_TYPE_H264,
+            .width = SRC_WIDTH,
+            .height = SRC_HEIGHT,
+            .fps = SRC_FPS,
+        },
+    };
+    CHECK(p->add_path(p, ESP_CAPTURE_PATH_PRIMARY, &sink) == ESP_CAPTURE_ERR_OK, "add primary");
+    return p;
+}
+
+static int add_secondary(esp_capture_path_if_t *p, int width, int height)
+{
+    esp_capture_sink_cfg_t sink = {
+        .video_info = {
+            .codec = ESP_CAPTURE_CODEC_TYPE_H264,
+            .width = width,
+            .height = height,
+            .fps = LOW_FPS,
+        },
+    };
+    return p->add_path(p, ESP_CAPTURE_PATH_SECONDARY, &sink);
+}
+
+int main(int argc, char *argv[])
+{
+    media_lib_add_default_os_adapter();
+    src_frame = malloc(SRC_WIDTH * SRC_HEIGHT * 3 / 2);
+    fill_source(src_frame);
+
+    // Without secondary encoder only primary path exists
+    path = open_path(false);
+    CHECK(add_secondary(path, LOW_WIDTH, LOW_HEIGHT) == ESP_CAPTURE_ERR_NOT_SUPPORTED, "secondary without encoder");
+    path->close(path);
+    free(path);
+
+    path = open_path(true);
+    CHECK(add_secondary(path, LOW_WIDTH + 1, LOW_HEIGHT) == ESP_CAPTURE_ERR_NOT_SUPPORTED, "odd width accepted");
+    CHECK(add_secondary(path, SRC_WIDTH * 2, SRC_HEIGHT) == ESP_CAPTURE_ERR_NOT_SUPPORTED, "upscale accepted");
+    CHECK(add_secondary(path, LOW_WIDTH, LOW_HEIGHT) == ESP_CAPTURE_ERR_OK, "add secondary");
+    CHECK(path->enable_path(path, ESP_CAPTURE_PATH_PRIMARY, true) == ESP_CAPTURE_ERR_OK, "enable primary");
+    CHECK(path->enable_path(path, ESP_CAPTURE_PATH_SECONDARY, true) == ESP_CAPTURE_ERR_OK, "enable secondary");
+    int bitrate = 200000;
+    CHECK(path->set(path, ESP_CAPTURE_PATH_SECONDARY, ESP_CAPTURE_PATH_SET_TYPE_VIDEO_BITRATE, &bitrate, sizeof(int)) == ESP_CAPTURE_ERR_OK,
+          "set secondary bitrate");
+    CHECK(path->start(path) == ESP_CAPTURE_ERR_OK, "start");
+    // Called once for each path by capture
+    CHECK(path->start(path) == ESP_CAPTURE_ERR_OK, "start again");
+
+    int64_t start = esp_timer_get_time();
+    while (all_stopped == false) {
+        CHECK(esp_timer_get_time() - start < 5000000, "stop frame not reached on all paths");
+        usleep(1000);
+    }
+    path->stop(path);
+    path->close(path);
+    free(path);
+
+    test_sink_t *high = &sinks[ESP_CAPTURE_PATH_PRIMARY];
+    test_sink_t *low = &sinks[ESP_CAPTURE_PATH_SECONDARY];
+    printf("Primary %d frames, secondary %d frames %d key frames, at most %d held\n", high->frames, low->frames,
+           low->key_frames, low->max_held);
+    CHECK(high->frames == SRC_FRAMES, "primary lost frames %d", high->frames);
+    CHECK(primary_venc.starts == 1 && high->key_frames == 1, "primary restarted by secondary key request");
+    CHECK(secondary_venc.starts == 2 && low->key_frames == 2, "secondary key request not served");
+    CHECK(secondary_venc.bitrate == bitrate && primary_venc.bitrate == 0, "bitrate set on wrong encoder");
+    CHECK(low->max_held == 3, "slow secondary user held %d frames", low->max_held);
+    // Half fps, minus frames skipped while user held secondary frames
+    int expect = SRC_FRAMES * LOW_FPS / SRC_FPS;
+    CHECK(low->frames < expect && low->frames >= expect - (HOLD_END - HOLD_START) / 2, "secondary got %d frames", low->frames);
+    CHECK(error_events == 0, "unexpected error events");
+    CHECK(primary_venc.started == false && secondary_venc.started == false, "encoder not stopped");
+    free(src_frame);
+    printf("Simple path test passed\n");
+    return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <jpeglib.h>
+#include "esp_capture_video_enc.h"
+#include "media_lib_adapter.h"
+#include "esp_video_enc.h"
+
+#define VIDEO_WIDTH   (1280)
+#define VIDEO_HEIGHT  (720)
+#define VIDEO_FPS     (15)
+// 2 bits per pixel
+#define VIDEO_BITRATE (VIDEO_WIDTH * VIDEO_HEIGHT * VIDEO_FPS * 2)
+#define MIN_PSNR      (25.0)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef struct {
+    esp_capture_venc_if_t *enc;
+    uint8_t               *out;
+    int                    out_size;
+} test_enc_t;
+
+static uint8_t raw_rgb565[VIDEO_WIDTH * VIDEO_HEIGHT * 2];
+static uint8_t decoded[VIDEO_WIDTH * VIDEO_HEIGHT * 3];
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fill_frame(int frame)
+{
+    // Gradient with moving texture, not too flat so entropy coding costs real time
+    uint8_t *p = raw_rgb565;
+    for (int y = 0; y < VIDEO_HEIGHT; y++) {
+        for (int x = 0; x < VIDEO_WIDTH; x++) {
+            int r = x * 255 / VIDEO_WIDTH;
+            int g = y * 255 / VIDEO_HEIGHT;
+            int b = (((x + frame * 4) ^ y) & 0x3F) * 4;
+            uint16_t pixel = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+            *(p++) = pixel & 0xFF;
+            *(p++) = pixel >> 8;
+        }
+    }
+}
+
+static void get_source_rgb(int x, int y, int *rgb)
+{
+    uint8_t *p = raw_rgb565 + (y * VIDEO_WIDTH + x) * 2;
+    uint16_t pixel = p[0] | (p[1] << 8);
+    rgb[0] = (pixel >> 8) & 0xF8;
+    rgb[1] = (pixel >> 3) & 0xFC;
+    rgb[2] = (pixel << 3) & 0xF8;
+}
+
+static double decode_psnr(uint8_t *jpeg, int size)
+{
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, jpeg, size);
+    CHECK(jpeg_read_header(&cinfo, TRUE) == JPEG_HEADER_OK, "bad jpeg header");
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    CHECK(cinfo.output_width == VIDEO_WIDTH && cinfo.output_height == VIDEO_HEIGHT, "decoded %dx%d",
+          (int)cinfo.output_width, (int)cinfo.output_height);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = decoded + cinfo.output_scanline * VIDEO_WIDTH * 3;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    CHECK(jerr.num_warnings == 0, "decoder warnings %d (corrupt scan data)", (int)jerr.num_warnings);
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    double err = 0;
+    for (int y = 0; y < VIDEO_HEIGHT; y++) {
+        for (int x = 0; x < VIDEO_WIDTH; x++) {
+            int rgb[3];
+            get_source_rgb(x, y, rgb);
+            uint8_t *d = decoded + (y * VIDEO_WIDTH + x) * 3;
+            for (int i = 0; i < 3; i++) {
+                err += (double)(d[i] - rgb[i]) * (d[i] - rgb[i]);
+            }
+        }
+    }
+    err /= (double)VIDEO_WIDTH * VIDEO_HEIGHT * 3;
+    return err == 0 ? 99.0 : 10 * log10(255.0 * 255.0 / err);
+}
+
+static bool has_restart_interval(uint8_t *jpeg, int size)
+{
+    for (int i = 0; i + 1 < size; i++) {
+        if (jpeg[i] == 0xFF && jpeg[i + 1] == 0xDD) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void open_encoder(test_enc_t *t, int strip_num)
+{
+    if (strip_num) {
+        esp_capture_video_strip_enc_cfg_t cfg = { .strip_num = strip_num };
+        t->enc = esp_capture_new_video_strip_encoder(&cfg);
+    } else {
+        t->enc = esp_capture_new_video_encoder();
+    }
+    CHECK(t->enc, "create encoder");
+    esp_capture_video_info_t info = {
+        .codec = ESP_CAPTURE_CODEC_TYPE_MJPEG,
+        .width = VIDEO_WIDTH,
+        .height = VIDEO_HEIGHT,
+        .fps = VIDEO_FPS,
+        .bitrate = VIDEO_BITRATE,
+    };
+    CHECK(t->enc->start(t->enc, ESP_CAPTURE_CODEC_TYPE_RGB565, &info) == ESP_CAPTURE_ERR_OK, "start encoder");
+    int in_size = 0;
+    CHECK(t->enc->get_frame_size(t->enc, &in_size, &t->out_size) == ESP_CAPTURE_ERR_OK, "get frame size");
+    t->out = malloc(t->out_size);
+}
+
+static int encode(test_enc_t *t, int frame)
+{
+    esp_capture_stream_frame_t raw = {
+        .pts = frame * 1000 / VIDEO_FPS,
+        .data = raw_rgb565,
+        .size = sizeof(raw_rgb565),
+    };
+    while (1) {
+        esp_capture_stream_frame_t encoded = {
+            .data = t->out,
+            .size = t->out_size,
+        };
+        int ret = t->enc->encode_frame(t->enc, &raw, &encoded);
+        if (ret == ESP_CAPTURE_ERR_NOT_ENOUGH) {
+            // Grow output like capture path does
+            t->out_size *= 2;
+            t->out = realloc(t->out, t->out_size);
+            continue;
+        }
+        CHECK(ret == ESP_CAPTURE_ERR_OK, "encode frame %d ret %d", frame, ret);
+        CHECK(encoded.pts == raw.pts, "pts mismatch");
+        return encoded.size;
+    }
+}
+
+static void close_encoder(test_enc_t *t, int strip_num)
+{
+    t->enc->stop(t->enc);
+    if (strip_num) {
+        esp_capture_free_video_strip_encoder(t->enc);
+    } else {
+        free(t->enc);
+    }
+    free(t->out);
+}
+
+static void check_stitched(int strip_num)
+{
+    test_enc_t general = {}, strip = {};
+    open_encoder(&general, 0);
+    open_encoder(&strip, strip_num);
+    for (int frame = 0; frame < 3; frame++) {
+        fill_frame(frame);
+        int general_size = encode(&general, frame);
+        double general_psnr = decode_psnr(general.out, general_size);
+        int strip_size = encode(&strip, frame);
+        double strip_psnr = decode_psnr(strip.out, strip_size);
+        CHECK(has_restart_interval(strip.out, strip_size), "%d strips not stitched", strip_num);
+        // Tables shared so stitched image has same quality as single encoder
+        CHECK(strip_psnr >= MIN_PSNR && fabs(strip_psnr - general_psnr) < 0.5,
+              "%d strips PSNR %.2f general %.2f", strip_num, strip_psnr, general_psnr);
+        if (frame == 0) {
+            printf("%d strips: size %d PSNR %.2f, general: size %d PSNR %.2f\n", strip_num, strip_size, strip_psnr,
+                   general_size, general_psnr);
+        }
+    }
+    // Bitrate change keeps tables same across strips
+    CHECK(strip.enc->set_bitrate(strip.enc, VIDEO_BITRATE / 2) == ESP_CAPTURE_ERR_OK, "set bitrate");
+    int size = encode(&strip, 3);
+    CHECK(has_restart_interval(strip.out, size), "not stitched after bitrate change");
+    CHECK(decode_psnr(strip.out, size) >= MIN_PSNR - 5, "low PSNR after bitrate change");
+    close_encoder(&general, 0);
+    close_encoder(&strip, strip_num);
+}
+
+static void check_table_mismatch(void)
+{
+    // Encoders pick own quality, strips must not be stitched with tables of strip 0
+    esp_video_enc_host_rc_jitter = 1;
+    test_enc_t strip = {};
+    open_encoder(&strip, 4);
+    for (int frame = 0; frame < 2; frame++) {
+        fill_frame(frame);
+        int size = encode(&strip, frame);
+        CHECK(has_restart_interval(strip.out, size) == false, "stitched strips with different tables");
+        double psnr = decode_psnr(strip.out, size);
+        CHECK(psnr >= MIN_PSNR, "fallback PSNR %.2f", psnr);
+    }
+    close_encoder(&strip, 4);
+    esp_video_enc_host_rc_jitter = 0;
+    printf("Table mismatch falls back to general encoder\n");
+}
+
+static void bench(int frames)
+{
+    int strip_nums[] = { 0, 2, 4 };
+    double general_fps = 0;
+    for (int i = 0; i < sizeof(strip_nums) / sizeof(strip_nums[0]); i++) {
+        test_enc_t t = {};
+        open_encoder(&t, strip_nums[i]);
+        fill_frame(0);
+        double start = now_sec();
+        for (int frame = 0; frame < frames; frame++) {
+            encode(&t, frame);
+        }
+        double fps = frames / (now_sec() - start);
+        if (strip_nums[i] == 0) {
+            general_fps = fps;
+            printf("General: %.1f fps\n", fps);
+        } else {
+            printf("%d strips: %.1f fps (x%.2f)\n", strip_nums[i], fps, fps / general_fps);
+        }
+        close_encoder(&t, strip_nums[i]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 30;
+    media_lib_add_default_os_adapter();
+    check_stitched(2);
+    // Last strip is shorter (192 * 3 + 144)
+    check_stitched(4);
+    check_table_mismatch();
+    bench(frames);
+    printf("Strip encoder test passed\n");
+    return 0;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "esp_video_enc.h"
+
+uint32_t esp_video_codec_get_image_size(esp_video_codec_pixel_fmt_t fmt, esp_video_codec_resolution_t *res);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Host stand-in of esp_video_codec encoder API, MJPEG implemented by libjpeg in esp_video_enc_jpeg.c */
+
+typedef enum {
+    ESP_VC_ERR_OK             = 0,
+    ESP_VC_ERR_INVALID_ARG    = -1,
+    ESP_VC_ERR_NO_MEMORY      = -2,
+    ESP_VC_ERR_NOT_SUPPORTED  = -3,
+    ESP_VC_ERR_WRONG_DATA     = -4,
+    ESP_VC_ERR_BUF_NOT_ENOUGH = -5,
+} esp_vc_err_t;
+
+typedef enum {
+    ESP_VIDEO_CODEC_TYPE_NONE,
+    ESP_VIDEO_CODEC_TYPE_MJPEG,
+    ESP_VIDEO_CODEC_TYPE_H264,
+} esp_video_codec_type_t;
+
+typedef enum {
+    ESP_VIDEO_CODEC_PIXEL_FMT_NONE,
+    ESP_VIDEO_CODEC_PIXEL_FMT_RGB565_LE,
+    ESP_VIDEO_CODEC_PIXEL_FMT_YUV420P,
+    ESP_VIDEO_CODEC_PIXEL_FMT_O_UYY_E_VYY,
+} esp_video_codec_pixel_fmt_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+} esp_video_codec_resolution_t;
+
+typedef struct {
+    esp_video_codec_type_t       codec_type;
+    esp_video_codec_resolution_t resolution;
+    esp_video_codec_pixel_fmt_t  in_fmt;
+    uint8_t                      fps;
+} esp_video_enc_cfg_t;
+
+typedef void *esp_video_enc_handle_t;
+
+typedef struct {
+    uint32_t pts;
+    uint8_t *data;
+    uint32_t size;
+} esp_video_enc_in_frame_t;
+
+typedef struct {
+    uint32_t pts;
+    uint8_t *data;
+    uint32_t size;
+    uint32_t encoded_size;
+} esp_video_enc_out_frame_t;
+
+esp_vc_err_t esp_video_enc_open(esp_video_enc_cfg_t *cfg, esp_video_enc_handle_t *handle);
+esp_vc_err_t esp_video_enc_process(esp_video_enc_handle_t handle, esp_video_enc_in_frame_t *in_frame,
+                                   esp_video_enc_out_frame_t *out_frame);
+esp_vc_err_t esp_video_enc_set_bitrate(esp_video_enc_handle_t handle, uint32_t bitrate);
+esp_vc_err_t esp_video_enc_close(esp_video_enc_handle_t handle);
+
+/* Host only: emulate independent rate control which lets each encoder instance pick its own quality */
+extern int esp_video_enc_host_rc_jitter;
@@ -0,0 +1,157 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <jpeglib.h>
+#include "esp_video_enc.h"
+#include "esp_video_codec_utils.h"
+
+/* Host stand-in of MJPEG encoder, maps bitrate to libjpeg quality like a simple rate control */
+
+#define DEFAULT_QUALITY (80)
+#define MIN_QUALITY     (10)
+#define MAX_QUALITY     (95)
+
+typedef struct {
+    esp_video_enc_cfg_t cfg;
+    int                 quality;
+    int                 index;
+    uint8_t            *line;
+} jpeg_enc_t;
+
+int esp_video_enc_host_rc_jitter;
+
+static int             instance_num;
+static pthread_mutex_t instance_lock = PTHREAD_MUTEX_INITIALIZER;
+
+uint32_t esp_video_codec_get_image_size(esp_video_codec_pixel_fmt_t fmt, esp_video_codec_resolution_t *res)
+{
+    switch (fmt) {
+        case ESP_VIDEO_CODEC_PIXEL_FMT_RGB565_LE:
+            return res->width * res->height * 2;
+        case ESP_VIDEO_CODEC_PIXEL_FMT_YUV420P:
+        case ESP_VIDEO_CODEC_PIXEL_FMT_O_UYY_E_VYY:
+            return res->width * res->height * 3 / 2;
+        default:
+            return 0;
+    }
+}
+
+esp_vc_err_t esp_video_enc_open(esp_video_enc_cfg_t *cfg, esp_video_enc_handle_t *handle)
+{
+    if (cfg->codec_type != ESP_VIDEO_CODEC_TYPE_MJPEG || cfg->in_fmt != ESP_VIDEO_CODEC_PIXEL_FMT_RGB565_LE) {
+        return ESP_VC_ERR_NOT_SUPPORTED;
+    }
+    jpeg_enc_t *enc = (jpeg_enc_t *)calloc(1, sizeof(jpeg_enc_t));
+    if (enc == NULL) {
+        return ESP_VC_ERR_NO_MEMORY;
+    }
+    enc->line = (uint8_t *)malloc(cfg->resolution.width * 3);
+    if (enc->line == NULL) {
+        free(enc);
+        return ESP_VC_ERR_NO_MEMORY;
+    }
+    enc->cfg = *cfg;
+    enc->quality = DEFAULT_QUALITY;
+    pthread_mutex_lock(&instance_lock);
+    enc->index = instance_num++;
+    pthread_mutex_unlock(&instance_lock);
+    *handle = enc;
+    return ESP_VC_ERR_OK;
+}
+
+esp_vc_err_t esp_video_enc_set_bitrate(esp_video_enc_handle_t handle, uint32_t bitrate)
+{
+    jpeg_enc_t *enc = (jpeg_enc_t *)handle;
+    uint32_t fps = enc->cfg.fps ? enc->cfg.fps : 1;
+    uint64_t bpp_x100 = (uint64_t)bitrate * 100 / ((uint64_t)enc->cfg.resolution.width * enc->cfg.resolution.height * fps);
+    int quality = 20 + (int)(bpp_x100 * 30 / 100);
+    quality = quality < MIN_QUALITY ? MIN_QUALITY : quality > MAX_QUALITY ? MAX_QUALITY : quality;
+    enc->quality = quality;
+    return ESP_VC_ERR_OK;
+}
+
+esp_vc_err_t esp_video_enc_process(esp_video_enc_handle_t handle, esp_video_enc_in_frame_t *in_frame,
+                                   esp_video_enc_out_frame_t *out_frame)
+{
+    jpeg_enc_t *enc = (jpeg_enc_t *)handle;
+    int width = enc->cfg.resolution.width;
+    int height = enc->cfg.resolution.height;
+    if (in_frame->size < (uint32_t)(width * height * 2)) {
+        return ESP_VC_ERR_INVALID_ARG;
+    }
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    unsigned char *mem = NULL;
+    unsigned long mem_size = 0;
+    jpeg_mem_dest(&cinfo, &mem, &mem_size);
+    cinfo.image_width = width;
+    cinfo.image_height = height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    int quality = enc->quality;
+    if (esp_video_enc_host_rc_jitter) {
+        quality -= enc->index % 3;
+    }
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    const uint8_t *src = in_frame->data;
+    while (cinfo.next_scanline < cinfo.image_height) {
+        for (int x = 0; x < width; x++) {
+            uint16_t pixel = src[0] | (src[1] << 8);
+            enc->line[x * 3] = (pixel >> 8) & 0xF8;
+            enc->line[x * 3 + 1] = (pixel >> 3) & 0xFC;
+            enc->line[x * 3 + 2] = (pixel << 3) & 0xF8;
+            src += 2;
+        }
+        JSAMPROW row = enc->line;
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    esp_vc_err_t ret = ESP_VC_ERR_OK;
+    if (mem_size > out_frame->size) {
+        ret = ESP_VC_ERR_BUF_NOT_ENOUGH;
+    } else {
+        memcpy(out_frame->data, mem, mem_size);
+        out_frame->encoded_size = (uint32_t)mem_size;
+        out_frame->pts = in_frame->pts;
+    }
+    free(mem);
+    return ret;
+}
+
+esp_vc_err_t esp_video_enc_close(esp_video_enc_handle_t handle)
+{
+    jpeg_enc_t *enc = (jpeg_enc_t *)handle;
+    free(enc->line);
+    free(enc);
+    return ESP_VC_ERR_OK;
+}
@@ -0,0 +1,111 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_capture_sync.h"
+#include "esp_timer.h"
+
+#define FRAME_MS         (20)
+#define CALL_HOURS       (8)
+#define FRAME_JITTER_US  (2000)  /* Audio read wakes up late by up to 2 ms */
+#define SETTLE_SEC       (120)   /* Convergence time excluded from steady state check */
+#define MAX_OFFSET_MS    (10)    /* Allowed audio pts vs wall clock offset after settle */
+#define MAX_PPM_ERR      (50)    /* Allowed estimated drift error after settle, jitter leaks into integral term */
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+static int64_t sim_now_us;
+
+int64_t esp_timer_get_time(void)
+{
+    return sim_now_us;
+}
+
+static void run_call(int32_t drift_ppm)
+{
+    esp_capture_sync_handle_t sync = NULL;
+    CHECK(esp_capture_sync_create(ESP_CAPTURE_SYNC_MODE_SYSTEM, &sync) == ESP_CAPTURE_ERR_OK, "create sync");
+    sim_now_us = 0;
+    esp_capture_sync_start(sync);
+    srand(1234);
+    uint32_t frames = (uint32_t)CALL_HOURS * 3600 * 1000 / FRAME_MS;
+    uint32_t settle_frames = SETTLE_SEC * 1000 / FRAME_MS;
+    int64_t max_offset_us = 0;
+    int32_t max_ppm_err = 0;
+    uint32_t last_pts = 0;
+    for (uint32_t i = 1; i <= frames; i++) {
+        // Sample clock runs faster by drift_ppm, so each frame of samples is ready earlier on wall clock
+        int64_t ideal_us = (int64_t)i * FRAME_MS * 1000 * 1000000 / (1000000 + drift_ppm);
+        sim_now_us = ideal_us + rand() % FRAME_JITTER_US;
+        // Pts calculated from sample count as capture audio source does
+        uint32_t pts = i * FRAME_MS;
+        esp_capture_sync_audio_update(sync, pts);
+        esp_capture_sync_audio_correct(sync, &pts);
+        CHECK(pts >= last_pts, "pts goes back from %d to %d at frame %d", (int)last_pts, (int)pts, (int)i);
+        last_pts = pts;
+        if (i < settle_frames) {
+            continue;
+        }
+        // Compare with ideal delivery time, jitter is not part of drift
+        int64_t offset_us = (int64_t)pts * 1000 - ideal_us;
+        if (offset_us < 0) {
+            offset_us = -offset_us;
+        }
+        if (offset_us > max_offset_us) {
+            max_offset_us = offset_us;
+        }
+        int32_t ppm = 0;
+        esp_capture_sync_get_audio_drift(sync, &ppm);
+        // Positive estimate means output is slowed down to follow wall clock
+        int32_t ppm_err = abs(ppm + drift_ppm);
+        if (ppm_err > max_ppm_err) {
+            max_ppm_err = ppm_err;
+        }
+    }
+    int32_t ppm = 0;
+    esp_capture_sync_get_audio_drift(sync, &ppm);
+    esp_capture_sync_destroy(sync);
+    printf("Drift %+d ppm over %dh: uncorrected offset %d ms, max offset %d ms, estimate %+d ppm (max error %d ppm)\n",
+           (int)drift_ppm, CALL_HOURS, (int)((int64_t)frames * FRAME_MS * drift_ppm / 1000000),
+           (int)(max_offset_us / 1000), (int)ppm, (int)max_ppm_err);
+    CHECK(max_offset_us <= MAX_OFFSET_MS * 1000, "offset %d us not bounded", (int)max_offset_us);
+    CHECK(max_ppm_err <= MAX_PPM_ERR, "drift estimate error %d ppm", (int)max_ppm_err);
+}
+
+int main(void)
+{
+    run_call(200);
+    run_call(-200);
+    run_call(0);
+    printf("Sync drift test passed\n");
+    return 0;
+}
@@ -243,6 +243,21 @@ int esp_capture_start(esp_capture_handle_t capture);
  */
 int esp_capture_set_path_bitrate(esp_capture_path_handle_t h, esp_capture_stream_type_t stream_type, uint32_t bitrate);
 
+/**
+ * @brief  Request key frame for video stream of capture path
+ *
+ * @note  Used when receiver loses decoding reference (e.g. reconnected), so that it need not wait for next GOP
+ *        Request is handled asynchronously by the video encoder of the path
+ *
+ * @param[in]  h  Capture path handle
+ *
+ * @return
+ *       - ESP_CAPTURE_ERR_OK             Key frame requested
+ *       - ESP_CAPTURE_ERR_INVALID_ARG    Invalid input argument
+ *       - ESP_CAPTURE_ERR_NOT_SUPPORTED  Path interface not provided or not support key frame request
+ */
+int esp_capture_request_key_frame(esp_capture_path_handle_t h);
+
 /**
  * @brief  Acquire stream data from capture path
  *
@@ -277,6 +292,23 @@ int esp_capture_acquire_path_frame(esp_capture_path_handle_t h, esp_capture_stre
  */
 int esp_capture_release_path_frame(esp_capture_path_handle_t h, esp_capture_stream_frame_t *frame);
 
+/**
+ * @brief  Get estimated clock drift of audio source against system clock
+ *
+ * @note  Only valid when sync mode is `ESP_CAPTURE_SYNC_MODE_SYSTEM`
+ *        Positive value means audio source clock runs slower than system clock
+ *
+ * @param[in]   capture  Capture handle
+ * @param[out]  ppm      Drift in parts per million
+ *
+ * @return
+ *       - ESP_CAPTURE_ERR_OK           On success
+ *       - ESP_CAPTURE_ERR_INVALID_ARG  Invalid input argument
+ *       - ESP_CAPTURE_ERR_NOT_SUPPORTED  Sync not enabled
+ *
+ */
+int esp_capture_get_audio_drift(esp_capture_handle_t capture, int32_t *ppm);
+
 /**
  * @brief  Stop capture
  *
@@ -27,6 +27,7 @@
 #include "esp_capture_types.h"
 #include "esp_capture_video_src_if.h"
 #include "esp_capture_audio_src_if.h"
+#include "esp_capture_audio_proc_if.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -128,6 +129,138 @@ void esp_capture_enable_aec_src_dump(bool enable);
  */
 esp_capture_audio_src_if_t *esp_capture_new_audio_aec_src(esp_capture_audio_aec_src_cfg_t *cfg);
 
+/**
+ * @brief  Maximum processing stages supported by audio processing source
+ */
+#define ESP_CAPTURE_AUDIO_PROC_MAX_STAGE (4)
+
+/**
+ * @brief  Audio processing source configuration
+ */
+typedef struct {
+    esp_capture_audio_src_if_t *src;           /*!< Audio source which provide 16 bits PCM data */
+    uint32_t                    stat_interval; /*!< Interval to report per stage cost (unit ms), 0 to disable */
+} esp_capture_audio_proc_src_cfg_t;
+
+/**
+ * @brief  Processing cost statistics of one stage
+ */
+typedef struct {
+    const char *name;       /*!< Stage name */
+    uint32_t    frames;     /*!< Processed frame count */
+    uint64_t    samples;    /*!< Processed samples */
+    uint64_t    process_us; /*!< Total processing time (unit us) */
+    uint32_t    max_us;     /*!< Maximum time for one frame (unit us) */
+    uint32_t    latency_ms; /*!< Added latency to reconcile frame size (unit ms) */
+} esp_capture_audio_proc_stat_t;
+
+/**
+ * @brief  Create audio source which run processing stages (like AEC, NS, AGC) over another audio source
+ *
+ * @note  Stages process data in place, data is read into the output frame and pass through all stages without copy
+ *        When stage frame size mismatch with capture frame size, a per-stage FIFO is added which introduce latency of one stage frame
+ *        Stages are run in the audio source thread (`AUD_SRC`), pin it to proper core through thread scheduler
+ *
+ * @param[in]  cfg  Audio processing source configuration
+ *
+ * @return
+ *       - NULL    Invalid argument or not enough memory
+ *       - Others  Audio processing source instance
+ *
+ */
+esp_capture_audio_src_if_t *esp_capture_new_audio_proc_src(esp_capture_audio_proc_src_cfg_t *cfg);
+
+/**
+ * @brief  Append processing stage into audio processing source
+ *
+ * @note  Stages must be added before capture start, stages are run in added order
+ *
+ * @param[in]  src   Audio processing source instance
+ * @param[in]  name  Stage name for statistics
+ * @param[in]  proc  Audio processing stage
+ *
+ * @return
+ *       - ESP_CAPTURE_ERR_OK             On success
+ *       - ESP_CAPTURE_ERR_INVALID_ARG    Invalid argument
+ *       - ESP_CAPTURE_ERR_INVALID_STATE  Source already started
+ *       - ESP_CAPTURE_ERR_NO_RESOURCES   Reach maximum stage number
+ *
+ */
+int esp_capture_audio_proc_src_add_stage(esp_capture_audio_src_if_t *src, const char *name, esp_capture_audio_proc_if_t *proc);
+
+/**
+ * @brief  Get processing cost statistics of stage
+ *
+ * @param[in]   src    Audio processing source instance
+ * @param[in]   stage  Stage index
+ * @param[out]  stat   Stage statistics
+ *
+ * @return
+ *       - ESP_CAPTURE_ERR_OK           On success
+ *       - ESP_CAPTURE_ERR_INVALID_ARG  Invalid argument or stage not existed
+ *
+ */
+int esp_capture_audio_proc_src_get_stat(esp_capture_audio_src_if_t *src, uint8_t stage, esp_capture_audio_proc_stat_t *stat);
+
+/**
+ * @brief  Software AGC stage configuration
+ */
+typedef struct {
+    int16_t  target_level; /*!< Target RMS level (unit 0.1 dBFS, negative), default -180 */
+    uint16_t max_gain;     /*!< Maximum amplify gain (unit 0.1 dB), default 240 */
+    int16_t  noise_gate;   /*!< Gain is hold when RMS lower than it (unit 0.1 dBFS), default -600 */
+    uint8_t  frame_ms;     /*!< Analysis frame duration (unit ms), default 10 */
+} esp_capture_audio_agc_cfg_t;
+
+/**
+ * @brief  Create software AGC processing stage
+ *
+ * @param[in]  cfg  AGC configuration, use default settings if set to NULL
+ *
+ * @return
+ *       - NULL    Not enough memory
+ *       - Others  AGC processing stage
+ *
+ */
+esp_capture_audio_proc_if_t *esp_capture_new_audio_agc_proc(esp_capture_audio_agc_cfg_t *cfg);
+
+/**
+ * @brief  Video file source configuration
+ *
+ * @note  Access unit index is built when open and cached into `<file_name>.idx` for later use
+ *        Cache is rebuilt when file size, modification time or hash of file head and tail changes
+ */
+typedef struct {
+    const char *file_name;   /*!< Video file path (supports `.h264`) */
+    bool        loop;        /*!< Restart from beginning when reach file end */
+    bool        pace_by_fps; /*!< Deliver frames in real time according negotiated fps */
+} esp_capture_video_file_src_cfg_t;
+
+/**
+ * @brief  Create video source instance for file
+ *
+ * @param[in]  cfg  Video file source configuration
+ *
+ * @return
+ *       - NULL    Not enough memory to hold video file source instance
+ *       - Others  Video file source instance
+ *
+ */
+esp_capture_video_src_if_t *esp_capture_new_video_file_src(esp_capture_video_file_src_cfg_t *cfg);
+
+/**
+ * @brief  Seek video file source to nearest IDR frame before the position
+ *
+ * @param[in]  src  Video file source instance
+ * @param[in]  pts  Position to seek (unit ms)
+ *
+ * @return
+ *       - ESP_CAPTURE_ERR_OK             On success
+ *       - ESP_CAPTURE_ERR_INVALID_STATE  Source not opened yet
+ *
+ */
+int esp_capture_video_file_src_seek(esp_capture_video_src_if_t *src, uint32_t pts);
+
 #ifdef __cplusplus
 }
 #endif
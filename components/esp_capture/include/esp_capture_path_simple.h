@@ -38,6 +38,8 @@ extern "C" {
  * @note  Simple capture path consisted by one audio encoder and one video encoder
  *        It also support bypass mode, during bypass encoder not work,
  *        audio source data and video source data is sent to user directly.
+ *        When `secondary_venc` is set, `ESP_CAPTURE_PATH_SECONDARY` can be added for a lower resolution video stream
+ *        (e.g. simulcast layer). Primary source frame is downscaled for it, so primary path must encode video.
  *
  */
 typedef struct {
@@ -45,6 +47,10 @@ typedef struct {
     esp_capture_venc_if_t *venc;             /*!< Video encoder instance */
     uint32_t               aenc_frame_count; /*!< Audio encoder output frame count */
     uint32_t               venc_frame_count; /*!< Video encoder output frame count */
+    esp_capture_venc_if_t *secondary_venc;   /*!< Video encoder instance for secondary path, NULL to support primary path only
+                                                  Must be another instance than `venc` (e.g. `esp_capture_new_video_encoder` again)
+                                                  Secondary path is video only, resolution not larger than primary and frames
+                                                  are skipped when user holds too many of them */
 } esp_capture_simple_path_cfg_t;
 
 /**
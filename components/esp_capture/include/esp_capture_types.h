@@ -40,11 +40,11 @@ typedef enum {
     ESP_CAPTURE_ERR_INVALID_ARG   = -2,
     ESP_CAPTURE_ERR_NOT_SUPPORTED = -3,
     ESP_CAPTURE_ERR_NOT_FOUND     = -4,
-    ESP_CAPTURE_ERR_NOT_ENOUGH,
     ESP_CAPTURE_ERR_TIMEOUT       = -5,
     ESP_CAPTURE_ERR_INVALID_STATE = -6,
     ESP_CAPTURE_ERR_INTERNAL      = -7,
     ESP_CAPTURE_ERR_NO_RESOURCES  = -8,
+    ESP_CAPTURE_ERR_NOT_ENOUGH    = -9,
 } esp_capture_err_t;
 
 /**
@@ -41,6 +41,44 @@ extern "C" {
  */
 esp_capture_venc_if_t *esp_capture_new_video_encoder(void);
 
+/**
+ * @brief  Strip video encoder configuration
+ */
+typedef struct {
+    uint8_t strip_num; /*!< Horizontal strips to split frame into (0: use default 2, max 4) */
+} esp_capture_video_strip_enc_cfg_t;
+
+/**
+ * @brief  Create an instance for strip video encoder
+ *
+ * @note  For MJPEG, each frame is split into horizontal strips which are encoded concurrently,
+ *        strip 0 is encoded in caller thread, other strips in threads named "venc_strip"
+ *        (pin them to another core through `media_lib_thread_set_schedule_cb`).
+ *        Encoded strips are stitched into one JPEG using restart interval.
+ *        Each strip gets bitrate in proportion to its height so that all strips share same tables,
+ *        if quantization or huffman tables still differ, switches to general video encoder.
+ *        Other codecs fall back to general video encoder
+ *        Instance (and its clones) owns an inner general video encoder, release it through
+ *        `esp_capture_free_video_strip_encoder` instead of `free`
+ *
+ * @param[in]  cfg  Strip video encoder configuration
+ *
+ * @return
+ *       - NULL    Not enough memory to hold video encoder instance
+ *       - Others  Video encoder instance
+ *
+ */
+esp_capture_venc_if_t *esp_capture_new_video_strip_encoder(esp_capture_video_strip_enc_cfg_t *cfg);
+
+/**
+ * @brief  Free strip video encoder instance
+ *
+ * @note  Encoder is stopped first if still running
+ *
+ * @param[in]  enc  Strip video encoder instance created by `esp_capture_new_video_strip_encoder` or its clone
+ */
+void esp_capture_free_video_strip_encoder(esp_capture_venc_if_t *enc);
+
 #ifdef __cplusplus
 }
 #endif
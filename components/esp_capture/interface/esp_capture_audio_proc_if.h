@@ -0,0 +1,62 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#pragma once
+
+#include "esp_capture_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Capture audio processing stage interface
+ *
+ * @note  A stage processes 16 bits PCM in place, so that data flows through the chain without copy
+ *        Stages which work on different frame size are reconciled by the audio processing source
+ */
+typedef struct esp_capture_audio_proc_if_t esp_capture_audio_proc_if_t;
+
+struct esp_capture_audio_proc_if_t {
+    /**
+     * @brief  Open the stage with negotiated audio information
+     *         Stage reports the samples per process call through `frame_samples`, 0 means any size is accepted
+     */
+    int (*open)(esp_capture_audio_proc_if_t *proc, const esp_capture_audio_info_t *info, uint32_t *frame_samples);
+
+    /**
+     * @brief  Process one frame of audio data in place
+     */
+    int (*process)(esp_capture_audio_proc_if_t *proc, uint8_t *data, int size);
+
+    /**
+     * @brief  Close the stage, stage can be opened again later
+     */
+    int (*close)(esp_capture_audio_proc_if_t *proc);
+};
+
+#ifdef __cplusplus
+}
+#endif
@@ -54,6 +54,7 @@ typedef enum {
     ESP_CAPTURE_PATH_SET_TYPE_AUDIO_BITRATE, /*!< Set for audio bitrate */
     ESP_CAPTURE_PATH_SET_TYPE_VIDEO_BITRATE, /*!< Set for video bitrate */
     ESP_CAPTURE_PATH_SET_TYPE_VIDEO_FPS,     /*!< Set for video frame per second */
+    ESP_CAPTURE_PATH_SET_TYPE_KEY_FRAME,     /*!< Request next encoded video frame to be key frame (no configuration data) */
 } esp_capture_path_set_type_t;
 
 /**
@@ -361,11 +361,8 @@ static void audio_src_thread(void *arg)
         if (capture->sync_handle) {
             esp_capture_sync_audio_update(capture->sync_handle, frame->pts);
             if (capture->cfg.sync_mode != ESP_CAPTURE_SYNC_MODE_AUDIO) {
-                uint32_t cur_pts = 0;
-                esp_capture_sync_get_current(capture->sync_handle, &cur_pts);
-                if (frame->pts > cur_pts + CAPTURE_SYNC_TOLERANCE || frame->pts + CAPTURE_SYNC_TOLERANCE < cur_pts) {
-                    frame->pts = cur_pts;
-                }
+                // Slew audio pts toward system clock instead of jumping when drift exceeds tolerance
+                esp_capture_sync_audio_correct(capture->sync_handle, &frame->pts);
             }
         }
         data_queue_send_buffer(capture->audio_src_q, frame_size);
@@ -1424,6 +1421,24 @@ int esp_capture_set_path_bitrate(esp_capture_path_handle_t h, esp_capture_stream
     return ret;
 }
 
+int esp_capture_request_key_frame(esp_capture_path_handle_t h)
+{
+    capture_path_t *path = (capture_path_t *)h;
+    if (path == NULL || path->parent == NULL) {
+        return ESP_CAPTURE_ERR_INVALID_ARG;
+    }
+    capture_t *capture = path->parent;
+    media_lib_mutex_lock(capture->api_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (capture->cfg.capture_path == NULL) {
+        ESP_LOGE(TAG, "Capture path not supported");
+        media_lib_mutex_unlock(capture->api_lock);
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    int ret = capture->cfg.capture_path->set(capture->cfg.capture_path, path->path_type, ESP_CAPTURE_PATH_SET_TYPE_KEY_FRAME, NULL, 0);
+    media_lib_mutex_unlock(capture->api_lock);
+    return ret;
+}
+
 int esp_capture_acquire_path_frame(esp_capture_path_handle_t h, esp_capture_stream_frame_t *frame, bool no_wait)
 {
     capture_path_t *path = (capture_path_t *)h;
@@ -1611,6 +1626,18 @@ int esp_capture_stop(esp_capture_handle_t h)
     return ESP_CAPTURE_ERR_OK;
 }
 
+int esp_capture_get_audio_drift(esp_capture_handle_t h, int32_t *ppm)
+{
+    capture_t *capture = (capture_t *)h;
+    if (capture == NULL || ppm == NULL) {
+        return ESP_CAPTURE_ERR_INVALID_ARG;
+    }
+    if (capture->sync_handle == NULL) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    return esp_capture_sync_get_audio_drift(capture->sync_handle, ppm);
+}
+
 int esp_capture_close(esp_capture_handle_t h)
 {
     if (h == NULL) {
@@ -30,11 +30,32 @@
 #define ELAPSE(cur, last) (cur > last ? cur - last : cur + (0xFFFFFFFF - last))
 #define CUR()             (uint32_t)(esp_timer_get_time() / 1000)
 
+/* PI loop gains for audio clock drift estimation
+ * Proportional: ppm per millisecond of error, integral: ppm per millisecond error per second
+ */
+#define DRIFT_KP_X1000     (47)
+#define DRIFT_KI_X10000    (11)
+#define DRIFT_MAX_PPM      (2000)
+#define DRIFT_INTEG_SCALE  (1000000)
+#define DRIFT_INTEG_MAX    ((int64_t)1000 * DRIFT_INTEG_SCALE)
+/* Error too large to slew out (source stall or restart), re-anchor to wall clock */
+#define DRIFT_RESYNC_US    (200000)
+
+typedef struct {
+    bool     anchored;       /*!< Audio clock anchored to wall clock */
+    uint32_t last_src_pts;   /*!< Last pts derived from sample count */
+    int64_t  out_us;         /*!< Drift corrected audio time in microseconds */
+    int64_t  integ;          /*!< Integral term scaled by DRIFT_INTEG_SCALE */
+    int32_t  ppm;            /*!< Estimated sample clock vs wall clock ratio in ppm */
+} audio_drift_t;
+
 typedef struct {
     esp_capture_sync_mode_t mode;
     uint32_t                last_update_time;
     uint32_t                last_update_pts;
     uint32_t                last_audio_pts;
+    int64_t                 last_update_us;
+    audio_drift_t           drift;
     bool                    started;
 } sync_t;
 
@@ -53,7 +74,8 @@ int esp_capture_sync_audio_update(esp_capture_sync_handle_t handle, uint32_t aud
 {
     sync_t *sync = (sync_t *)handle;
     if (sync->mode == ESP_CAPTURE_SYNC_MODE_AUDIO) {
-        sync->last_update_time = CUR();
+        sync->last_update_us = esp_timer_get_time();
+        sync->last_update_time = (uint32_t)(sync->last_update_us / 1000);
         sync->last_update_pts = sync->last_audio_pts = aud_pts;
     }
     return ESP_CAPTURE_ERR_OK;
@@ -66,7 +88,9 @@ int esp_capture_sync_start(esp_capture_sync_handle_t handle)
     }
     sync_t *sync = (sync_t *)handle;
     sync->started = true;
-    sync->last_update_time = CUR();
+    sync->last_update_us = esp_timer_get_time();
+    sync->last_update_time = (uint32_t)(sync->last_update_us / 1000);
+    sync->drift.anchored = false;
     return ESP_CAPTURE_ERR_OK;
 }
 
@@ -96,6 +120,61 @@ int esp_capture_sync_get_current(esp_capture_sync_handle_t handle, uint32_t *pts
     return ESP_CAPTURE_ERR_OK;
 }
 
+int esp_capture_sync_audio_correct(esp_capture_sync_handle_t handle, uint32_t *aud_pts)
+{
+    if (handle == NULL || aud_pts == NULL) {
+        return ESP_CAPTURE_ERR_INVALID_ARG;
+    }
+    sync_t *sync = (sync_t *)handle;
+    audio_drift_t *drift = &sync->drift;
+    if (sync->started == false || sync->mode == ESP_CAPTURE_SYNC_MODE_AUDIO) {
+        return ESP_CAPTURE_ERR_OK;
+    }
+    int64_t wall_us = (int64_t)sync->last_update_pts * 1000 + esp_timer_get_time() - sync->last_update_us;
+    if (drift->anchored == false) {
+        drift->anchored = true;
+        drift->last_src_pts = *aud_pts;
+        drift->out_us = wall_us;
+        *aud_pts = (uint32_t)(wall_us / 1000);
+        return ESP_CAPTURE_ERR_OK;
+    }
+    // Advance by sample duration scaled with estimated ratio so that pts stays smooth
+    int64_t delta_us = (int64_t)(uint32_t)(*aud_pts - drift->last_src_pts) * 1000;
+    drift->last_src_pts = *aud_pts;
+    drift->out_us += delta_us + delta_us * drift->ppm / 1000000;
+    int64_t err_us = wall_us - drift->out_us;
+    if (err_us > DRIFT_RESYNC_US || err_us < -DRIFT_RESYNC_US) {
+        drift->out_us = wall_us;
+        err_us = 0;
+    }
+    drift->integ += err_us * delta_us * DRIFT_KI_X10000 / 10000;
+    if (drift->integ > DRIFT_INTEG_MAX) {
+        drift->integ = DRIFT_INTEG_MAX;
+    } else if (drift->integ < -DRIFT_INTEG_MAX) {
+        drift->integ = -DRIFT_INTEG_MAX;
+    }
+    int64_t ppm = drift->integ / DRIFT_INTEG_SCALE + err_us * DRIFT_KP_X1000 / 1000;
+    if (ppm > DRIFT_MAX_PPM) {
+        ppm = DRIFT_MAX_PPM;
+    } else if (ppm < -DRIFT_MAX_PPM) {
+        ppm = -DRIFT_MAX_PPM;
+    }
+    drift->ppm = (int32_t)ppm;
+    *aud_pts = (uint32_t)(drift->out_us / 1000);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int esp_capture_sync_get_audio_drift(esp_capture_sync_handle_t handle, int32_t *ppm)
+{
+    if (handle == NULL || ppm == NULL) {
+        return ESP_CAPTURE_ERR_INVALID_ARG;
+    }
+    sync_t *sync = (sync_t *)handle;
+    // Report integral part only, proportional part is jitter
+    *ppm = (int32_t)(sync->drift.integ / DRIFT_INTEG_SCALE);
+    return ESP_CAPTURE_ERR_OK;
+}
+
 int esp_capture_sync_destroy(esp_capture_sync_handle_t handle)
 {
     if (handle == NULL) {
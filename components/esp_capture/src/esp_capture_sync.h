@@ -37,6 +37,20 @@ int esp_capture_sync_start(esp_capture_sync_handle_t handle);
 
 int esp_capture_sync_get_current(esp_capture_sync_handle_t handle, uint32_t *pts);
 
+/**
+ * @brief  Convert sample count based audio pts into drift compensated pts
+ *
+ * @note  Estimates the ratio between audio sample clock and system clock through a PI filter,
+ *        so that output pts tracks wall clock smoothly without jumps
+ *        Does nothing when sync mode is `ESP_CAPTURE_SYNC_MODE_AUDIO`
+ */
+int esp_capture_sync_audio_correct(esp_capture_sync_handle_t handle, uint32_t *aud_pts);
+
+/**
+ * @brief  Get estimated audio clock drift against system clock in ppm
+ */
+int esp_capture_sync_get_audio_drift(esp_capture_sync_handle_t handle, int32_t *ppm);
+
 int esp_capture_sync_stop(esp_capture_sync_handle_t handle);
 
 int esp_capture_sync_destroy(esp_capture_sync_handle_t handle);
\ No newline at end of file
@@ -0,0 +1,168 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "esp_capture_types.h"
+#include "esp_capture_audio_proc_if.h"
+#include "esp_capture_defaults.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define TAG "AUD_AGC"
+
+#define AGC_GAIN_SHIFT     (12)
+#define AGC_UNITY_GAIN     (1 << AGC_GAIN_SHIFT)
+#define AGC_MIN_GAIN       (AGC_UNITY_GAIN / 8)
+// Gain move towards target in 1/2^N per frame
+#define AGC_ATTACK_SHIFT   (2)
+#define AGC_RELEASE_SHIFT  (5)
+
+typedef struct {
+    esp_capture_audio_proc_if_t base;
+    esp_capture_audio_agc_cfg_t cfg;
+    int32_t                     target_rms;
+    int32_t                     gate_rms;
+    int32_t                     max_gain;
+    int32_t                     gain;
+} audio_agc_proc_t;
+
+static int32_t db_to_linear(int16_t db_x10, int32_t scale)
+{
+    return (int32_t)(scale * powf(10.0f, db_x10 / 200.0f));
+}
+
+static int audio_agc_open(esp_capture_audio_proc_if_t *h, const esp_capture_audio_info_t *info, uint32_t *frame_samples)
+{
+    audio_agc_proc_t *agc = (audio_agc_proc_t *)h;
+    if (info->bits_per_sample != 16 || info->sample_rate == 0) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    agc->target_rms = db_to_linear(agc->cfg.target_level, 32767);
+    agc->gate_rms = db_to_linear(agc->cfg.noise_gate, 32767);
+    agc->max_gain = db_to_linear(agc->cfg.max_gain, AGC_UNITY_GAIN);
+    agc->gain = AGC_UNITY_GAIN;
+    *frame_samples = agc->cfg.frame_ms * info->sample_rate / 1000;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int32_t agc_calc_gain(audio_agc_proc_t *agc, int16_t *data, int samples)
+{
+    int64_t power = 0;
+    int32_t peak = 0;
+    for (int i = 0; i < samples; i++) {
+        int32_t v = data[i];
+        power += v * v;
+        if (v < 0) {
+            v = -v;
+        }
+        if (v > peak) {
+            peak = v;
+        }
+    }
+    int32_t rms = (int32_t)sqrtf((float)(power / samples));
+    if (rms < agc->gate_rms || rms == 0) {
+        // Keep gain for silence, avoid pumping background noise
+        return agc->gain;
+    }
+    int32_t target = (int32_t)((int64_t)agc->target_rms * AGC_UNITY_GAIN / rms);
+    if (target > agc->max_gain) {
+        target = agc->max_gain;
+    } else if (target < AGC_MIN_GAIN) {
+        target = AGC_MIN_GAIN;
+    }
+    int32_t gain = agc->gain;
+    if (target < gain) {
+        gain += (target - gain) >> AGC_ATTACK_SHIFT;
+    } else {
+        gain += (target - gain) >> AGC_RELEASE_SHIFT;
+    }
+    // Limit gain so that peak not clip
+    if (peak && (int64_t)peak * gain > ((int64_t)32767 << AGC_GAIN_SHIFT)) {
+        gain = (int32_t)(((int64_t)32767 << AGC_GAIN_SHIFT) / peak);
+    }
+    return gain;
+}
+
+static int audio_agc_process(esp_capture_audio_proc_if_t *h, uint8_t *data, int size)
+{
+    audio_agc_proc_t *agc = (audio_agc_proc_t *)h;
+    int16_t *pcm = (int16_t *)data;
+    int samples = size / 2;
+    if (samples == 0) {
+        return ESP_CAPTURE_ERR_OK;
+    }
+    int32_t new_gain = agc_calc_gain(agc, pcm, samples);
+    // Ramp gain across frame to avoid zipper noise
+    int32_t gain = agc->gain;
+    int32_t step = (new_gain - gain) / samples;
+    for (int i = 0; i < samples; i++) {
+        int32_t v = (pcm[i] * gain) >> AGC_GAIN_SHIFT;
+        if (v > 32767) {
+            v = 32767;
+        } else if (v < -32768) {
+            v = -32768;
+        }
+        pcm[i] = (int16_t)v;
+        gain += step;
+    }
+    agc->gain = new_gain;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int audio_agc_close(esp_capture_audio_proc_if_t *h)
+{
+    audio_agc_proc_t *agc = (audio_agc_proc_t *)h;
+    agc->gain = AGC_UNITY_GAIN;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+esp_capture_audio_proc_if_t *esp_capture_new_audio_agc_proc(esp_capture_audio_agc_cfg_t *cfg)
+{
+    audio_agc_proc_t *agc = calloc(1, sizeof(audio_agc_proc_t));
+    if (agc == NULL) {
+        ESP_LOGE(TAG, "No memory for AGC");
+        return NULL;
+    }
+    agc->base.open = audio_agc_open;
+    agc->base.process = audio_agc_process;
+    agc->base.close = audio_agc_close;
+    if (cfg) {
+        agc->cfg = *cfg;
+    }
+    if (agc->cfg.target_level == 0) {
+        agc->cfg.target_level = -180;
+    }
+    if (agc->cfg.max_gain == 0) {
+        agc->cfg.max_gain = 240;
+    }
+    if (agc->cfg.noise_gate == 0) {
+        agc->cfg.noise_gate = -600;
+    }
+    if (agc->cfg.frame_ms == 0) {
+        agc->cfg.frame_ms = 10;
+    }
+    return &agc->base;
+}
@@ -0,0 +1,337 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "esp_capture_types.h"
+#include "esp_capture_audio_src_if.h"
+#include "esp_capture_audio_proc_if.h"
+#include "esp_capture_defaults.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TAG "AUD_PROC_SRC"
+
+/**
+ * @brief  Processing stage wrapper
+ *
+ * @note  FIFO is only used when stage frame size can not divide capture frame size
+ *        It is primed with one stage frame of silence so that whole capture frame can always be output
+ */
+typedef struct {
+    esp_capture_audio_proc_if_t  *proc;
+    uint32_t                      frame_size; /*!< Bytes per process call, 0 for any size */
+    uint8_t                      *fifo;
+    int                           fifo_cap;
+    int                           fifo_chunk; /*!< Capture frame size the FIFO is prepared for */
+    int                           rd_pos;     /*!< Processed data already output */
+    int                           proc_pos;   /*!< Data before it is processed */
+    int                           fill;
+    bool                          opened;
+    esp_capture_audio_proc_stat_t stat;
+} proc_stage_t;
+
+typedef struct {
+    esp_capture_audio_src_if_t base;
+    esp_capture_audio_src_if_t *src;
+    esp_capture_audio_info_t   info;
+    proc_stage_t               stages[ESP_CAPTURE_AUDIO_PROC_MAX_STAGE];
+    uint8_t                    stage_num;
+    uint32_t                   stat_interval;
+    uint64_t                   report_samples;
+    uint64_t                   samples;
+    bool                       start;
+} audio_proc_src_t;
+
+static int audio_proc_src_open(esp_capture_audio_src_if_t *h)
+{
+    audio_proc_src_t *src = (audio_proc_src_t *)h;
+    return src->src->open(src->src);
+}
+
+static int audio_proc_src_get_support_codecs(esp_capture_audio_src_if_t *h, const esp_capture_codec_type_t **codecs, uint8_t *num)
+{
+    static esp_capture_codec_type_t support_codecs[] = { ESP_CAPTURE_CODEC_TYPE_PCM };
+    *codecs = support_codecs;
+    *num = 1;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int audio_proc_src_negotiate_caps(esp_capture_audio_src_if_t *h, esp_capture_audio_info_t *in_cap, esp_capture_audio_info_t *out_caps)
+{
+    audio_proc_src_t *src = (audio_proc_src_t *)h;
+    // Stages only handle 16 bits PCM
+    if (in_cap->codec != ESP_CAPTURE_CODEC_TYPE_PCM || in_cap->bits_per_sample != 16) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    int ret = src->src->negotiate_caps(src->src, in_cap, out_caps);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        return ret;
+    }
+    if (out_caps->codec != ESP_CAPTURE_CODEC_TYPE_PCM || out_caps->bits_per_sample != 16) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    src->info = *out_caps;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static void close_stages(audio_proc_src_t *src)
+{
+    for (int i = 0; i < src->stage_num; i++) {
+        proc_stage_t *stage = &src->stages[i];
+        if (stage->opened) {
+            stage->proc->close(stage->proc);
+            stage->opened = false;
+        }
+        if (stage->fifo) {
+            free(stage->fifo);
+            stage->fifo = NULL;
+        }
+        stage->fifo_cap = stage->fifo_chunk = 0;
+    }
+}
+
+static int open_stages(audio_proc_src_t *src)
+{
+    int sample_size = src->info.channel * 2;
+    for (int i = 0; i < src->stage_num; i++) {
+        proc_stage_t *stage = &src->stages[i];
+        uint32_t frame_samples = 0;
+        int ret = stage->proc->open(stage->proc, &src->info, &frame_samples);
+        if (ret != ESP_CAPTURE_ERR_OK) {
+            ESP_LOGE(TAG, "Fail to open stage %s ret %d", stage->stat.name, ret);
+            close_stages(src);
+            return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+        }
+        stage->opened = true;
+        stage->frame_size = frame_samples * sample_size;
+        const char *name = stage->stat.name;
+        memset(&stage->stat, 0, sizeof(esp_capture_audio_proc_stat_t));
+        stage->stat.name = name;
+    }
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int audio_proc_src_start(esp_capture_audio_src_if_t *h)
+{
+    audio_proc_src_t *src = (audio_proc_src_t *)h;
+    int ret = src->src->start(src->src);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        return ret;
+    }
+    ret = open_stages(src);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        src->src->stop(src->src);
+        return ret;
+    }
+    src->samples = 0;
+    src->report_samples = 0;
+    src->start = true;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int run_stage(audio_proc_src_t *src, proc_stage_t *stage, uint8_t *data, int size)
+{
+    int64_t start_time = esp_timer_get_time();
+    int ret = stage->proc->process(stage->proc, data, size);
+    uint32_t cost = (uint32_t)(esp_timer_get_time() - start_time);
+    stage->stat.frames++;
+    stage->stat.samples += size / (src->info.channel * 2);
+    stage->stat.process_us += cost;
+    if (cost > stage->stat.max_us) {
+        stage->stat.max_us = cost;
+    }
+    return ret;
+}
+
+static int prepare_fifo(audio_proc_src_t *src, proc_stage_t *stage, int size)
+{
+    if (stage->fifo && stage->fifo_chunk == size) {
+        return ESP_CAPTURE_ERR_OK;
+    }
+    int cap = stage->frame_size * 2 + size;
+    if (cap > stage->fifo_cap) {
+        uint8_t *fifo = realloc(stage->fifo, cap);
+        if (fifo == NULL) {
+            return ESP_CAPTURE_ERR_NO_MEM;
+        }
+        stage->fifo = fifo;
+        stage->fifo_cap = cap;
+    }
+    // Prime with one frame of silence
+    memset(stage->fifo, 0, stage->frame_size);
+    stage->rd_pos = 0;
+    stage->proc_pos = stage->fill = stage->frame_size;
+    stage->fifo_chunk = size;
+    int samples = stage->frame_size / (src->info.channel * 2);
+    stage->stat.latency_ms = samples * 1000 / src->info.sample_rate;
+    ESP_LOGI(TAG, "Stage %s frame %d mismatch %d add latency %dms", stage->stat.name,
+             (int)stage->frame_size, size, (int)stage->stat.latency_ms);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int process_stage(audio_proc_src_t *src, proc_stage_t *stage, uint8_t *data, int size)
+{
+    int ret = ESP_CAPTURE_ERR_OK;
+    if (stage->frame_size == 0) {
+        return run_stage(src, stage, data, size);
+    }
+    // Process in place inside capture frame
+    if (size % stage->frame_size == 0) {
+        for (int pos = 0; pos < size && ret == ESP_CAPTURE_ERR_OK; pos += stage->frame_size) {
+            ret = run_stage(src, stage, data + pos, stage->frame_size);
+        }
+        return ret;
+    }
+    ret = prepare_fifo(src, stage, size);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        return ret;
+    }
+    if (stage->fill + size > stage->fifo_cap) {
+        int left = stage->fill - stage->rd_pos;
+        memmove(stage->fifo, stage->fifo + stage->rd_pos, left);
+        stage->proc_pos -= stage->rd_pos;
+        stage->fill = left;
+        stage->rd_pos = 0;
+    }
+    memcpy(stage->fifo + stage->fill, data, size);
+    stage->fill += size;
+    while (stage->fill - stage->proc_pos >= (int)stage->frame_size && ret == ESP_CAPTURE_ERR_OK) {
+        ret = run_stage(src, stage, stage->fifo + stage->proc_pos, stage->frame_size);
+        stage->proc_pos += stage->frame_size;
+    }
+    // Priming guarantees processed data is always enough for one capture frame
+    memcpy(data, stage->fifo + stage->rd_pos, size);
+    stage->rd_pos += size;
+    return ret;
+}
+
+static void report_stages(audio_proc_src_t *src)
+{
+    uint32_t elapse_ms = (uint32_t)((src->samples - src->report_samples) * 1000 / src->info.sample_rate);
+    if (elapse_ms < src->stat_interval) {
+        return;
+    }
+    src->report_samples = src->samples;
+    for (int i = 0; i < src->stage_num; i++) {
+        esp_capture_audio_proc_stat_t *stat = &src->stages[i].stat;
+        if (stat->samples == 0) {
+            continue;
+        }
+        // Cost in permille of audio duration
+        uint32_t audio_us = (uint32_t)(stat->samples * 1000000 / src->info.sample_rate);
+        uint32_t cost = audio_us ? (uint32_t)(stat->process_us * 1000 / audio_us) : 0;
+        ESP_LOGI(TAG, "Stage %s cpu %d.%d%% max %dus latency %dms", stat->name, (int)(cost / 10), (int)(cost % 10),
+                 (int)stat->max_us, (int)stat->latency_ms);
+    }
+}
+
+static int audio_proc_src_read_frame(esp_capture_audio_src_if_t *h, esp_capture_stream_frame_t *frame)
+{
+    audio_proc_src_t *src = (audio_proc_src_t *)h;
+    if (src->start == false) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    int ret = src->src->read_frame(src->src, frame);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        return ret;
+    }
+    for (int i = 0; i < src->stage_num; i++) {
+        ret = process_stage(src, &src->stages[i], frame->data, frame->size);
+        if (ret != ESP_CAPTURE_ERR_OK) {
+            ESP_LOGE(TAG, "Fail to process stage %s ret %d", src->stages[i].stat.name, ret);
+            return ESP_CAPTURE_ERR_INTERNAL;
+        }
+    }
+    src->samples += frame->size / (src->info.channel * 2);
+    if (src->stat_interval) {
+        report_stages(src);
+    }
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int audio_proc_src_stop(esp_capture_audio_src_if_t *h)
+{
+    audio_proc_src_t *src = (audio_proc_src_t *)h;
+    int ret = src->src->stop(src->src);
+    close_stages(src);
+    src->start = false;
+    return ret;
+}
+
+static int audio_proc_src_close(esp_capture_audio_src_if_t *h)
+{
+    audio_proc_src_t *src = (audio_proc_src_t *)h;
+    return src->src->close(src->src);
+}
+
+esp_capture_audio_src_if_t *esp_capture_new_audio_proc_src(esp_capture_audio_proc_src_cfg_t *cfg)
+{
+    if (cfg == NULL || cfg->src == NULL) {
+        return NULL;
+    }
+    audio_proc_src_t *src = calloc(1, sizeof(audio_proc_src_t));
+    if (src == NULL) {
+        return NULL;
+    }
+    src->base.open = audio_proc_src_open;
+    src->base.get_support_codecs = audio_proc_src_get_support_codecs;
+    src->base.negotiate_caps = audio_proc_src_negotiate_caps;
+    src->base.start = audio_proc_src_start;
+    src->base.read_frame = audio_proc_src_read_frame;
+    src->base.stop = audio_proc_src_stop;
+    src->base.close = audio_proc_src_close;
+    src->src = cfg->src;
+    src->stat_interval = cfg->stat_interval;
+    return &src->base;
+}
+
+int esp_capture_audio_proc_src_add_stage(esp_capture_audio_src_if_t *h, const char *name, esp_capture_audio_proc_if_t *proc)
+{
+    audio_proc_src_t *src = (audio_proc_src_t *)h;
+    if (src == NULL || proc == NULL || proc->open == NULL || proc->process == NULL || proc->close == NULL) {
+        return ESP_CAPTURE_ERR_INVALID_ARG;
+    }
+    if (src->start) {
+        return ESP_CAPTURE_ERR_INVALID_STATE;
+    }
+    if (src->stage_num >= ESP_CAPTURE_AUDIO_PROC_MAX_STAGE) {
+        return ESP_CAPTURE_ERR_NO_RESOURCES;
+    }
+    proc_stage_t *stage = &src->stages[src->stage_num++];
+    stage->proc = proc;
+    stage->stat.name = name ? name : "";
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int esp_capture_audio_proc_src_get_stat(esp_capture_audio_src_if_t *h, uint8_t stage, esp_capture_audio_proc_stat_t *stat)
+{
+    audio_proc_src_t *src = (audio_proc_src_t *)h;
+    if (src == NULL || stat == NULL || stage >= src->stage_num) {
+        return ESP_CAPTURE_ERR_INVALID_ARG;
+    }
+    *stat = src->stages[stage].stat;
+    return ESP_CAPTURE_ERR_OK;
+}
@@ -23,28 +23,74 @@
  */
 
 #include "esp_capture_types.h"
-#include "esp_capture_video_src_if.h"
+#include "esp_capture_defaults.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
 #include "data_queue.h"
+#include <sys/stat.h>
+#if CONFIG_IDF_TARGET_LINUX
+#include <sys/mman.h>
+#endif
 
 #define TAG "VID_FILE_SRC"
 
-#define NAL_UNIT_TYPE_SPS 7
-#define NAL_UNIT_TYPE_PPS 8
+#define NAL_UNIT_TYPE_NON_IDR 1
+#define NAL_UNIT_TYPE_IDR     5
+#define NAL_UNIT_TYPE_SEI     6
+#define NAL_UNIT_TYPE_SPS     7
+#define NAL_UNIT_TYPE_PPS     8
+#define NAL_UNIT_TYPE_AUD     9
+
+#define MAX_FRAME_NUM      2
+#define READ_SIZE          1024
+#define INDEX_READ_SIZE    (16 * 1024)
+#define MAX_FILE_PATH_LEN  128
+#define INDEX_FILE_EXT     ".idx"
+#define INDEX_FILE_MAGIC   0x49363248 // "H26I"
+#define INDEX_FILE_VERSION 2
+#define INDEX_IDR_FLAG     0x80000000
+#define INDEX_HASH_SIZE    (4 * 1024)
+
+/**
+ * @brief  Access unit index entry, IDR flag stored in top bit of size
+ */
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+} vid_file_index_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t file_size;
+    uint32_t file_mtime;
+    uint32_t file_hash;
+    uint32_t frame_num;
+} vid_file_index_header_t;
 
-#define MAX_FRAME_SIZE    40 * 1024
-#define MAX_FRAME_NUM     2
-#define READ_SIZE         1024
-#define MAX_FILE_PATH_LEN 128
 typedef struct {
     esp_capture_video_src_if_t base;
     esp_capture_video_info_t   vid_info;
     char                       file_path[MAX_FILE_PATH_LEN];
-    uint8_t                    frame_cache[READ_SIZE];
-    int                        cached_size;
+    bool                       loop;
+    bool                       pace_by_fps;
+    uint8_t                    header[READ_SIZE];
     FILE                      *fp;
+    uint32_t                   file_size;
+    uint32_t                   file_mtime;
+    uint32_t                   file_hash;
+    vid_file_index_t          *index;
+    uint32_t                   frame_num;
+    uint32_t                   max_frame_size;
+    uint32_t                   cur_frame;
+    int32_t                    seek_frame;
+    uint32_t                   sent_frames;
+    uint64_t                   start_time;
+    uint8_t                   *map_data;
     bool                       is_open;
     bool                       is_start;
     bool                       nego_ok;
@@ -206,6 +252,210 @@ static int try_parse_sps(vid_file_src_t *src, uint8_t *data, int size)
     return -1;
 }
 
+static int add_index(vid_file_src_t *src, uint32_t start, uint32_t end, bool idr)
+{
+    if ((src->frame_num & 0xFF) == 0) {
+        vid_file_index_t *index = realloc(src->index, (src->frame_num + 256) * sizeof(vid_file_index_t));
+        if (index == NULL) {
+            return ESP_CAPTURE_ERR_NO_MEM;
+        }
+        src->index = index;
+    }
+    uint32_t size = end - start;
+    src->index[src->frame_num].offset = start;
+    src->index[src->frame_num].size = size | (idr ? INDEX_IDR_FLAG : 0);
+    src->frame_num++;
+    if (size > src->max_frame_size) {
+        src->max_frame_size = size;
+    }
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int build_index(vid_file_src_t *src)
+{
+    uint8_t *buf = malloc(INDEX_READ_SIZE);
+    if (buf == NULL) {
+        return ESP_CAPTURE_ERR_NO_MEM;
+    }
+    // Scan NAL units in big blocks, new access unit starts from first non-VCL NAL or first slice after VCL NAL
+    uint32_t pos = 0, au_start = 0, nal_start = 0;
+    int zeros = 0;
+    int nal_type = -1;
+    bool wait_header = false;
+    bool has_vcl = false, is_idr = false;
+    int ret = ESP_CAPTURE_ERR_OK;
+    fseek(src->fp, 0, SEEK_SET);
+    while (ret == ESP_CAPTURE_ERR_OK) {
+        int size = fread(buf, 1, INDEX_READ_SIZE, src->fp);
+        if (size <= 0) {
+            break;
+        }
+        for (int i = 0; i < size; i++, pos++) {
+            uint8_t c = buf[i];
+            if (wait_header) {
+                wait_header = false;
+                nal_type = c & 0x1F;
+                if (nal_type == NAL_UNIT_TYPE_NON_IDR || nal_type == NAL_UNIT_TYPE_IDR) {
+                    // Need first byte of slice header to check first_mb_in_slice
+                    continue;
+                }
+                if (has_vcl && nal_type >= NAL_UNIT_TYPE_SEI && nal_type <= NAL_UNIT_TYPE_AUD) {
+                    ret = add_index(src, au_start, nal_start, is_idr);
+                    au_start = nal_start;
+                    has_vcl = is_idr = false;
+                }
+                nal_type = -1;
+                continue;
+            }
+            if (nal_type >= 0) {
+                // first_mb_in_slice is 0 means new picture
+                if (has_vcl && (c & 0x80)) {
+                    ret = add_index(src, au_start, nal_start, is_idr);
+                    au_start = nal_start;
+                    is_idr = false;
+                }
+                has_vcl = true;
+                if (nal_type == NAL_UNIT_TYPE_IDR) {
+                    is_idr = true;
+                }
+                nal_type = -1;
+            }
+            if (c == 0) {
+                zeros++;
+            } else {
+                if (c == 1 && zeros >= 2) {
+                    nal_start = pos - (zeros >= 3 ? 3 : 2);
+                    wait_header = true;
+                }
+                zeros = 0;
+            }
+        }
+    }
+    if (ret == ESP_CAPTURE_ERR_OK && has_vcl) {
+        ret = add_index(src, au_start, pos, is_idr);
+    }
+    free(buf);
+    return ret;
+}
+
+static uint32_t hash_file_range(vid_file_src_t *src, uint32_t hash, uint32_t start, uint32_t size)
+{
+    uint8_t buf[256];
+    fseek(src->fp, start, SEEK_SET);
+    while (size) {
+        int n = fread(buf, 1, size < sizeof(buf) ? size : sizeof(buf), src->fp);
+        if (n <= 0) {
+            break;
+        }
+        // FNV-1a
+        for (int i = 0; i < n; i++) {
+            hash = (hash ^ buf[i]) * 16777619;
+        }
+        size -= n;
+    }
+    return hash;
+}
+
+static void get_file_identity(vid_file_src_t *src)
+{
+    struct stat st;
+    src->file_mtime = fstat(fileno(src->fp), &st) == 0 ? (uint32_t)st.st_mtime : 0;
+    // Hash head and tail too, mtime may be unavailable or kept when file is replaced
+    uint32_t head = src->file_size < INDEX_HASH_SIZE ? src->file_size : INDEX_HASH_SIZE;
+    uint32_t tail = src->file_size - head < INDEX_HASH_SIZE ? src->file_size - head : INDEX_HASH_SIZE;
+    uint32_t hash = hash_file_range(src, 2166136261u, 0, head);
+    src->file_hash = hash_file_range(src, hash, src->file_size - tail, tail);
+}
+
+static void get_index_path(vid_file_src_t *src, char *path, int size)
+{
+    snprintf(path, size, "%s%s", src->file_path, INDEX_FILE_EXT);
+}
+
+static int load_index(vid_file_src_t *src)
+{
+    char path[MAX_FILE_PATH_LEN + sizeof(INDEX_FILE_EXT)];
+    get_index_path(src, path, sizeof(path));
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return ESP_CAPTURE_ERR_NOT_FOUND;
+    }
+    int ret = ESP_CAPTURE_ERR_NOT_FOUND;
+    vid_file_index_header_t header = { 0 };
+    do {
+        if (fread(&header, 1, sizeof(header), fp) != sizeof(header)) {
+            break;
+        }
+        // Rebuild index if file is changed
+        if (header.magic != INDEX_FILE_MAGIC || header.version != INDEX_FILE_VERSION || header.file_size != src->file_size
+            || header.file_mtime != src->file_mtime || header.file_hash != src->file_hash || header.frame_num == 0) {
+            break;
+        }
+        src->index = malloc(header.frame_num * sizeof(vid_file_index_t));
+        if (src->index == NULL) {
+            ret = ESP_CAPTURE_ERR_NO_MEM;
+            break;
+        }
+        if (fread(src->index, sizeof(vid_file_index_t), header.frame_num, fp) != header.frame_num) {
+            free(src->index);
+            src->index = NULL;
+            break;
+        }
+        src->frame_num = header.frame_num;
+        for (int i = 0; i < src->frame_num; i++) {
+            uint32_t size = src->index[i].size & ~INDEX_IDR_FLAG;
+            if (size > src->max_frame_size) {
+                src->max_frame_size = size;
+            }
+        }
+        ret = ESP_CAPTURE_ERR_OK;
+    } while (0);
+    fclose(fp);
+    return ret;
+}
+
+static void save_index(vid_file_src_t *src)
+{
+    char path[MAX_FILE_PATH_LEN + sizeof(INDEX_FILE_EXT)];
+    get_index_path(src, path, sizeof(path));
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        ESP_LOGW(TAG, "Fail to create index file %s", path);
+        return;
+    }
+    vid_file_index_header_t header = {
+        .magic = INDEX_FILE_MAGIC,
+        .version = INDEX_FILE_VERSION,
+        .file_size = src->file_size,
+        .file_mtime = src->file_mtime,
+        .file_hash = src->file_hash,
+        .frame_num = src->frame_num,
+    };
+    fwrite(&header, 1, sizeof(header), fp);
+    fwrite(src->index, sizeof(vid_file_index_t), src->frame_num, fp);
+    fclose(fp);
+}
+
+static int prepare_index(vid_file_src_t *src)
+{
+    fseek(src->fp, 0, SEEK_END);
+    src->file_size = (uint32_t)ftell(src->fp);
+    get_file_identity(src);
+    int ret = load_index(src);
+    if (ret == ESP_CAPTURE_ERR_OK) {
+        ESP_LOGI(TAG, "Load index %d frames", (int)src->frame_num);
+        return ret;
+    }
+    ret = build_index(src);
+    if (ret != ESP_CAPTURE_ERR_OK || src->frame_num == 0) {
+        ESP_LOGE(TAG, "Fail to build index");
+        return ESP_CAPTURE_ERR_NOT_FOUND;
+    }
+    ESP_LOGI(TAG, "Build index %d frames max size %d", (int)src->frame_num, (int)src->max_frame_size);
+    save_index(src);
+    return ESP_CAPTURE_ERR_OK;
+}
+
 static int get_vid_info_by_name(vid_file_src_t *src)
 {
     char *ext = strrchr(src->file_path, '.');
@@ -213,12 +463,11 @@ static int get_vid_info_by_name(vid_file_src_t *src)
         return -1;
     }
     if (strcmp(ext, ".h264") == 0) {
-        int ret = fread(src->frame_cache, 1, READ_SIZE, src->fp);
-        if (ret < 0) {
+        int ret = fread(src->header, 1, READ_SIZE, src->fp);
+        if (ret <= 0) {
             return ESP_CAPTURE_ERR_NOT_FOUND;
         }
-        src->cached_size = ret;
-        ret = try_parse_sps(src, src->frame_cache, ret);
+        ret = try_parse_sps(src, src->header, ret);
         if (ret != 0) {
             return ESP_CAPTURE_ERR_NOT_FOUND;
         }
@@ -231,6 +480,12 @@ static int get_vid_info_by_name(vid_file_src_t *src)
 static int vid_file_src_close(esp_capture_video_src_if_t *h)
 {
     vid_file_src_t *src = (vid_file_src_t *)h;
+#if CONFIG_IDF_TARGET_LINUX
+    if (src->map_data) {
+        munmap(src->map_data, src->file_size);
+        src->map_data = NULL;
+    }
+#endif
     if (src->fp != NULL) {
         fclose(src->fp);
         src->fp = NULL;
@@ -239,6 +494,13 @@ static int vid_file_src_close(esp_capture_video_src_if_t *h)
         data_queue_deinit(src->frame_q);
         src->frame_q = NULL;
     }
+    if (src->index) {
+        free(src->index);
+        src->index = NULL;
+    }
+    src->frame_num = 0;
+    src->max_frame_size = 0;
+    src->is_open = false;
     return ESP_CAPTURE_ERR_OK;
 }
 
@@ -250,16 +512,28 @@ static int vid_file_src_open(esp_capture_video_src_if_t *h)
         ESP_LOGE(TAG, "open file failed");
         return ESP_CAPTURE_ERR_NOT_FOUND;
     }
-    src->frame_q = data_queue_init(MAX_FRAME_NUM * MAX_FRAME_SIZE);
-    if (src->frame_q == NULL) {
-        vid_file_src_close(h);
-        return ESP_CAPTURE_ERR_NO_MEM;
-    }
     int ret = get_vid_info_by_name(src);
+    if (ret == ESP_CAPTURE_ERR_OK) {
+        ret = prepare_index(src);
+    }
     if (ret != ESP_CAPTURE_ERR_OK) {
         vid_file_src_close(h);
         return ret;
     }
+#if CONFIG_IDF_TARGET_LINUX
+    // Serve frames from mapped file directly
+    src->map_data = mmap(NULL, src->file_size, PROT_READ, MAP_PRIVATE, fileno(src->fp), 0);
+    if (src->map_data == MAP_FAILED) {
+        src->map_data = NULL;
+    }
+#endif
+    if (src->map_data == NULL) {
+        src->frame_q = data_queue_init(MAX_FRAME_NUM * (src->max_frame_size + 64));
+        if (src->frame_q == NULL) {
+            vid_file_src_close(h);
+            return ESP_CAPTURE_ERR_NO_MEM;
+        }
+    }
     src->is_open = true;
     return 0;
 }
@@ -285,6 +559,7 @@ static int vid_file_src_negotiate_caps(esp_capture_video_src_if_t *h, esp_captur
     }
     *out_caps = src->vid_info;
     out_caps->fps = in_cap->fps;
+    src->vid_info.fps = in_cap->fps;
     src->nego_ok = true;
     return ESP_CAPTURE_ERR_OK;
 }
@@ -295,67 +570,24 @@ static int vid_file_src_start(esp_capture_video_src_if_t *h)
     if (src->nego_ok == false) {
         return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
+    src->cur_frame = 0;
+    src->seek_frame = -1;
+    src->sent_frames = 0;
+    src->start_time = esp_timer_get_time();
     src->is_start = true;
     return ESP_CAPTURE_ERR_OK;
 }
 
-static int read_h264_frame(vid_file_src_t *src, uint8_t *data, int size)
+static void pace_frame(vid_file_src_t *src)
 {
-    // Find frame in cache
-    int fill = 0;
-    bool find_frame = false;
-    bool use_cache = false;
-    if (src->cached_size) {
-        memcpy(data, src->frame_cache, src->cached_size);
-        fill = src->cached_size;
-        src->cached_size = 0;
-        use_cache = true;
-    }
-    while (fill + READ_SIZE < size) {
-        int ret = 0;
-        int last;
-        if (use_cache == false) {
-            ret = fread(data + fill, 1, READ_SIZE, src->fp);
-            if (ret < 0) {
-                return -1;
-            }
-            last = fill > 5 ? fill - 5 : 0;
-        } else {
-            last = 0;
-        }
-        fill += ret;
-        for (int i = last; i < fill - 5; i++) {
-            int start_code_len = is_start_code(src, data + i);
-            if (start_code_len == 0) {
-                continue;
-            }
-            // Already find a frame
-            if (find_frame) {
-                // Reach file end
-                if (use_cache == false && ret < READ_SIZE) {
-                    return fill;
-                }
-                // Copy left buffer into cache
-                memcpy(src->frame_cache, data + i, fill - i);
-                src->cached_size = fill - i;
-                return i;
-            }
-            uint8_t nal_type = data[i + start_code_len] & 0x1F;
-            // Find IDR or non-IDR frame
-            if (nal_type == 5 || nal_type == 1) {
-                find_frame = true;
-            }
-            i += start_code_len;
-        }
-        if (use_cache) {
-            use_cache = false;
-            continue;
-        }
-        if (ret < READ_SIZE) {
-            break;
-        }
+    if (src->pace_by_fps == false || src->vid_info.fps == 0) {
+        return;
+    }
+    uint64_t expect = src->start_time + (uint64_t)src->sent_frames * 1000000 / src->vid_info.fps;
+    uint64_t cur = esp_timer_get_time();
+    if (expect > cur) {
+        media_lib_thread_sleep((uint32_t)((expect - cur) / 1000));
     }
-    return -1;
 }
 
 static int vid_file_src_acquire_frame(esp_capture_video_src_if_t *h, esp_capture_stream_frame_t *frame)
@@ -364,18 +596,38 @@ static int vid_file_src_acquire_frame(esp_capture_video_src_if_t *h, esp_capture
     if (src->is_start == false) {
         return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
-    uint8_t *data = data_queue_get_buffer(src->frame_q, MAX_FRAME_SIZE);
-    if (data) {
-        int ret = read_h264_frame(src, data, MAX_FRAME_SIZE);
-        if (ret > 0) {
-            frame->data = data;
-            frame->size = ret;
-            data_queue_send_buffer(src->frame_q, ret);
-            return ESP_CAPTURE_ERR_OK;
+    if (src->seek_frame >= 0) {
+        src->cur_frame = (uint32_t)src->seek_frame;
+        src->seek_frame = -1;
+    }
+    if (src->cur_frame >= src->frame_num) {
+        if (src->loop == false) {
+            return ESP_CAPTURE_ERR_NOT_FOUND;
+        }
+        src->cur_frame = 0;
+    }
+    vid_file_index_t *index = &src->index[src->cur_frame];
+    uint32_t size = index->size & ~INDEX_IDR_FLAG;
+    pace_frame(src);
+    if (src->map_data) {
+        frame->data = src->map_data + index->offset;
+    } else {
+        uint8_t *data = data_queue_get_buffer(src->frame_q, size);
+        if (data == NULL) {
+            return ESP_CAPTURE_ERR_NOT_FOUND;
+        }
+        fseek(src->fp, index->offset, SEEK_SET);
+        if (fread(data, 1, size, src->fp) != size) {
+            data_queue_send_buffer(src->frame_q, 0);
+            return ESP_CAPTURE_ERR_NOT_FOUND;
         }
-        data_queue_send_buffer(src->frame_q, 0);
+        data_queue_send_buffer(src->frame_q, size);
+        frame->data = data;
     }
-    return ESP_CAPTURE_ERR_NOT_FOUND;
+    frame->size = size;
+    src->cur_frame++;
+    src->sent_frames++;
+    return ESP_CAPTURE_ERR_OK;
 }
 
 static int vid_file_src_release_frame(esp_capture_video_src_if_t *h, esp_capture_stream_frame_t *frame)
@@ -384,30 +636,55 @@ static int vid_file_src_release_frame(esp_capture_video_src_if_t *h, esp_capture
     if (src->is_start == false) {
         return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
-    void *data = NULL;
-    int size = 0;
-    data_queue_read_lock(src->frame_q, &data, &size);
-    data_queue_read_unlock(src->frame_q);
+    if (src->frame_q) {
+        void *data = NULL;
+        int size = 0;
+        data_queue_read_lock(src->frame_q, &data, &size);
+        data_queue_read_unlock(src->frame_q);
+    }
     return ESP_CAPTURE_ERR_OK;
 }
 
 static int vid_file_src_stop(esp_capture_video_src_if_t *h)
 {
     vid_file_src_t *src = (vid_file_src_t *)h;
-    if (src->fp) {
-        fseek(src->fp, 0, SEEK_SET);
-    }
+    src->cur_frame = 0;
     src->is_start = false;
     return ESP_CAPTURE_ERR_OK;
 }
 
-esp_capture_video_src_if_t *esp_capture_new_video_file_src(const char *file_name)
+int esp_capture_video_file_src_seek(esp_capture_video_src_if_t *h, uint32_t pts)
+{
+    vid_file_src_t *src = (vid_file_src_t *)h;
+    if (src == NULL || src->is_open == false) {
+        return ESP_CAPTURE_ERR_INVALID_STATE;
+    }
+    uint32_t fps = src->vid_info.fps ? src->vid_info.fps : 1;
+    uint32_t frame = (uint32_t)((uint64_t)pts * fps / 1000);
+    if (frame >= src->frame_num) {
+        frame = src->frame_num - 1;
+    }
+    // Seek to nearest IDR before target frame
+    while (frame > 0 && (src->index[frame].size & INDEX_IDR_FLAG) == 0) {
+        frame--;
+    }
+    src->seek_frame = (int32_t)frame;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+esp_capture_video_src_if_t *esp_capture_new_video_file_src(esp_capture_video_file_src_cfg_t *cfg)
 {
+    if (cfg == NULL || cfg->file_name == NULL) {
+        return NULL;
+    }
     vid_file_src_t *src = (vid_file_src_t *)calloc(1, sizeof(vid_file_src_t));
     if (src == NULL) {
         return NULL;
     }
-    strncpy(src->file_path, file_name, sizeof(src->file_path) - 1);
+    strncpy(src->file_path, cfg->file_name, sizeof(src->file_path) - 1);
+    src->loop = cfg->loop;
+    src->pace_by_fps = cfg->pace_by_fps;
+    src->seek_frame = -1;
     src->base.open = vid_file_src_open;
     src->base.get_support_codecs = vid_file_src_get_support_codecs;
     src->base.negotiate_caps = vid_file_src_negotiate_caps;
@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include "esp_capture_path_simple.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "media_lib_os.h"
 #include "data_queue.h"
 
@@ -34,8 +35,26 @@
 #define CAPTURE_AENC_EXITED (1)
 #define CAPTURE_VENC_EXITED (2)
 
-#define VIDEO_ENC_OUT_ALIGNMENT (128)
-#define ALIGN_UP(size, align)   (((size) + (align)-1) & ~((align)-1))
+#define VIDEO_ENC_OUT_ALIGNMENT    (128)
+#define VIDEO_ENC_OUT_RESERVE_SIZE (256)
+#define ALIGN_UP(size, align)      (((size) + (align)-1) & ~((align)-1))
+
+#define VIDEO_STAGE_REPORT_INTERVAL (5000000)
+
+// Keep secondary frames held by user less than capture share queue depth so that primary never blocks on it
+#define SECONDARY_MAX_QUEUED_FRAMES (3)
+
+/**
+ * @brief  Time spent by video encoder thread in each pipeline stage (unit us)
+ *         Source wait high means source is the bottleneck, output wait high means consumer is slow
+ */
+typedef struct {
+    uint64_t start_time;
+    uint32_t frames;
+    uint64_t src_wait;
+    uint64_t encode;
+    uint64_t out_wait;
+} video_stage_stats_t;
 
 typedef struct {
     bool                         added;
@@ -51,6 +70,10 @@ typedef struct {
     data_queue_t                *video_q;
     int                          audio_frame_size;
     int                          video_frame_size;
+    int                          video_max_frame_size;
+    int                          video_bitrate;
+    bool                         key_frame_req;
+    esp_capture_venc_if_t       *venc;
     media_lib_event_grp_handle_t event_group;
 } simple_capture_res_t;
 
@@ -61,6 +84,13 @@ typedef struct {
     esp_capture_audio_info_t      aud_info;
     esp_capture_audio_info_t      vid_info;
     simple_capture_res_t          primary;
+    simple_capture_res_t          secondary;
+    media_lib_mutex_handle_t      secondary_lock;  // Protect secondary encoder used by video encoder thread
+    uint8_t                      *scaled_data;     // Source frame downscaled for secondary encoder
+    int                           scaled_size;
+    bool                          scaled_ready;
+    bool                          secondary_error;
+    uint32_t                      secondary_pts;   // Source frame pts from which secondary encodes next frame
 } simple_capture_t;
 
 int simple_capture_open(esp_capture_path_if_t *h, esp_capture_path_cfg_t *cfg)
@@ -167,9 +197,79 @@ static bool check_video_codec_support(simple_capture_t *capture, esp_capture_ven
     return false;
 }
 
+static int get_raw_frame_size(esp_capture_codec_type_t codec, int width, int height)
+{
+    switch (codec) {
+        case ESP_CAPTURE_CODEC_TYPE_RGB565:
+            return width * height * 2;
+        case ESP_CAPTURE_CODEC_TYPE_YUV420:
+        case ESP_CAPTURE_CODEC_TYPE_YUV420P:
+            return width * height * 3 / 2;
+        default:
+            return 0;
+    }
+}
+
+static bool check_secondary_support(simple_capture_t *capture, esp_capture_video_info_t *video_info)
+{
+    // Secondary encoder takes downscaled primary source frame, source is not negotiated again
+    simple_capture_res_t *primary = &capture->primary;
+    esp_capture_video_info_t *src_info = &primary->sink.video_info;
+    esp_capture_venc_if_t *venc = capture->enc_cfg.secondary_venc;
+    if (primary->added == false || src_info->codec == ESP_CAPTURE_CODEC_TYPE_NONE || primary->venc_bypass) {
+        ESP_LOGE(TAG, "Secondary path need primary path encoding video");
+        return false;
+    }
+    if (get_raw_frame_size(primary->video_src_codec, 2, 2) == 0) {
+        ESP_LOGE(TAG, "Not support downscale source codec %d", primary->video_src_codec);
+        return false;
+    }
+    if (video_info->width == 0 || video_info->height == 0 || video_info->width > src_info->width ||
+        video_info->height > src_info->height || (video_info->width & 1) || (video_info->height & 1)) {
+        ESP_LOGE(TAG, "Secondary resolution %dx%d not supported", (int)video_info->width, (int)video_info->height);
+        return false;
+    }
+    const esp_capture_codec_type_t *codecs = NULL;
+    uint8_t num = 0;
+    venc->get_input_codecs(venc, video_info->codec, &codecs, &num);
+    for (int i = 0; i < num; i++) {
+        if (codecs[i] == primary->video_src_codec) {
+            return true;
+        }
+    }
+    ESP_LOGE(TAG, "Secondary encoder not support codec %d from %d", video_info->codec, primary->video_src_codec);
+    return false;
+}
+
+static int simple_capture_add_secondary(simple_capture_t *capture, esp_capture_sink_cfg_t *sink)
+{
+    simple_capture_res_t *res = &capture->secondary;
+    if (capture->enc_cfg.secondary_venc == NULL || capture->enc_cfg.secondary_venc == capture->enc_cfg.venc || sink->audio_info.codec || sink->video_info.codec == ESP_CAPTURE_CODEC_TYPE_NONE) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    if (res->started) {
+        return ESP_CAPTURE_ERR_INVALID_STATE;
+    }
+    if (check_secondary_support(capture, &sink->video_info) == false) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    if (capture->secondary_lock == NULL) {
+        media_lib_mutex_create(&capture->secondary_lock);
+        if (capture->secondary_lock == NULL) {
+            return ESP_CAPTURE_ERR_NO_MEM;
+        }
+    }
+    res->sink = *sink;
+    res->added = true;
+    return ESP_CAPTURE_ERR_OK;
+}
+
 int simple_capture_add_path(esp_capture_path_if_t *p, esp_capture_path_type_t path, esp_capture_sink_cfg_t *sink)
 {
     simple_capture_t *capture = (simple_capture_t *)p;
+    if (path == ESP_CAPTURE_PATH_SECONDARY) {
+        return simple_capture_add_secondary(capture, sink);
+    }
     if (path != ESP_CAPTURE_PATH_PRIMARY) {
         return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
@@ -292,18 +392,273 @@ static void simple_capture_aenc_thread(void *arg)
     media_lib_thread_destroy(NULL);
 }
 
+static bool grow_video_frame_size(simple_capture_res_t *res)
+{
+    // Keep space for frame header and alignment so that grown frame still fits into fifo
+    int max_size = res->video_q->size - VIDEO_ENC_OUT_RESERVE_SIZE;
+    if (res->video_max_frame_size && res->video_max_frame_size < max_size) {
+        max_size = res->video_max_frame_size;
+    }
+    if (res->video_frame_size >= max_size) {
+        return false;
+    }
+    int size = ALIGN_UP(res->video_frame_size * 2, VIDEO_ENC_OUT_ALIGNMENT);
+    res->video_frame_size = size > max_size ? max_size : size;
+    ESP_LOGI(TAG, "Grow video output frame size to %d", res->video_frame_size);
+    return true;
+}
+
+static int restart_video_encoder(simple_capture_res_t *res)
+{
+    // Encoder API has no IDR request, a reopened encoder always starts with key frame
+    esp_capture_venc_if_t *venc = res->venc;
+    venc->stop(venc);
+    int ret = venc->start(venc, res->video_src_codec, &res->sink.video_info);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGE(TAG, "Fail to restart video encoder ret %d", ret);
+        return ret;
+    }
+    if (res->video_bitrate) {
+        venc->set_bitrate(venc, res->video_bitrate);
+    }
+    ESP_LOGI(TAG, "Video encoder restarted for key frame");
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static void report_video_stage(video_stage_stats_t *stats, uint64_t cur_time)
+{
+    stats->frames++;
+    uint64_t elapse = cur_time - stats->start_time;
+    if (elapse < VIDEO_STAGE_REPORT_INTERVAL) {
+        return;
+    }
+    ESP_LOGI(TAG, "Video fps:%d source wait:%d%% encode:%d%% output wait:%d%%",
+             (int)(stats->frames * 1000000 / elapse), (int)(stats->src_wait * 100 / elapse),
+             (int)(stats->encode * 100 / elapse), (int)(stats->out_wait * 100 / elapse));
+    memset(stats, 0, sizeof(video_stage_stats_t));
+    stats->start_time = cur_time;
+}
+
+static int encode_video_frame(simple_capture_res_t *res, esp_capture_stream_frame_t *frame, esp_capture_stream_frame_t *out_frame,
+                              video_stage_stats_t *stats, bool no_wait, uint8_t **out_data)
+{
+    // Reserve estimated frame size, only actual encoded size is committed into queue
+    uint8_t *data = NULL;
+    int ret = ESP_CAPTURE_ERR_OK;
+    while (res->video_enabled) {
+        int size = sizeof(esp_capture_stream_frame_t) + res->video_frame_size + VIDEO_ENC_OUT_ALIGNMENT;
+        if (no_wait && data_queue_get_available(res->video_q) < size) {
+            break;
+        }
+        uint64_t stage_start = esp_timer_get_time();
+        data = data_queue_get_buffer(res->video_q, size);
+        uint64_t stage_end = esp_timer_get_time();
+        stats->out_wait += stage_end - stage_start;
+        if (data == NULL) {
+            break;
+        }
+        out_frame->pts = frame->pts;
+        out_frame->data = data + sizeof(esp_capture_stream_frame_t);
+        // Align frame
+        out_frame->data = (uint8_t *)ALIGN_UP((uintptr_t)out_frame->data, VIDEO_ENC_OUT_ALIGNMENT);
+        out_frame->size = res->video_frame_size;
+        memcpy(data, out_frame, sizeof(esp_capture_stream_frame_t));
+        if (frame->size) {
+            ret = res->venc->encode_frame(res->venc, frame, out_frame);
+        } else {
+            out_frame->size = 0;
+        }
+        stats->encode += esp_timer_get_time() - stage_end;
+        if (ret != ESP_CAPTURE_ERR_NOT_ENOUGH) {
+            break;
+        }
+        data_queue_send_buffer(res->video_q, 0);
+        data = NULL;
+        if (grow_video_frame_size(res) == false) {
+            break;
+        }
+    }
+    *out_data = data;
+    return ret;
+}
+
+static void scale_video_plane(const uint8_t *src, int src_w, int src_h, uint8_t *dst, int dst_w, int dst_h, int pixel_size)
+{
+    uint32_t x_step = ((uint32_t)src_w << 16) / dst_w;
+    for (int y = 0; y < dst_h; y++) {
+        const uint8_t *src_line = src + (y * src_h / dst_h) * src_w * pixel_size;
+        uint32_t x_pos = 0;
+        if (pixel_size == 2) {
+            const uint16_t *s = (const uint16_t *)src_line;
+            uint16_t *d = (uint16_t *)dst;
+            for (int x = 0; x < dst_w; x++) {
+                d[x] = s[x_pos >> 16];
+                x_pos += x_step;
+            }
+        } else {
+            for (int x = 0; x < dst_w; x++) {
+                dst[x] = src_line[x_pos >> 16];
+                x_pos += x_step;
+            }
+        }
+        dst += dst_w * pixel_size;
+    }
+}
+
+static void scale_packed_yuv420(const uint8_t *src, int src_w, int src_h, uint8_t *dst, int dst_w, int dst_h)
+{
+    // Lines alternate between U Y Y and V Y Y for each 2 pixels, keep line parity so that chroma type matches
+    int src_stride = src_w * 3 / 2;
+    uint32_t x_step = ((uint32_t)src_w << 16) / dst_w;
+    for (int y = 0; y < dst_h; y++) {
+        const uint8_t *s = src + (((y * src_h / dst_h) & ~1) | (y & 1)) * src_stride;
+        uint32_t x_pos = 0;
+        for (int x = 0; x < dst_w; x += 2) {
+            int x0 = x_pos >> 16;
+            int x1 = (x_pos + x_step) >> 16;
+            x_pos += x_step * 2;
+            dst[0] = s[x0 / 2 * 3];
+            dst[1] = s[x0 / 2 * 3 + 1 + (x0 & 1)];
+            dst[2] = s[x1 / 2 * 3 + 1 + (x1 & 1)];
+            dst += 3;
+        }
+    }
+}
+
+static void scale_video_frame(esp_capture_codec_type_t codec, const uint8_t *src, int src_w, int src_h,
+                              uint8_t *dst, int dst_w, int dst_h)
+{
+    // Nearest neighbor downscale, cheap enough to run in video encoder thread
+    if (codec == ESP_CAPTURE_CODEC_TYPE_RGB565) {
+        scale_video_plane(src, src_w, src_h, dst, dst_w, dst_h, 2);
+        return;
+    }
+#if !CONFIG_IDF_TARGET_ESP32S3
+    if (codec == ESP_CAPTURE_CODEC_TYPE_YUV420) {
+        scale_packed_yuv420(src, src_w, src_h, dst, dst_w, dst_h);
+        return;
+    }
+#endif
+    // Planar YUV420: Y plane followed by quarter size U and V planes
+    scale_video_plane(src, src_w, src_h, dst, dst_w, dst_h, 1);
+    src += src_w * src_h;
+    dst += dst_w * dst_h;
+    for (int i = 0; i < 2; i++) {
+        scale_video_plane(src, src_w / 2, src_h / 2, dst, dst_w / 2, dst_h / 2, 1);
+        src += src_w * src_h / 4;
+        dst += dst_w * dst_h / 4;
+    }
+}
+
+static void prepare_secondary_frame(simple_capture_t *capture, esp_capture_stream_frame_t *frame)
+{
+    simple_capture_res_t *res = &capture->secondary;
+    esp_capture_video_info_t *src_info = &capture->primary.sink.video_info;
+    esp_capture_video_info_t *dst_info = &res->sink.video_info;
+    if (res->video_enabled == false || frame->size == 0) {
+        return;
+    }
+    media_lib_mutex_lock(capture->secondary_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    do {
+        capture->scaled_ready = false;
+        if (res->video_enabled == false || capture->secondary_error) {
+            break;
+        }
+        // Follow secondary fps by source pts, tolerate half source frame interval jitter
+        if (dst_info->fps && dst_info->fps < src_info->fps) {
+            uint32_t tolerance = src_info->fps ? 500 / src_info->fps : 0;
+            if (frame->pts + tolerance < capture->secondary_pts) {
+                break;
+            }
+            capture->secondary_pts += 1000 / dst_info->fps;
+            if (capture->secondary_pts + tolerance <= frame->pts) {
+                capture->secondary_pts = frame->pts + 1000 / dst_info->fps;
+            }
+        }
+        // Skip frame before encoding when consumer is slow, skipped frame is never referenced
+        int q_num = 0, q_size = 0;
+        data_queue_query(res->video_q, &q_num, &q_size);
+        int size = sizeof(esp_capture_stream_frame_t) + res->video_frame_size + VIDEO_ENC_OUT_ALIGNMENT;
+        if (q_num >= SECONDARY_MAX_QUEUED_FRAMES || data_queue_get_available(res->video_q) < size) {
+            break;
+        }
+        if (frame->size < get_raw_frame_size(res->video_src_codec, src_info->width, src_info->height)) {
+            ESP_LOGW(TAG, "Source frame size %d too small to downscale", (int)frame->size);
+            break;
+        }
+        scale_video_frame(res->video_src_codec, frame->data, src_info->width, src_info->height,
+                          capture->scaled_data, dst_info->width, dst_info->height);
+        capture->scaled_ready = true;
+    } while (0);
+    media_lib_mutex_unlock(capture->secondary_lock);
+}
+
+static void encode_secondary_frame(simple_capture_t *capture, uint32_t pts, bool stop, video_stage_stats_t *stats)
+{
+    simple_capture_res_t *res = &capture->secondary;
+    esp_capture_stream_frame_t out_frame = {};
+    out_frame.stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO;
+    uint8_t *data = NULL;
+    int ret = ESP_CAPTURE_ERR_OK;
+    if (res->video_enabled == false) {
+        return;
+    }
+    media_lib_mutex_lock(capture->secondary_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (res->video_enabled == false || capture->secondary_error || (stop == false && capture->scaled_ready == false)) {
+        media_lib_mutex_unlock(capture->secondary_lock);
+        return;
+    }
+    // Stop frame is passed with no data so that secondary user quits also
+    esp_capture_stream_frame_t frame = {
+        .stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO,
+        .pts = pts,
+        .data = stop ? NULL : capture->scaled_data,
+        .size = stop ? 0 : capture->scaled_size,
+    };
+    capture->scaled_ready = false;
+    if (res->key_frame_req && frame.size) {
+        res->key_frame_req = false;
+        ret = restart_video_encoder(res);
+    }
+    if (ret == ESP_CAPTURE_ERR_OK) {
+        ret = encode_video_frame(res, &frame, &out_frame, stats, true, &data);
+    }
+    if (data) {
+        int size = ret == ESP_CAPTURE_ERR_OK ? (int)(intptr_t)(out_frame.data - (uint8_t *)data) + out_frame.size : 0;
+        data_queue_send_buffer(res->video_q, size);
+    }
+    if (ret != ESP_CAPTURE_ERR_OK && ret != ESP_CAPTURE_ERR_NOT_ENOUGH) {
+        capture->secondary_error = true;
+    }
+    media_lib_mutex_unlock(capture->secondary_lock);
+    if (capture->secondary_error) {
+        // Primary keeps running when secondary encoder fails
+        ESP_LOGE(TAG, "Fail to encode secondary video frame ret %d", ret);
+        capture->src_cfg.event_cb(capture->src_cfg.src_ctx, ESP_CAPTURE_PATH_SECONDARY, ESP_CAPTURE_PATH_EVENT_VIDEO_ERROR);
+        return;
+    }
+    if (data && ret == ESP_CAPTURE_ERR_OK) {
+        capture->src_cfg.frame_processed(capture->src_cfg.src_ctx, ESP_CAPTURE_PATH_SECONDARY, &out_frame);
+    }
+}
+
 static void simple_capture_venc_thread(void *arg)
 {
     simple_capture_t *capture = (simple_capture_t *)arg;
     simple_capture_res_t *res = &capture->primary;
     esp_capture_stream_frame_t out_frame = {};
     out_frame.stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO;
+    video_stage_stats_t stats = {
+        .start_time = esp_timer_get_time(),
+    };
     ESP_LOGI(TAG, "Enter video encoder thread");
     while (res->video_enabled) {
         // grab data from src
         esp_capture_stream_frame_t frame;
         frame.stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO;
+        uint64_t stage_start = esp_timer_get_time();
         int ret = capture->src_cfg.acquire_src_frame(capture->src_cfg.src_ctx, &frame, false);
+        stats.src_wait += esp_timer_get_time() - stage_start;
         if (ret != ESP_CAPTURE_ERR_OK) {
             ESP_LOGE(TAG, "Fail to acquire video frame ret %d", ret);
             break;
@@ -320,44 +675,44 @@ static void simple_capture_venc_thread(void *arg)
             }
             continue;
         }
-        // Get data for output
-        int size = sizeof(esp_capture_stream_frame_t) + res->video_frame_size + VIDEO_ENC_OUT_ALIGNMENT;
-        uint8_t *data = data_queue_get_buffer(res->video_q, size);
+        if (res->key_frame_req) {
+            res->key_frame_req = false;
+            if (restart_video_encoder(res) != ESP_CAPTURE_ERR_OK) {
+                capture->src_cfg.release_src_frame(capture->src_cfg.src_ctx, &frame);
+                capture->src_cfg.event_cb(capture->src_cfg.src_ctx, ESP_CAPTURE_PATH_PRIMARY, ESP_CAPTURE_PATH_EVENT_VIDEO_ERROR);
+                break;
+            }
+        }
+        uint8_t *data = NULL;
+        ret = encode_video_frame(res, &frame, &out_frame, &stats, false, &data);
+        // Downscale before source frame is released, secondary is encoded after primary frame is sent
+        prepare_secondary_frame(capture, &frame);
+        capture->src_cfg.release_src_frame(capture->src_cfg.src_ctx, &frame);
+        if (ret == ESP_CAPTURE_ERR_NOT_ENOUGH) {
+            ESP_LOGW(TAG, "Bad input maybe skipped size %d", (int)res->video_frame_size);
+            continue;
+        }
         if (data == NULL) {
             ESP_LOGE(TAG, "Fail to get video fifo buffer");
-            capture->src_cfg.release_src_frame(capture->src_cfg.src_ctx, &frame);
             break;
         }
-        out_frame.pts = frame.pts;
-        out_frame.data = data + sizeof(esp_capture_stream_frame_t);
-        // Align frame
-        out_frame.data = (uint8_t *)ALIGN_UP((uintptr_t)out_frame.data, VIDEO_ENC_OUT_ALIGNMENT);
-        out_frame.size = res->video_frame_size;
-        memcpy(data, &out_frame, sizeof(esp_capture_stream_frame_t));
-        if (frame.size) {
-            ret = capture->enc_cfg.venc->encode_frame(capture->enc_cfg.venc, &frame, &out_frame);
-        } else {
-            out_frame.size = 0;
-        }
-        capture->src_cfg.release_src_frame(capture->src_cfg.src_ctx, &frame);
         if (ret != ESP_CAPTURE_ERR_OK) {
-            if (ret == ESP_CAPTURE_ERR_NOT_ENOUGH) {
-                ESP_LOGW(TAG, "Bad input maybe skipped size %d", (int)res->video_frame_size);
-                continue;
-            }
             ESP_LOGE(TAG, "Fail to encode video frame");
             data_queue_send_buffer(res->video_q, 0);
             capture->src_cfg.event_cb(capture->src_cfg.src_ctx, ESP_CAPTURE_PATH_PRIMARY, ESP_CAPTURE_PATH_EVENT_VIDEO_ERROR);
             break;
         }
-        size = (int)(intptr_t)(out_frame.data - (uint8_t *)data) + out_frame.size;
+        int size = (int)(intptr_t)(out_frame.data - (uint8_t *)data) + out_frame.size;
         data_queue_send_buffer(res->video_q, size);
+        report_video_stage(&stats, esp_timer_get_time());
         // Notify to use audio encoded frame
         capture->src_cfg.frame_processed(capture->src_cfg.src_ctx, ESP_CAPTURE_PATH_PRIMARY, &out_frame);
         if (frame.data == NULL && frame.size == 0) {
             ESP_LOGI(TAG, "Stop frame is received");
+            encode_secondary_frame(capture, frame.pts, true, &stats);
             break;
         }
+        encode_secondary_frame(capture, frame.pts, false, &stats);
     }
     ESP_LOGI(TAG, "Video encoder thread exit");
     media_lib_event_group_set_bits(res->event_group, CAPTURE_VENC_EXITED);
@@ -419,7 +774,7 @@ static int simple_capture_enable_video(simple_capture_t *capture, bool enable)
     if (res->sink.video_info.codec == ESP_CAPTURE_CODEC_TYPE_NONE) {
         return ESP_CAPTURE_ERR_OK;
     }
-    esp_capture_venc_if_t *venc = capture->enc_cfg.venc;
+    esp_capture_venc_if_t *venc = res->venc;
     if (enable == false) {
         if (res->video_enabled) {
             ESP_LOGI(TAG, "Start to disable video");
@@ -442,8 +797,9 @@ static int simple_capture_enable_video(simple_capture_t *capture, bool enable)
         int in_frame_size = 0, out_frame_size = 0;
         venc->get_frame_size(venc, &in_frame_size, &out_frame_size);
         res->video_frame_size = out_frame_size;
+        res->video_max_frame_size = in_frame_size;
         int frame_count = capture->enc_cfg.venc_frame_count ? capture->enc_cfg.venc_frame_count : 2;
-        int fifo_size = frame_count * (out_frame_size + 256);
+        int fifo_size = frame_count * (out_frame_size + VIDEO_ENC_OUT_RESERVE_SIZE);
         if (res->video_q == NULL) {
             res->video_q = data_queue_init(fifo_size);
         }
@@ -462,13 +818,75 @@ static int simple_capture_enable_video(simple_capture_t *capture, bool enable)
     return ret;
 }
 
+static int simple_capture_enable_secondary(simple_capture_t *capture, bool enable)
+{
+    simple_capture_res_t *res = &capture->secondary;
+    esp_capture_venc_if_t *venc = res->venc;
+    if (enable == false) {
+        if (res->video_enabled) {
+            // Wait for video encoder thread to leave secondary encoder
+            media_lib_mutex_lock(capture->secondary_lock, MEDIA_LIB_MAX_LOCK_TIME);
+            res->video_enabled = false;
+            media_lib_mutex_unlock(capture->secondary_lock);
+            data_queue_consume_all(res->video_q);
+            venc->stop(venc);
+        }
+        return ESP_CAPTURE_ERR_OK;
+    }
+    // Fed with downscaled primary source frame
+    esp_capture_video_info_t *info = &res->sink.video_info;
+    res->video_src_codec = capture->primary.video_src_codec;
+    int size = get_raw_frame_size(res->video_src_codec, info->width, info->height);
+    if (size == 0) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    if (capture->scaled_size < size) {
+        media_lib_free(capture->scaled_data);
+        capture->scaled_data = media_lib_malloc(size);
+        if (capture->scaled_data == NULL) {
+            capture->scaled_size = 0;
+            return ESP_CAPTURE_ERR_NO_MEM;
+        }
+    }
+    capture->scaled_size = size;
+    int ret = venc->start(venc, res->video_src_codec, info);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGE(TAG, "Fail to start secondary video encoder");
+        return ret;
+    }
+    if (res->video_bitrate) {
+        venc->set_bitrate(venc, res->video_bitrate);
+    }
+    int in_frame_size = 0, out_frame_size = 0;
+    venc->get_frame_size(venc, &in_frame_size, &out_frame_size);
+    res->video_frame_size = out_frame_size;
+    res->video_max_frame_size = in_frame_size;
+    int frame_count = capture->enc_cfg.venc_frame_count ? capture->enc_cfg.venc_frame_count : 2;
+    if (res->video_q == NULL) {
+        res->video_q = data_queue_init(frame_count * (out_frame_size + VIDEO_ENC_OUT_RESERVE_SIZE));
+    }
+    if (res->video_q == NULL) {
+        ESP_LOGE(TAG, "Fail to init secondary video fifo");
+        venc->stop(venc);
+        return ESP_CAPTURE_ERR_NO_MEM;
+    }
+    media_lib_mutex_lock(capture->secondary_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    capture->secondary_error = false;
+    capture->scaled_ready = false;
+    capture->secondary_pts = 0;
+    res->key_frame_req = false;
+    res->video_enabled = true;
+    media_lib_mutex_unlock(capture->secondary_lock);
+    return ESP_CAPTURE_ERR_OK;
+}
+
 int simple_capture_enable_path(esp_capture_path_if_t *p, esp_capture_path_type_t path, bool enable)
 {
     simple_capture_t *capture = (simple_capture_t *)p;
-    if (path != ESP_CAPTURE_PATH_PRIMARY) {
+    if (path != ESP_CAPTURE_PATH_PRIMARY && path != ESP_CAPTURE_PATH_SECONDARY) {
         return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
-    simple_capture_res_t *res = &capture->primary;
+    simple_capture_res_t *res = path == ESP_CAPTURE_PATH_PRIMARY ? &capture->primary : &capture->secondary;
     if (res->enable == enable) {
         return ESP_CAPTURE_ERR_OK;
     }
@@ -478,6 +896,16 @@ int simple_capture_enable_path(esp_capture_path_if_t *p, esp_capture_path_type_t
     }
     res->enable = enable;
     int ret = ESP_CAPTURE_ERR_OK;
+    if (path == ESP_CAPTURE_PATH_SECONDARY) {
+        // Secondary frames are produced only while primary video encoder thread runs
+        if (res->started) {
+            ret = simple_capture_enable_secondary(capture, enable);
+            if (ret != ESP_CAPTURE_ERR_OK) {
+                capture->src_cfg.event_cb(capture->src_cfg.src_ctx, ESP_CAPTURE_PATH_SECONDARY, ESP_CAPTURE_PATH_EVENT_VIDEO_ERROR);
+            }
+        }
+        return ret;
+    }
     if (res->started) {
         ret = simple_capture_enable_audio(capture, enable);
         if (ret != ESP_CAPTURE_ERR_OK) {
@@ -503,6 +931,14 @@ int simple_capture_start(esp_capture_path_if_t *p)
     }
     int ret = ESP_CAPTURE_ERR_OK;
     res->started = true;
+    // Secondary is ready before video encoder thread starts
+    simple_capture_res_t *secondary = &capture->secondary;
+    if (secondary->added) {
+        secondary->started = true;
+        if (secondary->enable && simple_capture_enable_secondary(capture, true) != ESP_CAPTURE_ERR_OK) {
+            capture->src_cfg.event_cb(capture->src_cfg.src_ctx, ESP_CAPTURE_PATH_SECONDARY, ESP_CAPTURE_PATH_EVENT_VIDEO_ERROR);
+        }
+    }
     if (res->enable) {
         ret = simple_capture_enable_audio(capture, true);
         if (ret != ESP_CAPTURE_ERR_OK) {
@@ -519,21 +955,32 @@ int simple_capture_start(esp_capture_path_if_t *p)
 int simple_capture_set(esp_capture_path_if_t *p, esp_capture_path_type_t path, esp_capture_path_set_type_t type, void *cfg, int cfg_size)
 {
     simple_capture_t *capture = (simple_capture_t *)p;
-    simple_capture_res_t *res = &capture->primary;
+    if (path != ESP_CAPTURE_PATH_PRIMARY && path != ESP_CAPTURE_PATH_SECONDARY) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    simple_capture_res_t *res = path == ESP_CAPTURE_PATH_PRIMARY ? &capture->primary : &capture->secondary;
     int ret = ESP_CAPTURE_ERR_OK;
     switch (type) {
         case ESP_CAPTURE_PATH_SET_TYPE_AUDIO_BITRATE:
-            if (res->aenc_bypass == false && capture->enc_cfg.aenc != NULL && cfg_size == sizeof(int)) {
+            if (res->sink.audio_info.codec && res->aenc_bypass == false && capture->enc_cfg.aenc != NULL && cfg_size == sizeof(int)) {
                 ret = capture->enc_cfg.aenc->set_bitrate(capture->enc_cfg.aenc, *(int *)cfg);
             }
             break;
         case ESP_CAPTURE_PATH_SET_TYPE_VIDEO_BITRATE:
-            if (res->venc_bypass == false && capture->enc_cfg.venc != NULL && cfg_size == sizeof(int)) {
-                ret = capture->enc_cfg.venc->set_bitrate(capture->enc_cfg.venc, *(int *)cfg);
+            if (res->venc_bypass == false && res->venc != NULL && cfg_size == sizeof(int)) {
+                res->video_bitrate = *(int *)cfg;
+                ret = res->venc->set_bitrate(res->venc, *(int *)cfg);
             }
             break;
         case ESP_CAPTURE_PATH_SET_TYPE_VIDEO_FPS:
             break;
+        case ESP_CAPTURE_PATH_SET_TYPE_KEY_FRAME:
+            // Bypassed frames come from source directly, MJPEG frames are all key frames
+            if (res->venc_bypass || res->venc == NULL || res->sink.video_info.codec != ESP_CAPTURE_CODEC_TYPE_H264) {
+                return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+            }
+            res->key_frame_req = true;
+            break;
         default:
             return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
@@ -543,7 +990,7 @@ int simple_capture_set(esp_capture_path_if_t *p, esp_capture_path_type_t path, e
 int simple_capture_return_frame(esp_capture_path_if_t *p, esp_capture_path_type_t path, esp_capture_stream_frame_t *frame)
 {
     simple_capture_t *capture = (simple_capture_t *)p;
-    simple_capture_res_t *res = &capture->primary;
+    simple_capture_res_t *res = path == ESP_CAPTURE_PATH_SECONDARY ? &capture->secondary : &capture->primary;
     int ret = ESP_CAPTURE_ERR_NOT_SUPPORTED;
     if (frame->stream_type == ESP_CAPTURE_STREAM_TYPE_AUDIO) {
         if (res->audio_enabled) {
@@ -596,6 +1043,15 @@ int simple_capture_stop(esp_capture_path_if_t *h)
         res->video_q = NULL;
     }
     res->started = false;
+    simple_capture_res_t *secondary = &capture->secondary;
+    if (secondary->started) {
+        simple_capture_enable_secondary(capture, false);
+        if (secondary->video_q) {
+            data_queue_deinit(secondary->video_q);
+            secondary->video_q = NULL;
+        }
+        secondary->started = false;
+    }
     return ret;
 }
 
@@ -608,6 +1064,13 @@ int simple_capture_close(esp_capture_path_if_t *h)
         media_lib_event_group_destroy(res->event_group);
         res->event_group = NULL;
     }
+    if (capture->secondary_lock) {
+        media_lib_mutex_destroy(capture->secondary_lock);
+        capture->secondary_lock = NULL;
+    }
+    media_lib_free(capture->scaled_data);
+    capture->scaled_data = NULL;
+    capture->scaled_size = 0;
     return ESP_CAPTURE_ERR_OK;
 }
 
@@ -629,5 +1092,7 @@ esp_capture_path_if_t *esp_capture_build_simple_path(esp_capture_simple_path_cfg
     capture->base.stop = simple_capture_stop;
     capture->base.close = simple_capture_close;
     capture->enc_cfg = *cfg;
+    capture->primary.venc = cfg->venc;
+    capture->secondary.venc = cfg->secondary_venc;
     return &capture->base;
 }
@@ -34,6 +34,12 @@
 
 #define ALIGN_UP(size, align) (((size) + (align)-1) & ~((align)-1))
 
+// Bits per pixel assumed for rate control when no bitrate is configured (in 1/100 bit)
+#define VENC_DEFAULT_BPP_X100  (10)
+// IDR frames are much bigger than average frames, reserve room for them
+#define VENC_IDR_SIZE_RATIO    (8)
+#define VENC_MIN_OUT_SIZE      (16 * 1024)
+
 typedef struct {
     esp_capture_venc_if_t       base;
     esp_capture_video_info_t    info;
@@ -106,8 +112,20 @@ static int venc_get_frame_size(esp_capture_venc_if_t *h, int *in_frame_size, int
     if (venc->info.codec == ESP_CAPTURE_CODEC_TYPE_MJPEG) {
         *out_frame_size = *in_frame_size / 20;
     } else if (venc->info.codec == ESP_CAPTURE_CODEC_TYPE_H264) {
-        *out_frame_size = *in_frame_size;
-        *out_frame_size = ALIGN_UP(*out_frame_size, 128);
+        // Size output according rate control, caller retry with bigger buffer if not enough
+        int fps = venc->info.fps ? venc->info.fps : 1;
+        uint64_t bitrate = venc->bitrate;
+        if (bitrate == 0) {
+            bitrate = (uint64_t)res.width * res.height * fps * VENC_DEFAULT_BPP_X100 / 100;
+        }
+        int frame_size = (int)(bitrate / 8 / fps) * VENC_IDR_SIZE_RATIO;
+        if (frame_size < VENC_MIN_OUT_SIZE) {
+            frame_size = VENC_MIN_OUT_SIZE;
+        }
+        if (frame_size > *in_frame_size) {
+            frame_size = *in_frame_size;
+        }
+        *out_frame_size = ALIGN_UP(frame_size, 128);
     } else {
         return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
@@ -164,6 +182,10 @@ static int venc_start(esp_capture_venc_if_t *h, esp_capture_codec_type_t src_cod
         ESP_LOGE(TAG, "Fail to open encoder");
         return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
+    if (info->bitrate) {
+        venc->bitrate = info->bitrate;
+        esp_video_enc_set_bitrate(venc->enc_handle, venc->bitrate);
+    }
     venc->started = true;
     int in_size = 0;
     venc_get_frame_size(h, &in_size, &venc->out_frame_size);
@@ -173,7 +195,10 @@ static int venc_start(esp_capture_venc_if_t *h, esp_capture_codec_type_t src_cod
 static int venc_set_bitrate(esp_capture_venc_if_t *h, int bitrate)
 {
     venc_inst_t *venc = (venc_inst_t *)h;
-    esp_video_enc_set_bitrate(venc->enc_handle, bitrate);
+    venc->bitrate = bitrate;
+    if (venc->enc_handle) {
+        esp_video_enc_set_bitrate(venc->enc_handle, bitrate);
+    }
     return ESP_CAPTURE_ERR_OK;
 }
 
@@ -184,7 +209,7 @@ static int venc_encode_frame(esp_capture_venc_if_t *h, esp_capture_stream_frame_
         return ESP_CAPTURE_ERR_NOT_SUPPORTED;
     }
     if (encoded->size < venc->out_frame_size) {
-        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+        return ESP_CAPTURE_ERR_NOT_ENOUGH;
     }
     esp_video_enc_in_frame_t in_frame = {
         .pts = raw->pts,
@@ -205,7 +230,6 @@ static int venc_encode_frame(esp_capture_venc_if_t *h, esp_capture_stream_frame_
     }
     encoded->pts = out_frame.pts;
     encoded->size = out_frame.encoded_size;
-    ;
     return ESP_CAPTURE_ERR_OK;
 }
 
@@ -0,0 +1,588 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include "esp_capture_types.h"
+#include "esp_capture_video_enc.h"
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "media_lib_os.h"
+#include "esp_video_enc.h"
+#include "esp_video_codec_utils.h"
+
+#define TAG "VENC_STRIP"
+
+#define ALIGN_UP(size, align) (((size) + (align)-1) & ~((align)-1))
+
+#define STRIP_DEFAULT_NUM     (2)
+#define STRIP_MAX_NUM         (4)
+// Strip height aligned to biggest JPEG MCU height (YUV420 sub-sampling)
+#define STRIP_HEIGHT_ALIGN    (16)
+#define STRIP_OUT_ALIGNMENT   (128)
+#define JPEG_DRI_SEGMENT_SIZE (6)
+
+#define JPEG_MARKER_SOI (0xD8)
+#define JPEG_MARKER_EOI (0xD9)
+#define JPEG_MARKER_SOF (0xC0)
+#define JPEG_MARKER_DHT (0xC4)
+#define JPEG_MARKER_DQT (0xDB)
+#define JPEG_MARKER_DRI (0xDD)
+#define JPEG_MARKER_SOS (0xDA)
+#define JPEG_MARKER_RST (0xD0)
+
+typedef struct {
+    uint8_t *sof;       /*!< Start of frame marker position */
+    uint8_t *sos;       /*!< Start of scan marker position */
+    uint8_t *scan;      /*!< Entropy coded data */
+    int      scan_size; /*!< Entropy coded data size (not include EOI) */
+    uint8_t  mcu_w;     /*!< MCU width */
+    uint8_t  mcu_h;     /*!< MCU height */
+} jpeg_layout_t;
+
+struct venc_strip_inst_t;
+
+typedef struct {
+    struct venc_strip_inst_t  *parent;
+    esp_video_enc_handle_t     enc_handle;
+    uint8_t                   *in_data;
+    int                        in_size;
+    uint8_t                   *out_data;
+    int                        out_size;
+    int                        encoded_size;
+    int                        ret;
+    media_lib_sema_handle_t    start_sema;
+    media_lib_sema_handle_t    done_sema;
+    media_lib_thread_handle_t  thread;
+} venc_strip_t;
+
+typedef struct venc_strip_inst_t {
+    esp_capture_venc_if_t             base;
+    esp_capture_video_strip_enc_cfg_t cfg;
+    esp_capture_venc_if_t            *general;
+    bool                              use_general;
+    esp_capture_video_info_t          info;
+    esp_video_codec_pixel_fmt_t       src_fmt;
+    int                               in_frame_size;
+    int                               out_frame_size;
+    uint16_t                          strip_height;
+    uint8_t                           strip_num;
+    int                               bitrate;
+    bool                              quit;
+    bool                              started;
+    venc_strip_t                      strips[STRIP_MAX_NUM];
+} venc_strip_inst_t;
+
+static int strip_get_support_codecs(esp_capture_venc_if_t *h, const esp_capture_codec_type_t **codecs, uint8_t *num)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)h;
+    return venc->general->get_support_codecs(venc->general, codecs, num);
+}
+
+static int strip_get_input_codecs(esp_capture_venc_if_t *h, esp_capture_codec_type_t out_codec, const esp_capture_codec_type_t **codecs, uint8_t *num)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)h;
+    return venc->general->get_input_codecs(venc->general, out_codec, codecs, num);
+}
+
+static int get_strip_image_size(venc_strip_inst_t *venc, int height)
+{
+    esp_video_codec_resolution_t res = {
+        .width = venc->info.width,
+        .height = height,
+    };
+    return (int)esp_video_codec_get_image_size(venc->src_fmt, &res);
+}
+
+static int strip_get_frame_size(esp_capture_venc_if_t *h, int *in_frame_size, int *out_frame_size)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)h;
+    if (venc->use_general) {
+        return venc->general->get_frame_size(venc->general, in_frame_size, out_frame_size);
+    }
+    if (venc->started == false) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    *in_frame_size = venc->in_frame_size;
+    *out_frame_size = venc->out_frame_size;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int strip_encode(venc_strip_t *strip, uint32_t pts)
+{
+    esp_video_enc_in_frame_t in_frame = {
+        .pts = pts,
+        .data = strip->in_data,
+        .size = strip->in_size,
+    };
+    esp_video_enc_out_frame_t out_frame = {
+        .data = strip->out_data,
+        .size = strip->out_size,
+    };
+    strip->encoded_size = 0;
+    int ret = esp_video_enc_process(strip->enc_handle, &in_frame, &out_frame);
+    if (ret == ESP_VC_ERR_BUF_NOT_ENOUGH) {
+        return ESP_CAPTURE_ERR_NOT_ENOUGH;
+    }
+    if (ret != ESP_VC_ERR_OK) {
+        return ESP_CAPTURE_ERR_INTERNAL;
+    }
+    strip->encoded_size = out_frame.encoded_size;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static void strip_enc_thread(void *arg)
+{
+    venc_strip_t *strip = (venc_strip_t *)arg;
+    venc_strip_inst_t *venc = strip->parent;
+    while (1) {
+        media_lib_sema_lock(strip->start_sema, MEDIA_LIB_MAX_LOCK_TIME);
+        if (venc->quit) {
+            break;
+        }
+        strip->ret = strip_encode(strip, 0);
+        media_lib_sema_unlock(strip->done_sema);
+    }
+    media_lib_sema_unlock(strip->done_sema);
+    media_lib_thread_destroy(NULL);
+}
+
+static int parse_jpeg_layout(uint8_t *data, int size, jpeg_layout_t *layout)
+{
+    if (size < 4 || data[0] != 0xFF || data[1] != JPEG_MARKER_SOI) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    memset(layout, 0, sizeof(jpeg_layout_t));
+    int pos = 2;
+    while (pos + 4 <= size) {
+        if (data[pos] != 0xFF) {
+            return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+        }
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            // Skip fill bytes
+            pos++;
+            continue;
+        }
+        int len = (data[pos + 2] << 8) | data[pos + 3];
+        if (pos + 2 + len > size) {
+            return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+        }
+        if (marker == JPEG_MARKER_SOF) {
+            uint8_t *sof = data + pos;
+            int comp_num = sof[9];
+            if (len < 8 + comp_num * 3) {
+                return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+            }
+            uint8_t h_max = 1, v_max = 1;
+            for (int i = 0; i < comp_num; i++) {
+                uint8_t hv = sof[10 + i * 3 + 1];
+                h_max = (hv >> 4) > h_max ? (hv >> 4) : h_max;
+                v_max = (hv & 0xF) > v_max ? (hv & 0xF) : v_max;
+            }
+            layout->sof = sof;
+            layout->mcu_w = h_max * 8;
+            layout->mcu_h = v_max * 8;
+        } else if ((marker > JPEG_MARKER_SOF && marker <= 0xCF && marker != JPEG_MARKER_DHT && marker != 0xC8 && marker != 0xCC)
+                   || marker == JPEG_MARKER_DRI) {
+            // Only baseline JPEG without restart interval can be stitched
+            return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+        } else if (marker == JPEG_MARKER_SOS) {
+            if (layout->sof == NULL) {
+                return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+            }
+            layout->sos = data + pos;
+            layout->scan = data + pos + 2 + len;
+            int end = size - 2;
+            while (end > layout->scan - data && !(data[end] == 0xFF && data[end + 1] == JPEG_MARKER_EOI)) {
+                end--;
+            }
+            layout->scan_size = (int)(data + end - layout->scan);
+            return layout->scan_size > 0 ? ESP_CAPTURE_ERR_OK : ESP_CAPTURE_ERR_NOT_SUPPORTED;
+        }
+        pos += 2 + len;
+    }
+    return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+}
+
+static uint8_t *next_table_segment(uint8_t *pos, uint8_t *end)
+{
+    // Segments before SOS already validated by `parse_jpeg_layout`
+    while (pos < end) {
+        uint8_t marker = pos[1];
+        if (marker == 0xFF) {
+            pos++;
+            continue;
+        }
+        if (marker == JPEG_MARKER_DQT || marker == JPEG_MARKER_DHT) {
+            return pos;
+        }
+        pos += 2 + ((pos[2] << 8) | pos[3]);
+    }
+    return NULL;
+}
+
+static int get_segment_size(uint8_t *segment)
+{
+    return 2 + ((segment[2] << 8) | segment[3]);
+}
+
+static bool jpeg_tables_match(uint8_t *a, jpeg_layout_t *a_layout, uint8_t *b, jpeg_layout_t *b_layout)
+{
+    // Scan of all strips are decoded with quantization and huffman tables from strip 0
+    uint8_t *a_table = next_table_segment(a + 2, a_layout->sos);
+    uint8_t *b_table = next_table_segment(b + 2, b_layout->sos);
+    while (a_table && b_table) {
+        int size = get_segment_size(a_table);
+        if (size != get_segment_size(b_table) || memcmp(a_table, b_table, size)) {
+            return false;
+        }
+        a_table = next_table_segment(a_table + size, a_layout->sos);
+        b_table = next_table_segment(b_table + size, b_layout->sos);
+    }
+    if (a_table || b_table) {
+        return false;
+    }
+    // Table selection of each component
+    int size = get_segment_size(a_layout->sos);
+    return size == get_segment_size(b_layout->sos) && memcmp(a_layout->sos, b_layout->sos, size) == 0;
+}
+
+static int stitch_jpeg_strips(venc_strip_inst_t *venc, esp_capture_stream_frame_t *encoded)
+{
+    // Strip 0 is encoded into output buffer directly, add DRI and append left strips as restart intervals
+    if (venc->strip_num == 1) {
+        encoded->size = venc->strips[0].encoded_size;
+        return ESP_CAPTURE_ERR_OK;
+    }
+    jpeg_layout_t head;
+    int ret = parse_jpeg_layout(encoded->data, venc->strips[0].encoded_size, &head);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGE(TAG, "Strip 0 is not baseline JPEG");
+        return ret;
+    }
+    if (venc->strip_height % head.mcu_h) {
+        ESP_LOGE(TAG, "Strip height %d not aligned to MCU %d", venc->strip_height, head.mcu_h);
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    uint32_t interval = ((venc->info.width + head.mcu_w - 1) / head.mcu_w) * (venc->strip_height / head.mcu_h);
+    if (interval > 0xFFFF) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    int total = (int)(head.scan - encoded->data) + head.scan_size + JPEG_DRI_SEGMENT_SIZE + 2;
+    jpeg_layout_t body[STRIP_MAX_NUM];
+    for (int i = 1; i < venc->strip_num; i++) {
+        ret = parse_jpeg_layout(venc->strips[i].out_data, venc->strips[i].encoded_size, &body[i]);
+        if (ret != ESP_CAPTURE_ERR_OK || body[i].mcu_w != head.mcu_w || body[i].mcu_h != head.mcu_h
+            || jpeg_tables_match(encoded->data, &head, venc->strips[i].out_data, &body[i]) == false) {
+            ESP_LOGW(TAG, "Strip %d not match strip 0", i);
+            return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+        }
+        total += 2 + body[i].scan_size;
+    }
+    if (total > encoded->size) {
+        return ESP_CAPTURE_ERR_NOT_ENOUGH;
+    }
+    // Patch image height
+    head.sof[5] = (uint8_t)(venc->info.height >> 8);
+    head.sof[6] = (uint8_t)(venc->info.height & 0xFF);
+    // Insert DRI before SOS
+    uint8_t *sos = head.sos;
+    memmove(sos + JPEG_DRI_SEGMENT_SIZE, sos, head.scan + head.scan_size - sos);
+    sos[0] = 0xFF;
+    sos[1] = JPEG_MARKER_DRI;
+    sos[2] = 0;
+    sos[3] = 4;
+    sos[4] = (uint8_t)(interval >> 8);
+    sos[5] = (uint8_t)(interval & 0xFF);
+    uint8_t *pos = head.scan + head.scan_size + JPEG_DRI_SEGMENT_SIZE;
+    for (int i = 1; i < venc->strip_num; i++) {
+        *(pos++) = 0xFF;
+        *(pos++) = JPEG_MARKER_RST + ((i - 1) & 7);
+        memcpy(pos, body[i].scan, body[i].scan_size);
+        pos += body[i].scan_size;
+    }
+    *(pos++) = 0xFF;
+    *(pos++) = JPEG_MARKER_EOI;
+    encoded->size = (int)(pos - encoded->data);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static void strip_release(venc_strip_inst_t *venc)
+{
+    venc->quit = true;
+    for (int i = 0; i < STRIP_MAX_NUM; i++) {
+        venc_strip_t *strip = &venc->strips[i];
+        if (strip->thread) {
+            media_lib_sema_unlock(strip->start_sema);
+            media_lib_sema_lock(strip->done_sema, MEDIA_LIB_MAX_LOCK_TIME);
+            strip->thread = NULL;
+        }
+        if (strip->start_sema) {
+            media_lib_sema_destroy(strip->start_sema);
+            strip->start_sema = NULL;
+        }
+        if (strip->done_sema) {
+            media_lib_sema_destroy(strip->done_sema);
+            strip->done_sema = NULL;
+        }
+        if (strip->enc_handle) {
+            esp_video_enc_close(strip->enc_handle);
+            strip->enc_handle = NULL;
+        }
+        // Output of strip 0 is frame buffer from caller
+        if (strip->out_data && i > 0) {
+            media_lib_free_align(strip->out_data);
+        }
+        strip->out_data = NULL;
+    }
+    venc->strip_num = 0;
+    venc->quit = false;
+}
+
+static int get_strip_height(venc_strip_inst_t *venc, int i)
+{
+    int y = i * venc->strip_height;
+    return (i == venc->strip_num - 1) ? venc->info.height - y : venc->strip_height;
+}
+
+static void apply_strip_bitrate(venc_strip_inst_t *venc)
+{
+    // Keep same bits per pixel for all strips so that encoders choose the same quantization tables
+    for (int i = 0; i < venc->strip_num; i++) {
+        uint32_t bitrate = (uint32_t)((uint64_t)venc->bitrate * get_strip_height(venc, i) / venc->info.height);
+        esp_video_enc_set_bitrate(venc->strips[i].enc_handle, bitrate);
+    }
+}
+
+static int strip_open(venc_strip_inst_t *venc)
+{
+    int strip_num = venc->cfg.strip_num ? venc->cfg.strip_num : STRIP_DEFAULT_NUM;
+    if (strip_num > STRIP_MAX_NUM) {
+        strip_num = STRIP_MAX_NUM;
+    }
+    venc->strip_height = ALIGN_UP((venc->info.height + strip_num - 1) / strip_num, STRIP_HEIGHT_ALIGN);
+    venc->strip_num = (venc->info.height + venc->strip_height - 1) / venc->strip_height;
+    venc->in_frame_size = get_strip_image_size(venc, venc->info.height);
+    venc->out_frame_size = ALIGN_UP(venc->in_frame_size / 20, STRIP_OUT_ALIGNMENT);
+    for (int i = 0; i < venc->strip_num; i++) {
+        venc_strip_t *strip = &venc->strips[i];
+        int height = get_strip_height(venc, i);
+        esp_video_enc_cfg_t enc_cfg = {
+            .codec_type = ESP_VIDEO_CODEC_TYPE_MJPEG,
+            .resolution = {
+                .width = venc->info.width,
+                .height = height,
+            },
+            .in_fmt = venc->src_fmt,
+            .fps = venc->info.fps,
+        };
+        int ret = esp_video_enc_open(&enc_cfg, &strip->enc_handle);
+        if (ret != ESP_VC_ERR_OK) {
+            ESP_LOGE(TAG, "Fail to open encoder for strip %d", i);
+            return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+        }
+        strip->parent = venc;
+        strip->in_size = get_strip_image_size(venc, height);
+        if (i == 0) {
+            // Strip 0 encoded in caller thread into output frame directly
+            continue;
+        }
+        strip->out_size = venc->out_frame_size;
+        strip->out_data = media_lib_malloc_align(strip->out_size, STRIP_OUT_ALIGNMENT);
+        media_lib_sema_create(&strip->start_sema);
+        media_lib_sema_create(&strip->done_sema);
+        if (strip->out_data == NULL || strip->start_sema == NULL || strip->done_sema == NULL) {
+            return ESP_CAPTURE_ERR_NO_MEM;
+        }
+        media_lib_thread_create_from_scheduler(&strip->thread, "venc_strip", strip_enc_thread, strip);
+        if (strip->thread == NULL) {
+            ESP_LOGE(TAG, "Fail to create strip thread");
+            return ESP_CAPTURE_ERR_NO_RESOURCES;
+        }
+    }
+    if (venc->bitrate) {
+        apply_strip_bitrate(venc);
+    }
+    ESP_LOGI(TAG, "Encode %dx%d with %d strips", (int)venc->info.width, (int)venc->info.height, venc->strip_num);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int strip_start(esp_capture_venc_if_t *h, esp_capture_codec_type_t src_codec, esp_capture_video_info_t *info)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)h;
+    // Only MJPEG support stitch strips, H264 slices need encoder to share reference frame
+    venc->use_general = (info->codec != ESP_CAPTURE_CODEC_TYPE_MJPEG || src_codec != ESP_CAPTURE_CODEC_TYPE_RGB565
+                         || info->height < STRIP_HEIGHT_ALIGN * 2 || venc->cfg.strip_num == 1);
+    if (venc->use_general) {
+        return venc->general->start(venc->general, src_codec, info);
+    }
+    venc->info = *info;
+    if (info->bitrate) {
+        venc->bitrate = info->bitrate;
+    }
+    venc->src_fmt = ESP_VIDEO_CODEC_PIXEL_FMT_RGB565_LE;
+    int ret = strip_open(venc);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        strip_release(venc);
+        return ret;
+    }
+    venc->started = true;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int strip_set_bitrate(esp_capture_venc_if_t *h, int bitrate)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)h;
+    venc->bitrate = bitrate;
+    if (venc->use_general) {
+        return venc->general->set_bitrate(venc->general, bitrate);
+    }
+    if (venc->started) {
+        apply_strip_bitrate(venc);
+    }
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int strip_switch_to_general(venc_strip_inst_t *venc)
+{
+    // Strips can not be stitched, encode whole frame by general encoder from now on
+    ESP_LOGW(TAG, "Strip tables differ, fallback to general encoder");
+    strip_release(venc);
+    venc->started = false;
+    esp_capture_video_info_t info = venc->info;
+    info.bitrate = venc->bitrate;
+    int ret = venc->general->start(venc->general, ESP_CAPTURE_CODEC_TYPE_RGB565, &info);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        return ret;
+    }
+    venc->use_general = true;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int strip_encode_frame(esp_capture_venc_if_t *h, esp_capture_stream_frame_t *raw, esp_capture_stream_frame_t *encoded)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)h;
+    if (venc->use_general) {
+        return venc->general->encode_frame(venc->general, raw, encoded);
+    }
+    if (venc->started == false) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    if (raw->size < venc->in_frame_size) {
+        return ESP_CAPTURE_ERR_INVALID_ARG;
+    }
+    // Kick off workers firstly then encode strip 0 in current thread
+    uint8_t *in_data = raw->data;
+    for (int i = 1; i < venc->strip_num; i++) {
+        venc_strip_t *strip = &venc->strips[i];
+        in_data += venc->strips[i - 1].in_size;
+        strip->in_data = in_data;
+        media_lib_sema_unlock(strip->start_sema);
+    }
+    venc_strip_t *head = &venc->strips[0];
+    head->in_data = raw->data;
+    head->out_data = encoded->data;
+    head->out_size = encoded->size;
+    int ret = strip_encode(head, raw->pts);
+    for (int i = 1; i < venc->strip_num; i++) {
+        venc_strip_t *strip = &venc->strips[i];
+        media_lib_sema_lock(strip->done_sema, MEDIA_LIB_MAX_LOCK_TIME);
+        if (ret == ESP_CAPTURE_ERR_OK) {
+            ret = strip->ret;
+        }
+    }
+    if (ret == ESP_CAPTURE_ERR_OK) {
+        ret = stitch_jpeg_strips(venc, encoded);
+        if (ret == ESP_CAPTURE_ERR_NOT_SUPPORTED) {
+            ret = strip_switch_to_general(venc);
+            if (ret == ESP_CAPTURE_ERR_OK) {
+                return venc->general->encode_frame(venc->general, raw, encoded);
+            }
+        }
+    }
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        if (ret != ESP_CAPTURE_ERR_NOT_ENOUGH) {
+            ESP_LOGE(TAG, "Fail to encode frame ret %d", ret);
+        }
+        return ret;
+    }
+    encoded->pts = raw->pts;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static int strip_stop(esp_capture_venc_if_t *h)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)h;
+    if (venc->use_general) {
+        venc->use_general = false;
+        return venc->general->stop(venc->general);
+    }
+    strip_release(venc);
+    venc->started = false;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+static esp_capture_venc_if_t *strip_clone(esp_capture_venc_if_t *h)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)h;
+    return esp_capture_new_video_strip_encoder(&venc->cfg);
+}
+
+esp_capture_venc_if_t *esp_capture_new_video_strip_encoder(esp_capture_video_strip_enc_cfg_t *cfg)
+{
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)calloc(1, sizeof(venc_strip_inst_t));
+    if (venc == NULL) {
+        return NULL;
+    }
+    venc->general = esp_capture_new_video_encoder();
+    if (venc->general == NULL) {
+        free(venc);
+        return NULL;
+    }
+    if (cfg) {
+        venc->cfg = *cfg;
+    }
+    venc->base.clone = strip_clone;
+    venc->base.get_support_codecs = strip_get_support_codecs;
+    venc->base.get_input_codecs = strip_get_input_codecs;
+    venc->base.set_bitrate = strip_set_bitrate;
+    venc->base.start = strip_start;
+    venc->base.get_frame_size = strip_get_frame_size;
+    venc->base.encode_frame = strip_encode_frame;
+    venc->base.stop = strip_stop;
+    return &(venc->base);
+}
+
+void esp_capture_free_video_strip_encoder(esp_capture_venc_if_t *enc)
+{
+    if (enc == NULL) {
+        return;
+    }
+    venc_strip_inst_t *venc = (venc_strip_inst_t *)enc;
+    strip_stop(enc);
+    // Inner general encoder is a single allocation without own release API
+    free(venc->general);
+    free(venc);
+}
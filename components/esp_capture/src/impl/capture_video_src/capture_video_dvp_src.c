@@ -27,20 +27,33 @@
 #include "esp_log.h"
 #include "esp_capture_defaults.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "freertos/semphr.h"
 
 #define TAG "DVP_SRC"
 
+#define DVP_SRC_MAX_FRAMES (4)
+/* Wait for free frame in short steps so that stop request is noticed even if wake up is missed */
+#define DVP_SRC_WAIT_FRAME_MS (100)
+#define DVP_SRC_STOP_WAIT_MS  (1000)
+
+typedef struct {
+    bool         used;
+    camera_fb_t *fb;     /*!< Camera frame buffer, returned early when frame is converted */
+    uint8_t     *yuv420; /*!< Converted YUV420 frame */
+} dvp_frame_t;
+
 typedef struct {
     esp_capture_video_src_if_t      base;
     esp_capture_video_dvp_src_cfg_t cfg;
     esp_capture_video_info_t        vid_info;
     bool                            dvp_inited;
     bool                            need_convert_420;
-    camera_fb_t                    *pic[2];
-    uint8_t                        *yuv420_cache;
-    SemaphoreHandle_t               yuv420_lock;
-    uint8_t                         cur_pic;
+    dvp_frame_t                     frames[DVP_SRC_MAX_FRAMES];
+    SemaphoreHandle_t               frame_sema;
+    volatile bool                   stopping; /*!< Stop requested, reader must leave without taking new frame */
+    volatile int                    readers;  /*!< Readers inside acquire, stop waits for them before cleanup */
+    portMUX_TYPE                    lock;
 } dvp_src_t;
 
 static int dvp_src_open(esp_capture_video_src_if_t *src)
@@ -163,26 +176,43 @@ static int dvp_src_negotiate_caps(esp_capture_video_src_if_t *src, esp_capture_v
     return -1;
 }
 
+static void dvp_src_free_frames(dvp_src_t *dvp_src)
+{
+    for (int i = 0; i < DVP_SRC_MAX_FRAMES; i++) {
+        if (dvp_src->frames[i].yuv420) {
+            free(dvp_src->frames[i].yuv420);
+            dvp_src->frames[i].yuv420 = NULL;
+        }
+    }
+}
+
 static int dvp_src_start(esp_capture_video_src_if_t *src)
 {
     dvp_src_t *dvp_src = (dvp_src_t *)src;
     if (dvp_src->dvp_inited == false) {
         return -1;
     }
+    // Each in-flight frame owns one convert buffer so that next frame can be converted during encoding
     if (dvp_src->need_convert_420) {
-        dvp_src->yuv420_cache = malloc(dvp_src->vid_info.width * dvp_src->vid_info.height * 3 / 2);
-        if (dvp_src->yuv420_cache == NULL) {
-            return ESP_CAPTURE_ERR_NO_MEM;
-        }
-        dvp_src->yuv420_lock = xSemaphoreCreateCounting(1, 1);
-        if (dvp_src->yuv420_lock == NULL) {
-            return ESP_CAPTURE_ERR_NO_MEM;
+        for (int i = 0; i < dvp_src->cfg.buf_count; i++) {
+            dvp_src->frames[i].yuv420 = malloc(dvp_src->vid_info.width * dvp_src->vid_info.height * 3 / 2);
+            if (dvp_src->frames[i].yuv420 == NULL) {
+                dvp_src_free_frames(dvp_src);
+                return ESP_CAPTURE_ERR_NO_MEM;
+            }
         }
     }
+    // Limit in-flight frames, acquire blocks until one frame is released
+    dvp_src->frame_sema = xSemaphoreCreateCounting(dvp_src->cfg.buf_count, dvp_src->cfg.buf_count);
+    if (dvp_src->frame_sema == NULL) {
+        dvp_src_free_frames(dvp_src);
+        return ESP_CAPTURE_ERR_NO_MEM;
+    }
+    dvp_src->stopping = false;
     return 0;
 }
 
-static void convert_yuv420(uint32_t w, uint32_t h, uint8_t *src, uint8_t *dst)
+static void convert_yuv420_bytes(uint32_t w, uint32_t h, uint8_t *src, uint8_t *dst)
 {
     uint32_t bytes = w * h;
     uint8_t *y = dst;
@@ -206,64 +236,136 @@ static void convert_yuv420(uint32_t w, uint32_t h, uint8_t *src, uint8_t *dst)
     }
 }
 
-static int dvp_src_acquire_frame(esp_capture_video_src_if_t *src, esp_capture_stream_frame_t *frame)
+// Each word holds 2 YUYV pixels: Y0 | U << 8 | Y1 << 16 | V << 24
+#define PACK_Y(a, b) (((a) & 0xFF) | (((a) >> 8) & 0xFF00) | (((b) & 0xFF) << 16) | (((b) << 8) & 0xFF000000))
+#define PACK_U(a, b, c, d) ((((a) >> 8) & 0xFF) | ((b) & 0xFF00) | (((c) << 8) & 0xFF0000) | (((d) << 16) & 0xFF000000))
+#define PACK_V(a, b, c, d) (((a) >> 24) | (((b) >> 16) & 0xFF00) | (((c) >> 8) & 0xFF0000) | ((d) & 0xFF000000))
+
+static void convert_yuv420(uint32_t w, uint32_t h, uint8_t *src, uint8_t *dst)
 {
-    dvp_src_t *dvp_src = (dvp_src_t *)src;
-    if (dvp_src->dvp_inited == false) {
+    uint32_t bytes = w * h;
+    // Word path need 16 pixels aligned width and word aligned buffers
+    if ((w & 15) || (((uintptr_t)src | (uintptr_t)dst | bytes) & 3)) {
+        convert_yuv420_bytes(w, h, src, dst);
+        return;
+    }
+    uint32_t *s = (uint32_t *)src;
+    uint32_t *y = (uint32_t *)dst;
+    uint32_t *u = (uint32_t *)(dst + bytes);
+    uint32_t *v = (uint32_t *)(dst + bytes + (bytes >> 2));
+    // Process 16 pixels per loop
+    uint32_t loop = w >> 4;
+    h >>= 1;
+    for (int i = 0; i < h; i++) {
+        for (int j = 0; j < loop; j++) {
+            uint32_t s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+            uint32_t s4 = s[4], s5 = s[5], s6 = s[6], s7 = s[7];
+            y[0] = PACK_Y(s0, s1);
+            y[1] = PACK_Y(s2, s3);
+            y[2] = PACK_Y(s4, s5);
+            y[3] = PACK_Y(s6, s7);
+            u[0] = PACK_U(s0, s1, s2, s3);
+            u[1] = PACK_U(s4, s5, s6, s7);
+            v[0] = PACK_V(s0, s1, s2, s3);
+            v[1] = PACK_V(s4, s5, s6, s7);
+            s += 8;
+            y += 4;
+            u += 2;
+            v += 2;
+        }
+        // Chroma of odd line is dropped
+        for (int j = 0; j < loop; j++) {
+            y[0] = PACK_Y(s[0], s[1]);
+            y[1] = PACK_Y(s[2], s[3]);
+            y[2] = PACK_Y(s[4], s[5]);
+            y[3] = PACK_Y(s[6], s[7]);
+            s += 8;
+            y += 4;
+        }
+    }
+}
+
+static int dvp_src_get_frame(dvp_src_t *dvp_src, esp_capture_stream_frame_t *frame)
+{
+    while (xSemaphoreTake(dvp_src->frame_sema, pdMS_TO_TICKS(DVP_SRC_WAIT_FRAME_MS)) != pdTRUE) {
+        if (dvp_src->stopping) {
+            return -1;
+        }
+    }
+    if (dvp_src->stopping) {
+        // Woken up by stop, pass wake up to other reader if any
+        xSemaphoreGive(dvp_src->frame_sema);
         return -1;
     }
     camera_fb_t *fb = esp_camera_fb_get();
     if (fb == NULL) {
         ESP_LOGE(TAG, "Camera capture failed");
+        xSemaphoreGive(dvp_src->frame_sema);
         return -1;
     }
     for (int i = 0; i < dvp_src->cfg.buf_count; i++) {
-        if (dvp_src->pic[i] == NULL) {
-            dvp_src->pic[i] = fb;
-            if (dvp_src->need_convert_420) {
-                xSemaphoreTake(dvp_src->yuv420_lock, portMAX_DELAY);
-                dvp_src->cur_pic = i;
-                convert_yuv420(dvp_src->vid_info.width, dvp_src->vid_info.height,
-                               dvp_src->pic[i]->buf, dvp_src->yuv420_cache);
-                frame->data = dvp_src->yuv420_cache;
-                frame->size = dvp_src->pic[i]->len * 3 / 4;
-            } else {
-                frame->data = dvp_src->pic[i]->buf;
-                frame->size = dvp_src->pic[i]->len;
-            }
-            return 0;
+        dvp_frame_t *dvp_frame = &dvp_src->frames[i];
+        if (dvp_frame->used) {
+            continue;
         }
+        dvp_frame->used = true;
+        if (dvp_src->need_convert_420) {
+            convert_yuv420(dvp_src->vid_info.width, dvp_src->vid_info.height, fb->buf, dvp_frame->yuv420);
+            frame->data = dvp_frame->yuv420;
+            frame->size = fb->len * 3 / 4;
+            // Give back camera buffer at once so that sensor can fill next frame
+            esp_camera_fb_return(fb);
+        } else {
+            dvp_frame->fb = fb;
+            frame->data = fb->buf;
+            frame->size = fb->len;
+        }
+        return 0;
     }
     ESP_LOGE(TAG, "Impossible");
     // User not consumed, should not happen
     esp_camera_fb_return(fb);
+    xSemaphoreGive(dvp_src->frame_sema);
     return -1;
 }
 
+static int dvp_src_acquire_frame(esp_capture_video_src_if_t *src, esp_capture_stream_frame_t *frame)
+{
+    dvp_src_t *dvp_src = (dvp_src_t *)src;
+    taskENTER_CRITICAL(&dvp_src->lock);
+    if (dvp_src->dvp_inited == false || dvp_src->frame_sema == NULL || dvp_src->stopping) {
+        taskEXIT_CRITICAL(&dvp_src->lock);
+        return -1;
+    }
+    dvp_src->readers++;
+    taskEXIT_CRITICAL(&dvp_src->lock);
+    int ret = dvp_src_get_frame(dvp_src, frame);
+    taskENTER_CRITICAL(&dvp_src->lock);
+    dvp_src->readers--;
+    taskEXIT_CRITICAL(&dvp_src->lock);
+    return ret;
+}
+
 static int dvp_src_release_frame(esp_capture_video_src_if_t *src, esp_capture_stream_frame_t *frame)
 {
     dvp_src_t *dvp_src = (dvp_src_t *)src;
     if (dvp_src->dvp_inited == false) {
         return -1;
     }
-    int sel = -1;
-    if (dvp_src->need_convert_420) {
-        sel = dvp_src->cur_pic;
-    } else {
-        for (int i = 0; i < dvp_src->cfg.buf_count; i++) {
-            if (dvp_src->pic[i] && frame->data == dvp_src->pic[i]->buf) {
-                sel = i;
-                break;
-            }
+    for (int i = 0; i < dvp_src->cfg.buf_count; i++) {
+        dvp_frame_t *dvp_frame = &dvp_src->frames[i];
+        if (dvp_frame->used == false) {
+            continue;
         }
-    }
-    if (sel >= 0 && dvp_src->pic[sel]) {
-        if (dvp_src->need_convert_420) {
-            xSemaphoreGive(dvp_src->yuv420_lock);
+        if (dvp_src->need_convert_420 ? (frame->data == dvp_frame->yuv420) : (dvp_frame->fb && frame->data == dvp_frame->fb->buf)) {
+            if (dvp_frame->fb) {
+                esp_camera_fb_return(dvp_frame->fb);
+                dvp_frame->fb = NULL;
+            }
+            dvp_frame->used = false;
+            xSemaphoreGive(dvp_src->frame_sema);
+            return 0;
         }
-        esp_camera_fb_return(dvp_src->pic[sel]);
-        dvp_src->pic[sel] = NULL;
-        return 0;
     }
     return -1;
 }
@@ -271,19 +373,34 @@ static int dvp_src_release_frame(esp_capture_video_src_if_t *src, esp_capture_st
 static int dvp_src_stop(esp_capture_video_src_if_t *src)
 {
     dvp_src_t *dvp_src = (dvp_src_t *)src;
+    // Wake up reader blocked on free frame and wait for it to leave before camera and semaphore are released
+    taskENTER_CRITICAL(&dvp_src->lock);
+    dvp_src->stopping = true;
+    taskEXIT_CRITICAL(&dvp_src->lock);
+    if (dvp_src->frame_sema) {
+        xSemaphoreGive(dvp_src->frame_sema);
+    }
+    int wait_ms = 0;
+    while (dvp_src->readers && wait_ms < DVP_SRC_STOP_WAIT_MS) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        wait_ms += 10;
+    }
+    if (dvp_src->readers) {
+        ESP_LOGE(TAG, "Reader not left after %dms", wait_ms);
+    }
     if (dvp_src->dvp_inited) {
         dvp_src->dvp_inited = false;
-        dvp_src->pic[0] = dvp_src->pic[1] = NULL;
-        if (dvp_src->yuv420_lock) {
-            vSemaphoreDelete(dvp_src->yuv420_lock);
-            dvp_src->yuv420_lock = NULL;
+        for (int i = 0; i < DVP_SRC_MAX_FRAMES; i++) {
+            dvp_src->frames[i].fb = NULL;
+            dvp_src->frames[i].used = false;
         }
         esp_camera_deinit();
     }
-    if (dvp_src->yuv420_cache) {
-        free(dvp_src->yuv420_cache);
-        dvp_src->yuv420_cache = NULL;
+    if (dvp_src->frame_sema) {
+        vSemaphoreDelete(dvp_src->frame_sema);
+        dvp_src->frame_sema = NULL;
     }
+    dvp_src_free_frames(dvp_src);
     return 0;
 }
 
@@ -307,8 +424,11 @@ esp_capture_video_src_if_t *esp_capture_new_video_dvp_src(esp_capture_video_dvp_
     dvp->base.stop = dvp_src_stop;
     dvp->base.close = dvp_src_close;
     dvp->cfg = *cfg;
+    portMUX_INITIALIZE(&dvp->lock);
     if (cfg->buf_count == 0) {
         dvp->cfg.buf_count = 1;
+    } else if (cfg->buf_count > DVP_SRC_MAX_FRAMES) {
+        dvp->cfg.buf_count = DVP_SRC_MAX_FRAMES;
     }
     return &dvp->base;
 }
@@ -0,0 +1,284 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "esp_peer.h"
+#include "esp_peer_loopback.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+#include "media_lib_adapter.h"
+#include "media_fanout.h"
+
+#define FRAME_INTERVAL    (33)
+#define GOP               (30)
+#define FRAME_SLEEP_US    (2000)
+#define MAX_WAIT_INTERVAL (100)
+// Simulcast layers sent by capture, layer 1 key frames are in the middle of layer 0 GOP
+#define HIGH_FRAME_SIZE   (1000)
+#define LOW_FRAME_SIZE    (250)
+#define HIGH_RATE         (HIGH_FRAME_SIZE * 8 * 1000 / FRAME_INTERVAL)
+#define LOW_RATE          (LOW_FRAME_SIZE * 8 * 1000 / FRAME_INTERVAL)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef struct {
+    uint8_t  layer;
+    uint8_t  key_frame;
+    uint32_t seq;
+} test_frame_t;
+
+typedef struct {
+    esp_peer_handle_t            send_pc;
+    esp_peer_handle_t            recv_pc;
+    media_fanout_viewer_handle_t viewer;
+    volatile bool                running;
+    volatile bool                send_connected;
+    volatile bool                recv_connected;
+    pthread_t                    thread;
+    pthread_mutex_t              lock;
+    int                          frames;
+    int                          layer;
+    uint32_t                     last_seq;
+    uint32_t                     switch_seq;
+    int                          switches;
+    int                          overlaps;
+} test_viewer_t;
+
+static test_viewer_t viewer;
+static uint32_t      frame_seq;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int on_send_state(esp_peer_state_t state, void *ctx)
+{
+    if (state == ESP_PEER_STATE_CONNECTED) {
+        ((test_viewer_t *)ctx)->send_connected = true;
+    }
+    return 0;
+}
+
+static int on_recv_state(esp_peer_state_t state, void *ctx)
+{
+    if (state == ESP_PEER_STATE_CONNECTED) {
+        ((test_viewer_t *)ctx)->recv_connected = true;
+    }
+    return 0;
+}
+
+static int on_video_data(esp_peer_video_frame_t *frame, void *ctx)
+{
+    test_viewer_t *v = (test_viewer_t *)ctx;
+    test_frame_t info;
+    memcpy(&info, frame->data, sizeof(info));
+    CHECK(frame->size == (info.layer ? LOW_FRAME_SIZE : HIGH_FRAME_SIZE), "layer %d frame size %d", info.layer, frame->size);
+    pthread_mutex_lock(&v->lock);
+    if (v->frames == 0) {
+        CHECK(info.key_frame, "viewer started from non key frame");
+    } else {
+        if (info.layer != v->layer) {
+            CHECK(info.key_frame, "switch to layer %d on non key frame %d", info.layer, (int)info.seq);
+            // Frame of old layer with same timestamp is sent before key frame of lower layer
+            CHECK(info.seq >= v->last_seq, "frame %d after %d", (int)info.seq, (int)v->last_seq);
+            v->overlaps += (info.seq == v->last_seq);
+            v->switch_seq = info.seq;
+            v->switches++;
+        } else {
+            // Only one layer is forwarded, so every frame is newer than last one
+            CHECK(info.seq > v->last_seq, "frame %d after %d", (int)info.seq, (int)v->last_seq);
+        }
+    }
+    v->layer = info.layer;
+    v->last_seq = info.seq;
+    v->frames++;
+    pthread_mutex_unlock(&v->lock);
+    return 0;
+}
+
+static void *recv_loop(void *arg)
+{
+    test_viewer_t *v = (test_viewer_t *)arg;
+    while (v->running) {
+        esp_peer_main_loop(v->recv_pc);
+        esp_peer_wait_info_t info = {};
+        CHECK(esp_peer_get_wait_info(v->recv_pc, &info) == ESP_PEER_ERR_NONE, "get wait info");
+        if (info.timeout_ms) {
+            uint32_t timeout = info.timeout_ms < MAX_WAIT_INTERVAL ? info.timeout_ms : MAX_WAIT_INTERVAL;
+            media_lib_sema_lock((media_lib_sema_handle_t)info.wake_sema, timeout);
+        }
+    }
+    return NULL;
+}
+
+static esp_peer_handle_t open_pc(bool send)
+{
+    esp_peer_loopback_cfg_t link_cfg = {
+        .channel = 0,
+    };
+    esp_peer_cfg_t cfg = {
+        .video_info = {
+            .codec = ESP_PEER_VIDEO_CODEC_H264,
+            .width = 320,
+            .height = 240,
+            .fps = 1000 / FRAME_INTERVAL,
+        },
+        .video_dir = send ? ESP_PEER_MEDIA_DIR_SEND_ONLY : ESP_PEER_MEDIA_DIR_RECV_ONLY,
+        .on_state = send ? on_send_state : on_recv_state,
+        .on_video_data = on_video_data,
+        .ctx = &viewer,
+        .extra_cfg = &link_cfg,
+        .extra_size = sizeof(link_cfg),
+    };
+    esp_peer_handle_t pc = NULL;
+    CHECK(esp_peer_open(&cfg, esp_peer_get_loopback_impl(), &pc) == ESP_PEER_ERR_NONE, "open peer");
+    CHECK(esp_peer_new_connection(pc) == ESP_PEER_ERR_NONE, "new connection");
+    return pc;
+}
+
+static void send_layer(media_fanout_handle_t fanout, uint8_t layer, bool key)
+{
+    uint8_t data[HIGH_FRAME_SIZE] = {};
+    test_frame_t info = {
+        .layer = layer,
+        .key_frame = key,
+        .seq = frame_seq,
+    };
+    memcpy(data, &info, sizeof(info));
+    media_fanout_frame_t frame = {
+        .type = MEDIA_FANOUT_FRAME_VIDEO,
+        .key_frame = key,
+        .layer = layer,
+        .pts = frame_seq * FRAME_INTERVAL,
+        .data = data,
+        .size = layer ? LOW_FRAME_SIZE : HIGH_FRAME_SIZE,
+    };
+    CHECK(media_fanout_send(fanout, &frame) == ESP_PEER_ERR_NONE, "fan-out send");
+}
+
+static void send_frames(media_fanout_handle_t fanout, int num)
+{
+    for (int i = 0; i < num; i++) {
+        send_layer(fanout, 0, frame_seq % GOP == 0);
+        send_layer(fanout, 1, frame_seq % GOP == GOP / 2);
+        CHECK(media_fanout_get_key_request(fanout) == 0, "layer switch requested key frame at %d", (int)frame_seq);
+        frame_seq++;
+        usleep(FRAME_SLEEP_US);
+    }
+}
+
+static uint32_t next_key_seq(uint32_t seq, uint8_t layer)
+{
+    uint32_t offset = layer ? GOP / 2 : 0;
+    while (seq % GOP != offset) {
+        seq++;
+    }
+    return seq;
+}
+
+static void wait_delivered(uint32_t last_seq)
+{
+    int64_t start = esp_timer_get_time();
+    for (;;) {
+        pthread_mutex_lock(&viewer.lock);
+        bool done = viewer.frames && viewer.last_seq >= last_seq;
+        pthread_mutex_unlock(&viewer.lock);
+        if (done) {
+            break;
+        }
+        CHECK(esp_timer_get_time() - start < 1000000, "viewer missing frame %d", (int)last_seq);
+        usleep(1000);
+    }
+}
+
+static void switch_bandwidth(media_fanout_handle_t fanout, uint32_t bandwidth, uint8_t layer)
+{
+    int switches = viewer.switches;
+    uint32_t set_seq = frame_seq;
+    CHECK(media_fanout_set_viewer_bandwidth(fanout, viewer.viewer, bandwidth) == ESP_PEER_ERR_NONE, "set bandwidth");
+    send_frames(fanout, GOP * 2);
+    wait_delivered(frame_seq - 1);
+    media_fanout_stat_t stat;
+    CHECK(media_fanout_get_stat(fanout, viewer.viewer, &stat, false) == ESP_PEER_ERR_NONE, "get stat");
+    printf("Bandwidth %d: layer %d switched at frame %d\n", (int)bandwidth, stat.layer, (int)viewer.switch_seq);
+    CHECK(stat.layer == layer && viewer.layer == layer, "expect layer %d got %d", layer, stat.layer);
+    if (switches != viewer.switches) {
+        CHECK(viewer.switch_seq == next_key_seq(set_seq, layer), "switched at %d not first key frame of layer %d",
+              (int)viewer.switch_seq, layer);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    media_lib_add_default_os_adapter();
+    media_fanout_handle_t fanout = media_fanout_open(0);
+    CHECK(fanout, "open fan-out");
+    CHECK(media_fanout_set_video_layers(fanout, 2) == ESP_PEER_ERR_NONE, "set layers");
+
+    pthread_mutex_init(&viewer.lock, NULL);
+    viewer.send_pc = open_pc(true);
+    viewer.recv_pc = open_pc(false);
+    viewer.running = true;
+    pthread_create(&viewer.thread, NULL, recv_loop, &viewer);
+    CHECK(media_fanout_add_viewer(fanout, viewer.send_pc, &viewer.viewer) == ESP_PEER_ERR_NONE, "add viewer");
+    int64_t start = esp_timer_get_time();
+    while (!(viewer.send_connected && viewer.recv_connected)) {
+        CHECK(esp_timer_get_time() - start < 1000000, "viewer not connected");
+        usleep(1000);
+    }
+
+    // Without bandwidth estimation viewer stays on highest layer, rates get measured meanwhile
+    send_frames(fanout, GOP * 2);
+    wait_delivered(frame_seq - 1);
+    CHECK(viewer.layer == 0 && viewer.switches == 0, "viewer left layer 0 without bandwidth limit");
+
+    // Layer 0 does not fit, switch down on next layer 1 key frame
+    switch_bandwidth(fanout, (HIGH_RATE + LOW_RATE) / 2, 1);
+    CHECK(viewer.switches == 1, "expect one switch got %d", viewer.switches);
+    // Bandwidth grows, back to layer 0 on its key frame
+    switch_bandwidth(fanout, HIGH_RATE * 2, 0);
+    CHECK(viewer.switches == 2, "expect two switches got %d", viewer.switches);
+    // Nothing fits, lowest layer is still forwarded
+    switch_bandwidth(fanout, LOW_RATE / 2, 1);
+    CHECK(viewer.switches == 3, "expect three switches got %d", viewer.switches);
+    // Estimation cleared, follow send congestion only which is clean
+    switch_bandwidth(fanout, 0, 0);
+    CHECK(viewer.switches == 4, "expect four switches got %d", viewer.switches);
+
+    media_fanout_stat_t stat;
+    CHECK(media_fanout_get_stat(fanout, viewer.viewer, &stat, false) == ESP_PEER_ERR_NONE, "get stat");
+    printf("Viewer received %d sent %d dropped %d\n", viewer.frames, (int)stat.video_frames, (int)stat.video_dropped);
+    CHECK(viewer.frames == (int)stat.video_frames, "viewer lost frames on link");
+    CHECK(viewer.overlaps == 2, "expect overlap on switching down only got %d", viewer.overlaps);
+    CHECK(viewer.frames == (int)frame_seq + viewer.overlaps, "expect one layer of every frame got %d of %d", viewer.frames,
+          (int)frame_seq);
+
+    CHECK(media_fanout_remove_viewer(fanout, viewer.viewer) == ESP_PEER_ERR_NONE, "remove viewer");
+    viewer.running = false;
+    pthread_join(viewer.thread, NULL);
+    esp_peer_close(viewer.send_pc);
+    esp_peer_close(viewer.recv_pc);
+    pthread_mutex_destroy(&viewer.lock);
+    media_fanout_close(fanout);
+    printf("Fan-out layer test passed\n");
+    return 0;
+}
@@ -0,0 +1,272 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "esp_peer.h"
+#include "esp_peer_loopback.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+#include "media_lib_adapter.h"
+#include "media_fanout.h"
+
+// Loopback has 8 peers at most, every viewer takes a linked pair
+#define EARLY_VIEWERS      (2)
+#define LATE_VIEWERS       (2)
+#define MAX_VIEWERS        (EARLY_VIEWERS + LATE_VIEWERS)
+#define FRAME_INTERVAL     (33)
+#define NATURAL_GOP        (10)
+#define FRAME_SLEEP_US     (3000)
+#define KEY_WAIT_MS        (500)
+#define MAX_WAIT_INTERVAL  (100)
+#define MAX_AVG_LATENCY_US (5000)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef struct {
+    uint8_t  key_frame;
+    uint32_t seq;
+    int64_t  send_us;
+} test_frame_t;
+
+typedef struct {
+    esp_peer_handle_t            send_pc;
+    esp_peer_handle_t            recv_pc;
+    media_fanout_viewer_handle_t viewer;
+    volatile bool                running;
+    volatile bool                send_connected;
+    volatile bool                recv_connected;
+    pthread_t                    thread;
+    pthread_mutex_t              lock;
+    int                          frames;
+    int                          first_key;
+    uint32_t                     last_seq;
+    int64_t                      latency_sum;
+} test_viewer_t;
+
+static test_viewer_t viewers[MAX_VIEWERS];
+static uint32_t      frame_seq;
+static bool          key_pending;
+static int           key_requests;
+static uint32_t      key_request_seq;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int on_send_state(esp_peer_state_t state, void *ctx)
+{
+    if (state == ESP_PEER_STATE_CONNECTED) {
+        ((test_viewer_t *)ctx)->send_connected = true;
+    }
+    return 0;
+}
+
+static int on_recv_state(esp_peer_state_t state, void *ctx)
+{
+    if (state == ESP_PEER_STATE_CONNECTED) {
+        ((test_viewer_t *)ctx)->recv_connected = true;
+    }
+    return 0;
+}
+
+static int on_video_data(esp_peer_video_frame_t *frame, void *ctx)
+{
+    test_viewer_t *viewer = (test_viewer_t *)ctx;
+    test_frame_t info;
+    CHECK(frame->size == sizeof(info), "unexpected frame size %d", frame->size);
+    memcpy(&info, frame->data, sizeof(info));
+    pthread_mutex_lock(&viewer->lock);
+    if (viewer->frames == 0) {
+        viewer->first_key = info.key_frame;
+    } else {
+        CHECK(info.seq > viewer->last_seq, "frame %d after %d", (int)info.seq, (int)viewer->last_seq);
+    }
+    viewer->last_seq = info.seq;
+    viewer->frames++;
+    viewer->latency_sum += esp_timer_get_time() - info.send_us;
+    pthread_mutex_unlock(&viewer->lock);
+    return 0;
+}
+
+static void *recv_loop(void *arg)
+{
+    // Receiver side blocks on loopback wake semaphore like pc_task
+    test_viewer_t *viewer = (test_viewer_t *)arg;
+    while (viewer->running) {
+        esp_peer_main_loop(viewer->recv_pc);
+        esp_peer_wait_info_t info = {};
+        CHECK(esp_peer_get_wait_info(viewer->recv_pc, &info) == ESP_PEER_ERR_NONE, "get wait info");
+        if (info.timeout_ms) {
+            uint32_t timeout = info.timeout_ms < MAX_WAIT_INTERVAL ? info.timeout_ms : MAX_WAIT_INTERVAL;
+            media_lib_sema_lock((media_lib_sema_handle_t)info.wake_sema, timeout);
+        }
+    }
+    return NULL;
+}
+
+static esp_peer_handle_t open_pc(test_viewer_t *viewer, uint8_t channel, bool send)
+{
+    esp_peer_loopback_cfg_t link_cfg = {
+        .channel = channel,
+    };
+    esp_peer_cfg_t cfg = {
+        .video_info = {
+            .codec = ESP_PEER_VIDEO_CODEC_H264,
+            .width = 320,
+            .height = 240,
+            .fps = 1000 / FRAME_INTERVAL,
+        },
+        .video_dir = send ? ESP_PEER_MEDIA_DIR_SEND_ONLY : ESP_PEER_MEDIA_DIR_RECV_ONLY,
+        .on_state = send ? on_send_state : on_recv_state,
+        .on_video_data = on_video_data,
+        .ctx = viewer,
+        .extra_cfg = &link_cfg,
+        .extra_size = sizeof(link_cfg),
+    };
+    esp_peer_handle_t pc = NULL;
+    CHECK(esp_peer_open(&cfg, esp_peer_get_loopback_impl(), &pc) == ESP_PEER_ERR_NONE, "open peer");
+    CHECK(esp_peer_new_connection(pc) == ESP_PEER_ERR_NONE, "new connection");
+    return pc;
+}
+
+static void add_viewers(media_fanout_handle_t fanout, int start, int num)
+{
+    for (int i = start; i < start + num; i++) {
+        test_viewer_t *viewer = &viewers[i];
+        memset(viewer, 0, sizeof(test_viewer_t));
+        pthread_mutex_init(&viewer->lock, NULL);
+        viewer->send_pc = open_pc(viewer, (uint8_t)i, true);
+        viewer->recv_pc = open_pc(viewer, (uint8_t)i, false);
+        viewer->running = true;
+        pthread_create(&viewer->thread, NULL, recv_loop, viewer);
+        // Fan-out viewer thread drives main loop of sender side
+        CHECK(media_fanout_add_viewer(fanout, viewer->send_pc, &viewer->viewer) == ESP_PEER_ERR_NONE, "add viewer");
+    }
+    int64_t start_us = esp_timer_get_time();
+    for (int i = start; i < start + num; i++) {
+        while (!(viewers[i].send_connected && viewers[i].recv_connected)) {
+            CHECK(esp_timer_get_time() - start_us < 1000000, "viewer %d not connected", i);
+            usleep(1000);
+        }
+    }
+}
+
+static void send_frames(media_fanout_handle_t fanout, int num, int gop)
+{
+    for (int i = 0; i < num; i++) {
+        // Encoder restarts with key frame on request
+        bool key = key_pending || (gop && frame_seq % gop == 0);
+        key_pending = false;
+        test_frame_t info = {
+            .key_frame = key,
+            .seq = frame_seq,
+            .send_us = esp_timer_get_time(),
+        };
+        media_fanout_frame_t frame = {
+            .type = MEDIA_FANOUT_FRAME_VIDEO,
+            .key_frame = key,
+            .pts = frame_seq * FRAME_INTERVAL,
+            .data = (uint8_t *)&info,
+            .size = sizeof(info),
+        };
+        CHECK(media_fanout_send(fanout, &frame) == ESP_PEER_ERR_NONE, "fan-out send");
+        if (media_fanout_get_key_request(fanout) & 1) {
+            key_requests++;
+            key_request_seq = frame_seq;
+            key_pending = true;
+        }
+        frame_seq++;
+        usleep(FRAME_SLEEP_US);
+    }
+}
+
+static void wait_delivered(int num, uint32_t last_seq)
+{
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < num; i++) {
+        for (;;) {
+            pthread_mutex_lock(&viewers[i].lock);
+            bool done = viewers[i].frames && viewers[i].last_seq >= last_seq;
+            pthread_mutex_unlock(&viewers[i].lock);
+            if (done) {
+                break;
+            }
+            CHECK(esp_timer_get_time() - start < 1000000, "viewer %d missing frame %d", i, (int)last_seq);
+            usleep(1000);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    media_lib_add_default_os_adapter();
+    media_fanout_handle_t fanout = media_fanout_open(0);
+    CHECK(fanout, "open fan-out");
+
+    // Viewers joined before stream take natural key frame, shared encoder is never restarted
+    add_viewers(fanout, 0, EARLY_VIEWERS);
+    frame_seq = 1;
+    send_frames(fanout, NATURAL_GOP * 3, NATURAL_GOP);
+    CHECK(key_requests == 0, "%d key frame requests while natural GOP is %dms", key_requests, NATURAL_GOP * FRAME_INTERVAL);
+    wait_delivered(EARLY_VIEWERS, frame_seq - 1);
+
+    // Late viewers on a stream without natural key frame share one request after waiting
+    add_viewers(fanout, EARLY_VIEWERS, LATE_VIEWERS);
+    uint32_t join_seq = frame_seq;
+    send_frames(fanout, KEY_WAIT_MS * 2 / FRAME_INTERVAL, 0);
+    CHECK(key_requests == 1, "expect one key frame request got %d", key_requests);
+    int waited_ms = (int)(key_request_seq - join_seq) * FRAME_INTERVAL;
+    CHECK(waited_ms >= KEY_WAIT_MS && waited_ms <= KEY_WAIT_MS + FRAME_INTERVAL * 2,
+          "key frame requested after %dms of waiting", waited_ms);
+    wait_delivered(MAX_VIEWERS, frame_seq - 1);
+
+    int64_t latency_sum = 0;
+    int frames = 0;
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        test_viewer_t *viewer = &viewers[i];
+        CHECK(viewer->first_key, "viewer %d started from non key frame", i);
+        media_fanout_stat_t stat;
+        CHECK(media_fanout_get_stat(fanout, viewer->viewer, &stat, false) == ESP_PEER_ERR_NONE, "get stat");
+        printf("Viewer %d: received %d sent %d dropped %d\n", i, viewer->frames, (int)stat.video_frames,
+               (int)stat.video_dropped);
+        CHECK(viewer->frames == (int)stat.video_frames, "viewer %d lost frames on link", i);
+        latency_sum += viewer->latency_sum;
+        frames += viewer->frames;
+    }
+    CHECK(viewers[MAX_VIEWERS - 1].last_seq > join_seq, "late viewer got no frame");
+    int avg_latency = (int)(latency_sum / frames);
+    printf("%d viewers fan-out to receive latency avg %dus\n", MAX_VIEWERS, avg_latency);
+    CHECK(avg_latency < MAX_AVG_LATENCY_US, "fan-out latency %dus too high", avg_latency);
+
+    for (int i = 0; i < MAX_VIEWERS; i++) {
+        test_viewer_t *viewer = &viewers[i];
+        CHECK(media_fanout_remove_viewer(fanout, viewer->viewer) == ESP_PEER_ERR_NONE, "remove viewer");
+        viewer->running = false;
+        pthread_join(viewer->thread, NULL);
+        esp_peer_close(viewer->send_pc);
+        esp_peer_close(viewer->recv_pc);
+        pthread_mutex_destroy(&viewer->lock);
+    }
+    media_fanout_close(fanout);
+    printf("Fan-out test passed\n");
+    return 0;
+}
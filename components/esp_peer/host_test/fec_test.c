@@ -0,0 +1,301 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_peer_fec.h"
+
+#define MTU              (1200)
+#define FEC_PT           (120)
+#define RED_PT           (121)
+#define MAX_PACKETS      (8192)
+#define VIDEO_FRAMES     (300)
+#define MAX_FRAME_SIZE   (24 * 1024)
+#define AUDIO_FRAMES     (3000)
+#define AUDIO_FRAME_SIZE (120)
+#define VIDEO_LOSS       (5)  // Percent
+#define AUDIO_LOSS       (10) // Percent
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef struct {
+    uint8_t data[MTU];
+    int     size;
+    bool    is_fec;
+    bool    lost;
+} wire_packet_t;
+
+typedef struct {
+    uint8_t data[MTU];
+    int     size;
+    bool    received;
+    bool    output;
+} media_packet_t;
+
+static wire_packet_t  wire[MAX_PACKETS];
+static int            wire_num;
+static media_packet_t media[65536];
+static int            media_num;
+static int            max_fec_size;
+static uint32_t       output_num;
+
+static uint16_t get_be16(const uint8_t *data)
+{
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static void wire_add(esp_peer_rtp_iovec_t *iov, int iov_num, bool is_fec)
+{
+    CHECK(wire_num < MAX_PACKETS, "too many packets");
+    wire_packet_t *pkt = &wire[wire_num++];
+    pkt->size = 0;
+    pkt->is_fec = is_fec;
+    pkt->lost = false;
+    for (int i = 0; i < iov_num; i++) {
+        CHECK(pkt->size + iov[i].size <= MTU, "packet size %d over MTU %d", pkt->size + iov[i].size, MTU);
+        memcpy(pkt->data + pkt->size, iov[i].data, iov[i].size);
+        pkt->size += iov[i].size;
+    }
+}
+
+static int on_fec_packet(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    wire_add(iov, iov_num, true);
+    int size = wire[wire_num - 1].size;
+    if (size > max_fec_size) {
+        max_fec_size = size;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int on_media_packet(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    // Keep copy of sent packet to verify recovered one byte by byte
+    wire_add(iov, iov_num, false);
+    wire_packet_t *pkt = &wire[wire_num - 1];
+    media_packet_t *orig = &media[get_be16(pkt->data + 2)];
+    memcpy(orig->data, pkt->data, pkt->size);
+    orig->size = pkt->size;
+    media_num++;
+    return esp_peer_fec_encode((esp_peer_fec_handle_t)ctx, iov, iov_num, on_fec_packet, NULL);
+}
+
+static int on_red_packet(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    wire_add(iov, iov_num, false);
+    return ESP_PEER_ERR_NONE;
+}
+
+static int on_audio_packet(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    media_packet_t *orig = &media[get_be16(iov[0].data + 2)];
+    orig->size = 0;
+    for (int i = 0; i < iov_num; i++) {
+        memcpy(orig->data + orig->size, iov[i].data, iov[i].size);
+        orig->size += iov[i].size;
+    }
+    media_num++;
+    return esp_peer_red_encode((esp_peer_fec_handle_t)ctx, iov, iov_num, on_red_packet, NULL);
+}
+
+static int on_output(const uint8_t *data, int size, void *ctx)
+{
+    media_packet_t *orig = &media[get_be16(data + 2)];
+    CHECK(orig->size == size && memcmp(orig->data, data, size) == 0, "packet %d differs from sent one",
+          get_be16(data + 2));
+    CHECK(orig->output == false, "packet %d output twice", get_be16(data + 2));
+    orig->output = true;
+    output_num++;
+    return ESP_PEER_ERR_NONE;
+}
+
+static void reset_packets(void)
+{
+    wire_num = 0;
+    media_num = 0;
+    max_fec_size = 0;
+    output_num = 0;
+    memset(media, 0, sizeof(media));
+}
+
+static void apply_loss(int loss_percent)
+{
+    for (int i = 0; i < wire_num; i++) {
+        wire[i].lost = (rand() % 100) < loss_percent;
+        if (wire[i].is_fec == false && wire[i].lost == false) {
+            media[get_be16(wire[i].data + 2)].received = true;
+        }
+    }
+}
+
+static int make_h264_frame(uint8_t *frame)
+{
+    int size = 500 + rand() % (MAX_FRAME_SIZE - 500);
+    frame[0] = frame[1] = frame[2] = 0;
+    frame[3] = 1;
+    frame[4] = 0x41;
+    for (int i = 5; i < size; i++) {
+        // Avoid start code emulation inside NAL body
+        frame[i] = (uint8_t)(rand() % 255 + 1);
+    }
+    return size;
+}
+
+static int expected_fec_recovery(void)
+{
+    // Group is repaired when its FEC packet arrives and exactly one of its media packets is lost
+    int expected = 0;
+    for (int i = 0; i < wire_num; i++) {
+        if (wire[i].is_fec == false || wire[i].lost) {
+            continue;
+        }
+        uint16_t base_seq = get_be16(wire[i].data + ESP_PEER_RTP_HEADER_SIZE + 12);
+        uint16_t mask = get_be16(wire[i].data + ESP_PEER_RTP_HEADER_SIZE + 14);
+        int missing = 0;
+        for (int j = 0; j < ESP_PEER_FEC_MAX_GROUP; j++) {
+            if ((mask & (0x8000 >> j)) == 0) {
+                continue;
+            }
+            media_packet_t *protected_pkt = &media[(uint16_t)(base_seq + j)];
+            CHECK(protected_pkt->size + ESP_PEER_FEC_HEADER_SIZE <= MTU, "protected packet too large for FEC");
+            missing += (protected_pkt->received == false);
+        }
+        expected += (missing == 1);
+    }
+    return expected;
+}
+
+static void test_fec(int packetizer_mtu)
+{
+    reset_packets();
+    esp_peer_fec_encoder_cfg_t enc_cfg = {
+        .payload_type = FEC_PT,
+        .ssrc = 0x5678,
+        .max_packet_size = MTU,
+        .group_size = 8,
+    };
+    esp_peer_fec_handle_t enc = NULL;
+    CHECK(esp_peer_fec_encoder_open(&enc_cfg, &enc) == ESP_PEER_ERR_NONE, "open FEC encoder");
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_H264,
+        .payload_type = 96,
+        .ssrc = 0x1234,
+        .mtu = packetizer_mtu,
+    };
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    CHECK(esp_peer_rtp_packetizer_open(&pack_cfg, &packetizer) == ESP_PEER_ERR_NONE, "open packetizer");
+    uint8_t *frame = (uint8_t *)malloc(MAX_FRAME_SIZE);
+    CHECK(frame, "no memory");
+    for (int i = 0; i < VIDEO_FRAMES; i++) {
+        int size = make_h264_frame(frame);
+        CHECK(esp_peer_rtp_packetize(packetizer, frame, size, i * 33, on_media_packet, enc) == ESP_PEER_ERR_NONE,
+              "packetize frame %d", i);
+    }
+    free(frame);
+    esp_peer_rtp_packetizer_close(packetizer);
+    esp_peer_fec_encoder_close(enc);
+    CHECK(max_fec_size <= MTU, "FEC packet size %d over MTU %d", max_fec_size, MTU);
+
+    apply_loss(VIDEO_LOSS);
+    esp_peer_fec_decoder_cfg_t dec_cfg = {
+        .payload_type = FEC_PT,
+        .max_packet_size = MTU,
+    };
+    esp_peer_fec_handle_t dec = NULL;
+    CHECK(esp_peer_fec_decoder_open(&dec_cfg, &dec) == ESP_PEER_ERR_NONE, "open FEC decoder");
+    for (int i = 0; i < wire_num; i++) {
+        if (wire[i].lost == false) {
+            esp_peer_fec_decode(dec, wire[i].data, wire[i].size, on_output, NULL);
+        }
+    }
+    esp_peer_fec_stat_t stat = {};
+    esp_peer_fec_decoder_get_stat(dec, &stat);
+    esp_peer_fec_decoder_close(dec);
+    int expected = expected_fec_recovery();
+    printf("FEC mtu %d: media %d fec %d max FEC size %d lost %d recovered %d unrecovered %d\n", packetizer_mtu,
+           media_num, (int)stat.fec_packets, max_fec_size, (int)stat.lost, (int)stat.recovered, (int)stat.unrecovered);
+    CHECK(stat.recovered == expected && expected > 0, "recovered %d expected %d", (int)stat.recovered, expected);
+    CHECK(output_num == stat.media_packets + stat.recovered, "output %d packets", (int)output_num);
+}
+
+static void test_red(void)
+{
+    reset_packets();
+    esp_peer_red_encoder_cfg_t enc_cfg = {
+        .payload_type = RED_PT,
+        .enable = true,
+    };
+    esp_peer_fec_handle_t enc = NULL;
+    CHECK(esp_peer_red_encoder_open(&enc_cfg, &enc) == ESP_PEER_ERR_NONE, "open RED encoder");
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_OPUS,
+        .payload_type = 111,
+        .ssrc = 0x4321,
+    };
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    CHECK(esp_peer_rtp_packetizer_open(&pack_cfg, &packetizer) == ESP_PEER_ERR_NONE, "open packetizer");
+    uint8_t frame[AUDIO_FRAME_SIZE];
+    for (int i = 0; i < AUDIO_FRAMES; i++) {
+        int size = AUDIO_FRAME_SIZE / 2 + rand() % (AUDIO_FRAME_SIZE / 2);
+        for (int j = 0; j < size; j++) {
+            frame[j] = (uint8_t)rand();
+        }
+        CHECK(esp_peer_rtp_packetize(packetizer, frame, size, i * 20, on_audio_packet, enc) == ESP_PEER_ERR_NONE,
+              "packetize audio %d", i);
+    }
+    esp_peer_rtp_packetizer_close(packetizer);
+    esp_peer_red_encoder_close(enc);
+
+    apply_loss(AUDIO_LOSS);
+    // Lost packet is rebuilt from redundant block of the next one, loss before first received packet is not seen
+    int first = 0;
+    while (wire[first].lost) {
+        first++;
+    }
+    int expected = 0;
+    for (int i = first; i + 1 < wire_num; i++) {
+        expected += (wire[i].lost && wire[i + 1].lost == false);
+    }
+    esp_peer_red_decoder_cfg_t dec_cfg = {
+        .payload_type = RED_PT,
+    };
+    esp_peer_fec_handle_t dec = NULL;
+    CHECK(esp_peer_red_decoder_open(&dec_cfg, &dec) == ESP_PEER_ERR_NONE, "open RED decoder");
+    for (int i = 0; i < wire_num; i++) {
+        if (wire[i].lost == false) {
+            esp_peer_red_decode(dec, wire[i].data, wire[i].size, on_output, NULL);
+        }
+    }
+    esp_peer_fec_stat_t stat = {};
+    esp_peer_red_decoder_get_stat(dec, &stat);
+    esp_peer_red_decoder_close(dec);
+    printf("RED: media %d lost %d recovered %d unrecovered %d\n", media_num, (int)stat.lost, (int)stat.recovered,
+           (int)stat.unrecovered);
+    CHECK(wire_num == media_num, "RED should not add packets");
+    CHECK(stat.recovered == expected && expected > 0, "recovered %d expected %d", (int)stat.recovered, expected);
+    CHECK(output_num == stat.media_packets + stat.recovered, "output %d packets", (int)output_num);
+}
+
+int main(void)
+{
+    srand(1234);
+    // Packetizer leaves room for FEC header so every packet is protected
+    test_fec(MTU - ESP_PEER_FEC_HEADER_SIZE);
+    // Full size packets are left unprotected, FEC packet still fits into MTU
+    test_fec(MTU);
+    test_red();
+    printf("FEC test passed\n");
+    return 0;
+}
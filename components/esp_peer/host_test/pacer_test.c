@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_peer_pacer.h"
+
+#define SIM_DURATION_MS  (10000)
+#define FRAME_INTERVAL   (33)
+#define GOP_SIZE         (30)
+#define KEY_FRAME_SIZE   (60 * 1024)
+#define FRAME_SIZE       (3 * 1024)
+#define PACKET_SIZE      (1200)
+#define AUDIO_INTERVAL   (20)
+#define AUDIO_SIZE       (100)
+#define TARGET_BITRATE   (1200000)
+#define MAX_BITRATE      (1800000)
+// Bottleneck link: Wi-Fi AP with small buffer in front of slower uplink
+#define LINK_BITRATE     (2000000)
+#define LINK_BUFFER      (24 * 1024)
+#define RATE_WINDOW_MS   (50)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef struct {
+    int64_t  now_us;
+    double   link_bytes;    // Bytes waiting in bottleneck buffer
+    uint32_t link_drops;
+    uint32_t window_bytes[SIM_DURATION_MS / RATE_WINDOW_MS + 64];
+    uint32_t audio_max_delay_us;
+    uint32_t video_max_delay_us;
+} link_sim_t;
+
+static link_sim_t sim;
+
+static void link_drain(double elapsed_us)
+{
+    sim.link_bytes -= elapsed_us * LINK_BITRATE / 8 / 1000000;
+    if (sim.link_bytes < 0) {
+        sim.link_bytes = 0;
+    }
+}
+
+static int link_send(const uint8_t *data, int size, bool is_audio, void *ctx)
+{
+    int64_t enqueue_us;
+    memcpy(&enqueue_us, data, sizeof(enqueue_us));
+    uint32_t delay_us = (uint32_t)(sim.now_us - enqueue_us);
+    if (is_audio && delay_us > sim.audio_max_delay_us) {
+        sim.audio_max_delay_us = delay_us;
+    }
+    if (is_audio == false && delay_us > sim.video_max_delay_us) {
+        sim.video_max_delay_us = delay_us;
+    }
+    sim.window_bytes[sim.now_us / 1000 / RATE_WINDOW_MS] += size;
+    if (sim.link_bytes + size > LINK_BUFFER) {
+        sim.link_drops++;
+        return ESP_PEER_ERR_NONE;
+    }
+    sim.link_bytes += size;
+    return ESP_PEER_ERR_NONE;
+}
+
+static void make_packet(uint8_t *pkt, int size)
+{
+    memset(pkt, 0x5A, size);
+    memcpy(pkt, &sim.now_us, sizeof(sim.now_us));
+}
+
+static void send_frame(esp_peer_pacer_handle_t pacer, int frame_size, bool paced)
+{
+    uint8_t pkt[PACKET_SIZE];
+    for (int sent = 0; sent < frame_size; sent += PACKET_SIZE) {
+        int size = frame_size - sent < PACKET_SIZE ? frame_size - sent : PACKET_SIZE;
+        make_packet(pkt, size);
+        if (paced) {
+            esp_peer_rtp_iovec_t iov = { .data = pkt, .size = size };
+            esp_peer_pacer_enqueue(pacer, false, &iov, 1, sim.now_us);
+        } else {
+            link_send(pkt, size, false, NULL);
+        }
+    }
+}
+
+static void send_audio(esp_peer_pacer_handle_t pacer, bool paced)
+{
+    uint8_t pkt[AUDIO_SIZE];
+    make_packet(pkt, AUDIO_SIZE);
+    if (paced) {
+        esp_peer_rtp_iovec_t iov = { .data = pkt, .size = AUDIO_SIZE };
+        esp_peer_pacer_enqueue(pacer, true, &iov, 1, sim.now_us);
+    } else {
+        link_send(pkt, AUDIO_SIZE, true, NULL);
+    }
+}
+
+static void run_sim(bool paced, esp_peer_pacer_stat_t *stat)
+{
+    memset(&sim, 0, sizeof(sim));
+    esp_peer_pacer_handle_t pacer = NULL;
+    if (paced) {
+        esp_peer_pacer_cfg_t cfg = {
+            .bitrate = TARGET_BITRATE,
+            .max_bitrate = MAX_BITRATE,
+            .frame_interval = FRAME_INTERVAL,
+        };
+        CHECK(esp_peer_pacer_open(&cfg, &pacer) == ESP_PEER_ERR_NONE, "open pacer");
+    }
+    int frame_idx = 0;
+    // Run 1 ms ticks, keep going after capture stops until queue drained
+    for (int ms = 0; ms < SIM_DURATION_MS + 2000; ms++) {
+        sim.now_us = (int64_t)ms * 1000;
+        if (ms < SIM_DURATION_MS) {
+            if (ms % FRAME_INTERVAL == 0) {
+                send_frame(pacer, frame_idx % GOP_SIZE ? FRAME_SIZE : KEY_FRAME_SIZE, paced);
+                frame_idx++;
+            }
+            if (ms % AUDIO_INTERVAL == 0) {
+                send_audio(pacer, paced);
+            }
+        }
+        if (paced) {
+            esp_peer_pacer_process(pacer, sim.now_us, link_send, NULL, NULL);
+        }
+        link_drain(1000);
+    }
+    if (paced) {
+        esp_peer_pacer_get_stat(pacer, stat, false);
+        esp_peer_pacer_close(pacer);
+    }
+}
+
+int main(void)
+{
+    esp_peer_pacer_stat_t stat = {};
+    run_sim(false, &stat);
+    uint32_t burst_drops = sim.link_drops;
+    printf("Unpaced: link drops %d\n", (int)burst_drops);
+    // Model sanity: key frame burst must overflow the bottleneck buffer
+    CHECK(burst_drops > 0, "unpaced key frame burst should overflow link buffer");
+
+    run_sim(true, &stat);
+    uint32_t max_window = 0;
+    for (int i = 0; i < sizeof(sim.window_bytes) / sizeof(sim.window_bytes[0]); i++) {
+        if (sim.window_bytes[i] > max_window) {
+            max_window = sim.window_bytes[i];
+        }
+    }
+    uint32_t max_rate = (uint32_t)((uint64_t)max_window * 8 * 1000 / RATE_WINDOW_MS);
+    printf("Paced: link drops %d max rate %d bps audio delay %dus video max delay %dms (pacer avg %dms max %dms)\n",
+           (int)sim.link_drops, (int)max_rate, (int)sim.audio_max_delay_us, (int)(sim.video_max_delay_us / 1000),
+           (int)stat.avg_queue_delay_ms, (int)stat.max_queue_delay_ms);
+    CHECK(sim.link_drops == 0, "paced stream lost %d packets on bottleneck", (int)sim.link_drops);
+    // Audio packets in one window may add to video which is paced to the maximum rate
+    uint32_t rate_limit = MAX_BITRATE + (uint32_t)((uint64_t)(PACKET_SIZE + 3 * AUDIO_SIZE) * 8 * 1000 / RATE_WINDOW_MS);
+    CHECK(max_rate <= rate_limit, "send rate %d over limit %d", (int)max_rate, (int)rate_limit);
+    CHECK(sim.audio_max_delay_us == 0, "audio waited %dus behind video", (int)sim.audio_max_delay_us);
+    // Key frame drains at maximum rate, add one frame interval for queued delta frame
+    uint32_t delay_limit = (uint32_t)((uint64_t)KEY_FRAME_SIZE * 8 * 1000 / MAX_BITRATE) + FRAME_INTERVAL;
+    CHECK(stat.max_queue_delay_ms <= delay_limit, "queue delay %dms over %dms", (int)stat.max_queue_delay_ms,
+          (int)delay_limit);
+    CHECK(stat.max_queue_delay_ms == sim.video_max_delay_us / 1000, "pacer delay statistics mismatch");
+    CHECK(stat.queue_bytes == 0 && stat.dropped_packets == 0, "queue not drained");
+    printf("Pacer test passed\n");
+    return 0;
+}
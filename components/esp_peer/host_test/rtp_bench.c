@@ -0,0 +1,151 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_peer_rtp.h"
+
+#define MAX_PACKETS     (512)
+#define MAX_PACKET_SIZE (1500)
+#define KEY_FRAME_SIZE  (60 * 1024)
+#define FRAME_SIZE      (8 * 1024)
+#define GOP_SIZE        (30)
+
+typedef struct {
+    uint8_t data[MAX_PACKET_SIZE];
+    int     size;
+} bench_packet_t;
+
+static bench_packet_t packets[MAX_PACKETS];
+static int            packet_num;
+static uint64_t       out_bytes;
+
+static int on_packet_count(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    packet_num++;
+    return ESP_PEER_ERR_NONE;
+}
+
+static int on_packet_copy(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    bench_packet_t *pkt = &packets[packet_num++ % MAX_PACKETS];
+    pkt->size = 0;
+    for (int i = 0; i < iov_num; i++) {
+        memcpy(pkt->data + pkt->size, iov[i].data, iov[i].size);
+        pkt->size += iov[i].size;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int on_frame(esp_peer_rtp_frame_t *frame, void *ctx)
+{
+    out_bytes += frame->size;
+    return ESP_PEER_ERR_NONE;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int build_h264_frame(uint8_t *buf, bool key_frame, int size)
+{
+    static const uint8_t start_code[4] = { 0, 0, 0, 1 };
+    int pos = 0;
+    memcpy(buf + pos, start_code, 4);
+    pos += 4;
+    buf[pos++] = key_frame ? 0x65 : 0x41;
+    while (pos < size) {
+        buf[pos++] = (uint8_t)(rand() % 255 + 1);
+    }
+    return size;
+}
+
+int main(int argc, char *argv[])
+{
+    int gop_num = argc > 1 ? atoi(argv[1]) : 1000;
+    static uint8_t key_frame[KEY_FRAME_SIZE];
+    static uint8_t frame[FRAME_SIZE];
+    build_h264_frame(key_frame, true, sizeof(key_frame));
+    build_h264_frame(frame, false, sizeof(frame));
+
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_H264,
+        .payload_type = 96,
+    };
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    esp_peer_rtp_packetizer_open(&pack_cfg, &packetizer);
+    esp_peer_rtp_depacketizer_cfg_t dep_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_H264,
+    };
+
+    // Packetize only, segments are not copied
+    uint64_t bytes = 0;
+    uint32_t pts = 0;
+    packet_num = 0;
+    double start = now_sec();
+    for (int g = 0; g < gop_num; g++) {
+        for (int i = 0; i < GOP_SIZE; i++) {
+            uint8_t *data = i ? frame : key_frame;
+            int size = i ? sizeof(frame) : sizeof(key_frame);
+            esp_peer_rtp_packetize(packetizer, data, size, pts, on_packet_count, NULL);
+            bytes += size;
+            pts += 33;
+        }
+    }
+    double cost = now_sec() - start;
+    printf("Packetize:   %d packets %.1f MB/s %.0f packets/s\n", packet_num, bytes / cost / 1e6, packet_num / cost);
+
+    // Depacketize pre-built GOP in order and with adjacent packets swapped
+    for (int reorder = 0; reorder < 2; reorder++) {
+        packet_num = 0;
+        for (int i = 0; i < GOP_SIZE; i++) {
+            esp_peer_rtp_packetize(packetizer, i ? frame : key_frame, i ? sizeof(frame) : sizeof(key_frame),
+                                   pts, on_packet_copy, NULL);
+            pts += 33;
+        }
+        int gop_packets = packet_num < MAX_PACKETS ? packet_num : MAX_PACKETS;
+        if (reorder) {
+            for (int i = 0; i + 1 < gop_packets; i += 2) {
+                bench_packet_t tmp = packets[i];
+                packets[i] = packets[i + 1];
+                packets[i + 1] = tmp;
+            }
+        }
+        esp_peer_rtp_depacketizer_handle_t depacketizer = NULL;
+        esp_peer_rtp_depacketizer_open(&dep_cfg, &depacketizer);
+        out_bytes = 0;
+        start = now_sec();
+        for (int g = 0; g < gop_num; g++) {
+            // Shift sequence number and timestamp so every GOP looks new
+            for (int i = 0; i < gop_packets; i++) {
+                uint8_t *hdr = packets[i].data;
+                uint16_t seq = ((hdr[2] << 8) | hdr[3]) + gop_packets;
+                uint32_t ts = ((uint32_t)hdr[4] << 24 | hdr[5] << 16 | hdr[6] << 8 | hdr[7]) + GOP_SIZE * 3000;
+                hdr[2] = seq >> 8;
+                hdr[3] = seq & 0xFF;
+                hdr[4] = ts >> 24;
+                hdr[5] = (ts >> 16) & 0xFF;
+                hdr[6] = (ts >> 8) & 0xFF;
+                hdr[7] = ts & 0xFF;
+                esp_peer_rtp_depacketize(depacketizer, packets[i].data, packets[i].size, on_frame, NULL);
+            }
+        }
+        cost = now_sec() - start;
+        esp_peer_rtp_stat_t stat;
+        esp_peer_rtp_depacketizer_get_stat(depacketizer, &stat);
+        printf("Depacketize%s: %.1f MB/s %.0f packets/s lost:%d\n", reorder ? " (reordered)" : "",
+               out_bytes / cost / 1e6, (double)gop_packets * gop_num / cost, (int)stat.lost);
+        esp_peer_rtp_depacketizer_close(depacketizer);
+    }
+    esp_peer_rtp_packetizer_close(packetizer);
+    return 0;
+}
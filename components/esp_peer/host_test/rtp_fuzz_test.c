@@ -0,0 +1,406 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_peer_rtp.h"
+
+#define MAX_PACKETS      (4096)
+#define MAX_PACKET_SIZE  (1500)
+#define MAX_FRAMES       (64)
+#define MAX_FRAME_SIZE   (64 * 1024)
+#define FUZZ_ITERATIONS  (100000)
+
+#define TEST_CHECK(cond, fmt, ...) do {                           \
+    if (!(cond)) {                                                \
+        printf("FAIL %s:%d " fmt "\n", __func__, __LINE__, ##__VA_ARGS__); \
+        return -1;                                                \
+    }                                                             \
+} while (0)
+
+typedef struct {
+    uint8_t data[MAX_PACKET_SIZE];
+    int     size;
+} test_packet_t;
+
+typedef struct {
+    uint8_t *data;
+    int      size;
+    bool     key_frame;
+} test_frame_t;
+
+static test_packet_t packets[MAX_PACKETS];
+static int           packet_num;
+static test_frame_t  out_frames[MAX_FRAMES];
+static int           out_num;
+
+static int on_packet(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    if (packet_num >= MAX_PACKETS) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    test_packet_t *pkt = &packets[packet_num++];
+    pkt->size = 0;
+    for (int i = 0; i < iov_num; i++) {
+        if (pkt->size + iov[i].size > MAX_PACKET_SIZE) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        memcpy(pkt->data + pkt->size, iov[i].data, iov[i].size);
+        pkt->size += iov[i].size;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int on_frame(esp_peer_rtp_frame_t *frame, void *ctx)
+{
+    if (out_num >= MAX_FRAMES) {
+        return ESP_PEER_ERR_NONE;
+    }
+    test_frame_t *out = &out_frames[out_num++];
+    out->data = (uint8_t *)malloc(frame->size);
+    memcpy(out->data, frame->data, frame->size);
+    out->size = frame->size;
+    out->key_frame = frame->key_frame;
+    return ESP_PEER_ERR_NONE;
+}
+
+static int on_frame_discard(esp_peer_rtp_frame_t *frame, void *ctx)
+{
+    // Touch every byte so that sanitizer catches bad output range
+    volatile uint8_t sum = 0;
+    for (int i = 0; i < frame->size; i++) {
+        sum += frame->data[i];
+    }
+    (void)sum;
+    return ESP_PEER_ERR_NONE;
+}
+
+static void clear_frames(void)
+{
+    for (int i = 0; i < out_num; i++) {
+        free(out_frames[i].data);
+    }
+    out_num = 0;
+}
+
+static int add_nal(uint8_t *buf, int pos, uint8_t nal_hdr, int size)
+{
+    static const uint8_t start_code[4] = { 0, 0, 0, 1 };
+    memcpy(buf + pos, start_code, sizeof(start_code));
+    pos += sizeof(start_code);
+    buf[pos++] = nal_hdr;
+    // Non-zero payload never forms a start code
+    for (int i = 1; i < size; i++) {
+        buf[pos++] = (uint8_t)(rand() % 255 + 1);
+    }
+    return pos;
+}
+
+static int build_h264_frame(uint8_t *buf, bool key_frame, int slice_size)
+{
+    int size = 0;
+    if (key_frame) {
+        size = add_nal(buf, size, 0x67, 12);
+        size = add_nal(buf, size, 0x68, 4);
+        size = add_nal(buf, size, 0x65, slice_size);
+    } else {
+        size = add_nal(buf, size, 0x41, slice_size);
+    }
+    return size;
+}
+
+static void shuffle_packets(int start, int end, int max_shift)
+{
+    // Reverse small groups so that no packet moves further than reorder window allows
+    for (int g = start; g < end; g += max_shift) {
+        int l = g, r = (g + max_shift < end ? g + max_shift : end) - 1;
+        while (l < r) {
+            test_packet_t tmp = packets[l];
+            packets[l++] = packets[r];
+            packets[r--] = tmp;
+        }
+    }
+}
+
+static int test_h264_reorder(uint8_t reorder_num, uint16_t start_seq)
+{
+    static uint8_t frames[MAX_FRAMES][MAX_FRAME_SIZE];
+    int frame_size[MAX_FRAMES];
+    int frame_num = 30;
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_H264,
+        .payload_type = 96,
+        .ssrc = 1,
+        .start_seq = start_seq,
+    };
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    TEST_CHECK(esp_peer_rtp_packetizer_open(&pack_cfg, &packetizer) == ESP_PEER_ERR_NONE, "open packetizer");
+    packet_num = 0;
+    for (int i = 0; i < frame_num; i++) {
+        frame_size[i] = build_h264_frame(frames[i], i == 0, i == 0 ? 30000 : 500 + rand() % 3000);
+        TEST_CHECK(esp_peer_rtp_packetize(packetizer, frames[i], frame_size[i], i * 33, on_packet, NULL) == ESP_PEER_ERR_NONE,
+                   "packetize frame %d", i);
+    }
+    esp_peer_rtp_packetizer_close(packetizer);
+
+    // First packet (STAP-A with SPS and PPS) arrives after the second one
+    test_packet_t tmp = packets[0];
+    packets[0] = packets[1];
+    packets[1] = tmp;
+    shuffle_packets(2, packet_num, reorder_num / 2 > 1 ? reorder_num / 2 : 1);
+
+    esp_peer_rtp_depacketizer_cfg_t dep_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_H264,
+        .reorder_num = reorder_num,
+    };
+    esp_peer_rtp_depacketizer_handle_t depacketizer = NULL;
+    TEST_CHECK(esp_peer_rtp_depacketizer_open(&dep_cfg, &depacketizer) == ESP_PEER_ERR_NONE, "open depacketizer");
+    for (int i = 0; i < packet_num; i++) {
+        esp_peer_rtp_depacketize(depacketizer, packets[i].data, packets[i].size, on_frame, NULL);
+    }
+    esp_peer_rtp_stat_t stat;
+    esp_peer_rtp_depacketizer_get_stat(depacketizer, &stat);
+    esp_peer_rtp_depacketizer_close(depacketizer);
+
+    int ret = 0;
+    if (stat.lost || stat.discarded || out_num + 1 < frame_num) {
+        printf("FAIL %s reorder:%d seq:%d lost:%d discarded:%d frames:%d/%d\n", __func__, reorder_num, start_seq,
+               (int)stat.lost, (int)stat.discarded, out_num, frame_num);
+        ret = -1;
+    }
+    // Last frame stays in progress till next timestamp arrives when marker packet is reordered
+    for (int i = 0; ret == 0 && i < out_num; i++) {
+        if (out_frames[i].size != frame_size[i] || memcmp(out_frames[i].data, frames[i], frame_size[i]) ||
+            out_frames[i].key_frame != (i == 0)) {
+            printf("FAIL %s reorder:%d frame %d size %d expect %d\n", __func__, reorder_num, i, out_frames[i].size, frame_size[i]);
+            ret = -1;
+        }
+    }
+    clear_frames();
+    return ret;
+}
+
+static int test_h264_loss(void)
+{
+    static uint8_t frame[MAX_FRAME_SIZE];
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_H264,
+        .payload_type = 96,
+    };
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    esp_peer_rtp_packetizer_open(&pack_cfg, &packetizer);
+    packet_num = 0;
+    int frame_size = build_h264_frame(frame, true, 8000);
+    for (int i = 0; i < 4; i++) {
+        esp_peer_rtp_packetize(packetizer, frame, frame_size, i * 33, on_packet, NULL);
+    }
+    esp_peer_rtp_packetizer_close(packetizer);
+    int per_frame = packet_num / 4;
+
+    esp_peer_rtp_depacketizer_cfg_t dep_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_H264,
+        .reorder_num = 4,
+    };
+    esp_peer_rtp_depacketizer_handle_t depacketizer = NULL;
+    esp_peer_rtp_depacketizer_open(&dep_cfg, &depacketizer);
+    for (int i = 0; i < packet_num; i++) {
+        // Drop one middle packet of second frame
+        if (i != per_frame + 2) {
+            esp_peer_rtp_depacketize(depacketizer, packets[i].data, packets[i].size, on_frame, NULL);
+        }
+    }
+    esp_peer_rtp_stat_t stat;
+    esp_peer_rtp_depacketizer_get_stat(depacketizer, &stat);
+    esp_peer_rtp_depacketizer_close(depacketizer);
+    int got = out_num;
+    clear_frames();
+    TEST_CHECK(stat.lost == 1, "lost %d", (int)stat.lost);
+    TEST_CHECK(stat.dropped_frames == 1, "dropped %d", (int)stat.dropped_frames);
+    TEST_CHECK(got == 3, "frames %d", got);
+    return 0;
+}
+
+static int build_rtp_jpeg(uint8_t *pkt, int scan_size)
+{
+    static const uint8_t rtp_hdr[12] = { 0x80, 0x80 | 26, 0, 1, 0, 0, 0, 0, 0, 0, 0, 2 };
+    static const uint8_t jpeg_hdr[8] = { 0, 0, 0, 0, 1, 80, 320 / 8, 240 / 8 };
+    memcpy(pkt, rtp_hdr, sizeof(rtp_hdr));
+    memcpy(pkt + sizeof(rtp_hdr), jpeg_hdr, sizeof(jpeg_hdr));
+    int size = sizeof(rtp_hdr) + sizeof(jpeg_hdr);
+    for (int i = 0; i < scan_size; i++) {
+        pkt[size++] = (uint8_t)(rand() % 0xFF);
+    }
+    return size;
+}
+
+static int test_jpeg_roundtrip(void)
+{
+    static uint8_t pkt[MAX_PACKET_SIZE];
+    // Window smaller than packet number of the frame so that depacketizer starts within it
+    esp_peer_rtp_depacketizer_cfg_t dep_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_MJPEG,
+        .reorder_num = 4,
+    };
+    // Build a JPEG file from single RTP packet using default tables, no reorder so that it is output at once
+    esp_peer_rtp_depacketizer_cfg_t build_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_MJPEG,
+        .reorder_num = 1,
+    };
+    esp_peer_rtp_depacketizer_handle_t depacketizer = NULL;
+    esp_peer_rtp_depacketizer_open(&build_cfg, &depacketizer);
+    int size = build_rtp_jpeg(pkt, 1000);
+    esp_peer_rtp_depacketize(depacketizer, pkt, size, on_frame, NULL);
+    esp_peer_rtp_depacketizer_close(depacketizer);
+    TEST_CHECK(out_num == 1 && out_frames[0].key_frame, "jpeg build frames %d", out_num);
+    test_frame_t jpeg = out_frames[0];
+    out_num = 0;
+
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_MJPEG,
+        .payload_type = 26,
+        .mtu = 200,
+    };
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    esp_peer_rtp_packetizer_open(&pack_cfg, &packetizer);
+    packet_num = 0;
+    int ret = esp_peer_rtp_packetize(packetizer, jpeg.data, jpeg.size, 0, on_packet, NULL);
+    esp_peer_rtp_packetizer_close(packetizer);
+    if (ret != ESP_PEER_ERR_NONE) {
+        free(jpeg.data);
+        TEST_CHECK(false, "packetize jpeg ret %d", ret);
+    }
+    shuffle_packets(0, packet_num, 3);
+    esp_peer_rtp_depacketizer_open(&dep_cfg, &depacketizer);
+    for (int i = 0; i < packet_num; i++) {
+        esp_peer_rtp_depacketize(depacketizer, packets[i].data, packets[i].size, on_frame, NULL);
+    }
+    esp_peer_rtp_depacketizer_close(depacketizer);
+    bool match = out_num == 1 && out_frames[0].size == jpeg.size && memcmp(out_frames[0].data, jpeg.data, jpeg.size) == 0;
+    int got = out_num;
+    free(jpeg.data);
+    clear_frames();
+    TEST_CHECK(match, "jpeg roundtrip frames %d packets %d", got, packet_num);
+    return 0;
+}
+
+static int test_audio(void)
+{
+    uint8_t frame[100];
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_OPUS,
+        .payload_type = 111,
+    };
+    esp_peer_rtp_depacketizer_cfg_t dep_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_OPUS,
+    };
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    esp_peer_rtp_depacketizer_handle_t depacketizer = NULL;
+    esp_peer_rtp_packetizer_open(&pack_cfg, &packetizer);
+    esp_peer_rtp_depacketizer_open(&dep_cfg, &depacketizer);
+    packet_num = 0;
+    for (int i = 0; i < 10; i++) {
+        memset(frame, i, sizeof(frame));
+        esp_peer_rtp_packetize(packetizer, frame, sizeof(frame), i * 20, on_packet, NULL);
+    }
+    for (int i = 0; i < packet_num; i++) {
+        esp_peer_rtp_depacketize(depacketizer, packets[i].data, packets[i].size, on_frame, NULL);
+    }
+    esp_peer_rtp_packetizer_close(packetizer);
+    esp_peer_rtp_depacketizer_close(depacketizer);
+    int ret = out_num == 10 ? 0 : -1;
+    for (int i = 0; ret == 0 && i < out_num; i++) {
+        if (out_frames[i].size != sizeof(frame) || out_frames[i].data[0] != i || out_frames[i].data[99] != i) {
+            ret = -1;
+        }
+    }
+    int got = out_num;
+    clear_frames();
+    TEST_CHECK(ret == 0, "audio frames %d", got);
+    return 0;
+}
+
+static int test_fuzz(int iterations)
+{
+    static uint8_t frame[MAX_FRAME_SIZE];
+    esp_peer_rtp_codec_t codecs[] = { ESP_PEER_RTP_CODEC_H264, ESP_PEER_RTP_CODEC_MJPEG, ESP_PEER_RTP_CODEC_OPUS };
+    esp_peer_rtp_depacketizer_handle_t depacketizer[3] = { NULL };
+    for (int i = 0; i < 3; i++) {
+        esp_peer_rtp_depacketizer_cfg_t dep_cfg = {
+            .codec = codecs[i],
+            .max_frame_size = 16 * 1024,
+            .reorder_num = (uint8_t)(5 + i * 6),
+        };
+        TEST_CHECK(esp_peer_rtp_depacketizer_open(&dep_cfg, &depacketizer[i]) == ESP_PEER_ERR_NONE, "open");
+    }
+    // Valid packets to mutate
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = ESP_PEER_RTP_CODEC_H264,
+        .mtu = 300,
+    };
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    esp_peer_rtp_packetizer_open(&pack_cfg, &packetizer);
+    packet_num = 0;
+    int frame_size = build_h264_frame(frame, true, 4000);
+    esp_peer_rtp_packetize(packetizer, frame, frame_size, 0, on_packet, NULL);
+    esp_peer_rtp_packetizer_close(packetizer);
+    int valid_num = packet_num;
+
+    uint8_t pkt[MAX_PACKET_SIZE];
+    for (int k = 0; k < iterations; k++) {
+        int size;
+        if (k & 1) {
+            // Random packet with valid version
+            size = rand() % 1400;
+            for (int i = 0; i < size; i++) {
+                pkt[i] = (uint8_t)rand();
+            }
+            if (size) {
+                pkt[0] = 0x80 | (pkt[0] & 0x3F);
+            }
+        } else {
+            // Mutated valid packet with random sequence jump
+            test_packet_t *src = &packets[rand() % valid_num];
+            size = src->size;
+            memcpy(pkt, src->data, size);
+            for (int m = rand() % 4; m > 0; m--) {
+                pkt[rand() % size] = (uint8_t)rand();
+            }
+            pkt[2] = (uint8_t)rand();
+            pkt[3] = (uint8_t)rand();
+            if (rand() % 8 == 0) {
+                size = rand() % size;
+            }
+        }
+        esp_peer_rtp_depacketize(depacketizer[k % 3], pkt, size, on_frame_discard, NULL);
+    }
+    for (int i = 0; i < 3; i++) {
+        esp_peer_rtp_depacketizer_close(depacketizer[i]);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : FUZZ_ITERATIONS;
+    int fail = 0;
+    srand(1);
+    // Window sizes not dividing 65536 and sequence wrap inside the stream
+    uint8_t reorder_nums[] = { 16, 10, 3, 2 };
+    uint16_t start_seqs[] = { 0, 65500, 65535 };
+    for (int i = 0; i < sizeof(reorder_nums); i++) {
+        for (int j = 0; j < sizeof(start_seqs) / sizeof(start_seqs[0]); j++) {
+            fail |= test_h264_reorder(reorder_nums[i], start_seqs[j]);
+        }
+    }
+    fail |= test_h264_loss();
+    fail |= test_jpeg_roundtrip();
+    fail |= test_audio();
+    fail |= test_fuzz(iterations);
+    printf("%s\n", fail ? "RTP test FAILED" : "RTP test passed");
+    return fail ? 1 : 0;
+}
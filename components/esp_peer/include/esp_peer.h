@@ -273,6 +273,27 @@ typedef struct {
     int (*on_channel_close)(esp_peer_data_channel_info_t *ch, void *ctx);
 } esp_peer_cfg_t;
 
+/**
+ * @brief  Maximum sockets reported by `esp_peer_get_wait_info`
+ */
+#define ESP_PEER_MAX_WAIT_FD (4)
+
+/**
+ * @brief  Peer wait information
+ *
+ * @note  Tells the main loop owner which sockets to wait on and when the next internal timer
+ *        (STUN keepalive, retransmission, RTCP report etc.) expires, so that it can block until either happens
+ *        Realization without sockets (such as in process transport) reports `wake_sema` instead,
+ *        it is given whenever new work is queued for the peer so that waiting on it ends at once
+ */
+typedef struct {
+    int      fds[ESP_PEER_MAX_WAIT_FD];  /*!< Sockets to wait for readable */
+    uint8_t  fd_num;                     /*!< Number of valid sockets in `fds` */
+    uint32_t timeout_ms;                 /*!< Time until next timer deadline (unit ms), 0 means run main loop at once */
+    void    *wake_sema;                  /*!< Binary semaphore (`media_lib_sema_handle_t`) to wait on when `fd_num` is 0,
+                                              NULL if not supported */
+} esp_peer_wait_info_t;
+
 /**
  * @brief  Peer connection interface
  */
@@ -379,6 +400,47 @@ typedef struct {
     int (*close)(esp_peer_handle_t peer);
 } esp_peer_ops_t;
 
+/**
+ * @brief  Optional peer connection interface extension
+ *
+ * @note  Kept apart from `esp_peer_ops_t` so that realizations built against the original ops table
+ *        (such as the prebuilt default realization) stay compatible
+ *        `size` tells which members are present, new members are only appended
+ */
+typedef struct {
+    uint32_t size;  /*!< Set to `sizeof(esp_peer_ops_ext_t)` of the realization build */
+
+    /**
+     * @brief  Get sockets and next timer deadline to wait on before calling `main_loop` again
+     * @param[in]   peer   Peer handle
+     * @param[out]  info   Wait information
+     * @return             Status code indicating success or failure.
+     */
+    int (*get_wait_info)(esp_peer_handle_t peer, esp_peer_wait_info_t *info);
+} esp_peer_ops_ext_t;
+
+/**
+ * @brief  Maximum realizations which can register ops extension
+ */
+#define ESP_PEER_MAX_OPS_EXT (4)
+
+/**
+ * @brief  Register ops extension for peer connection realization
+ *
+ * @note  Peer opened by `esp_peer_open` with `ops` afterwards uses the extension
+ *        Should be called before any `esp_peer_open` using `ops`, registering the same `ops` again replaces the extension
+ *        Registry is protected by lock, it is safe to register from one task while another one opens peer
+ *
+ * @param[in]  ops  Peer connection implementation
+ * @param[in]  ext  Ops extension, must be kept valid while registered
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Too many realizations registered
+ */
+int esp_peer_register_ops_ext(const esp_peer_ops_t *ops, const esp_peer_ops_ext_t *ext);
+
 /**
  * @brief  Open peer connection
  *
@@ -523,6 +585,23 @@ int esp_peer_send_data(esp_peer_handle_t peer, esp_peer_data_frame_t *frame);
  */
 int esp_peer_main_loop(esp_peer_handle_t peer);
 
+/**
+ * @brief  Get sockets and next timer deadline which peer main loop is waiting for
+ *
+ * @note  User can block on the reported sockets (e.g. through `media_lib_socket_select`) or on `wake_sema`
+ *        (through `media_lib_sema_lock`) until data arrives or `timeout_ms` elapsed, then call `esp_peer_main_loop`,
+ *        instead of polling the main loop periodically
+ *
+ * @param[in]   peer  Peer handle
+ * @param[out]  info  Wait information
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NOT_SUPPORT  Peer realization has no `get_wait_info` extension, keep polling main loop
+ */
+int esp_peer_get_wait_info(esp_peer_handle_t peer, esp_peer_wait_info_t *info);
+
 /**
  * @brief  Disconnect peer connection
  *
@@ -0,0 +1,316 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "esp_peer_rtp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_PEER_FEC_HEADER_SIZE (16) /*!< XOR FEC header size after RTP header */
+#define ESP_PEER_FEC_MAX_GROUP   (16) /*!< Maximum media packets protected by one XOR FEC packet */
+
+/**
+ * @brief  XOR FEC encoder configuration
+ *
+ * @note  FEC packet is sent as separate RTP stream, its payload is laid out in FlexFEC (RFC 8627) style:
+ *        |PT recovery(2)|length recovery(2)|TS recovery(4)|media SSRC(4)|SN base(2)|mask(2)|XOR of media payloads|
+ *        One FEC packet protects up to 16 consecutive media packets and recovers any single loss among them
+ */
+typedef struct {
+    uint8_t  payload_type;    /*!< Payload type of FEC packets */
+    uint32_t ssrc;            /*!< SSRC of FEC packets */
+    uint16_t start_seq;       /*!< First sequence number of FEC packets */
+    uint16_t max_packet_size; /*!< Maximum FEC packet size with RTP header (transport MTU), 0 to use `ESP_PEER_RTP_DEFAULT_MTU`
+                                   Media packets larger than `max_packet_size - ESP_PEER_FEC_HEADER_SIZE` are left unprotected,
+                                   so open media packetizer with `mtu` reduced by `ESP_PEER_FEC_HEADER_SIZE` */
+    uint8_t  group_size;      /*!< Media packets protected by one FEC packet (2-16), 0 to keep disabled until loss is reported */
+} esp_peer_fec_encoder_cfg_t;
+
+/**
+ * @brief  XOR FEC decoder configuration
+ */
+typedef struct {
+    uint8_t  payload_type;    /*!< Payload type of FEC packets, others are treated as media packets */
+    uint16_t max_packet_size; /*!< Maximum media packet size, 0 to use `ESP_PEER_RTP_DEFAULT_MTU` */
+} esp_peer_fec_decoder_cfg_t;
+
+/**
+ * @brief  RED (RFC 2198) audio redundancy encoder configuration
+ *
+ * @note  Each RED packet carries previous audio frame as redundant block and current frame as primary block
+ *        Any single lost audio packet is recovered by the next one without waiting for resend
+ */
+typedef struct {
+    uint8_t payload_type; /*!< Payload type of RED packets */
+    bool    enable;       /*!< Start with redundancy enabled, else keep disabled until loss is reported */
+} esp_peer_red_encoder_cfg_t;
+
+/**
+ * @brief  RED audio redundancy decoder configuration
+ */
+typedef struct {
+    uint8_t payload_type; /*!< Payload type of RED packets, others are passed through */
+} esp_peer_red_decoder_cfg_t;
+
+/**
+ * @brief  FEC decoder statistics
+ */
+typedef struct {
+    uint32_t media_packets; /*!< Received media packets */
+    uint32_t fec_packets;   /*!< Received FEC packets (or RED packets with redundant block) */
+    uint32_t lost;          /*!< Media packets lost on network (before recovery) */
+    uint32_t recovered;     /*!< Media packets recovered */
+    uint32_t unrecovered;   /*!< Loss can not be recovered (more than one loss in one group) */
+} esp_peer_fec_stat_t;
+
+/**
+ * @brief  Decoder output callback
+ *
+ * @param[in]  data  RTP media packet (received or recovered)
+ * @param[in]  size  Packet size
+ * @param[in]  ctx   User context
+ *
+ * @return  Status code indicating success or failure
+ */
+typedef int (*esp_peer_fec_output_cb_t)(const uint8_t *data, int size, void *ctx);
+
+/**
+ * @brief  FEC encoder and decoder handle
+ */
+typedef void *esp_peer_fec_handle_t;
+
+/**
+ * @brief  Open XOR FEC encoder
+ *
+ * @param[in]   cfg     Encoder configuration
+ * @param[out]  handle  Encoder handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_fec_encoder_open(esp_peer_fec_encoder_cfg_t *cfg, esp_peer_fec_handle_t *handle);
+
+/**
+ * @brief  Adapt FEC overhead to loss measured by receiver (e.g. RTCP receiver report)
+ *
+ * @note  Below 0.5% FEC is disabled, then group size shrinks from 16 to 2 as loss grows
+ *
+ * @param[in]  handle     Encoder handle
+ * @param[in]  loss_rate  Measured loss rate (unit 1/1000)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_fec_encoder_set_loss(esp_peer_fec_handle_t handle, uint16_t loss_rate);
+
+/**
+ * @brief  Feed one media packet after it is sent
+ *
+ * @note  FEC packet is output through callback when group is full or frame ends (marker bit set),
+ *        so that recovery never waits for next frame
+ *
+ * @param[in]  handle   Encoder handle
+ * @param[in]  iov      Media packet segments
+ * @param[in]  iov_num  Number of segments
+ * @param[in]  cb       FEC packet output callback
+ * @param[in]  ctx      User context
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - Others                    Returned by output callback
+ */
+int esp_peer_fec_encode(esp_peer_fec_handle_t handle, esp_peer_rtp_iovec_t *iov, int iov_num,
+                        esp_peer_rtp_packet_cb_t cb, void *ctx);
+
+/**
+ * @brief  Close XOR FEC encoder
+ *
+ * @param[in]  handle  Encoder handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_fec_encoder_close(esp_peer_fec_handle_t handle);
+
+/**
+ * @brief  Open XOR FEC decoder
+ *
+ * @param[in]   cfg     Decoder configuration
+ * @param[out]  handle  Decoder handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_fec_decoder_open(esp_peer_fec_decoder_cfg_t *cfg, esp_peer_fec_handle_t *handle);
+
+/**
+ * @brief  Feed one received packet of the protected stream
+ *
+ * @note  Media packets are kept for recovery and output at once, FEC packets output the recovered media packet if any
+ *        FEC packet overtaking its media packets is kept and checked again when they arrive
+ *        Recovered packet arrives out of order, so depacketizer reorder window should cover one FEC group
+ *
+ * @param[in]  handle  Decoder handle
+ * @param[in]  data    Received RTP packet
+ * @param[in]  size    Packet size
+ * @param[in]  cb      Media packet output callback
+ * @param[in]  ctx     User context
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_BAD_DATA     Not a valid RTP or FEC packet
+ */
+int esp_peer_fec_decode(esp_peer_fec_handle_t handle, const uint8_t *data, int size, esp_peer_fec_output_cb_t cb, void *ctx);
+
+/**
+ * @brief  Get XOR FEC decoder statistics
+ *
+ * @param[in]   handle  Decoder handle
+ * @param[out]  stat    Statistics
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_fec_decoder_get_stat(esp_peer_fec_handle_t handle, esp_peer_fec_stat_t *stat);
+
+/**
+ * @brief  Close XOR FEC decoder
+ *
+ * @param[in]  handle  Decoder handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_fec_decoder_close(esp_peer_fec_handle_t handle);
+
+/**
+ * @brief  Open RED audio redundancy encoder
+ *
+ * @param[in]   cfg     Encoder configuration
+ * @param[out]  handle  Encoder handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_red_encoder_open(esp_peer_red_encoder_cfg_t *cfg, esp_peer_fec_handle_t *handle);
+
+/**
+ * @brief  Adapt RED redundancy to loss measured by receiver
+ *
+ * @note  Redundancy is enabled when loss reaches 0.5%
+ *
+ * @param[in]  handle     Encoder handle
+ * @param[in]  loss_rate  Measured loss rate (unit 1/1000)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_red_encoder_set_loss(esp_peer_fec_handle_t handle, uint16_t loss_rate);
+
+/**
+ * @brief  Wrap one audio RTP packet into RED packet
+ *
+ * @note  Packet is output unchanged when redundancy is disabled or packet has CSRC or header extension
+ *
+ * @param[in]  handle   Encoder handle
+ * @param[in]  iov      Audio packet segments
+ * @param[in]  iov_num  Number of segments
+ * @param[in]  cb       Packet output callback
+ * @param[in]  ctx      User context
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - Others                    Returned by output callback
+ */
+int esp_peer_red_encode(esp_peer_fec_handle_t handle, esp_peer_rtp_iovec_t *iov, int iov_num,
+                        esp_peer_rtp_packet_cb_t cb, void *ctx);
+
+/**
+ * @brief  Close RED audio redundancy encoder
+ *
+ * @param[in]  handle  Encoder handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_red_encoder_close(esp_peer_fec_handle_t handle);
+
+/**
+ * @brief  Open RED audio redundancy decoder
+ *
+ * @param[in]   cfg     Decoder configuration
+ * @param[out]  handle  Decoder handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_red_decoder_open(esp_peer_red_decoder_cfg_t *cfg, esp_peer_fec_handle_t *handle);
+
+/**
+ * @brief  Feed one received audio packet
+ *
+ * @note  RED packet is unwrapped to primary packet, previous packet is rebuilt from redundant block first if it was lost
+ *
+ * @param[in]  handle  Decoder handle
+ * @param[in]  data    Received RTP packet
+ * @param[in]  size    Packet size
+ * @param[in]  cb      Audio packet output callback
+ * @param[in]  ctx     User context
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_BAD_DATA     Not a valid RTP or RED packet
+ */
+int esp_peer_red_decode(esp_peer_fec_handle_t handle, const uint8_t *data, int size, esp_peer_fec_output_cb_t cb, void *ctx);
+
+/**
+ * @brief  Get RED decoder statistics
+ *
+ * @param[in]   handle  Decoder handle
+ * @param[out]  stat    Statistics
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_red_decoder_get_stat(esp_peer_fec_handle_t handle, esp_peer_fec_stat_t *stat);
+
+/**
+ * @brief  Close RED audio redundancy decoder
+ *
+ * @param[in]  handle  Decoder handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_red_decoder_close(esp_peer_fec_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
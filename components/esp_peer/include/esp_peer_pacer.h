@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "esp_peer_rtp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_PEER_PACER_NO_WAIT (0xFFFFFFFF) /*!< Wait time reported when nothing is queued */
+
+/**
+ * @brief  Send pacer configuration
+ *
+ * @note  Audio packets are sent at once ahead of queued video
+ *        Video packets are released at `max(bitrate, queued_video_bits / (frame_interval * spread_ratio))` capped by `max_bitrate`
+ *        so that a big key frame is spread over part of the frame interval instead of going out as a line-rate burst
+ */
+typedef struct {
+    uint32_t bitrate;         /*!< Target send bitrate (unit bps), lowest pacing rate */
+    uint32_t max_bitrate;     /*!< Highest pacing rate (unit bps, e.g. known uplink capacity), 0 for no limit
+                                   Frame is spread beyond the spread window when limited by it */
+    uint16_t frame_interval;  /*!< Video frame interval (unit ms), 0 to use 33ms */
+    uint8_t  spread_ratio;    /*!< Percentage of frame interval to spread queued video over, 0 to use 50% */
+    uint32_t max_queue_bytes; /*!< Maximum queued bytes, video packets over it are dropped, 0 to use 512KB */
+} esp_peer_pacer_cfg_t;
+
+/**
+ * @brief  Send pacer statistics
+ */
+typedef struct {
+    uint32_t audio_packets;      /*!< Audio packets sent */
+    uint32_t video_packets;      /*!< Video packets sent */
+    uint32_t dropped_packets;    /*!< Video packets dropped for queue full */
+    uint32_t queue_bytes;        /*!< Current queued bytes */
+    uint32_t avg_queue_delay_ms; /*!< Average time packets stay in queue (unit ms) */
+    uint32_t max_queue_delay_ms; /*!< Maximum time packets stay in queue (unit ms) */
+} esp_peer_pacer_stat_t;
+
+/**
+ * @brief  Pacer output callback
+ *
+ * @param[in]  data      RTP packet
+ * @param[in]  size      Packet size
+ * @param[in]  is_audio  Whether it is audio packet
+ * @param[in]  ctx       User context
+ *
+ * @return  Status code indicating success or failure
+ */
+typedef int (*esp_peer_pacer_send_cb_t)(const uint8_t *data, int size, bool is_audio, void *ctx);
+
+/**
+ * @brief  Send pacer handle
+ */
+typedef void *esp_peer_pacer_handle_t;
+
+/**
+ * @brief  Open send pacer
+ *
+ * @note  Pacer is not thread safe, caller need protect it when enqueue and process in different tasks
+ *
+ * @param[in]   cfg     Pacer configuration
+ * @param[out]  handle  Pacer handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_pacer_open(esp_peer_pacer_cfg_t *cfg, esp_peer_pacer_handle_t *handle);
+
+/**
+ * @brief  Update target bitrate (e.g. from bandwidth estimation)
+ *
+ * @param[in]  handle   Pacer handle
+ * @param[in]  bitrate  Target bitrate (unit bps)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_pacer_set_bitrate(esp_peer_pacer_handle_t handle, uint32_t bitrate);
+
+/**
+ * @brief  Queue one RTP packet, segments are copied so caller can reuse them after return
+ *
+ * @param[in]  handle    Pacer handle
+ * @param[in]  is_audio  Whether it is audio packet
+ * @param[in]  iov       Packet segments (as output by `esp_peer_rtp_packetize`)
+ * @param[in]  iov_num   Number of segments
+ * @param[in]  now_us    Current time (unit us)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE          On success
+ *       - ESP_PEER_ERR_INVALID_ARG   Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM        Not enough memory
+ *       - ESP_PEER_ERR_OVER_LIMITED  Queue full, video packet dropped
+ */
+int esp_peer_pacer_enqueue(esp_peer_pacer_handle_t handle, bool is_audio, esp_peer_rtp_iovec_t *iov, int iov_num, int64_t now_us);
+
+/**
+ * @brief  Send packets which are due
+ *
+ * @param[in]   handle   Pacer handle
+ * @param[in]   now_us   Current time (unit us)
+ * @param[in]   cb       Output callback
+ * @param[in]   ctx      User context
+ * @param[out]  wait_ms  Time until next packet is due, `ESP_PEER_PACER_NO_WAIT` if queue is empty (can be NULL)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_pacer_process(esp_peer_pacer_handle_t handle, int64_t now_us, esp_peer_pacer_send_cb_t cb, void *ctx,
+                           uint32_t *wait_ms);
+
+/**
+ * @brief  Get pacer statistics
+ *
+ * @param[in]   handle  Pacer handle
+ * @param[out]  stat    Statistics
+ * @param[in]   reset   Clear counters and delay statistics after read
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_pacer_get_stat(esp_peer_pacer_handle_t handle, esp_peer_pacer_stat_t *stat, bool reset);
+
+/**
+ * @brief  Drop all queued packets and close pacer
+ *
+ * @param[in]  handle  Pacer handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_pacer_close(esp_peer_pacer_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
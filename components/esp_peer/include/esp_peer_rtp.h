@@ -0,0 +1,220 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#pragma once
+
+#include "esp_peer_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_PEER_RTP_HEADER_SIZE  (12)   /*!< Fixed RTP header size without CSRC and extension */
+#define ESP_PEER_RTP_DEFAULT_MTU  (1200) /*!< Default maximum RTP packet size */
+#define ESP_PEER_RTP_MAX_IOV      (8)    /*!< Maximum segments of one output RTP packet */
+
+/**
+ * @brief  RTP payload codec
+ */
+typedef enum {
+    ESP_PEER_RTP_CODEC_NONE  = 0, /*!< Invalid codec */
+    ESP_PEER_RTP_CODEC_H264  = 1, /*!< H264 (RFC 6184 single NAL, STAP-A and FU-A, packetization mode 1) */
+    ESP_PEER_RTP_CODEC_MJPEG = 2, /*!< JPEG (RFC 2435, baseline YUV420 or YUV422, 8-bit quantization and standard Huffman tables) */
+    ESP_PEER_RTP_CODEC_OPUS  = 3, /*!< OPUS (RFC 7587, 48kHz clock) */
+    ESP_PEER_RTP_CODEC_G711A = 4, /*!< G711 A-law (RFC 3551, 8kHz clock) */
+    ESP_PEER_RTP_CODEC_G711U = 5, /*!< G711 u-law (RFC 3551, 8kHz clock) */
+} esp_peer_rtp_codec_t;
+
+/**
+ * @brief  One segment of output RTP packet
+ */
+typedef struct {
+    const uint8_t *data; /*!< Segment data */
+    int            size; /*!< Segment size */
+} esp_peer_rtp_iovec_t;
+
+/**
+ * @brief  RTP packetizer configuration
+ */
+typedef struct {
+    esp_peer_rtp_codec_t codec;        /*!< Payload codec */
+    uint8_t              payload_type; /*!< RTP payload type */
+    uint32_t             ssrc;         /*!< RTP SSRC */
+    uint16_t             start_seq;    /*!< First sequence number */
+    uint16_t             mtu;          /*!< Maximum RTP packet size with header, 0 to use `ESP_PEER_RTP_DEFAULT_MTU` */
+} esp_peer_rtp_packetizer_cfg_t;
+
+/**
+ * @brief  RTP depacketizer configuration
+ */
+typedef struct {
+    esp_peer_rtp_codec_t codec;          /*!< Payload codec */
+    uint32_t             max_frame_size; /*!< Maximum reassembled frame size, 0 to use 256KB for video and 4KB for audio */
+    uint8_t              reorder_num;    /*!< Out of order packets kept waiting for the missing one, 0 to use 16
+                                              Video holds first `reorder_num` packets and starts from the lowest one */
+} esp_peer_rtp_depacketizer_cfg_t;
+
+/**
+ * @brief  Reassembled frame from depacketizer
+ */
+typedef struct {
+    uint32_t  pts;       /*!< Presentation timestamp converted from RTP timestamp (unit ms) */
+    uint32_t  timestamp; /*!< Original RTP timestamp */
+    bool      key_frame; /*!< Video frame can be decoded independently (always true for audio) */
+    uint8_t  *data;      /*!< Frame data (H264 in Annex-B format, JPEG with full headers) */
+    int       size;      /*!< Frame size */
+} esp_peer_rtp_frame_t;
+
+/**
+ * @brief  RTP depacketizer statistics
+ */
+typedef struct {
+    uint32_t packets;        /*!< Received packets */
+    uint32_t lost;           /*!< Packets never arrived in reorder window */
+    uint32_t reordered;      /*!< Packets arrived out of order but recovered */
+    uint32_t discarded;      /*!< Duplicated, too late or invalid packets */
+    uint32_t frames;         /*!< Output frames */
+    uint32_t dropped_frames; /*!< Frames dropped for loss or overflow */
+} esp_peer_rtp_stat_t;
+
+/**
+ * @brief  RTP packet output callback
+ *
+ * @note  Segments reference packetizer internal header storage and the input frame directly
+ *        They are only valid during the callback, transport should send them with scatter-gather IO or copy them
+ *
+ * @param[in]  iov      Segments of one RTP packet, first one always starts with RTP header
+ * @param[in]  iov_num  Number of segments
+ * @param[in]  ctx      User context
+ *
+ * @return  Status code, packetizer stops when it is not ESP_PEER_ERR_NONE
+ */
+typedef int (*esp_peer_rtp_packet_cb_t)(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx);
+
+/**
+ * @brief  RTP frame output callback
+ *
+ * @param[in]  frame  Reassembled frame, only valid during the callback
+ * @param[in]  ctx    User context
+ *
+ * @return  Status code indicating success or failure
+ */
+typedef int (*esp_peer_rtp_frame_cb_t)(esp_peer_rtp_frame_t *frame, void *ctx);
+
+/**
+ * @brief  RTP packetizer handle
+ */
+typedef void *esp_peer_rtp_packetizer_handle_t;
+
+/**
+ * @brief  RTP depacketizer handle
+ */
+typedef void *esp_peer_rtp_depacketizer_handle_t;
+
+/**
+ * @brief  Open RTP packetizer
+ *
+ * @param[in]   cfg     Packetizer configuration
+ * @param[out]  handle  Packetizer handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_rtp_packetizer_open(esp_peer_rtp_packetizer_cfg_t *cfg, esp_peer_rtp_packetizer_handle_t *handle);
+
+/**
+ * @brief  Split one encoded frame into RTP packets without copying payload
+ *
+ * @param[in]  handle  Packetizer handle
+ * @param[in]  data    Encoded frame (H264 in Annex-B format, whole JPEG file, or one audio frame)
+ * @param[in]  size    Frame size
+ * @param[in]  pts     Presentation timestamp (unit ms), converted to RTP timestamp by codec clock rate
+ * @param[in]  cb      Packet output callback
+ * @param[in]  ctx     User context
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NOT_SUPPORT  Frame format not supported (e.g. progressive JPEG)
+ *       - Others                    Returned by output callback
+ */
+int esp_peer_rtp_packetize(esp_peer_rtp_packetizer_handle_t handle, const uint8_t *data, int size, uint32_t pts,
+                           esp_peer_rtp_packet_cb_t cb, void *ctx);
+
+/**
+ * @brief  Close RTP packetizer
+ *
+ * @param[in]  handle  Packetizer handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_rtp_packetizer_close(esp_peer_rtp_packetizer_handle_t handle);
+
+/**
+ * @brief  Open RTP depacketizer
+ *
+ * @param[in]   cfg     Depacketizer configuration
+ * @param[out]  handle  Depacketizer handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_peer_rtp_depacketizer_open(esp_peer_rtp_depacketizer_cfg_t *cfg, esp_peer_rtp_depacketizer_handle_t *handle);
+
+/**
+ * @brief  Feed one received RTP packet
+ *
+ * @note  In order packets are parsed in place, out of order ones are copied and kept until the gap is filled
+ *        or reorder window is exceeded, frames with lost packets are dropped
+ *
+ * @param[in]  handle  Depacketizer handle
+ * @param[in]  data    RTP packet
+ * @param[in]  size    Packet size
+ * @param[in]  cb      Frame output callback
+ * @param[in]  ctx     User context
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success (packet may be kept or discarded)
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_BAD_DATA     Not a valid RTP packet
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory to keep out of order packet
+ */
+int esp_peer_rtp_depacketize(esp_peer_rtp_depacketizer_handle_t handle, const uint8_t *data, int size,
+                             esp_peer_rtp_frame_cb_t cb, void *ctx);
+
+/**
+ * @brief  Get RTP depacketizer statistics
+ *
+ * @param[in]   handle  Depacketizer handle
+ * @param[out]  stat    Statistics
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_rtp_depacketizer_get_stat(esp_peer_rtp_depacketizer_handle_t handle, esp_peer_rtp_stat_t *stat);
+
+/**
+ * @brief  Close RTP depacketizer
+ *
+ * @param[in]  handle  Depacketizer handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_peer_rtp_depacketizer_close(esp_peer_rtp_depacketizer_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
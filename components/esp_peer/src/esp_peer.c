@@ -8,12 +8,64 @@
 #include "esp_peer.h"
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 typedef struct {
-    esp_peer_ops_t    ops;
-    esp_peer_handle_t handle;
+    esp_peer_ops_t     ops;
+    esp_peer_ops_ext_t ext;
+    esp_peer_handle_t  handle;
 } peer_wrapper_t;
 
+typedef struct {
+    const esp_peer_ops_t     *ops;
+    const esp_peer_ops_ext_t *ext;
+} peer_ops_ext_entry_t;
+
+static peer_ops_ext_entry_t ops_ext_entries[ESP_PEER_MAX_OPS_EXT];
+// Statically initialized so that first registration has no creation race
+static pthread_mutex_t      ops_ext_lock = PTHREAD_MUTEX_INITIALIZER;
+
+int esp_peer_register_ops_ext(const esp_peer_ops_t *ops, const esp_peer_ops_ext_t *ext)
+{
+    if (ops == NULL || ext == NULL || ext->size < sizeof(uint32_t)) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    peer_ops_ext_entry_t *free_entry = NULL;
+    pthread_mutex_lock(&ops_ext_lock);
+    for (int i = 0; i < ESP_PEER_MAX_OPS_EXT; i++) {
+        if (ops_ext_entries[i].ops == ops) {
+            ops_ext_entries[i].ext = ext;
+            pthread_mutex_unlock(&ops_ext_lock);
+            return ESP_PEER_ERR_NONE;
+        }
+        if (ops_ext_entries[i].ops == NULL && free_entry == NULL) {
+            free_entry = &ops_ext_entries[i];
+        }
+    }
+    int ret = ESP_PEER_ERR_NO_MEM;
+    if (free_entry) {
+        free_entry->ext = ext;
+        free_entry->ops = ops;
+        ret = ESP_PEER_ERR_NONE;
+    }
+    pthread_mutex_unlock(&ops_ext_lock);
+    return ret;
+}
+
+static void get_ops_ext(const esp_peer_ops_t *ops, esp_peer_ops_ext_t *ext)
+{
+    pthread_mutex_lock(&ops_ext_lock);
+    for (int i = 0; i < ESP_PEER_MAX_OPS_EXT; i++) {
+        if (ops_ext_entries[i].ops == ops) {
+            // Members beyond registered size are unknown to realization, keep them cleared
+            const esp_peer_ops_ext_t *reg = ops_ext_entries[i].ext;
+            memcpy(ext, reg, reg->size < sizeof(esp_peer_ops_ext_t) ? reg->size : sizeof(esp_peer_ops_ext_t));
+            break;
+        }
+    }
+    pthread_mutex_unlock(&ops_ext_lock);
+}
+
 int esp_peer_open(esp_peer_cfg_t *cfg, const esp_peer_ops_t *ops, esp_peer_handle_t *handle)
 {
     if (cfg == NULL || ops == NULL || handle == NULL || ops->open == NULL) {
@@ -24,6 +76,7 @@ int esp_peer_open(esp_peer_cfg_t *cfg, const esp_peer_ops_t *ops, esp_peer_handl
         return ESP_PEER_ERR_NO_MEM;
     }
     memcpy(&peer->ops, ops, sizeof(esp_peer_ops_t));
+    get_ops_ext(ops, &peer->ext);
     int ret = ops->open(cfg, &peer->handle);
     if (ret != ESP_PEER_ERR_NONE) {
         free(peer);
@@ -141,6 +194,18 @@ int esp_peer_main_loop(esp_peer_handle_t handle)
     return ESP_PEER_ERR_NOT_SUPPORT;
 }
 
+int esp_peer_get_wait_info(esp_peer_handle_t handle, esp_peer_wait_info_t *info)
+{
+    if (handle == NULL || info == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    peer_wrapper_t *peer = (peer_wrapper_t *)handle;
+    if (peer->ext.get_wait_info) {
+        return peer->ext.get_wait_info(peer->handle, info);
+    }
+    return ESP_PEER_ERR_NOT_SUPPORT;
+}
+
 int esp_peer_disconnect(esp_peer_handle_t handle)
 {
     if (handle == NULL) {
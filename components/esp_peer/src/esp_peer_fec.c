@@ -0,0 +1,495 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_peer_fec.h"
+
+#define RTP_VERSION         (2)
+#define FEC_DEC_SLOTS       (32)
+#define FEC_DEC_PENDING     (4)
+#define FEC_MIN_LOSS        (5)
+#define FEC_PKT_HDR_SIZE    (ESP_PEER_RTP_HEADER_SIZE + ESP_PEER_FEC_HEADER_SIZE)
+
+typedef struct {
+    esp_peer_fec_encoder_cfg_t cfg;
+    uint8_t                    group_size;
+    uint8_t                    count;
+    uint16_t                   seq;
+    uint16_t                   base_seq;
+    uint16_t                   mask;
+    uint32_t                   media_ssrc;
+    uint32_t                   timestamp;
+    int                        max_len;
+    int                        max_payload;
+    uint8_t                   *buf;
+} fec_encoder_t;
+
+typedef struct {
+    bool     used;
+    uint16_t seq;
+    int      size;
+    uint8_t *data;
+} fec_slot_t;
+
+typedef struct {
+    esp_peer_fec_decoder_cfg_t cfg;
+    fec_slot_t                 slots[FEC_DEC_SLOTS];
+    fec_slot_t                 pending[FEC_DEC_PENDING];
+    bool                       started;
+    uint16_t                   highest_seq;
+    uint8_t                   *buf;
+    esp_peer_fec_stat_t        stat;
+} fec_decoder_t;
+
+static inline uint16_t get_be16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline uint32_t get_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static inline void put_be16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+static inline void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+static void xor_bytes(uint8_t *dst, const uint8_t *src, int size)
+{
+    for (int i = 0; i < size; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+static uint8_t fec_group_for_loss(uint16_t loss_rate)
+{
+    // Keep residual loss low with least overhead: one FEC packet fixes one loss in a group
+    if (loss_rate < FEC_MIN_LOSS) {
+        return 0;
+    }
+    if (loss_rate < 20) {
+        return 16;
+    }
+    if (loss_rate < 50) {
+        return 8;
+    }
+    if (loss_rate < 100) {
+        return 4;
+    }
+    if (loss_rate < 200) {
+        return 3;
+    }
+    return 2;
+}
+
+static int fec_flush(fec_encoder_t *enc, esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    if (enc->count == 0) {
+        return ESP_PEER_ERR_NONE;
+    }
+    uint8_t *hdr = enc->buf;
+    hdr[0] = RTP_VERSION << 6;
+    hdr[1] = enc->cfg.payload_type & 0x7F;
+    put_be16(hdr + 2, enc->seq++);
+    put_be32(hdr + 4, enc->timestamp);
+    put_be32(hdr + 8, enc->cfg.ssrc);
+    uint8_t *fec_hdr = hdr + ESP_PEER_RTP_HEADER_SIZE;
+    put_be32(fec_hdr + 8, enc->media_ssrc);
+    put_be16(fec_hdr + 12, enc->base_seq);
+    put_be16(fec_hdr + 14, enc->mask);
+    esp_peer_rtp_iovec_t iov = {
+        .data = enc->buf,
+        .size = FEC_PKT_HDR_SIZE + enc->max_len,
+    };
+    enc->count = 0;
+    return cb(&iov, 1, ctx);
+}
+
+int esp_peer_fec_encoder_open(esp_peer_fec_encoder_cfg_t *cfg, esp_peer_fec_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL || cfg->group_size > ESP_PEER_FEC_MAX_GROUP ||
+        (cfg->max_packet_size && cfg->max_packet_size <= FEC_PKT_HDR_SIZE)) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    fec_encoder_t *enc = (fec_encoder_t *)calloc(1, sizeof(fec_encoder_t));
+    if (enc == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    enc->cfg = *cfg;
+    if (enc->cfg.max_packet_size == 0) {
+        enc->cfg.max_packet_size = ESP_PEER_RTP_DEFAULT_MTU;
+    }
+    // FEC packet carries XOR of protected payloads after its headers, it must fit into MTU too
+    enc->max_payload = enc->cfg.max_packet_size - FEC_PKT_HDR_SIZE;
+    enc->buf = (uint8_t *)malloc(enc->cfg.max_packet_size);
+    if (enc->buf == NULL) {
+        free(enc);
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    enc->group_size = cfg->group_size == 1 ? 2 : cfg->group_size;
+    enc->seq = cfg->start_seq;
+    *handle = enc;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_fec_encoder_set_loss(esp_peer_fec_handle_t handle, uint16_t loss_rate)
+{
+    fec_encoder_t *enc = (fec_encoder_t *)handle;
+    if (enc == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    enc->group_size = fec_group_for_loss(loss_rate);
+    if (enc->group_size == 0) {
+        // Pending group is dropped, not worth one more packet
+        enc->count = 0;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_fec_encode(esp_peer_fec_handle_t handle, esp_peer_rtp_iovec_t *iov, int iov_num,
+                        esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    fec_encoder_t *enc = (fec_encoder_t *)handle;
+    if (enc == NULL || iov == NULL || iov_num <= 0 || cb == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    if (enc->group_size == 0) {
+        return ESP_PEER_ERR_NONE;
+    }
+    int size = 0;
+    for (int i = 0; i < iov_num; i++) {
+        size += iov[i].size;
+    }
+    // Packetizer always puts whole RTP header in first segment
+    // Payload over `max_payload` would make FEC packet exceed MTU, leave such packet unprotected
+    if (iov[0].size < ESP_PEER_RTP_HEADER_SIZE || size - ESP_PEER_RTP_HEADER_SIZE > enc->max_payload) {
+        return ESP_PEER_ERR_NONE;
+    }
+    const uint8_t *hdr = iov[0].data;
+    uint16_t seq = get_be16(hdr + 2);
+    uint32_t ssrc = get_be32(hdr + 8);
+    int ret = ESP_PEER_ERR_NONE;
+    if (enc->count && ((uint16_t)(seq - enc->base_seq) >= ESP_PEER_FEC_MAX_GROUP || ssrc != enc->media_ssrc)) {
+        ret = fec_flush(enc, cb, ctx);
+    }
+    uint8_t *fec_hdr = enc->buf + ESP_PEER_RTP_HEADER_SIZE;
+    uint8_t *fec_payload = enc->buf + FEC_PKT_HDR_SIZE;
+    if (enc->count == 0) {
+        enc->base_seq = seq;
+        enc->mask = 0;
+        enc->media_ssrc = ssrc;
+        enc->max_len = 0;
+        memset(fec_hdr, 0, enc->cfg.max_packet_size - ESP_PEER_RTP_HEADER_SIZE);
+    }
+    int payload_len = size - ESP_PEER_RTP_HEADER_SIZE;
+    fec_hdr[0] ^= hdr[0];
+    fec_hdr[1] ^= hdr[1];
+    put_be16(fec_hdr + 2, get_be16(fec_hdr + 2) ^ (uint16_t)payload_len);
+    put_be32(fec_hdr + 4, get_be32(fec_hdr + 4) ^ get_be32(hdr + 4));
+    int pos = 0;
+    for (int i = 0; i < iov_num; i++) {
+        const uint8_t *data = iov[i].data;
+        int seg_size = iov[i].size;
+        if (i == 0) {
+            data += ESP_PEER_RTP_HEADER_SIZE;
+            seg_size -= ESP_PEER_RTP_HEADER_SIZE;
+        }
+        xor_bytes(fec_payload + pos, data, seg_size);
+        pos += seg_size;
+    }
+    if (payload_len > enc->max_len) {
+        enc->max_len = payload_len;
+    }
+    enc->mask |= 0x8000 >> (uint16_t)(seq - enc->base_seq);
+    enc->timestamp = get_be32(hdr + 4);
+    enc->count++;
+    // Flush at frame end so that recovery never waits for next frame
+    if (enc->count >= enc->group_size || (hdr[1] & 0x80)) {
+        int flush_ret = fec_flush(enc, cb, ctx);
+        if (ret == ESP_PEER_ERR_NONE) {
+            ret = flush_ret;
+        }
+    }
+    return ret;
+}
+
+int esp_peer_fec_encoder_close(esp_peer_fec_handle_t handle)
+{
+    fec_encoder_t *enc = (fec_encoder_t *)handle;
+    if (enc == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    free(enc->buf);
+    free(enc);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_fec_decoder_open(esp_peer_fec_decoder_cfg_t *cfg, esp_peer_fec_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    fec_decoder_t *dec = (fec_decoder_t *)calloc(1, sizeof(fec_decoder_t));
+    if (dec == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    dec->cfg = *cfg;
+    if (dec->cfg.max_packet_size == 0) {
+        dec->cfg.max_packet_size = ESP_PEER_RTP_DEFAULT_MTU;
+    }
+    dec->buf = (uint8_t *)malloc(ESP_PEER_RTP_HEADER_SIZE + dec->cfg.max_packet_size);
+    if (dec->buf == NULL) {
+        free(dec);
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    *handle = dec;
+    return ESP_PEER_ERR_NONE;
+}
+
+static fec_slot_t *fec_find_slot(fec_decoder_t *dec, uint16_t seq)
+{
+    fec_slot_t *slot = &dec->slots[seq % FEC_DEC_SLOTS];
+    return (slot->used && slot->seq == seq) ? slot : NULL;
+}
+
+static void fec_store_media(fec_decoder_t *dec, const uint8_t *data, int size)
+{
+    if (size - ESP_PEER_RTP_HEADER_SIZE > dec->cfg.max_packet_size) {
+        return;
+    }
+    uint16_t seq = get_be16(data + 2);
+    fec_slot_t *slot = &dec->slots[seq % FEC_DEC_SLOTS];
+    if (slot->data == NULL) {
+        // Slot buffers are allocated on first use and reused afterwards
+        slot->data = (uint8_t *)malloc(ESP_PEER_RTP_HEADER_SIZE + dec->cfg.max_packet_size);
+        if (slot->data == NULL) {
+            slot->used = false;
+            return;
+        }
+    }
+    memcpy(slot->data, data, size);
+    slot->size = size;
+    slot->seq = seq;
+    slot->used = true;
+}
+
+static void fec_track_media(fec_decoder_t *dec, uint16_t seq)
+{
+    if (dec->started == false) {
+        dec->started = true;
+        dec->highest_seq = seq;
+        return;
+    }
+    int16_t diff = (int16_t)(seq - dec->highest_seq);
+    if (diff > 0) {
+        dec->stat.lost += diff - 1;
+        dec->highest_seq = seq;
+    } else if (diff < 0) {
+        // Late packet was counted as lost, and not a real loss if it was already rebuilt
+        if (dec->stat.lost) {
+            dec->stat.lost--;
+        }
+        if (fec_find_slot(dec, seq) && dec->stat.recovered) {
+            dec->stat.recovered--;
+        }
+    }
+}
+
+static int fec_recover(fec_decoder_t *dec, const uint8_t *data, int size, bool *done,
+                       esp_peer_fec_output_cb_t cb, void *ctx)
+{
+    const uint8_t *fec_hdr = data + ESP_PEER_RTP_HEADER_SIZE;
+    const uint8_t *fec_payload = data + FEC_PKT_HDR_SIZE;
+    int fec_len = size - FEC_PKT_HDR_SIZE;
+    uint16_t base_seq = get_be16(fec_hdr + 12);
+    uint16_t mask = get_be16(fec_hdr + 14);
+    uint16_t missing_seq = 0;
+    int missing = 0;
+    for (int i = 0; i < ESP_PEER_FEC_MAX_GROUP; i++) {
+        if ((mask & (0x8000 >> i)) && fec_find_slot(dec, base_seq + i) == NULL) {
+            missing_seq = base_seq + i;
+            missing++;
+        }
+    }
+    // Wait for more media packets (may be reordered) when more than one is missing
+    *done = (missing <= 1);
+    if (missing != 1) {
+        return ESP_PEER_ERR_NONE;
+    }
+    uint8_t b0 = fec_hdr[0];
+    uint8_t b1 = fec_hdr[1];
+    uint16_t len = get_be16(fec_hdr + 2);
+    uint32_t ts = get_be32(fec_hdr + 4);
+    for (int i = 0; i < ESP_PEER_FEC_MAX_GROUP; i++) {
+        uint16_t seq = base_seq + i;
+        if ((mask & (0x8000 >> i)) == 0 || seq == missing_seq) {
+            continue;
+        }
+        fec_slot_t *slot = fec_find_slot(dec, seq);
+        b0 ^= slot->data[0];
+        b1 ^= slot->data[1];
+        len ^= (uint16_t)(slot->size - ESP_PEER_RTP_HEADER_SIZE);
+        ts ^= get_be32(slot->data + 4);
+    }
+    if (len > fec_len || len > dec->cfg.max_packet_size || (b0 >> 6) != RTP_VERSION) {
+        dec->stat.unrecovered++;
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    uint8_t *out = dec->buf;
+    out[0] = b0;
+    out[1] = b1;
+    put_be16(out + 2, missing_seq);
+    put_be32(out + 4, ts);
+    memcpy(out + 8, fec_hdr + 8, 4);
+    uint8_t *payload = out + ESP_PEER_RTP_HEADER_SIZE;
+    memcpy(payload, fec_payload, len);
+    for (int i = 0; i < ESP_PEER_FEC_MAX_GROUP; i++) {
+        uint16_t seq = base_seq + i;
+        if ((mask & (0x8000 >> i)) == 0 || seq == missing_seq) {
+            continue;
+        }
+        fec_slot_t *slot = fec_find_slot(dec, seq);
+        int slot_len = slot->size - ESP_PEER_RTP_HEADER_SIZE;
+        xor_bytes(payload, slot->data + ESP_PEER_RTP_HEADER_SIZE, slot_len < len ? slot_len : len);
+    }
+    int out_size = ESP_PEER_RTP_HEADER_SIZE + len;
+    dec->stat.recovered++;
+    fec_store_media(dec, out, out_size);
+    return cb(out, out_size, ctx);
+}
+
+static void fec_drop_pending(fec_decoder_t *dec, fec_slot_t *pending)
+{
+    pending->used = false;
+    dec->stat.unrecovered++;
+}
+
+static int fec_keep_pending(fec_decoder_t *dec, const uint8_t *data, int size)
+{
+    if (size > FEC_PKT_HDR_SIZE + dec->cfg.max_packet_size) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    // Use free slot or replace the oldest one
+    fec_slot_t *pending = NULL;
+    for (int i = 0; i < FEC_DEC_PENDING; i++) {
+        fec_slot_t *cur = &dec->pending[i];
+        if (cur->used == false) {
+            pending = cur;
+            break;
+        }
+        if (pending == NULL || (int16_t)(cur->seq - pending->seq) < 0) {
+            pending = cur;
+        }
+    }
+    if (pending->used) {
+        fec_drop_pending(dec, pending);
+    }
+    if (pending->data == NULL) {
+        pending->data = (uint8_t *)malloc(FEC_PKT_HDR_SIZE + dec->cfg.max_packet_size);
+        if (pending->data == NULL) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+    }
+    memcpy(pending->data, data, size);
+    pending->size = size;
+    // Sort by protected base sequence
+    pending->seq = get_be16(data + ESP_PEER_RTP_HEADER_SIZE + 12);
+    pending->used = true;
+    return ESP_PEER_ERR_NONE;
+}
+
+static int fec_check_pending(fec_decoder_t *dec, uint16_t seq, esp_peer_fec_output_cb_t cb, void *ctx)
+{
+    int ret = ESP_PEER_ERR_NONE;
+    for (int i = 0; i < FEC_DEC_PENDING; i++) {
+        fec_slot_t *pending = &dec->pending[i];
+        if (pending->used == false) {
+            continue;
+        }
+        uint16_t offset = seq - pending->seq;
+        if (offset < ESP_PEER_FEC_MAX_GROUP) {
+            bool done = false;
+            ret = fec_recover(dec, pending->data, pending->size, &done, cb, ctx);
+            if (done) {
+                pending->used = false;
+            }
+        } else if ((int16_t)(dec->highest_seq - pending->seq) >= FEC_DEC_SLOTS - ESP_PEER_FEC_MAX_GROUP) {
+            // Protected packets are about to be overwritten
+            fec_drop_pending(dec, pending);
+        }
+    }
+    return ret;
+}
+
+int esp_peer_fec_decode(esp_peer_fec_handle_t handle, const uint8_t *data, int size, esp_peer_fec_output_cb_t cb, void *ctx)
+{
+    fec_decoder_t *dec = (fec_decoder_t *)handle;
+    if (dec == NULL || data == NULL || cb == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    if (size < ESP_PEER_RTP_HEADER_SIZE || (data[0] >> 6) != RTP_VERSION) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    if ((data[1] & 0x7F) != dec->cfg.payload_type) {
+        uint16_t seq = get_be16(data + 2);
+        dec->stat.media_packets++;
+        fec_track_media(dec, seq);
+        fec_store_media(dec, data, size);
+        int ret = cb(data, size, ctx);
+        fec_check_pending(dec, seq, cb, ctx);
+        return ret;
+    }
+    if (size < FEC_PKT_HDR_SIZE) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    dec->stat.fec_packets++;
+    bool done = false;
+    int ret = fec_recover(dec, data, size, &done, cb, ctx);
+    if (done == false) {
+        ret = fec_keep_pending(dec, data, size);
+    }
+    return ret;
+}
+
+int esp_peer_fec_decoder_get_stat(esp_peer_fec_handle_t handle, esp_peer_fec_stat_t *stat)
+{
+    fec_decoder_t *dec = (fec_decoder_t *)handle;
+    if (dec == NULL || stat == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    *stat = dec->stat;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_fec_decoder_close(esp_peer_fec_handle_t handle)
+{
+    fec_decoder_t *dec = (fec_decoder_t *)handle;
+    if (dec == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < FEC_DEC_SLOTS; i++) {
+        free(dec->slots[i].data);
+    }
+    for (int i = 0; i < FEC_DEC_PENDING; i++) {
+        free(dec->pending[i].data);
+    }
+    free(dec->buf);
+    free(dec);
+    return ESP_PEER_ERR_NONE;
+}
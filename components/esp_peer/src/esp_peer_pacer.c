@@ -0,0 +1,266 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_peer_pacer.h"
+
+#define PACER_DEFAULT_FRAME_INTERVAL (33)
+#define PACER_DEFAULT_SPREAD_RATIO   (50)
+#define PACER_DEFAULT_MAX_QUEUE      (512 * 1024)
+#define PACER_MIN_BITRATE            (64000)
+
+typedef struct pacer_pkt_t {
+    struct pacer_pkt_t *next;
+    int64_t             enqueue_us;
+    int                 size;
+    uint8_t             data[0];
+} pacer_pkt_t;
+
+typedef struct {
+    pacer_pkt_t *head;
+    pacer_pkt_t *tail;
+    uint32_t     bytes;
+} pacer_queue_t;
+
+typedef struct {
+    esp_peer_pacer_cfg_t  cfg;
+    pacer_queue_t         audio_q;
+    pacer_queue_t         video_q;
+    bool                  sending;
+    uint32_t              rate;
+    int64_t               next_send_us;
+    uint64_t              delay_sum_us;
+    uint32_t              delay_count;
+    esp_peer_pacer_stat_t stat;
+} pacer_t;
+
+static void queue_push(pacer_queue_t *q, pacer_pkt_t *pkt)
+{
+    pkt->next = NULL;
+    if (q->tail) {
+        q->tail->next = pkt;
+    } else {
+        q->head = pkt;
+    }
+    q->tail = pkt;
+    q->bytes += pkt->size;
+}
+
+static pacer_pkt_t *queue_pop(pacer_queue_t *q)
+{
+    pacer_pkt_t *pkt = q->head;
+    if (pkt) {
+        q->head = pkt->next;
+        if (q->head == NULL) {
+            q->tail = NULL;
+        }
+        q->bytes -= pkt->size;
+    }
+    return pkt;
+}
+
+static void queue_clear(pacer_queue_t *q)
+{
+    pacer_pkt_t *pkt;
+    while ((pkt = queue_pop(q)) != NULL) {
+        free(pkt);
+    }
+}
+
+static void pacer_update_rate(pacer_t *pacer)
+{
+    // Drain queued video within the spread window, but never slower than the target bitrate
+    uint32_t window_ms = (uint32_t)pacer->cfg.frame_interval * pacer->cfg.spread_ratio / 100;
+    if (window_ms == 0) {
+        window_ms = 1;
+    }
+    uint64_t rate = (uint64_t)pacer->video_q.bytes * 8 * 1000 / window_ms;
+    if (rate < pacer->cfg.bitrate) {
+        rate = pacer->cfg.bitrate;
+    }
+    if (pacer->cfg.max_bitrate && rate > pacer->cfg.max_bitrate) {
+        rate = pacer->cfg.max_bitrate;
+    }
+    // Only speed up while draining, so that one frame is sent at an even rate
+    if (rate > pacer->rate) {
+        pacer->rate = rate > UINT32_MAX ? UINT32_MAX : (uint32_t)rate;
+    }
+}
+
+static void pacer_add_send_time(pacer_t *pacer, int size)
+{
+    if (pacer->rate == 0) {
+        pacer_update_rate(pacer);
+    }
+    pacer->next_send_us += (int64_t)size * 8 * 1000000 / pacer->rate;
+}
+
+static void pacer_account_delay(pacer_t *pacer, pacer_pkt_t *pkt, int64_t now_us)
+{
+    uint32_t delay_ms = now_us > pkt->enqueue_us ? (uint32_t)((now_us - pkt->enqueue_us) / 1000) : 0;
+    pacer->delay_sum_us += now_us > pkt->enqueue_us ? (uint64_t)(now_us - pkt->enqueue_us) : 0;
+    pacer->delay_count++;
+    if (delay_ms > pacer->stat.max_queue_delay_ms) {
+        pacer->stat.max_queue_delay_ms = delay_ms;
+    }
+}
+
+int esp_peer_pacer_open(esp_peer_pacer_cfg_t *cfg, esp_peer_pacer_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    pacer_t *pacer = (pacer_t *)calloc(1, sizeof(pacer_t));
+    if (pacer == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    pacer->cfg = *cfg;
+    if (pacer->cfg.frame_interval == 0) {
+        pacer->cfg.frame_interval = PACER_DEFAULT_FRAME_INTERVAL;
+    }
+    if (pacer->cfg.spread_ratio == 0 || pacer->cfg.spread_ratio > 100) {
+        pacer->cfg.spread_ratio = PACER_DEFAULT_SPREAD_RATIO;
+    }
+    if (pacer->cfg.max_queue_bytes == 0) {
+        pacer->cfg.max_queue_bytes = PACER_DEFAULT_MAX_QUEUE;
+    }
+    if (pacer->cfg.bitrate < PACER_MIN_BITRATE) {
+        pacer->cfg.bitrate = PACER_MIN_BITRATE;
+    }
+    if (pacer->cfg.max_bitrate && pacer->cfg.max_bitrate < pacer->cfg.bitrate) {
+        pacer->cfg.max_bitrate = pacer->cfg.bitrate;
+    }
+    *handle = pacer;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_pacer_set_bitrate(esp_peer_pacer_handle_t handle, uint32_t bitrate)
+{
+    pacer_t *pacer = (pacer_t *)handle;
+    if (pacer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    pacer->cfg.bitrate = bitrate < PACER_MIN_BITRATE ? PACER_MIN_BITRATE : bitrate;
+    if (pacer->cfg.max_bitrate && pacer->cfg.max_bitrate < pacer->cfg.bitrate) {
+        pacer->cfg.max_bitrate = pacer->cfg.bitrate;
+    }
+    pacer->rate = 0;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_pacer_enqueue(esp_peer_pacer_handle_t handle, bool is_audio, esp_peer_rtp_iovec_t *iov, int iov_num, int64_t now_us)
+{
+    pacer_t *pacer = (pacer_t *)handle;
+    if (pacer == NULL || iov == NULL || iov_num <= 0) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    int size = 0;
+    for (int i = 0; i < iov_num; i++) {
+        size += iov[i].size;
+    }
+    if (size <= 0) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    // Audio is tiny and latency critical, only video is dropped when queue is full
+    if (is_audio == false && pacer->audio_q.bytes + pacer->video_q.bytes + size > pacer->cfg.max_queue_bytes) {
+        pacer->stat.dropped_packets++;
+        return ESP_PEER_ERR_OVER_LIMITED;
+    }
+    pacer_pkt_t *pkt = (pacer_pkt_t *)malloc(sizeof(pacer_pkt_t) + size);
+    if (pkt == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    pkt->enqueue_us = now_us;
+    pkt->size = size;
+    uint8_t *dst = pkt->data;
+    for (int i = 0; i < iov_num; i++) {
+        memcpy(dst, iov[i].data, iov[i].size);
+        dst += iov[i].size;
+    }
+    if (pacer->sending == false) {
+        // No credit is accumulated while idle, so burst after idle is paced too
+        pacer->sending = true;
+        pacer->next_send_us = now_us;
+    }
+    queue_push(is_audio ? &pacer->audio_q : &pacer->video_q, pkt);
+    if (is_audio == false) {
+        pacer_update_rate(pacer);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_pacer_process(esp_peer_pacer_handle_t handle, int64_t now_us, esp_peer_pacer_send_cb_t cb, void *ctx,
+                           uint32_t *wait_ms)
+{
+    pacer_t *pacer = (pacer_t *)handle;
+    if (pacer == NULL || cb == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    pacer_pkt_t *pkt;
+    // Audio goes out at once, its size still consumes budget so total rate is kept
+    while ((pkt = queue_pop(&pacer->audio_q)) != NULL) {
+        cb(pkt->data, pkt->size, true, ctx);
+        pacer_account_delay(pacer, pkt, now_us);
+        pacer->stat.audio_packets++;
+        pacer_add_send_time(pacer, pkt->size);
+        free(pkt);
+    }
+    while (pacer->video_q.head && pacer->next_send_us <= now_us) {
+        pkt = queue_pop(&pacer->video_q);
+        pacer_add_send_time(pacer, pkt->size);
+        cb(pkt->data, pkt->size, false, ctx);
+        pacer_account_delay(pacer, pkt, now_us);
+        pacer->stat.video_packets++;
+        free(pkt);
+    }
+    if (pacer->video_q.head == NULL) {
+        // Recalculate rate for next frame
+        pacer->rate = 0;
+        // Allow next packet to be sent when budget used by last packet is consumed
+        if (pacer->next_send_us <= now_us) {
+            pacer->sending = false;
+        }
+        if (wait_ms) {
+            *wait_ms = ESP_PEER_PACER_NO_WAIT;
+        }
+        return ESP_PEER_ERR_NONE;
+    }
+    if (wait_ms) {
+        *wait_ms = (uint32_t)((pacer->next_send_us - now_us + 999) / 1000);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_pacer_get_stat(esp_peer_pacer_handle_t handle, esp_peer_pacer_stat_t *stat, bool reset)
+{
+    pacer_t *pacer = (pacer_t *)handle;
+    if (pacer == NULL || stat == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    pacer->stat.queue_bytes = pacer->audio_q.bytes + pacer->video_q.bytes;
+    pacer->stat.avg_queue_delay_ms = pacer->delay_count ? (uint32_t)(pacer->delay_sum_us / pacer->delay_count / 1000) : 0;
+    *stat = pacer->stat;
+    if (reset) {
+        memset(&pacer->stat, 0, sizeof(esp_peer_pacer_stat_t));
+        pacer->delay_sum_us = 0;
+        pacer->delay_count = 0;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_pacer_close(esp_peer_pacer_handle_t handle)
+{
+    pacer_t *pacer = (pacer_t *)handle;
+    if (pacer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    queue_clear(&pacer->audio_q);
+    queue_clear(&pacer->video_q);
+    free(pacer);
+    return ESP_PEER_ERR_NONE;
+}
@@ -0,0 +1,319 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_peer_fec.h"
+
+#define RTP_VERSION          (2)
+#define RED_MIN_LOSS         (5)
+#define RED_MAX_BLOCK        (1023)  /* 10-bit block length */
+#define RED_MAX_TS_OFFSET    (16383) /* 14-bit timestamp offset */
+#define RED_BLOCK_HDR_SIZE   (4)
+#define RED_PRIMARY_HDR_SIZE (1)
+
+typedef struct {
+    esp_peer_red_encoder_cfg_t cfg;
+    bool                       enable;
+    bool                       has_prev;
+    uint8_t                    prev_pt;
+    uint16_t                   prev_seq;
+    uint32_t                   prev_ts;
+    int                        prev_size;
+    uint8_t                    prev[RED_MAX_BLOCK];
+    uint8_t                    hdr[ESP_PEER_RTP_HEADER_SIZE + RED_BLOCK_HDR_SIZE + RED_PRIMARY_HDR_SIZE];
+} red_encoder_t;
+
+typedef struct {
+    esp_peer_red_decoder_cfg_t cfg;
+    bool                       started;
+    uint16_t                   highest_seq;
+    uint8_t                   *buf;
+    int                        buf_size;
+    esp_peer_fec_stat_t        stat;
+} red_decoder_t;
+
+static inline uint16_t get_be16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline uint32_t get_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static inline void put_be16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+static inline void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+int esp_peer_red_encoder_open(esp_peer_red_encoder_cfg_t *cfg, esp_peer_fec_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    red_encoder_t *enc = (red_encoder_t *)calloc(1, sizeof(red_encoder_t));
+    if (enc == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    enc->cfg = *cfg;
+    enc->enable = cfg->enable;
+    *handle = enc;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_red_encoder_set_loss(esp_peer_fec_handle_t handle, uint16_t loss_rate)
+{
+    red_encoder_t *enc = (red_encoder_t *)handle;
+    if (enc == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    enc->enable = (loss_rate >= RED_MIN_LOSS);
+    return ESP_PEER_ERR_NONE;
+}
+
+static void red_save_prev(red_encoder_t *enc, const uint8_t *hdr, esp_peer_rtp_iovec_t *payload, int payload_num,
+                          int payload_size)
+{
+    enc->has_prev = (payload_size <= RED_MAX_BLOCK);
+    if (enc->has_prev == false) {
+        return;
+    }
+    int pos = 0;
+    for (int i = 0; i < payload_num; i++) {
+        memcpy(enc->prev + pos, payload[i].data, payload[i].size);
+        pos += payload[i].size;
+    }
+    enc->prev_size = payload_size;
+    enc->prev_pt = hdr[1] & 0x7F;
+    enc->prev_seq = get_be16(hdr + 2);
+    enc->prev_ts = get_be32(hdr + 4);
+}
+
+int esp_peer_red_encode(esp_peer_fec_handle_t handle, esp_peer_rtp_iovec_t *iov, int iov_num,
+                        esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    red_encoder_t *enc = (red_encoder_t *)handle;
+    if (enc == NULL || iov == NULL || iov_num <= 0 || iov_num > ESP_PEER_RTP_MAX_IOV || cb == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    const uint8_t *hdr = iov[0].data;
+    // Only plain RTP header is supported, CSRC and extension would need rewriting
+    if (enc->enable == false || iov[0].size < ESP_PEER_RTP_HEADER_SIZE || (hdr[0] & 0x3F)) {
+        enc->has_prev = false;
+        return cb(iov, iov_num, ctx);
+    }
+    // Payload segments without RTP header
+    esp_peer_rtp_iovec_t out[ESP_PEER_RTP_MAX_IOV + 2];
+    esp_peer_rtp_iovec_t *payload = out + 2;
+    int payload_num = 0;
+    int payload_size = 0;
+    for (int i = 0; i < iov_num; i++) {
+        int skip = (i == 0) ? ESP_PEER_RTP_HEADER_SIZE : 0;
+        if (iov[i].size > skip) {
+            payload[payload_num].data = iov[i].data + skip;
+            payload[payload_num].size = iov[i].size - skip;
+            payload_size += payload[payload_num].size;
+            payload_num++;
+        }
+    }
+    uint16_t seq = get_be16(hdr + 2);
+    uint32_t ts = get_be32(hdr + 4);
+    uint8_t pt = hdr[1] & 0x7F;
+    uint8_t *red_hdr = enc->hdr;
+    memcpy(red_hdr, hdr, ESP_PEER_RTP_HEADER_SIZE);
+    red_hdr[1] = (hdr[1] & 0x80) | (enc->cfg.payload_type & 0x7F);
+    int hdr_size = ESP_PEER_RTP_HEADER_SIZE;
+    uint32_t ts_offset = ts - enc->prev_ts;
+    bool add_prev = enc->has_prev && (uint16_t)(enc->prev_seq + 1) == seq && ts_offset <= RED_MAX_TS_OFFSET;
+    if (add_prev) {
+        uint8_t *block = red_hdr + hdr_size;
+        block[0] = 0x80 | enc->prev_pt;
+        block[1] = ts_offset >> 6;
+        block[2] = ((ts_offset & 0x3F) << 2) | (enc->prev_size >> 8);
+        block[3] = enc->prev_size & 0xFF;
+        hdr_size += RED_BLOCK_HDR_SIZE;
+    }
+    red_hdr[hdr_size++] = pt;
+    out[0].data = red_hdr;
+    out[0].size = hdr_size;
+    int out_num = 1;
+    if (add_prev) {
+        out[out_num].data = enc->prev;
+        out[out_num].size = enc->prev_size;
+        out_num++;
+    }
+    memmove(out + out_num, payload, payload_num * sizeof(esp_peer_rtp_iovec_t));
+    int ret = cb(out, out_num + payload_num, ctx);
+    // Output segments are not used anymore, safe to overwrite previous block
+    red_save_prev(enc, hdr, out + out_num, payload_num, payload_size);
+    return ret;
+}
+
+int esp_peer_red_encoder_close(esp_peer_fec_handle_t handle)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    free(handle);
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_red_decoder_open(esp_peer_red_decoder_cfg_t *cfg, esp_peer_fec_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    red_decoder_t *dec = (red_decoder_t *)calloc(1, sizeof(red_decoder_t));
+    if (dec == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    dec->cfg = *cfg;
+    *handle = dec;
+    return ESP_PEER_ERR_NONE;
+}
+
+static uint8_t *red_get_buf(red_decoder_t *dec, int size)
+{
+    if (size > dec->buf_size) {
+        uint8_t *buf = (uint8_t *)realloc(dec->buf, size);
+        if (buf == NULL) {
+            return NULL;
+        }
+        dec->buf = buf;
+        dec->buf_size = size;
+    }
+    return dec->buf;
+}
+
+static int red_output(red_decoder_t *dec, const uint8_t *hdr, uint8_t b1, uint16_t seq, uint32_t ts,
+                      const uint8_t *payload, int payload_size, esp_peer_fec_output_cb_t cb, void *ctx)
+{
+    uint8_t *out = red_get_buf(dec, ESP_PEER_RTP_HEADER_SIZE + payload_size);
+    if (out == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    out[0] = RTP_VERSION << 6;
+    out[1] = b1;
+    put_be16(out + 2, seq);
+    put_be32(out + 4, ts);
+    memcpy(out + 8, hdr + 8, 4);
+    memcpy(out + ESP_PEER_RTP_HEADER_SIZE, payload, payload_size);
+    return cb(out, ESP_PEER_RTP_HEADER_SIZE + payload_size, ctx);
+}
+
+static int red_track_media(red_decoder_t *dec, uint16_t seq)
+{
+    if (dec->started == false) {
+        dec->started = true;
+        dec->highest_seq = seq;
+        return 1;
+    }
+    int16_t diff = (int16_t)(seq - dec->highest_seq);
+    if (diff > 0) {
+        dec->stat.lost += diff - 1;
+        dec->highest_seq = seq;
+    } else if (diff < 0 && dec->stat.lost) {
+        // Late packet was counted as lost
+        dec->stat.lost--;
+    }
+    return diff;
+}
+
+int esp_peer_red_decode(esp_peer_fec_handle_t handle, const uint8_t *data, int size, esp_peer_fec_output_cb_t cb, void *ctx)
+{
+    red_decoder_t *dec = (red_decoder_t *)handle;
+    if (dec == NULL || data == NULL || cb == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    if (size < ESP_PEER_RTP_HEADER_SIZE || (data[0] >> 6) != RTP_VERSION) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    uint16_t seq = get_be16(data + 2);
+    dec->stat.media_packets++;
+    if ((data[1] & 0x7F) != dec->cfg.payload_type) {
+        red_track_media(dec, seq);
+        return cb(data, size, ctx);
+    }
+    if (data[0] & 0x3F) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    // Parse block headers, only the nearest redundant block is used
+    const uint8_t *p = data + ESP_PEER_RTP_HEADER_SIZE;
+    const uint8_t *end = data + size;
+    int red_size = 0;
+    int red_total = 0;
+    uint8_t red_pt = 0;
+    uint16_t red_offset = 0;
+    while (p < end && (p[0] & 0x80)) {
+        if (end - p < RED_BLOCK_HDR_SIZE) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        red_pt = p[0] & 0x7F;
+        red_offset = (p[1] << 6) | (p[2] >> 2);
+        red_size = ((p[2] & 0x3) << 8) | p[3];
+        red_total += red_size;
+        p += RED_BLOCK_HDR_SIZE;
+    }
+    if (end - p < RED_PRIMARY_HDR_SIZE) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    uint8_t primary_pt = p[0] & 0x7F;
+    p += RED_PRIMARY_HDR_SIZE;
+    if (red_total > end - p) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    uint32_t ts = get_be32(data + 4);
+    int diff = red_track_media(dec, seq);
+    if (red_total) {
+        dec->stat.fec_packets++;
+    }
+    if (diff >= 2) {
+        if (red_size) {
+            // Previous packet lost, rebuild it from last redundant block which is always distance 1
+            const uint8_t *red_data = p + red_total - red_size;
+            dec->stat.recovered++;
+            dec->stat.unrecovered += diff - 2;
+            red_output(dec, data, red_pt, seq - 1, ts - red_offset, red_data, red_size, cb, ctx);
+        } else {
+            dec->stat.unrecovered += diff - 1;
+        }
+    }
+    p += red_total;
+    return red_output(dec, data, (data[1] & 0x80) | primary_pt, seq, ts, p, end - p, cb, ctx);
+}
+
+int esp_peer_red_decoder_get_stat(esp_peer_fec_handle_t handle, esp_peer_fec_stat_t *stat)
+{
+    red_decoder_t *dec = (red_decoder_t *)handle;
+    if (dec == NULL || stat == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    *stat = dec->stat;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_red_decoder_close(esp_peer_fec_handle_t handle)
+{
+    red_decoder_t *dec = (red_decoder_t *)handle;
+    if (dec == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    free(dec->buf);
+    free(dec);
+    return ESP_PEER_ERR_NONE;
+}
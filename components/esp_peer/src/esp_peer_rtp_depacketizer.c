@@ -0,0 +1,632 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_peer_rtp.h"
+
+#define RTP_VERSION             (2)
+#define H264_NAL_STAP_A         (24)
+#define H264_NAL_FU_A           (28)
+#define JPEG_QT_SIZE            (64)
+#define DEFAULT_REORDER_NUM     (16)
+#define DEFAULT_VIDEO_FRAME_MAX (256 * 1024)
+#define DEFAULT_AUDIO_FRAME_MAX (4 * 1024)
+
+typedef struct {
+    bool            marker;
+    uint16_t        seq;
+    uint32_t        timestamp;
+    const uint8_t  *payload;
+    int             payload_size;
+} rtp_pkt_t;
+
+typedef struct {
+    bool      used;
+    uint16_t  seq;
+    uint8_t  *data;
+    int       size;
+    int       cap;
+} rtp_slot_t;
+
+typedef struct {
+    esp_peer_rtp_depacketizer_cfg_t cfg;
+    uint32_t                        clock_rate;
+    bool                            started;
+    uint16_t                        expected_seq;
+    uint16_t                        start_low;   // Lowest sequence number held before start
+    uint16_t                        start_high;  // Highest sequence number held before start
+    uint8_t                         start_held;
+    uint16_t                        slot_mask;   // Slot number is power of 2 so that index stays same across seq wrap
+    rtp_slot_t                     *slots;
+    uint8_t                        *frame;
+    int                             frame_size;
+    uint32_t                        frame_ts;
+    bool                            in_frame;
+    bool                            corrupted;
+    bool                            pending_loss;
+    bool                            key_frame;
+    bool                            in_fu;
+    int                             jpeg_hdr_size;
+    esp_peer_rtp_stat_t             stat;
+} rtp_depacketizer_t;
+
+/* JPEG default tables from RFC 2435 Appendix A and B, quantization tables in zigzag order */
+static const uint8_t jpeg_luma_quantizer[JPEG_QT_SIZE] = {
+    16, 11, 12, 14, 12, 10, 16, 14, 13, 14, 18, 17, 16, 19, 24, 40,
+    26, 24, 22, 22, 24, 49, 35, 37, 29, 40, 58, 51, 61, 60, 57, 51,
+    56, 55, 64, 72, 92, 78, 64, 68, 87, 69, 55, 56, 80, 109, 81, 87,
+    95, 98, 103, 104, 103, 62, 77, 113, 121, 112, 100, 120, 92, 101, 103, 99,
+};
+
+static const uint8_t jpeg_chroma_quantizer[JPEG_QT_SIZE] = {
+    17, 18, 18, 24, 21, 24, 47, 26, 26, 47, 99, 66, 56, 66, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+};
+
+static const uint8_t lum_dc_codelens[16] = {
+    0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const uint8_t lum_dc_symbols[12] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+};
+
+static const uint8_t lum_ac_codelens[16] = {
+    0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d,
+};
+
+static const uint8_t lum_ac_symbols[162] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+    0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+
+static const uint8_t chm_dc_codelens[16] = {
+    0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+};
+
+static const uint8_t chm_dc_symbols[12] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+};
+
+static const uint8_t chm_ac_codelens[16] = {
+    0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77,
+};
+
+static const uint8_t chm_ac_symbols[162] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+    0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+    0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+    0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa,
+};
+
+static inline uint16_t get_be16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline uint32_t get_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t get_clock_rate(esp_peer_rtp_codec_t codec)
+{
+    switch (codec) {
+        case ESP_PEER_RTP_CODEC_H264:
+        case ESP_PEER_RTP_CODEC_MJPEG:
+            return 90000;
+        case ESP_PEER_RTP_CODEC_OPUS:
+            return 48000;
+        case ESP_PEER_RTP_CODEC_G711A:
+        case ESP_PEER_RTP_CODEC_G711U:
+            return 8000;
+        default:
+            return 0;
+    }
+}
+
+static bool is_video(rtp_depacketizer_t *dep)
+{
+    return dep->cfg.codec == ESP_PEER_RTP_CODEC_H264 || dep->cfg.codec == ESP_PEER_RTP_CODEC_MJPEG;
+}
+
+static int parse_rtp(const uint8_t *data, int size, rtp_pkt_t *pkt)
+{
+    if (size < ESP_PEER_RTP_HEADER_SIZE || (data[0] >> 6) != RTP_VERSION) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    int hdr_size = ESP_PEER_RTP_HEADER_SIZE + (data[0] & 0x0F) * 4;
+    if (data[0] & 0x10) {
+        if (size < hdr_size + 4) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        hdr_size += 4 + get_be16(data + hdr_size + 2) * 4;
+    }
+    int padding = (data[0] & 0x20) ? data[size - 1] : 0;
+    int payload_size = size - hdr_size - padding;
+    if (payload_size <= 0) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    pkt->marker = data[1] >> 7;
+    pkt->seq = get_be16(data + 2);
+    pkt->timestamp = get_be32(data + 4);
+    pkt->payload = data + hdr_size;
+    pkt->payload_size = payload_size;
+    return ESP_PEER_ERR_NONE;
+}
+
+static void frame_append(rtp_depacketizer_t *dep, const uint8_t *data, int size)
+{
+    if (dep->corrupted) {
+        return;
+    }
+    if (dep->frame_size + size > (int)dep->cfg.max_frame_size) {
+        dep->corrupted = true;
+        return;
+    }
+    memcpy(dep->frame + dep->frame_size, data, size);
+    dep->frame_size += size;
+}
+
+static void frame_append_start_code(rtp_depacketizer_t *dep)
+{
+    static const uint8_t start_code[4] = { 0, 0, 0, 1 };
+    frame_append(dep, start_code, sizeof(start_code));
+}
+
+static void frame_begin(rtp_depacketizer_t *dep, uint32_t timestamp)
+{
+    if (dep->in_frame && dep->frame_ts == timestamp) {
+        return;
+    }
+    if (dep->in_frame) {
+        // Previous frame never got its last packet
+        dep->stat.dropped_frames++;
+    }
+    dep->in_frame = true;
+    dep->frame_ts = timestamp;
+    dep->frame_size = 0;
+    dep->corrupted = dep->pending_loss;
+    dep->pending_loss = false;
+    dep->key_frame = false;
+    dep->in_fu = false;
+    dep->jpeg_hdr_size = 0;
+}
+
+static int frame_finish(rtp_depacketizer_t *dep, esp_peer_rtp_frame_cb_t cb, void *ctx)
+{
+    dep->in_frame = false;
+    if (dep->corrupted || dep->frame_size == 0) {
+        dep->stat.dropped_frames++;
+        return ESP_PEER_ERR_NONE;
+    }
+    esp_peer_rtp_frame_t frame = {
+        .pts = (uint32_t)((uint64_t)dep->frame_ts * 1000 / dep->clock_rate),
+        .timestamp = dep->frame_ts,
+        .key_frame = dep->key_frame,
+        .data = dep->frame,
+        .size = dep->frame_size,
+    };
+    dep->stat.frames++;
+    return cb(&frame, ctx);
+}
+
+static void h264_mark_key(rtp_depacketizer_t *dep, uint8_t nal_type)
+{
+    if (nal_type == 5 || nal_type == 7) {
+        dep->key_frame = true;
+    }
+}
+
+static void unpack_h264(rtp_depacketizer_t *dep, const uint8_t *p, int size)
+{
+    uint8_t nal_type = p[0] & 0x1F;
+    if (nal_type >= 1 && nal_type <= 23) {
+        h264_mark_key(dep, nal_type);
+        frame_append_start_code(dep);
+        frame_append(dep, p, size);
+    } else if (nal_type == H264_NAL_STAP_A) {
+        int pos = 1;
+        while (pos + 2 <= size) {
+            int nal_size = get_be16(p + pos);
+            pos += 2;
+            if (nal_size == 0 || pos + nal_size > size) {
+                dep->corrupted = true;
+                return;
+            }
+            h264_mark_key(dep, p[pos] & 0x1F);
+            frame_append_start_code(dep);
+            frame_append(dep, p + pos, nal_size);
+            pos += nal_size;
+        }
+    } else if (nal_type == H264_NAL_FU_A && size > 2) {
+        uint8_t fu_hdr = p[1];
+        if (fu_hdr & 0x80) {
+            uint8_t nal_hdr = (p[0] & 0xE0) | (fu_hdr & 0x1F);
+            h264_mark_key(dep, nal_hdr & 0x1F);
+            frame_append_start_code(dep);
+            frame_append(dep, &nal_hdr, 1);
+            dep->in_fu = true;
+        } else if (dep->in_fu == false) {
+            // Start fragment lost
+            dep->corrupted = true;
+            return;
+        }
+        frame_append(dep, p + 2, size - 2);
+        if (fu_hdr & 0x40) {
+            dep->in_fu = false;
+        }
+    } else {
+        // STAP-B, MTAP and FU-B are not used in packetization mode 1
+        dep->corrupted = true;
+    }
+}
+
+static void make_quant_tables(int q, uint8_t *lqt, uint8_t *cqt)
+{
+    int factor = q < 1 ? 1 : (q > 99 ? 99 : q);
+    int scale = q < 50 ? 5000 / factor : 200 - factor * 2;
+    for (int i = 0; i < JPEG_QT_SIZE; i++) {
+        int lq = (jpeg_luma_quantizer[i] * scale + 50) / 100;
+        int cq = (jpeg_chroma_quantizer[i] * scale + 50) / 100;
+        lqt[i] = lq < 1 ? 1 : (lq > 255 ? 255 : lq);
+        cqt[i] = cq < 1 ? 1 : (cq > 255 ? 255 : cq);
+    }
+}
+
+static void append_huffman_table(rtp_depacketizer_t *dep, uint8_t class_id, const uint8_t *codelens, const uint8_t *symbols,
+                                 int symbol_num)
+{
+    uint8_t hdr[5] = { 0xFF, 0xC4, 0, 0, class_id };
+    int len = 3 + 16 + symbol_num;
+    hdr[2] = len >> 8;
+    hdr[3] = len & 0xFF;
+    frame_append(dep, hdr, sizeof(hdr));
+    frame_append(dep, codelens, 16);
+    frame_append(dep, symbols, symbol_num);
+}
+
+static void append_jpeg_header(rtp_depacketizer_t *dep, uint8_t type, int width, int height, uint16_t dri,
+                               const uint8_t *lqt, const uint8_t *cqt)
+{
+    static const uint8_t soi[2] = { 0xFF, 0xD8 };
+    static const uint8_t sos[14] = { 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00 };
+    frame_append(dep, soi, sizeof(soi));
+    uint8_t dqt[5] = { 0xFF, 0xDB, 0x00, 2 + (1 + JPEG_QT_SIZE) * 2, 0x00 };
+    frame_append(dep, dqt, sizeof(dqt));
+    frame_append(dep, lqt, JPEG_QT_SIZE);
+    uint8_t cqt_id = 0x01;
+    frame_append(dep, &cqt_id, 1);
+    frame_append(dep, cqt, JPEG_QT_SIZE);
+    if (dri) {
+        uint8_t dri_seg[6] = { 0xFF, 0xDD, 0x00, 0x04, dri >> 8, dri & 0xFF };
+        frame_append(dep, dri_seg, sizeof(dri_seg));
+    }
+    uint8_t sof[19] = {
+        0xFF, 0xC0, 0x00, 0x11, 0x08,
+        height >> 8, height & 0xFF, width >> 8, width & 0xFF, 0x03,
+        0x01, type == 0 ? 0x21 : 0x22, 0x00,
+        0x02, 0x11, 0x01,
+        0x03, 0x11, 0x01,
+    };
+    frame_append(dep, sof, sizeof(sof));
+    append_huffman_table(dep, 0x00, lum_dc_codelens, lum_dc_symbols, sizeof(lum_dc_symbols));
+    append_huffman_table(dep, 0x10, lum_ac_codelens, lum_ac_symbols, sizeof(lum_ac_symbols));
+    append_huffman_table(dep, 0x01, chm_dc_codelens, chm_dc_symbols, sizeof(chm_dc_symbols));
+    append_huffman_table(dep, 0x11, chm_ac_codelens, chm_ac_symbols, sizeof(chm_ac_symbols));
+    frame_append(dep, sos, sizeof(sos));
+}
+
+static void unpack_jpeg(rtp_depacketizer_t *dep, const uint8_t *p, int size)
+{
+    if (size < 8) {
+        dep->corrupted = true;
+        return;
+    }
+    uint32_t offset = ((uint32_t)p[1] << 16) | (p[2] << 8) | p[3];
+    uint8_t type = p[4];
+    uint8_t q = p[5];
+    int width = p[6] * 8;
+    int height = p[7] * 8;
+    uint16_t dri = 0;
+    int pos = 8;
+    if (type >= 64) {
+        if (size < pos + 4) {
+            dep->corrupted = true;
+            return;
+        }
+        dri = get_be16(p + pos);
+        pos += 4;
+        type -= 64;
+    }
+    if (type > 1 || width == 0 || height == 0) {
+        dep->corrupted = true;
+        return;
+    }
+    if (offset == 0) {
+        uint8_t lqt[JPEG_QT_SIZE], cqt[JPEG_QT_SIZE];
+        const uint8_t *luma = lqt;
+        const uint8_t *chroma = cqt;
+        if (q >= 128) {
+            if (size < pos + 4) {
+                dep->corrupted = true;
+                return;
+            }
+            int qt_len = get_be16(p + pos + 2);
+            // Only 8-bit precision luma and chroma table supported
+            if (p[pos + 1] != 0 || qt_len < JPEG_QT_SIZE * 2 || size < pos + 4 + qt_len) {
+                dep->corrupted = true;
+                return;
+            }
+            luma = p + pos + 4;
+            chroma = luma + JPEG_QT_SIZE;
+            pos += 4 + qt_len;
+        } else {
+            make_quant_tables(q, lqt, cqt);
+        }
+        dep->frame_size = 0;
+        append_jpeg_header(dep, type, width, height, dri, luma, chroma);
+        dep->jpeg_hdr_size = dep->frame_size;
+        dep->key_frame = true;
+    } else if (dep->jpeg_hdr_size == 0 || offset != (uint32_t)(dep->frame_size - dep->jpeg_hdr_size)) {
+        // First fragment or middle fragment lost
+        dep->corrupted = true;
+        return;
+    }
+    frame_append(dep, p + pos, size - pos);
+}
+
+static int process_packet(rtp_depacketizer_t *dep, rtp_pkt_t *pkt, esp_peer_rtp_frame_cb_t cb, void *ctx)
+{
+    if (is_video(dep) == false) {
+        // Each audio packet carries one frame, output it in place
+        esp_peer_rtp_frame_t frame = {
+            .pts = (uint32_t)((uint64_t)pkt->timestamp * 1000 / dep->clock_rate),
+            .timestamp = pkt->timestamp,
+            .key_frame = true,
+            .data = (uint8_t *)pkt->payload,
+            .size = pkt->payload_size,
+        };
+        dep->stat.frames++;
+        return cb(&frame, ctx);
+    }
+    frame_begin(dep, pkt->timestamp);
+    if (dep->cfg.codec == ESP_PEER_RTP_CODEC_H264) {
+        unpack_h264(dep, pkt->payload, pkt->payload_size);
+    } else {
+        unpack_jpeg(dep, pkt->payload, pkt->payload_size);
+    }
+    if (pkt->marker) {
+        if (dep->cfg.codec == ESP_PEER_RTP_CODEC_MJPEG && dep->corrupted == false) {
+            if (dep->frame_size < 2 || dep->frame[dep->frame_size - 2] != 0xFF || dep->frame[dep->frame_size - 1] != 0xD9) {
+                static const uint8_t eoi[2] = { 0xFF, 0xD9 };
+                frame_append(dep, eoi, sizeof(eoi));
+            }
+        }
+        return frame_finish(dep, cb, ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static void mark_loss(rtp_depacketizer_t *dep)
+{
+    dep->stat.lost++;
+    if (dep->in_frame) {
+        dep->corrupted = true;
+    } else {
+        dep->pending_loss = true;
+    }
+}
+
+static int process_slot(rtp_depacketizer_t *dep, rtp_slot_t *slot, esp_peer_rtp_frame_cb_t cb, void *ctx)
+{
+    rtp_pkt_t pkt;
+    slot->used = false;
+    dep->stat.reordered++;
+    if (parse_rtp(slot->data, slot->size, &pkt) != ESP_PEER_ERR_NONE) {
+        return ESP_PEER_ERR_NONE;
+    }
+    return process_packet(dep, &pkt, cb, ctx);
+}
+
+static int drain_slots(rtp_depacketizer_t *dep, esp_peer_rtp_frame_cb_t cb, void *ctx)
+{
+    int ret = ESP_PEER_ERR_NONE;
+    while (ret == ESP_PEER_ERR_NONE) {
+        rtp_slot_t *slot = &dep->slots[dep->expected_seq & dep->slot_mask];
+        if (slot->used == false || slot->seq != dep->expected_seq) {
+            break;
+        }
+        dep->expected_seq++;
+        ret = process_slot(dep, slot, cb, ctx);
+    }
+    return ret;
+}
+
+static int store_slot(rtp_depacketizer_t *dep, uint16_t seq, const uint8_t *data, int size)
+{
+    rtp_slot_t *slot = &dep->slots[seq & dep->slot_mask];
+    if (slot->used) {
+        dep->stat.discarded++;
+        return ESP_PEER_ERR_NONE;
+    }
+    if (slot->cap < size) {
+        uint8_t *buf = (uint8_t *)realloc(slot->data, size);
+        if (buf == NULL) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+        slot->data = buf;
+        slot->cap = size;
+    }
+    memcpy(slot->data, data, size);
+    slot->size = size;
+    slot->seq = seq;
+    slot->used = true;
+    return ESP_PEER_ERR_NONE;
+}
+
+static bool hold_before_start(rtp_depacketizer_t *dep, uint16_t seq)
+{
+    // Each audio packet is a frame by itself, no need to wait
+    if (is_video(dep) == false) {
+        return false;
+    }
+    if (dep->start_held == 0) {
+        dep->start_low = dep->start_high = seq;
+        return true;
+    }
+    uint16_t low = (int16_t)(seq - dep->start_low) < 0 ? seq : dep->start_low;
+    uint16_t high = (int16_t)(seq - dep->start_high) > 0 ? seq : dep->start_high;
+    if ((uint16_t)(high - low) >= dep->cfg.reorder_num) {
+        // Packet is out of reorder window, let normal path handle it
+        return false;
+    }
+    dep->start_low = low;
+    dep->start_high = high;
+    return true;
+}
+
+int esp_peer_rtp_depacketizer_open(esp_peer_rtp_depacketizer_cfg_t *cfg, esp_peer_rtp_depacketizer_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL || get_clock_rate(cfg->codec) == 0) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    rtp_depacketizer_t *dep = (rtp_depacketizer_t *)calloc(1, sizeof(rtp_depacketizer_t));
+    if (dep == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    dep->cfg = *cfg;
+    dep->clock_rate = get_clock_rate(cfg->codec);
+    if (dep->cfg.reorder_num == 0) {
+        dep->cfg.reorder_num = DEFAULT_REORDER_NUM;
+    }
+    if (dep->cfg.max_frame_size == 0) {
+        dep->cfg.max_frame_size = is_video(dep) ? DEFAULT_VIDEO_FRAME_MAX : DEFAULT_AUDIO_FRAME_MAX;
+    }
+    uint16_t slot_num = 1;
+    while (slot_num < dep->cfg.reorder_num) {
+        slot_num <<= 1;
+    }
+    dep->slot_mask = slot_num - 1;
+    dep->slots = (rtp_slot_t *)calloc(slot_num, sizeof(rtp_slot_t));
+    // Audio frame is output from packet directly
+    if (is_video(dep)) {
+        dep->frame = (uint8_t *)malloc(dep->cfg.max_frame_size);
+    }
+    if (dep->slots == NULL || (is_video(dep) && dep->frame == NULL)) {
+        esp_peer_rtp_depacketizer_close(dep);
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    *handle = dep;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_rtp_depacketize(esp_peer_rtp_depacketizer_handle_t handle, const uint8_t *data, int size,
+                             esp_peer_rtp_frame_cb_t cb, void *ctx)
+{
+    if (handle == NULL || data == NULL || cb == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    rtp_depacketizer_t *dep = (rtp_depacketizer_t *)handle;
+    rtp_pkt_t pkt;
+    int ret = parse_rtp(data, size, &pkt);
+    if (ret != ESP_PEER_ERR_NONE) {
+        dep->stat.discarded++;
+        return ret;
+    }
+    dep->stat.packets++;
+    if (dep->started == false) {
+        // Hold first packets for a reorder window then start from the lowest one
+        // So that reordered parameter sets or first fragment before it are not taken as late
+        if (hold_before_start(dep, pkt.seq)) {
+            ret = store_slot(dep, pkt.seq, data, size);
+            if (ret != ESP_PEER_ERR_NONE || ++dep->start_held < dep->cfg.reorder_num) {
+                return ret;
+            }
+            dep->started = true;
+            dep->expected_seq = dep->start_low;
+            return drain_slots(dep, cb, ctx);
+        }
+        dep->started = true;
+        dep->expected_seq = dep->start_held ? dep->start_low : pkt.seq;
+    }
+    int16_t diff = (int16_t)(pkt.seq - dep->expected_seq);
+    if (diff < 0) {
+        // Duplicated or arrived after given up
+        dep->stat.discarded++;
+        return ESP_PEER_ERR_NONE;
+    }
+    if (diff >= dep->cfg.reorder_num) {
+        // Reorder window exceeded, give up missing packets before it
+        while ((int16_t)(pkt.seq - dep->expected_seq) >= dep->cfg.reorder_num) {
+            rtp_slot_t *slot = &dep->slots[dep->expected_seq & dep->slot_mask];
+            uint16_t seq = dep->expected_seq++;
+            if (slot->used && slot->seq == seq) {
+                process_slot(dep, slot, cb, ctx);
+            } else {
+                mark_loss(dep);
+            }
+        }
+        drain_slots(dep, cb, ctx);
+        diff = (int16_t)(pkt.seq - dep->expected_seq);
+    }
+    if (diff == 0) {
+        dep->expected_seq++;
+        ret = process_packet(dep, &pkt, cb, ctx);
+        if (ret == ESP_PEER_ERR_NONE) {
+            ret = drain_slots(dep, cb, ctx);
+        }
+        return ret;
+    }
+    return store_slot(dep, pkt.seq, data, size);
+}
+
+int esp_peer_rtp_depacketizer_get_stat(esp_peer_rtp_depacketizer_handle_t handle, esp_peer_rtp_stat_t *stat)
+{
+    if (handle == NULL || stat == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    rtp_depacketizer_t *dep = (rtp_depacketizer_t *)handle;
+    *stat = dep->stat;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_rtp_depacketizer_close(esp_peer_rtp_depacketizer_handle_t handle)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    rtp_depacketizer_t *dep = (rtp_depacketizer_t *)handle;
+    if (dep->slots) {
+        for (int i = 0; i <= dep->slot_mask; i++) {
+            free(dep->slots[i].data);
+        }
+        free(dep->slots);
+    }
+    free(dep->frame);
+    free(dep);
+    return ESP_PEER_ERR_NONE;
+}
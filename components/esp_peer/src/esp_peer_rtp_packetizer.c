@@ -0,0 +1,409 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO., LTD
+ * SPDX-License-Identifier: LicenseRef-Espressif-Modified-MIT
+ *
+ * See LICENSE file for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_peer_rtp.h"
+
+#define RTP_VERSION           (2)
+#define H264_NAL_STAP_A       (24)
+#define H264_NAL_FU_A         (28)
+#define H264_STAP_MAX_NAL     (3)
+#define JPEG_MAIN_HDR_SIZE    (8)
+#define JPEG_RESTART_HDR_SIZE (4)
+#define JPEG_QT_HDR_SIZE      (4)
+#define JPEG_QT_SIZE          (64)
+#define JPEG_MAX_DIMENSION    (2040)
+#define RTP_PAYLOAD_HDR_MAX   (JPEG_MAIN_HDR_SIZE + JPEG_RESTART_HDR_SIZE + JPEG_QT_HDR_SIZE)
+
+typedef struct {
+    esp_peer_rtp_packetizer_cfg_t cfg;
+    uint32_t                      clock_rate;
+    uint16_t                      seq;
+    uint32_t                      timestamp;
+    uint8_t                       hdr[ESP_PEER_RTP_HEADER_SIZE + RTP_PAYLOAD_HDR_MAX];
+    uint8_t                       stap_len[H264_STAP_MAX_NAL][2];
+} rtp_packetizer_t;
+
+typedef struct {
+    const uint8_t *data;
+    int            size;
+} rtp_nal_t;
+
+typedef struct {
+    uint8_t        type;
+    uint16_t       width;
+    uint16_t       height;
+    uint16_t       dri;
+    const uint8_t *qt[2];
+    const uint8_t *scan;
+    int            scan_size;
+} rtp_jpeg_info_t;
+
+static inline void put_be16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+static inline void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+static uint32_t get_clock_rate(esp_peer_rtp_codec_t codec)
+{
+    switch (codec) {
+        case ESP_PEER_RTP_CODEC_H264:
+        case ESP_PEER_RTP_CODEC_MJPEG:
+            return 90000;
+        case ESP_PEER_RTP_CODEC_OPUS:
+            return 48000;
+        case ESP_PEER_RTP_CODEC_G711A:
+        case ESP_PEER_RTP_CODEC_G711U:
+            return 8000;
+        default:
+            return 0;
+    }
+}
+
+static int send_packet(rtp_packetizer_t *pack, bool marker, esp_peer_rtp_iovec_t *iov, int iov_num,
+                       esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    uint8_t *hdr = pack->hdr;
+    hdr[0] = RTP_VERSION << 6;
+    hdr[1] = (marker ? 0x80 : 0) | (pack->cfg.payload_type & 0x7F);
+    put_be16(hdr + 2, pack->seq++);
+    put_be32(hdr + 4, pack->timestamp);
+    put_be32(hdr + 8, pack->cfg.ssrc);
+    return cb(iov, iov_num, ctx);
+}
+
+static bool next_nal(const uint8_t *data, int size, int *pos, rtp_nal_t *nal)
+{
+    int i = *pos;
+    // Search start code
+    while (i + 3 <= size && !(data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1)) {
+        i++;
+    }
+    if (i + 3 > size) {
+        if (*pos == 0 && size > 0) {
+            // Frame without start code is treated as one NAL
+            nal->data = data;
+            nal->size = size;
+            *pos = size;
+            return true;
+        }
+        return false;
+    }
+    int start = i + 3;
+    int end = start;
+    while (end + 3 <= size && !(data[end] == 0 && data[end + 1] == 0 && (data[end + 2] == 1 || data[end + 2] == 0))) {
+        end++;
+    }
+    if (end + 3 > size) {
+        end = size;
+    }
+    *pos = end;
+    // Skip empty NAL
+    if (end <= start) {
+        return next_nal(data, size, pos, nal);
+    }
+    nal->data = data + start;
+    nal->size = end - start;
+    return true;
+}
+
+static int send_h264_fu_a(rtp_packetizer_t *pack, rtp_nal_t *nal, bool last_nal, esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    uint8_t nal_hdr = nal->data[0];
+    const uint8_t *payload = nal->data + 1;
+    int remain = nal->size - 1;
+    int max_chunk = pack->cfg.mtu - ESP_PEER_RTP_HEADER_SIZE - 2;
+    bool start = true;
+    while (remain > 0) {
+        int chunk = remain > max_chunk ? max_chunk : remain;
+        bool end = (chunk == remain);
+        pack->hdr[ESP_PEER_RTP_HEADER_SIZE] = (nal_hdr & 0xE0) | H264_NAL_FU_A;
+        pack->hdr[ESP_PEER_RTP_HEADER_SIZE + 1] = (start ? 0x80 : 0) | (end ? 0x40 : 0) | (nal_hdr & 0x1F);
+        esp_peer_rtp_iovec_t iov[2] = {
+            { pack->hdr, ESP_PEER_RTP_HEADER_SIZE + 2 },
+            { payload, chunk },
+        };
+        int ret = send_packet(pack, last_nal && end, iov, 2, cb, ctx);
+        if (ret != ESP_PEER_ERR_NONE) {
+            return ret;
+        }
+        payload += chunk;
+        remain -= chunk;
+        start = false;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int send_h264_stap_a(rtp_packetizer_t *pack, rtp_nal_t *nals, int nal_num, bool last_nal,
+                            esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    esp_peer_rtp_iovec_t iov[ESP_PEER_RTP_MAX_IOV];
+    // F bit is OR of all NAL, NRI is the maximum one
+    uint8_t f_bit = 0;
+    uint8_t nri = 0;
+    for (int i = 0; i < nal_num; i++) {
+        uint8_t nal_hdr = nals[i].data[0];
+        f_bit |= nal_hdr & 0x80;
+        if ((nal_hdr & 0x60) > nri) {
+            nri = nal_hdr & 0x60;
+        }
+    }
+    uint8_t *stap = pack->hdr + ESP_PEER_RTP_HEADER_SIZE;
+    stap[0] = f_bit | nri | H264_NAL_STAP_A;
+    put_be16(stap + 1, nals[0].size);
+    iov[0].data = pack->hdr;
+    iov[0].size = ESP_PEER_RTP_HEADER_SIZE + 3;
+    iov[1].data = nals[0].data;
+    iov[1].size = nals[0].size;
+    int iov_num = 2;
+    for (int i = 1; i < nal_num; i++) {
+        put_be16(pack->stap_len[i], nals[i].size);
+        iov[iov_num].data = pack->stap_len[i];
+        iov[iov_num++].size = 2;
+        iov[iov_num].data = nals[i].data;
+        iov[iov_num++].size = nals[i].size;
+    }
+    return send_packet(pack, last_nal, iov, iov_num, cb, ctx);
+}
+
+static int packetize_h264(rtp_packetizer_t *pack, const uint8_t *data, int size, esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    int max_payload = pack->cfg.mtu - ESP_PEER_RTP_HEADER_SIZE;
+    int pos = 0;
+    rtp_nal_t cur, next;
+    bool has_nal = next_nal(data, size, &pos, &cur);
+    while (has_nal) {
+        rtp_nal_t group[H264_STAP_MAX_NAL];
+        int nal_num = 0;
+        group[nal_num++] = cur;
+        int stap_size = 1 + 2 + cur.size;
+        has_nal = next_nal(data, size, &pos, &next);
+        // Aggregate small NAL (SPS, PPS, SEI) together
+        while (has_nal && nal_num < H264_STAP_MAX_NAL && stap_size + 2 + next.size <= max_payload) {
+            group[nal_num++] = next;
+            stap_size += 2 + next.size;
+            has_nal = next_nal(data, size, &pos, &next);
+        }
+        bool last_nal = !has_nal;
+        int ret;
+        if (nal_num > 1) {
+            ret = send_h264_stap_a(pack, group, nal_num, last_nal, cb, ctx);
+        } else if (cur.size <= max_payload) {
+            esp_peer_rtp_iovec_t iov[2] = {
+                { pack->hdr, ESP_PEER_RTP_HEADER_SIZE },
+                { cur.data, cur.size },
+            };
+            ret = send_packet(pack, last_nal, iov, 2, cb, ctx);
+        } else {
+            ret = send_h264_fu_a(pack, &cur, last_nal, cb, ctx);
+        }
+        if (ret != ESP_PEER_ERR_NONE) {
+            return ret;
+        }
+        cur = next;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int parse_jpeg(const uint8_t *data, int size, rtp_jpeg_info_t *info)
+{
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    bool has_sof = false;
+    int pos = 2;
+    while (pos + 4 <= size) {
+        if (data[pos] != 0xFF) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            pos++;
+            continue;
+        }
+        int len = (data[pos + 2] << 8) | data[pos + 3];
+        if (len < 2 || pos + 2 + len > size) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        const uint8_t *seg = data + pos + 4;
+        int seg_len = len - 2;
+        if (marker == 0xDB) {
+            for (int i = 0; i + 1 + JPEG_QT_SIZE <= seg_len; i += 1 + JPEG_QT_SIZE) {
+                // Only 8-bit precision table can be carried
+                if (seg[i] >> 4) {
+                    return ESP_PEER_ERR_NOT_SUPPORT;
+                }
+                if ((seg[i] & 0x0F) < 2) {
+                    info->qt[seg[i] & 0x0F] = seg + i + 1;
+                }
+            }
+        } else if (marker == 0xC0) {
+            if (seg_len < 15 || seg[5] != 3 || seg[10] != 0x11 || seg[13] != 0x11) {
+                return ESP_PEER_ERR_NOT_SUPPORT;
+            }
+            info->height = (seg[1] << 8) | seg[2];
+            info->width = (seg[3] << 8) | seg[4];
+            if (seg[7] == 0x21) {
+                info->type = 0;
+            } else if (seg[7] == 0x22) {
+                info->type = 1;
+            } else {
+                return ESP_PEER_ERR_NOT_SUPPORT;
+            }
+            has_sof = true;
+        } else if (marker >= 0xC1 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            // Progressive, lossless or arithmetic coding
+            return ESP_PEER_ERR_NOT_SUPPORT;
+        } else if (marker == 0xDD && seg_len >= 2) {
+            info->dri = (seg[0] << 8) | seg[1];
+        } else if (marker == 0xDA) {
+            info->scan = data + pos + 2 + len;
+            info->scan_size = size - (pos + 2 + len);
+            if (info->scan_size >= 2 && data[size - 2] == 0xFF && data[size - 1] == 0xD9) {
+                info->scan_size -= 2;
+            }
+            break;
+        }
+        pos += 2 + len;
+    }
+    if (has_sof == false || info->scan == NULL || info->scan_size <= 0 || info->qt[0] == NULL || info->qt[1] == NULL) {
+        return ESP_PEER_ERR_NOT_SUPPORT;
+    }
+    if (info->width == 0 || info->height == 0 || info->width > JPEG_MAX_DIMENSION || info->height > JPEG_MAX_DIMENSION) {
+        return ESP_PEER_ERR_NOT_SUPPORT;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int packetize_jpeg(rtp_packetizer_t *pack, const uint8_t *data, int size, esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    rtp_jpeg_info_t info = {};
+    int ret = parse_jpeg(data, size, &info);
+    if (ret != ESP_PEER_ERR_NONE) {
+        return ret;
+    }
+    uint8_t *main_hdr = pack->hdr + ESP_PEER_RTP_HEADER_SIZE;
+    int hdr_size = JPEG_MAIN_HDR_SIZE;
+    main_hdr[0] = 0;
+    main_hdr[4] = info.type | (info.dri ? 64 : 0);
+    // Quantization tables always sent in band
+    main_hdr[5] = 255;
+    main_hdr[6] = (info.width + 7) / 8;
+    main_hdr[7] = (info.height + 7) / 8;
+    if (info.dri) {
+        uint8_t *restart_hdr = main_hdr + hdr_size;
+        put_be16(restart_hdr, info.dri);
+        // F=1, L=1, restart count 0x3FFF
+        put_be16(restart_hdr + 2, 0xFFFF);
+        hdr_size += JPEG_RESTART_HDR_SIZE;
+    }
+    int offset = 0;
+    while (offset < info.scan_size) {
+        esp_peer_rtp_iovec_t iov[4];
+        int iov_num = 0;
+        int max_chunk = pack->cfg.mtu - ESP_PEER_RTP_HEADER_SIZE - hdr_size;
+        main_hdr[1] = (offset >> 16) & 0xFF;
+        main_hdr[2] = (offset >> 8) & 0xFF;
+        main_hdr[3] = offset & 0xFF;
+        if (offset == 0) {
+            uint8_t *qt_hdr = main_hdr + hdr_size;
+            qt_hdr[0] = 0;
+            qt_hdr[1] = 0;
+            put_be16(qt_hdr + 2, JPEG_QT_SIZE * 2);
+            iov[iov_num].data = pack->hdr;
+            iov[iov_num++].size = ESP_PEER_RTP_HEADER_SIZE + hdr_size + JPEG_QT_HDR_SIZE;
+            iov[iov_num].data = info.qt[0];
+            iov[iov_num++].size = JPEG_QT_SIZE;
+            iov[iov_num].data = info.qt[1];
+            iov[iov_num++].size = JPEG_QT_SIZE;
+            max_chunk -= JPEG_QT_HDR_SIZE + JPEG_QT_SIZE * 2;
+        } else {
+            iov[iov_num].data = pack->hdr;
+            iov[iov_num++].size = ESP_PEER_RTP_HEADER_SIZE + hdr_size;
+        }
+        if (max_chunk <= 0) {
+            return ESP_PEER_ERR_INVALID_ARG;
+        }
+        int chunk = info.scan_size - offset;
+        if (chunk > max_chunk) {
+            chunk = max_chunk;
+        }
+        iov[iov_num].data = info.scan + offset;
+        iov[iov_num++].size = chunk;
+        offset += chunk;
+        ret = send_packet(pack, offset == info.scan_size, iov, iov_num, cb, ctx);
+        if (ret != ESP_PEER_ERR_NONE) {
+            return ret;
+        }
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_rtp_packetizer_open(esp_peer_rtp_packetizer_cfg_t *cfg, esp_peer_rtp_packetizer_handle_t *handle)
+{
+    if (cfg == NULL || handle == NULL || get_clock_rate(cfg->codec) == 0) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    rtp_packetizer_t *pack = (rtp_packetizer_t *)calloc(1, sizeof(rtp_packetizer_t));
+    if (pack == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    pack->cfg = *cfg;
+    if (pack->cfg.mtu == 0) {
+        pack->cfg.mtu = ESP_PEER_RTP_DEFAULT_MTU;
+    }
+    pack->clock_rate = get_clock_rate(cfg->codec);
+    pack->seq = cfg->start_seq;
+    *handle = pack;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_peer_rtp_packetize(esp_peer_rtp_packetizer_handle_t handle, const uint8_t *data, int size, uint32_t pts,
+                           esp_peer_rtp_packet_cb_t cb, void *ctx)
+{
+    if (handle == NULL || data == NULL || size <= 0 || cb == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    rtp_packetizer_t *pack = (rtp_packetizer_t *)handle;
+    pack->timestamp = (uint32_t)((uint64_t)pts * pack->clock_rate / 1000);
+    switch (pack->cfg.codec) {
+        case ESP_PEER_RTP_CODEC_H264:
+            return packetize_h264(pack, data, size, cb, ctx);
+        case ESP_PEER_RTP_CODEC_MJPEG:
+            return packetize_jpeg(pack, data, size, cb, ctx);
+        default: {
+            // One audio frame per packet
+            if (size > pack->cfg.mtu - ESP_PEER_RTP_HEADER_SIZE) {
+                return ESP_PEER_ERR_INVALID_ARG;
+            }
+            esp_peer_rtp_iovec_t iov[2] = {
+                { pack->hdr, ESP_PEER_RTP_HEADER_SIZE },
+                { data, size },
+            };
+            return send_packet(pack, false, iov, 2, cb, ctx);
+        }
+    }
+}
+
+int esp_peer_rtp_packetizer_close(esp_peer_rtp_packetizer_handle_t handle)
+{
+    if (handle == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    free(handle);
+    return ESP_PEER_ERR_NONE;
+}
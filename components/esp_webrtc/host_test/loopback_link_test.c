@@ -0,0 +1,184 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "esp_peer.h"
+#include "esp_peer_loopback.h"
+#include "esp_timer.h"
+#include "media_lib_adapter.h"
+
+#define GET_IMPL_THREADS (8)
+#define DATA_MSG_SIZE    (512)
+#define DATA_MSG_NUM     (64)
+#define LINK_QUEUE_LIMIT (4 * 1024)
+#define LINK_BANDWIDTH   (2000)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef struct {
+    esp_peer_handle_t peer;
+    bool              connected;
+    int               recv_num;
+    int               next_seq;
+} link_peer_t;
+
+static volatile bool get_impl_go;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void *get_impl_thread(void *arg)
+{
+    while (get_impl_go == false) {
+        sched_yield();
+    }
+    *(const esp_peer_ops_t **)arg = esp_peer_get_loopback_impl();
+    return NULL;
+}
+
+static void test_concurrent_get_impl(void)
+{
+    // Lock and ops extension must be set up once, a second lock would be reported as leak by sanitizer
+    pthread_t threads[GET_IMPL_THREADS];
+    const esp_peer_ops_t *impl[GET_IMPL_THREADS] = {};
+    for (int i = 0; i < GET_IMPL_THREADS; i++) {
+        pthread_create(&threads[i], NULL, get_impl_thread, &impl[i]);
+    }
+    get_impl_go = true;
+    for (int i = 0; i < GET_IMPL_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        CHECK(impl[i] && impl[i] == impl[0], "thread %d got loopback impl %p", i, impl[i]);
+    }
+}
+
+static int on_state(esp_peer_state_t state, void *ctx)
+{
+    if (state == ESP_PEER_STATE_CONNECTED) {
+        ((link_peer_t *)ctx)->connected = true;
+    }
+    return 0;
+}
+
+static int on_data(esp_peer_data_frame_t *frame, void *ctx)
+{
+    link_peer_t *link = (link_peer_t *)ctx;
+    CHECK(frame->size == DATA_MSG_SIZE, "unexpected message size %d", frame->size);
+    // Reliable channel must keep order and have no gap
+    CHECK(frame->data[0] == (uint8_t)link->next_seq, "expect message %d got %d", link->next_seq, frame->data[0]);
+    link->next_seq++;
+    link->recv_num++;
+    return 0;
+}
+
+static void open_link_peer(link_peer_t *link)
+{
+    esp_peer_loopback_cfg_t link_cfg = {
+        .channel = 2,
+        .bandwidth = LINK_BANDWIDTH,
+        .queue_limit = LINK_QUEUE_LIMIT,
+    };
+    esp_peer_cfg_t cfg = {
+        .enable_data_channel = true,
+        .on_state = on_state,
+        .on_data = on_data,
+        .ctx = link,
+        .extra_cfg = &link_cfg,
+        .extra_size = sizeof(link_cfg),
+    };
+    memset(link, 0, sizeof(link_peer_t));
+    CHECK(esp_peer_open(&cfg, esp_peer_get_loopback_impl(), &link->peer) == ESP_PEER_ERR_NONE, "open peer");
+    CHECK(esp_peer_new_connection(link->peer) == ESP_PEER_ERR_NONE, "new connection");
+}
+
+static void test_reliable_overflow(void)
+{
+    link_peer_t sender, receiver;
+    open_link_peer(&sender);
+    open_link_peer(&receiver);
+    esp_peer_main_loop(sender.peer);
+    esp_peer_main_loop(receiver.peer);
+    CHECK(sender.connected && receiver.connected, "loopback peers not connected");
+
+    // Send far more than link can queue, every message either reaches remote or fails on sender
+    uint8_t msg[DATA_MSG_SIZE] = {};
+    int queued = 0, rejected = 0;
+    for (int i = 0; i < DATA_MSG_NUM; i++) {
+        msg[0] = (uint8_t)queued;
+        esp_peer_data_frame_t frame = {
+            .type = ESP_PEER_DATA_CHANNEL_DATA,
+            .data = msg,
+            .size = sizeof(msg),
+        };
+        int ret = esp_peer_send_data(sender.peer, &frame);
+        if (ret == ESP_PEER_ERR_NONE) {
+            queued++;
+        } else {
+            CHECK(ret == ESP_PEER_ERR_OVER_LIMITED, "send data return %d", ret);
+            rejected++;
+        }
+    }
+    CHECK(rejected > 0, "link queue limit never reached");
+    int64_t start = esp_timer_get_time();
+    while (receiver.recv_num < queued) {
+        CHECK(esp_timer_get_time() - start < 1000000, "only %d of %d queued messages received", receiver.recv_num, queued);
+        esp_peer_main_loop(receiver.peer);
+        usleep(1000);
+    }
+    // Usable again once drained
+    esp_peer_data_frame_t frame = {
+        .type = ESP_PEER_DATA_CHANNEL_DATA,
+        .data = msg,
+        .size = sizeof(msg),
+    };
+    msg[0] = (uint8_t)queued;
+    CHECK(esp_peer_send_data(sender.peer, &frame) == ESP_PEER_ERR_NONE, "send after drained");
+    printf("Reliable data queued:%d rejected:%d received:%d\n", queued, rejected, receiver.recv_num);
+    esp_peer_close(sender.peer);
+    esp_peer_close(receiver.peer);
+}
+
+int main(int argc, char *argv[])
+{
+    media_lib_add_default_os_adapter();
+    test_concurrent_get_impl();
+    test_reliable_overflow();
+    printf("Loopback link test passed\n");
+    return 0;
+}
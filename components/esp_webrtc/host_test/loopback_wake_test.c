@@ -0,0 +1,193 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "esp_peer.h"
+#include "esp_peer_loopback.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+#include "media_lib_adapter.h"
+
+#define DEFAULT_FRAME_NUM   (200)
+// Interval of polling main loop before loopback reported wake semaphore
+#define POLL_INTERVAL       (5)
+#define MAX_WAIT_INTERVAL   (100)
+#define MAX_AVG_LATENCY_US  (POLL_INTERVAL * 1000 / 2)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef struct {
+    esp_peer_handle_t peer;
+    bool              use_wake;
+    volatile bool     running;
+    volatile bool     connected;
+    volatile int      recv_num;
+    int64_t           latency_sum;
+    int64_t           latency_max;
+    pthread_t         thread;
+} loop_ctx_t;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int on_state(esp_peer_state_t state, void *ctx)
+{
+    if (state == ESP_PEER_STATE_CONNECTED) {
+        ((loop_ctx_t *)ctx)->connected = true;
+    }
+    return 0;
+}
+
+static int on_video_data(esp_peer_video_frame_t *frame, void *ctx)
+{
+    loop_ctx_t *loop = (loop_ctx_t *)ctx;
+    int64_t send_us;
+    CHECK(frame->size == sizeof(send_us), "unexpected frame size %d", frame->size);
+    memcpy(&send_us, frame->data, sizeof(send_us));
+    int64_t latency = esp_timer_get_time() - send_us;
+    loop->latency_sum += latency;
+    if (latency > loop->latency_max) {
+        loop->latency_max = latency;
+    }
+    loop->recv_num++;
+    return 0;
+}
+
+static void *peer_loop(void *arg)
+{
+    // Same wait as pc_task of esp_webrtc
+    loop_ctx_t *loop = (loop_ctx_t *)arg;
+    while (loop->running) {
+        esp_peer_main_loop(loop->peer);
+        if (loop->use_wake == false) {
+            media_lib_thread_sleep(POLL_INTERVAL);
+            continue;
+        }
+        esp_peer_wait_info_t info = {};
+        CHECK(esp_peer_get_wait_info(loop->peer, &info) == ESP_PEER_ERR_NONE, "get wait info");
+        CHECK(info.wake_sema && info.fd_num == 0, "loopback should report wake semaphore only");
+        if (info.timeout_ms) {
+            uint32_t timeout = info.timeout_ms < MAX_WAIT_INTERVAL ? info.timeout_ms : MAX_WAIT_INTERVAL;
+            media_lib_sema_lock((media_lib_sema_handle_t)info.wake_sema, timeout);
+        }
+    }
+    return NULL;
+}
+
+static void open_peer(loop_ctx_t *loop, esp_peer_media_dir_t dir, bool use_wake)
+{
+    esp_peer_loopback_cfg_t link_cfg = {
+        .channel = 1,
+    };
+    esp_peer_cfg_t cfg = {
+        .video_info = {
+            .codec = ESP_PEER_VIDEO_CODEC_MJPEG,
+            .width = 320,
+            .height = 240,
+            .fps = 30,
+        },
+        .video_dir = dir,
+        .on_state = on_state,
+        .on_video_data = on_video_data,
+        .ctx = loop,
+        .extra_cfg = &link_cfg,
+        .extra_size = sizeof(link_cfg),
+    };
+    memset(loop, 0, sizeof(loop_ctx_t));
+    loop->use_wake = use_wake;
+    loop->running = true;
+    CHECK(esp_peer_open(&cfg, esp_peer_get_loopback_impl(), &loop->peer) == ESP_PEER_ERR_NONE, "open peer");
+    CHECK(esp_peer_new_connection(loop->peer) == ESP_PEER_ERR_NONE, "new connection");
+    pthread_create(&loop->thread, NULL, peer_loop, loop);
+}
+
+static void close_peer(loop_ctx_t *loop)
+{
+    loop->running = false;
+    pthread_join(loop->thread, NULL);
+    esp_peer_close(loop->peer);
+}
+
+static int64_t measure_latency(bool use_wake, int frame_num, int64_t *max_us)
+{
+    loop_ctx_t sender, receiver;
+    open_peer(&sender, ESP_PEER_MEDIA_DIR_SEND_ONLY, use_wake);
+    open_peer(&receiver, ESP_PEER_MEDIA_DIR_RECV_ONLY, use_wake);
+    int64_t start = esp_timer_get_time();
+    while (!(sender.connected && receiver.connected)) {
+        CHECK(esp_timer_get_time() - start < 1000000, "loopback peers not connected");
+        usleep(1000);
+    }
+    unsigned int seed = 1;
+    for (int i = 0; i < frame_num; i++) {
+        // Send at random phase of receiver wait so that polling can not line up with it
+        usleep(2000 + rand_r(&seed) % 5000);
+        int64_t now = esp_timer_get_time();
+        esp_peer_video_frame_t frame = {
+            .pts = (uint32_t)(now / 1000),
+            .data = (uint8_t *)&now,
+            .size = sizeof(now),
+        };
+        CHECK(esp_peer_send_video(sender.peer, &frame) == ESP_PEER_ERR_NONE, "send video");
+    }
+    start = esp_timer_get_time();
+    while (receiver.recv_num < frame_num) {
+        CHECK(esp_timer_get_time() - start < 1000000, "only %d of %d frames received", receiver.recv_num, frame_num);
+        usleep(1000);
+    }
+    close_peer(&sender);
+    close_peer(&receiver);
+    *max_us = receiver.latency_max;
+    return receiver.latency_sum / frame_num;
+}
+
+int main(int argc, char *argv[])
+{
+    int frame_num = argc > 1 ? atoi(argv[1]) : DEFAULT_FRAME_NUM;
+    media_lib_add_default_os_adapter();
+    int64_t poll_max, wake_max;
+    int64_t poll_avg = measure_latency(false, frame_num, &poll_max);
+    int64_t wake_avg = measure_latency(true, frame_num, &wake_max);
+    printf("Poll every %dms: avg %dus max %dus\n", POLL_INTERVAL, (int)poll_avg, (int)poll_max);
+    printf("Wake semaphore: avg %dus max %dus\n", (int)wake_avg, (int)wake_max);
+    CHECK(wake_avg < MAX_AVG_LATENCY_US, "wake up latency %dus too high", (int)wake_avg);
+    printf("Loopback wake test passed\n");
+    return 0;
+}
@@ -0,0 +1,285 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_signaling_json.h"
+#ifdef HAVE_CJSON
+#include "cJSON.h"
+#endif
+
+#define MAX_MSG_SIZE (16 * 1024)
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef enum {
+    MSG_NONE,
+    MSG_SDP,
+    MSG_CANDIDATE,
+    MSG_BYE,
+    MSG_CUSTOMIZED,
+} msg_type_t;
+
+static char sdp[4096];
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Append `src` as quoted JSON string
+static int json_escape(char *dst, const char *src)
+{
+    char *p = dst;
+    *p++ = '"';
+    for (; *src; src++) {
+        switch (*src) {
+            case '"':
+            case '\\':
+                *p++ = '\\';
+                *p++ = *src;
+                break;
+            case '\r':
+                *p++ = '\\';
+                *p++ = 'r';
+                break;
+            case '\n':
+                *p++ = '\\';
+                *p++ = 'n';
+                break;
+            default:
+                *p++ = *src;
+                break;
+        }
+    }
+    *p++ = '"';
+    *p = 0;
+    return (int)(p - dst);
+}
+
+// Wrap inner message as AppRTC does: {"msg":"<escaped inner json>","error":""}
+static int apprtc_wrap(char *dst, const char *inner)
+{
+    int size = sprintf(dst, "{\"msg\":");
+    size += json_escape(dst + size, inner);
+    size += sprintf(dst + size, ",\"error\":\"\"}");
+    return size;
+}
+
+static void build_sdp(void)
+{
+    int size = sprintf(sdp, "v=0\r\no=- 4611731400430051336 2 IN IP4 127.0.0.1\r\ns=-\r\nt=0 0\r\n"
+                            "a=group:BUNDLE 0 1\r\na=msid-semantic: WMS \"stream\"\r\n");
+    for (int i = 0; i < 2; i++) {
+        size += sprintf(sdp + size, "m=%s 9 UDP/TLS/RTP/SAVPF 111 96\r\nc=IN IP4 0.0.0.0\r\n"
+                                    "a=ice-ufrag:Ab1C\r\na=ice-pwd:qwertyuiopasdfghjklzxcvb\r\n"
+                                    "a=fingerprint:sha-256 7B:8B:F0:65:5F:78:E2:51:3B:AC:6F:F3:3F:46:1B:35:DC:B8:5F:64:"
+                                    "1A:24:C2:43:F0:A1:58:D0:A1:2C:19:08\r\n"
+                                    "a=setup:actpass\r\na=mid:%d\r\na=sendrecv\r\na=rtcp-mux\r\n",
+                        i ? "video" : "audio", i);
+        for (int j = 0; j < 8; j++) {
+            size += sprintf(sdp + size, "a=rtpmap:%d %s\r\na=rtcp-fb:%d nack\r\na=fmtp:%d "
+                                        "level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f\r\n",
+                            96 + j, i ? "H264/90000" : "opus/48000/2", 96 + j, 96 + j);
+        }
+    }
+}
+
+// Same steps as AppRTC signaling `on_text`
+static msg_type_t parse_msg(char *text, int len, esp_signaling_json_value_t *out)
+{
+    char *body = text;
+    int body_size = len;
+    esp_signaling_json_value_t msg, method;
+    if (esp_signaling_json_find(text, body_size, "msg", &msg) == ESP_PEER_ERR_NONE &&
+        msg.type == ESP_SIGNALING_JSON_STRING) {
+        if (esp_signaling_json_unescape(&msg) != ESP_PEER_ERR_NONE) {
+            return MSG_NONE;
+        }
+        body = msg.data;
+        body_size = msg.size;
+    }
+    if (esp_signaling_json_find(body, body_size, "type", &method) != ESP_PEER_ERR_NONE) {
+        return MSG_NONE;
+    }
+    const char *key = NULL;
+    msg_type_t type = MSG_NONE;
+    if (esp_signaling_json_equal(&method, "offer") || esp_signaling_json_equal(&method, "answer")) {
+        key = "sdp";
+        type = MSG_SDP;
+    } else if (esp_signaling_json_equal(&method, "candidate")) {
+        key = "candidate";
+        type = MSG_CANDIDATE;
+    } else if (esp_signaling_json_equal(&method, "customized")) {
+        key = "data";
+        type = MSG_CUSTOMIZED;
+    } else if (esp_signaling_json_equal(&method, "bye")) {
+        return MSG_BYE;
+    }
+    if (key == NULL || esp_signaling_json_get_string(body, body_size, key, out) != ESP_PEER_ERR_NONE) {
+        return MSG_NONE;
+    }
+    return type;
+}
+
+static void check_msg(const char *text, msg_type_t expect_type, const char *expect)
+{
+    // Input is modified in place, parse a copy without NUL terminator
+    static char buf[MAX_MSG_SIZE];
+    int len = (int)strlen(text);
+    memcpy(buf, text, len);
+    memset(buf + len, 'x', 16);
+    esp_signaling_json_value_t value = {};
+    msg_type_t type = parse_msg(buf, len, &value);
+    CHECK(type == expect_type, "type %d expected %d for %.60s", type, expect_type, text);
+    if (expect) {
+        CHECK(value.size == (int)strlen(expect) && memcmp(value.data, expect, value.size) == 0 &&
+              value.data[value.size] == 0, "value mismatch for %.60s", text);
+    }
+}
+
+static void test_messages(void)
+{
+    static char inner[MAX_MSG_SIZE];
+    static char msg[MAX_MSG_SIZE];
+    static char escaped[MAX_MSG_SIZE / 2];
+    json_escape(escaped, sdp);
+    // Offer and answer wrapped in AppRTC message and sent directly
+    sprintf(inner, "{\"type\":\"offer\",\"sdp\":%s}", escaped);
+    apprtc_wrap(msg, inner);
+    check_msg(msg, MSG_SDP, sdp);
+    sprintf(inner, "{ \"sdp\" : %s , \"type\" : \"answer\" }", escaped);
+    check_msg(inner, MSG_SDP, sdp);
+
+    const char *cand = "candidate:1 1 UDP 2122252543 192.168.1.5 54321 typ host generation 0";
+    json_escape(escaped, cand);
+    sprintf(inner, "{\"type\":\"candidate\",\"label\":0,\"id\":\"0\",\"candidate\":%s}", escaped);
+    apprtc_wrap(msg, inner);
+    check_msg(msg, MSG_CANDIDATE, cand);
+
+    apprtc_wrap(msg, "{\"type\":\"bye\"}");
+    check_msg(msg, MSG_BYE, NULL);
+
+    // Unicode escapes including surrogate pair, nested members with same key are not matched
+    check_msg("{\"extra\":{\"data\":\"nested\",\"list\":[1,{\"type\":\"bye\"}]},\"type\":\"customized\","
+              "\"data\":\"caf\\u00e9 \\ud83d\\ude00 \\\"q\\\" \\/\"}",
+              MSG_CUSTOMIZED, "caf\xc3\xa9 \xf0\x9f\x98\x80 \"q\" /");
+
+    // Malformed or incomplete input
+    check_msg("{\"type\":\"offer\",\"sdp\":\"v=0", MSG_NONE, NULL);
+    check_msg("{\"type\":\"offer\"}", MSG_NONE, NULL);
+    check_msg("{\"type\":\"customized\",\"data\":\"bad \\u12\"}", MSG_NONE, NULL);
+    check_msg("{\"msg\":\"{\\\"type\\\":\\\"bye\\\"}\"", MSG_BYE, NULL);
+    check_msg("[\"type\",\"bye\"]", MSG_NONE, NULL);
+
+    esp_signaling_json_value_t value;
+    const char *arr = "[\"a\", {\"b\":[1,2]}, 3]";
+    CHECK(esp_signaling_json_get_item(arr, strlen(arr), 1, &value) == ESP_PEER_ERR_NONE &&
+          value.type == ESP_SIGNALING_JSON_OBJECT && value.size == 11, "array object item");
+    CHECK(esp_signaling_json_get_item(arr, strlen(arr), 2, &value) == ESP_PEER_ERR_NONE &&
+          value.type == ESP_SIGNALING_JSON_NUMBER, "array number item");
+    CHECK(esp_signaling_json_get_item(arr, strlen(arr), 3, &value) == ESP_PEER_ERR_NOT_EXISTS, "array out of range");
+}
+
+#ifdef HAVE_CJSON
+// Previous AppRTC path: parse outer message, then parse inner message string again
+static msg_type_t parse_msg_cjson(const char *text)
+{
+    msg_type_t type = MSG_NONE;
+    cJSON *root = cJSON_Parse(text);
+    if (root == NULL) {
+        return MSG_NONE;
+    }
+    cJSON *msg = cJSON_GetObjectItem(root, "msg");
+    cJSON *inner = cJSON_IsString(msg) ? cJSON_Parse(msg->valuestring) : NULL;
+    cJSON *body = inner ? inner : root;
+    cJSON *method = cJSON_GetObjectItem(body, "type");
+    if (cJSON_IsString(method) && strcmp(method->valuestring, "offer") == 0 &&
+        cJSON_IsString(cJSON_GetObjectItem(body, "sdp"))) {
+        type = MSG_SDP;
+    } else if (cJSON_IsString(method) && strcmp(method->valuestring, "candidate") == 0 &&
+               cJSON_IsString(cJSON_GetObjectItem(body, "candidate"))) {
+        type = MSG_CANDIDATE;
+    }
+    cJSON_Delete(inner);
+    cJSON_Delete(root);
+    return type;
+}
+#endif
+
+static void bench(int loops)
+{
+    static char inner[MAX_MSG_SIZE];
+    static char escaped[MAX_MSG_SIZE / 2];
+    static char msgs[2][MAX_MSG_SIZE];
+    static char buf[MAX_MSG_SIZE];
+    json_escape(escaped, sdp);
+    sprintf(inner, "{\"type\":\"offer\",\"sdp\":%s}", escaped);
+    int sizes[2];
+    sizes[0] = apprtc_wrap(msgs[0], inner);
+    sizes[1] = apprtc_wrap(msgs[1], "{\"type\":\"candidate\",\"label\":0,\"id\":\"0\",\"candidate\":"
+                                    "\"candidate:1 1 UDP 2122252543 192.168.1.5 54321 typ host generation 0\"}");
+    for (int m = 0; m < 2; m++) {
+        msg_type_t expect = m ? MSG_CANDIDATE : MSG_SDP;
+        double start = now_sec();
+        for (int i = 0; i < loops; i++) {
+            // Copy is part of real cost since websocket buffer is read only
+            memcpy(buf, msgs[m], sizes[m]);
+            esp_signaling_json_value_t value;
+            CHECK(parse_msg(buf, sizes[m], &value) == expect, "tokenizer parse");
+        }
+        double cost = (now_sec() - start) / loops;
+        printf("%-9s %5d bytes: tokenizer %.2f us", m ? "Candidate" : "Offer", sizes[m], cost * 1e6);
+#ifdef HAVE_CJSON
+        start = now_sec();
+        for (int i = 0; i < loops; i++) {
+            CHECK(parse_msg_cjson(msgs[m]) == expect, "cJSON parse");
+        }
+        double cjson_cost = (now_sec() - start) / loops;
+        printf(" cJSON %.2f us (%.1fx)", cjson_cost * 1e6, cjson_cost / cost);
+#endif
+        printf("\n");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int loops = argc > 1 ? atoi(argv[1]) : 20000;
+    build_sdp();
+    test_messages();
+    bench(loops);
+    printf("Signaling json test passed\n");
+    return 0;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+/* Host stand-in of lwIP socket API, POSIX provides same definitions */
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
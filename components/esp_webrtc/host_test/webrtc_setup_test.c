@@ -0,0 +1,406 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "esp_webrtc.h"
+#include "esp_peer_loopback.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+#include "media_lib_adapter.h"
+
+#define FRAME_INTERVAL     (33)
+// Low bitrate camera, encoder emits key frame every 2 seconds only
+#define GOP_FRAMES         (60)
+// Time from encoder start to first encoded frame
+#define ENCODER_START_MS   (150)
+// Forced key frame restarts encoder and leaves gap in stream
+#define ENCODER_RESTART_MS (100)
+// Doorbell server answers the offer, ICE check succeeds some time after answer
+#define ANSWER_DELAY_MS    (50)
+#define ICE_DELAY_MS       (300)
+#define RECV_FRAMES        (30)
+#define MAX_WAIT_INTERVAL  (100)
+
+#define CAND_HOST  "candidate:1 1 udp 2122260223 192.168.1.20 50000 typ host"
+#define CAND_SRFLX "candidate:2 1 udp 1686052607 203.0.113.7 50000 typ srflx raddr 192.168.1.20 rport 50000"
+#define CAND_RELAY "candidate:3 1 udp 41885439 198.51.100.3 3478 typ relay raddr 203.0.113.7 rport 50000"
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+typedef struct {
+    uint32_t seq;
+    int64_t  capture_us;
+} frame_tag_t;
+
+// H264 start code and NAL header followed by tag
+#define FRAME_HEADER_SIZE (5)
+#define FRAME_SIZE        (FRAME_HEADER_SIZE + sizeof(frame_tag_t))
+
+// Simulated capture with one H264 encoder, frames are produced on their due time
+typedef struct {
+    pthread_mutex_t lock;
+    bool            started;
+    int64_t         base_us;
+    int64_t         next_us;
+    uint32_t        frame_num;
+    bool            key_pending;
+    int             key_requests;
+    uint8_t         data[FRAME_SIZE];
+} sim_capture_t;
+
+// Browser side of the call, receives on a linked loopback peer
+typedef struct {
+    esp_peer_handle_t pc;
+    pthread_t         thread;
+    volatile bool     running;
+    pthread_mutex_t   lock;
+    int               frames;
+    bool              first_key;
+    uint32_t          first_seq;
+    uint32_t          last_seq;
+    int64_t           first_us;
+    int               gaps;
+} sim_browser_t;
+
+// Stand-in of doorbell signaling server, pushes candidates of answer before the answer itself
+typedef struct {
+    esp_peer_signaling_cfg_t cfg;
+    pthread_t                thread;
+    int64_t                  answer_us;
+} sim_server_t;
+
+static sim_capture_t capture;
+static sim_browser_t browser;
+static sim_server_t  server;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int esp_capture_setup_path(esp_capture_handle_t h, esp_capture_path_type_t path, esp_capture_sink_cfg_t *sink_info,
+                           esp_capture_path_handle_t *path_handle)
+{
+    if (path != ESP_CAPTURE_PATH_PRIMARY) {
+        return ESP_CAPTURE_ERR_NOT_SUPPORTED;
+    }
+    *path_handle = (esp_capture_path_handle_t)&capture;
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int esp_capture_enable_path(esp_capture_path_handle_t h, esp_capture_run_type_t run_type)
+{
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int esp_capture_start(esp_capture_handle_t h)
+{
+    pthread_mutex_lock(&capture.lock);
+    capture.started = true;
+    capture.base_us = esp_timer_get_time();
+    capture.next_us = capture.base_us + ENCODER_START_MS * 1000;
+    capture.frame_num = 0;
+    capture.key_pending = false;
+    pthread_mutex_unlock(&capture.lock);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int esp_capture_stop(esp_capture_handle_t h)
+{
+    pthread_mutex_lock(&capture.lock);
+    capture.started = false;
+    pthread_mutex_unlock(&capture.lock);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int esp_capture_request_key_frame(esp_capture_path_handle_t h)
+{
+    pthread_mutex_lock(&capture.lock);
+    capture.key_requests++;
+    capture.key_pending = true;
+    int64_t restart_us = esp_timer_get_time() + ENCODER_RESTART_MS * 1000;
+    if (capture.next_us < restart_us) {
+        capture.next_us = restart_us;
+    }
+    pthread_mutex_unlock(&capture.lock);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int esp_capture_acquire_path_frame(esp_capture_path_handle_t h, esp_capture_stream_frame_t *frame, bool no_wait)
+{
+    if (frame->stream_type != ESP_CAPTURE_STREAM_TYPE_VIDEO) {
+        return ESP_CAPTURE_ERR_NOT_FOUND;
+    }
+    pthread_mutex_lock(&capture.lock);
+    if (capture.started == false || esp_timer_get_time() < capture.next_us) {
+        pthread_mutex_unlock(&capture.lock);
+        return ESP_CAPTURE_ERR_NOT_FOUND;
+    }
+    bool key = capture.key_pending || capture.frame_num % GOP_FRAMES == 0;
+    capture.key_pending = false;
+    frame_tag_t tag = {
+        .seq = capture.frame_num++,
+        .capture_us = capture.next_us,
+    };
+    uint8_t header[FRAME_HEADER_SIZE] = {0, 0, 0, 1, key ? 0x65 : 0x41};
+    memcpy(capture.data, header, FRAME_HEADER_SIZE);
+    memcpy(capture.data + FRAME_HEADER_SIZE, &tag, sizeof(tag));
+    frame->pts = (uint32_t)((capture.next_us - capture.base_us) / 1000);
+    frame->data = capture.data;
+    frame->size = FRAME_SIZE;
+    capture.next_us += FRAME_INTERVAL * 1000;
+    pthread_mutex_unlock(&capture.lock);
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int esp_capture_release_path_frame(esp_capture_path_handle_t h, esp_capture_stream_frame_t *frame)
+{
+    return ESP_CAPTURE_ERR_OK;
+}
+
+int av_render_add_audio_stream(av_render_handle_t render, av_render_audio_info_t *audio_info)
+{
+    return 0;
+}
+
+int av_render_add_video_stream(av_render_handle_t render, av_render_video_info_t *video_info)
+{
+    return 0;
+}
+
+int av_render_add_audio_data(av_render_handle_t render, av_render_audio_data_t *audio_data)
+{
+    return 0;
+}
+
+int av_render_add_video_data(av_render_handle_t render, av_render_video_data_t *video_data)
+{
+    return 0;
+}
+
+int av_render_reset(av_render_handle_t render)
+{
+    return 0;
+}
+
+static int on_browser_video(esp_peer_video_frame_t *frame, void *ctx)
+{
+    CHECK(frame->size == FRAME_SIZE, "unexpected frame size %d", frame->size);
+    frame_tag_t tag;
+    memcpy(&tag, frame->data + FRAME_HEADER_SIZE, sizeof(tag));
+    pthread_mutex_lock(&browser.lock);
+    if (browser.frames == 0) {
+        browser.first_us = esp_timer_get_time();
+        browser.first_key = (frame->data[4] & 0x1F) == 5;
+        browser.first_seq = tag.seq;
+    } else if (tag.seq != browser.last_seq + 1) {
+        browser.gaps++;
+    }
+    browser.last_seq = tag.seq;
+    browser.frames++;
+    pthread_mutex_unlock(&browser.lock);
+    return 0;
+}
+
+static void *browser_loop(void *arg)
+{
+    while (browser.running) {
+        esp_peer_main_loop(browser.pc);
+        esp_peer_wait_info_t info = {};
+        CHECK(esp_peer_get_wait_info(browser.pc, &info) == ESP_PEER_ERR_NONE, "get wait info");
+        if (info.timeout_ms) {
+            uint32_t timeout = info.timeout_ms < MAX_WAIT_INTERVAL ? info.timeout_ms : MAX_WAIT_INTERVAL;
+            media_lib_sema_lock((media_lib_sema_handle_t)info.wake_sema, timeout);
+        }
+    }
+    return NULL;
+}
+
+static void server_push(esp_peer_signaling_msg_type_t type, const char *content)
+{
+    // Receiver may terminate candidate lines in place
+    char msg_data[512];
+    snprintf(msg_data, sizeof(msg_data), "%s", content);
+    esp_peer_signaling_msg_t msg = {
+        .type = type,
+        .data = (uint8_t *)msg_data,
+        .size = (int)strlen(msg_data),
+    };
+    server.cfg.on_msg(&msg, server.cfg.ctx);
+}
+
+static void *server_thread(void *arg)
+{
+    usleep(ANSWER_DELAY_MS * 1000);
+    // Candidates extracted from answer are notified before answer is forwarded
+    server_push(ESP_PEER_SIGNALING_MSG_CANDIDATE, CAND_HOST "\n" CAND_SRFLX);
+    server.answer_us = esp_timer_get_time();
+    server_push(ESP_PEER_SIGNALING_MSG_SDP, "v=0\r\n"
+                                            "m=video 9 UDP/TLS/RTP/SAVPF 96\r\n"
+                                            "a=" CAND_HOST "\r\n"
+                                            "a=" CAND_SRFLX "\r\n");
+    // Browser trickles the same candidates again and a late relay one
+    server_push(ESP_PEER_SIGNALING_MSG_CANDIDATE, CAND_HOST);
+    server_push(ESP_PEER_SIGNALING_MSG_CANDIDATE, CAND_SRFLX);
+    server_push(ESP_PEER_SIGNALING_MSG_CANDIDATE, CAND_RELAY);
+    usleep(ICE_DELAY_MS * 1000);
+    esp_peer_new_connection(browser.pc);
+    return NULL;
+}
+
+static int server_start(esp_peer_signaling_cfg_t *cfg, esp_peer_signaling_handle_t *handle)
+{
+    server.cfg = *cfg;
+    server.answer_us = 0;
+    *handle = &server;
+    esp_peer_signaling_ice_info_t ice_info = {
+        .is_initiator = true,
+    };
+    cfg->on_ice_info(&ice_info, cfg->ctx);
+    cfg->on_connected(cfg->ctx);
+    pthread_create(&server.thread, NULL, server_thread, NULL);
+    return ESP_PEER_ERR_NONE;
+}
+
+static int server_send_msg(esp_peer_signaling_handle_t handle, esp_peer_signaling_msg_t *msg)
+{
+    return ESP_PEER_ERR_NONE;
+}
+
+static int server_stop(esp_peer_signaling_handle_t handle)
+{
+    pthread_join(server.thread, NULL);
+    return ESP_PEER_ERR_NONE;
+}
+
+static const esp_peer_signaling_impl_t server_impl = {
+    .start = server_start,
+    .send_msg = server_send_msg,
+    .stop = server_stop,
+};
+
+static int run_call(bool early_media)
+{
+    esp_peer_loopback_cfg_t link_cfg = {};
+    memset(&browser, 0, sizeof(browser));
+    pthread_mutex_init(&browser.lock, NULL);
+    esp_peer_cfg_t browser_cfg = {
+        .video_info = {
+            .codec = ESP_PEER_VIDEO_CODEC_H264,
+            .width = 320,
+            .height = 240,
+            .fps = 1000 / FRAME_INTERVAL,
+        },
+        .video_dir = ESP_PEER_MEDIA_DIR_RECV_ONLY,
+        .on_video_data = on_browser_video,
+        .extra_cfg = &link_cfg,
+        .extra_size = sizeof(link_cfg),
+    };
+    CHECK(esp_peer_open(&browser_cfg, esp_peer_get_loopback_impl(), &browser.pc) == ESP_PEER_ERR_NONE, "open browser");
+    browser.running = true;
+    pthread_create(&browser.thread, NULL, browser_loop, NULL);
+    capture.key_requests = 0;
+
+    esp_webrtc_cfg_t cfg = {
+        .signaling_impl = &server_impl,
+        .peer_impl = esp_peer_get_loopback_impl(),
+        .peer_cfg = {
+            .video_info = browser_cfg.video_info,
+            .video_dir = ESP_PEER_MEDIA_DIR_SEND_ONLY,
+            .no_auto_reconnect = true,
+            .early_media = early_media,
+            .extra_cfg = &link_cfg,
+            .extra_size = sizeof(link_cfg),
+        },
+    };
+    esp_webrtc_handle_t rtc = NULL;
+    CHECK(esp_webrtc_open(&cfg, &rtc) == ESP_PEER_ERR_NONE, "open webrtc");
+    esp_webrtc_media_provider_t provider = {
+        .capture = (esp_capture_handle_t)&capture,
+    };
+    CHECK(esp_webrtc_set_media_provider(rtc, &provider) == ESP_PEER_ERR_NONE, "set media provider");
+    CHECK(esp_webrtc_start(rtc) == ESP_PEER_ERR_NONE, "start webrtc");
+
+    int64_t start = esp_timer_get_time();
+    for (;;) {
+        pthread_mutex_lock(&browser.lock);
+        bool done = browser.frames >= RECV_FRAMES;
+        pthread_mutex_unlock(&browser.lock);
+        if (done) {
+            break;
+        }
+        CHECK(esp_timer_get_time() - start < 3000000, "only %d frames received", browser.frames);
+        usleep(1000);
+    }
+    esp_webrtc_setup_stat_t stat = {};
+    CHECK(esp_webrtc_get_setup_stat(rtc, &stat) == ESP_PEER_ERR_NONE, "get setup stat");
+    // Stop while setup statistics finished, also covers cancel of unfinished setup
+    CHECK(esp_webrtc_close(rtc) == ESP_PEER_ERR_NONE, "close webrtc");
+    browser.running = false;
+    pthread_join(browser.thread, NULL);
+    esp_peer_close(browser.pc);
+    pthread_mutex_destroy(&browser.lock);
+
+    int first_frame_ms = (int)((browser.first_us - server.answer_us) / 1000);
+    printf("%s: first frame %dms after answer, connected %dms, key frame requests %d, duplicated candidates %d\n",
+           early_media ? "Early media" : "Start on connected", first_frame_ms, (int)stat.connect_ms,
+           capture.key_requests, (int)stat.dup_candidates);
+    CHECK(browser.first_key && browser.first_seq == 0, "stream started from frame %d", (int)browser.first_seq);
+    CHECK(browser.gaps == 0, "%d gaps in received stream", browser.gaps);
+    CHECK(capture.key_requests == 0, "encoder restarted %d times for key frame", capture.key_requests);
+    // Candidates of answer are pushed before it, trickle of them again must be dropped
+    CHECK(stat.dup_candidates == 2, "expect 2 duplicated candidates got %d", (int)stat.dup_candidates);
+    CHECK(stat.connect_ms >= ICE_DELAY_MS && stat.first_send_ms >= stat.connect_ms, "setup stat connect %d send %d",
+          (int)stat.connect_ms, (int)stat.first_send_ms);
+    return first_frame_ms;
+}
+
+int main(int argc, char *argv[])
+{
+    media_lib_add_default_os_adapter();
+    pthread_mutex_init(&capture.lock, NULL);
+    int late_ms = run_call(false);
+    CHECK(late_ms >= ICE_DELAY_MS + ENCODER_START_MS, "encoder warm-up not counted %dms", late_ms);
+    // Encoder warm-up overlaps ICE check, kept GOP is sent once connected
+    int early_ms = run_call(true);
+    CHECK(early_ms < ICE_DELAY_MS + ENCODER_START_MS / 2, "early media first frame %dms after answer", early_ms);
+    printf("Early media saves %dms to first frame\n", late_ms - early_ms);
+    pthread_mutex_destroy(&capture.lock);
+    printf("WebRTC setup test passed\n");
+    return 0;
+}
@@ -31,6 +31,7 @@
 #include "esp_log.h"
 #include "media_lib_os.h"
 #include "esp_peer_signaling.h"
+#include "esp_signaling_json.h"
 #include <esp_event.h>
 #include <esp_log.h>
 #include <esp_system.h>
@@ -65,6 +66,9 @@ typedef struct {
 typedef struct {
     esp_websocket_client_handle_t ws;
     int                           connected;
+    char                         *rx_buf;  /* Copy of received message for in place parsing, reused */
+    int                           rx_size;
+    int                           rx_cap;
 } wss_client_t;
 
 typedef struct {
@@ -209,6 +213,7 @@ static void destroy_wss(wss_client_t *wss)
         esp_websocket_client_stop(wss->ws);
         esp_websocket_client_destroy(wss->ws);
     }
+    free(wss->rx_buf);
     free(wss);
 }
 
@@ -265,98 +270,100 @@ static int on_connect(void *user)
     return 0;
 }
 
-/* The custom on_text handler for this instance of the websocket code. */
-static int on_text(void *user, const char *text, size_t len)
+static void notify_msg(wss_sig_t *sg, esp_peer_signaling_msg_type_t type, char *body, int size, const char *key)
+{
+    esp_signaling_json_value_t value;
+    if (esp_signaling_json_get_string(body, size, key, &value) != ESP_PEER_ERR_NONE) {
+        return;
+    }
+    esp_peer_signaling_msg_t msg = {
+        .type = type,
+        .data = (uint8_t *)value.data,
+        .size = value.size,
+    };
+    sg->cfg.on_msg(&msg, sg->cfg.ctx);
+}
+
+/* The custom on_text handler for this instance of the websocket code.
+ * Fields are extracted in place from receive buffer, no parse tree is built */
+static int on_text(void *user, char *text, size_t len)
 {
     if (len == 0) {
         return 0;
     }
     // printf("on_text(user, ws, '%.*s', %zd)\n", (int) len, text, len);
     wss_sig_t *sg = user;
-    if (sg->cfg.on_msg) {
-        cJSON *_json = cJSON_Parse(text);
-        cJSON *msg = NULL;
-        do {
-            if (_json == NULL) {
-                break;
-            }
-            msg = cJSON_GetObjectItem(_json, "msg");
-            // Json string in json
-            cJSON *method;
-            if (msg == NULL) {
-                method = cJSON_GetObjectItem(_json, "type");
-                if (method == NULL) {
-                    break;
-                }
-                msg = _json;
-            } else {
-                msg = cJSON_Parse(msg->valuestring);
-                method = cJSON_GetObjectItem(msg, "type");
-                if (method == NULL) {
-                    break;
-                }
-            }
-            if (strcmp(method->valuestring, "offer") == 0) {
-                cJSON *sdp = cJSON_GetObjectItem(msg, "sdp");
-                if (sdp) {
-                    esp_peer_signaling_msg_t msg = {
-                        .type = ESP_PEER_SIGNALING_MSG_SDP,
-                        .data = (uint8_t *)sdp->valuestring,
-                        .size = strlen(sdp->valuestring),
-                    };
-                    sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                }
-            } else if (strcmp(method->valuestring, "answer") == 0) {
-                cJSON *sdp = cJSON_GetObjectItem(msg, "sdp");
-                if (sdp) {
-                    esp_peer_signaling_msg_t msg = {
-                        .type = ESP_PEER_SIGNALING_MSG_SDP,
-                        .data = (uint8_t *)sdp->valuestring,
-                        .size = strlen(sdp->valuestring),
-                    };
-                    sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                }
-            } else if (strcmp(method->valuestring, "bye") == 0) {
-                // Peer closed
-                esp_peer_signaling_msg_t msg = {
-                    .type = ESP_PEER_SIGNALING_MSG_BYE,
-                };
-                sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                // When peer leave change rule to caller directly
-                ESP_LOGI(TAG, "Peer leaved become controlling now");
-                sg->ice_info.is_initiator = true;
-            } else if (strcmp(method->valuestring, "candidate") == 0) {
-                cJSON *candidate = cJSON_GetObjectItem(msg, "candidate");
-                if (candidate) {
-                    esp_peer_signaling_msg_t msg = {
-                        .type = ESP_PEER_SIGNALING_MSG_CANDIDATE,
-                        .data = (uint8_t *)candidate->valuestring,
-                        .size = strlen(candidate->valuestring),
-                    };
-                    sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                }
-            } else if (strcmp(method->valuestring, "customized") == 0) {
-                cJSON *custom_data = cJSON_GetObjectItem(msg, "data");
-                if (custom_data) {
-                    esp_peer_signaling_msg_t msg = {
-                        .type = ESP_PEER_SIGNALING_MSG_CUSTOMIZED,
-                        .data = (uint8_t *)custom_data->valuestring,
-                        .size = strlen(custom_data->valuestring),
-                    };
-                    sg->cfg.on_msg(&msg, sg->cfg.ctx);
-                }
-            }
-        } while (0);
-        if (msg == NULL) {
+    if (sg->cfg.on_msg == NULL) {
+        return 0;
+    }
+    char *body = text;
+    int body_size = (int)len;
+    esp_signaling_json_value_t msg, method;
+    if (esp_signaling_json_find(text, body_size, "msg", &msg) == ESP_PEER_ERR_NONE &&
+        msg.type == ESP_SIGNALING_JSON_STRING) {
+        // Json string in json, unescape it in place to get inner message
+        if (esp_signaling_json_unescape(&msg) != ESP_PEER_ERR_NONE) {
             ESP_LOGE(TAG, "Bad json input");
-        } else if (msg != _json) {
-            cJSON_Delete(msg);
+            return 0;
         }
-        cJSON_Delete(_json);
+        body = msg.data;
+        body_size = msg.size;
+    }
+    if (esp_signaling_json_find(body, body_size, "type", &method) != ESP_PEER_ERR_NONE) {
+        ESP_LOGE(TAG, "Bad json input");
+        return 0;
+    }
+    if (esp_signaling_json_equal(&method, "offer") || esp_signaling_json_equal(&method, "answer")) {
+        notify_msg(sg, ESP_PEER_SIGNALING_MSG_SDP, body, body_size, "sdp");
+    } else if (esp_signaling_json_equal(&method, "bye")) {
+        // Peer closed
+        esp_peer_signaling_msg_t bye_msg = {
+            .type = ESP_PEER_SIGNALING_MSG_BYE,
+        };
+        sg->cfg.on_msg(&bye_msg, sg->cfg.ctx);
+        // When peer leave change rule to caller directly
+        ESP_LOGI(TAG, "Peer leaved become controlling now");
+        sg->ice_info.is_initiator = true;
+    } else if (esp_signaling_json_equal(&method, "candidate")) {
+        notify_msg(sg, ESP_PEER_SIGNALING_MSG_CANDIDATE, body, body_size, "candidate");
+    } else if (esp_signaling_json_equal(&method, "customized")) {
+        notify_msg(sg, ESP_PEER_SIGNALING_MSG_CUSTOMIZED, body, body_size, "data");
     }
     return 0;
 }
 
+static void on_data(wss_sig_t *sg, esp_websocket_event_data_t *data)
+{
+    wss_client_t *wss = sg->wss_client;
+    if (wss == NULL) {
+        return;
+    }
+    // Websocket receive buffer is read only (`data_ptr` is const) and in place unescape writes to message,
+    // so always copy into own buffer, it also gathers message over websocket buffer size coming in fragments
+    if (data->payload_offset == 0) {
+        wss->rx_size = 0;
+        if (data->payload_len > wss->rx_cap) {
+            char *buf = realloc(wss->rx_buf, data->payload_len);
+            if (buf == NULL) {
+                ESP_LOGE(TAG, "No memory for message size %d", data->payload_len);
+                return;
+            }
+            wss->rx_buf = buf;
+            wss->rx_cap = data->payload_len;
+        }
+    }
+    if (wss->rx_buf == NULL || data->payload_offset != wss->rx_size ||
+        data->payload_offset + data->data_len > wss->rx_cap) {
+        return;
+    }
+    memcpy(wss->rx_buf + wss->rx_size, data->data_ptr, data->data_len);
+    wss->rx_size += data->data_len;
+    if (wss->rx_size >= data->payload_len) {
+        on_text(sg, wss->rx_buf, wss->rx_size);
+        wss->rx_size = 0;
+    }
+}
+
 /* The custom on_close handler for this instance of the websocket code. */
 static int on_close(void *user, int code)
 {
@@ -394,7 +401,7 @@ static void websocket_event_handler(void *ctx, esp_event_base_t base, int32_t ev
             }
             break;
         case WEBSOCKET_EVENT_DATA:
-            on_text(ctx, data->data_ptr, data->data_len);
+            on_data((wss_sig_t *)ctx, data);
             break;
         case WEBSOCKET_EVENT_ERROR:
             ESP_LOGI(TAG, "WEBSOCKET_EVENT_ERROR");
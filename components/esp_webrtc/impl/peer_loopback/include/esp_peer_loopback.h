@@ -0,0 +1,88 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_peer.h"
+#include "esp_peer_signaling.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Loopback peer configuration
+ *
+ * @note  Set as `extra_cfg` of `esp_peer_cfg_t` (`esp_webrtc_peer_cfg_t`)
+ *        Two peers opened with the same channel in one process are linked to each other without any network
+ *        Link model is applied to each audio, video frame and data channel message as one unit
+ *        When `mtu` is set, audio and video are split into RTP packets and link model is applied to each packet instead,
+ *        so loss of one packet drops the whole frame like a real network
+ */
+typedef struct {
+    uint8_t  channel;         /*!< Link channel, only two peers can be linked on one channel */
+    uint16_t delay_ms;        /*!< One way base delay (unit ms) */
+    uint16_t jitter_ms;       /*!< Extra random delay in [0, jitter_ms] (unit ms), frames can be reordered by it */
+    uint16_t loss_rate;       /*!< Audio and video loss rate (unit 1/1000), data channel is reliable and never lost */
+    uint32_t bandwidth;       /*!< Link bandwidth (unit kbps), 0 means unlimited */
+    uint32_t queue_limit;     /*!< Maximum bytes queued on the link, 0 to use 256KB
+                                   Audio and video frames overflow are dropped, data channel send fails with
+                                   `ESP_PEER_ERR_OVER_LIMITED` instead so that sender can retry */
+    uint32_t seed;            /*!< Random seed so that loss and jitter pattern are repeatable, 0 to use default */
+    uint16_t mtu;             /*!< Packetize audio and video into RTP packets of this size, 0 to send frame as one unit */
+    uint32_t pacing_rate;     /*!< Pace RTP packets by `esp_peer_pacer` at this target bitrate (unit bps), 0 to disable
+                                   Only valid when `mtu` is set */
+    uint32_t pacing_max_rate; /*!< Highest pacing rate (unit bps), 0 for no limit */
+    uint8_t  pacing_spread;   /*!< Percentage of frame interval to spread one video frame over, 0 to use pacer default */
+    bool     fec;             /*!< Protect audio by RED and video by XOR FEC, overhead follows loss reported by remote
+                                   Only valid when `mtu` is set */
+} esp_peer_loopback_cfg_t;
+
+/**
+ * @brief  Get loopback peer connection implementation
+ *
+ * @note  Use it for transport-free benchmarking and regression test of the full media pipeline
+ *        Peer statistics (sent, delivered, lost, overflow, max delay) are printed by `esp_peer_query`
+ *
+ * @return
+ *       - NULL    Not enough memory
+ *       - Others  Loopback peer connection implementation
+ */
+const esp_peer_ops_t *esp_peer_get_loopback_impl(void);
+
+/**
+ * @brief  Get loopback signaling implementation
+ *
+ * @note  It reports ICE information and connected event at once after started, SDP and candidates are ignored
+ *        Work together with loopback peer connection implementation
+ *
+ * @return
+ *       - Others  Loopback signaling implementation
+ */
+const esp_peer_signaling_impl_t *esp_signaling_get_loopback_impl(void);
+
+#ifdef __cplusplus
+}
+#endif
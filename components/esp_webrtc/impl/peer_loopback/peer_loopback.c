@@ -0,0 +1,1024 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <pthread.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+#include "esp_peer_loopback.h"
+#include "esp_peer_rtp.h"
+#include "esp_peer_pacer.h"
+#include "esp_peer_fec.h"
+
+#define TAG "PEER_LOOPBACK"
+
+#define LOOPBACK_MAX_PEER      (8)
+#define LOOPBACK_DEFAULT_QUEUE (256 * 1024)
+#define LOOPBACK_DEFAULT_SEED  (0x2545F491)
+#define LOOPBACK_IDLE_WAIT     (1000)
+#define LOOPBACK_CHANNEL_LABEL "loopback"
+#define LOOPBACK_AUDIO_PT      (111)
+#define LOOPBACK_VIDEO_PT      (96)
+#define LOOPBACK_RED_PT        (63)
+#define LOOPBACK_FEC_PT        (35)
+#define LOOPBACK_FEC_REORDER   (ESP_PEER_FEC_MAX_GROUP + 8)
+#define LOOPBACK_LOSS_REPORT   (1000)
+
+typedef enum {
+    LOOPBACK_PKT_AUDIO,
+    LOOPBACK_PKT_VIDEO,
+    LOOPBACK_PKT_DATA,
+} loopback_pkt_kind_t;
+
+typedef struct loopback_pkt_t {
+    struct loopback_pkt_t       *next;
+    loopback_pkt_kind_t          kind;
+    bool                         rtp;
+    esp_peer_data_channel_type_t data_type;
+    uint16_t                     stream_id;
+    uint32_t                     pts;
+    int64_t                      send_us;
+    int64_t                      deliver_us;
+    int                          size;
+} loopback_pkt_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t delivered;
+    uint32_t lost;
+    uint32_t overflow;
+    uint32_t max_delay_ms;
+} loopback_stat_t;
+
+typedef enum {
+    LOOPBACK_MEDIA_AUDIO,
+    LOOPBACK_MEDIA_VIDEO,
+    LOOPBACK_MEDIA_MAX,
+} loopback_media_t;
+
+typedef struct loopback_peer_t {
+    esp_peer_cfg_t           cfg;
+    esp_peer_loopback_cfg_t  link_cfg;
+    struct loopback_peer_t  *remote;
+    media_lib_sema_handle_t  wake_sema;
+    bool                     want_connect;
+    bool                     connected;
+    loopback_pkt_t          *inbound;
+    uint32_t                 inbound_bytes;
+    int64_t                  link_free_us;
+    uint32_t                 rand_state;
+    loopback_stat_t          stat;
+    /* Only used when send as RTP packets */
+    esp_peer_rtp_packetizer_handle_t   packetizer[LOOPBACK_MEDIA_MAX];
+    esp_peer_rtp_depacketizer_handle_t depacketizer[LOOPBACK_MEDIA_MAX];
+    esp_peer_pacer_handle_t            pacer;
+    int64_t                            pacer_due_us;
+    /* Only used when FEC enabled, index by loopback_media_t */
+    esp_peer_fec_handle_t              fec_enc[LOOPBACK_MEDIA_MAX];
+    esp_peer_fec_handle_t              fec_dec[LOOPBACK_MEDIA_MAX];
+    int64_t                            loss_report_us;
+    esp_peer_fec_stat_t                last_fec_stat[LOOPBACK_MEDIA_MAX];
+} loopback_peer_t;
+
+typedef struct {
+    loopback_peer_t *peer;
+    bool             is_audio;
+    int64_t          now_us;
+} loopback_packet_ctx_t;
+
+typedef struct {
+    esp_peer_signaling_cfg_t cfg;
+} loopback_signaling_t;
+
+static pthread_once_t           loopback_once = PTHREAD_ONCE_INIT;
+static media_lib_mutex_handle_t loopback_lock;
+static loopback_peer_t         *loopback_peers[LOOPBACK_MAX_PEER];
+
+static uint32_t loopback_rand(loopback_peer_t *peer)
+{
+    // xorshift32, enough for loss and jitter pattern
+    uint32_t x = peer->rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    peer->rand_state = x;
+    return x;
+}
+
+static void wake_peer_locked(loopback_peer_t *peer)
+{
+    // Main loop owner blocks on it, new packet or state change needs handling before the reported deadline
+    if (peer && peer->wake_sema) {
+        media_lib_sema_unlock(peer->wake_sema);
+    }
+}
+
+static void free_pkt_list(loopback_pkt_t *pkt)
+{
+    while (pkt) {
+        loopback_pkt_t *next = pkt->next;
+        free(pkt);
+        pkt = next;
+    }
+}
+
+static void flush_inbound_locked(loopback_peer_t *peer)
+{
+    free_pkt_list(peer->inbound);
+    peer->inbound = NULL;
+    peer->inbound_bytes = 0;
+}
+
+static int link_push_locked(loopback_peer_t *peer, loopback_pkt_t *info, esp_peer_rtp_iovec_t *iov, int iov_num)
+{
+    esp_peer_loopback_cfg_t *link_cfg = &peer->link_cfg;
+    loopback_peer_t *remote = peer->remote;
+    if (remote == NULL || remote->want_connect == false) {
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    int size = 0;
+    for (int i = 0; i < iov_num; i++) {
+        size += iov[i].size;
+    }
+    peer->stat.sent++;
+    bool reliable = (info->kind == LOOPBACK_PKT_DATA);
+    if (reliable == false && link_cfg->loss_rate && loopback_rand(peer) % 1000 < link_cfg->loss_rate) {
+        peer->stat.lost++;
+        return ESP_PEER_ERR_NONE;
+    }
+    if (remote->inbound_bytes + size > link_cfg->queue_limit) {
+        peer->stat.overflow++;
+        // Data channel is reliable, let sender know it is not queued instead of losing it silently
+        return reliable ? ESP_PEER_ERR_OVER_LIMITED : ESP_PEER_ERR_NONE;
+    }
+    loopback_pkt_t *pkt = (loopback_pkt_t *)malloc(sizeof(loopback_pkt_t) + size);
+    if (pkt == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    *pkt = *info;
+    pkt->size = size;
+    uint8_t *dst = (uint8_t *)(pkt + 1);
+    for (int i = 0; i < iov_num; i++) {
+        memcpy(dst, iov[i].data, iov[i].size);
+        dst += iov[i].size;
+    }
+    int64_t now = esp_timer_get_time();
+    int64_t leave_us = now;
+    if (link_cfg->bandwidth) {
+        // Frame leaves link after previous queued frames and its own serialization time
+        leave_us = MAX(now, remote->link_free_us) + (int64_t)size * 8000 / link_cfg->bandwidth;
+        remote->link_free_us = leave_us;
+    }
+    pkt->send_us = now;
+    pkt->deliver_us = leave_us + link_cfg->delay_ms * 1000;
+    // Keep data channel in order, only media is jittered
+    if (reliable == false && link_cfg->jitter_ms) {
+        pkt->deliver_us += loopback_rand(peer) % (link_cfg->jitter_ms * 1000 + 1);
+    }
+    loopback_pkt_t **pos = &remote->inbound;
+    while (*pos && (*pos)->deliver_us <= pkt->deliver_us) {
+        pos = &(*pos)->next;
+    }
+    pkt->next = *pos;
+    *pos = pkt;
+    remote->inbound_bytes += size;
+    wake_peer_locked(remote);
+    return ESP_PEER_ERR_NONE;
+}
+
+static int pacer_to_link(const uint8_t *data, int size, bool is_audio, void *ctx)
+{
+    loopback_pkt_t info = {
+        .kind = is_audio ? LOOPBACK_PKT_AUDIO : LOOPBACK_PKT_VIDEO,
+        .rtp = true,
+    };
+    esp_peer_rtp_iovec_t iov = {
+        .data = data,
+        .size = size,
+    };
+    return link_push_locked((loopback_peer_t *)ctx, &info, &iov, 1);
+}
+
+static void pacer_process_locked(loopback_peer_t *peer, int64_t now_us)
+{
+    uint32_t wait_ms = ESP_PEER_PACER_NO_WAIT;
+    esp_peer_pacer_process(peer->pacer, now_us, pacer_to_link, peer, &wait_ms);
+    peer->pacer_due_us = (wait_ms == ESP_PEER_PACER_NO_WAIT) ? 0 : now_us + (int64_t)wait_ms * 1000;
+}
+
+static int protected_to_link(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    loopback_packet_ctx_t *packet_ctx = (loopback_packet_ctx_t *)ctx;
+    loopback_peer_t *peer = packet_ctx->peer;
+    if (peer->pacer) {
+        int ret = esp_peer_pacer_enqueue(peer->pacer, packet_ctx->is_audio, iov, iov_num, packet_ctx->now_us);
+        // Dropped by pacer is same as overflow on link, keep packetizing rest of the frame
+        return ret == ESP_PEER_ERR_OVER_LIMITED ? ESP_PEER_ERR_NONE : ret;
+    }
+    loopback_pkt_t info = {
+        .kind = packet_ctx->is_audio ? LOOPBACK_PKT_AUDIO : LOOPBACK_PKT_VIDEO,
+        .rtp = true,
+    };
+    return link_push_locked(peer, &info, iov, iov_num);
+}
+
+static int packet_to_link(esp_peer_rtp_iovec_t *iov, int iov_num, void *ctx)
+{
+    loopback_packet_ctx_t *packet_ctx = (loopback_packet_ctx_t *)ctx;
+    loopback_peer_t *peer = packet_ctx->peer;
+    if (packet_ctx->is_audio) {
+        if (peer->fec_enc[LOOPBACK_MEDIA_AUDIO]) {
+            return esp_peer_red_encode(peer->fec_enc[LOOPBACK_MEDIA_AUDIO], iov, iov_num, protected_to_link, ctx);
+        }
+        return protected_to_link(iov, iov_num, ctx);
+    }
+    int ret = protected_to_link(iov, iov_num, ctx);
+    if (ret == ESP_PEER_ERR_NONE && peer->fec_enc[LOOPBACK_MEDIA_VIDEO]) {
+        ret = esp_peer_fec_encode(peer->fec_enc[LOOPBACK_MEDIA_VIDEO], iov, iov_num, protected_to_link, ctx);
+    }
+    return ret;
+}
+
+static int loopback_send(loopback_peer_t *peer, loopback_pkt_t *info, uint8_t *data)
+{
+    if (peer->connected == false) {
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    int ret;
+    esp_peer_rtp_packetizer_handle_t packetizer = NULL;
+    if (info->kind != LOOPBACK_PKT_DATA) {
+        packetizer = peer->packetizer[info->kind == LOOPBACK_PKT_AUDIO ? LOOPBACK_MEDIA_AUDIO : LOOPBACK_MEDIA_VIDEO];
+    }
+    media_lib_mutex_lock(loopback_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (packetizer == NULL) {
+        esp_peer_rtp_iovec_t iov = {
+            .data = data,
+            .size = info->size,
+        };
+        ret = link_push_locked(peer, info, &iov, 1);
+    } else if (peer->remote == NULL || peer->remote->want_connect == false) {
+        ret = ESP_PEER_ERR_WRONG_STATE;
+    } else {
+        loopback_packet_ctx_t packet_ctx = {
+            .peer = peer,
+            .is_audio = (info->kind == LOOPBACK_PKT_AUDIO),
+            .now_us = esp_timer_get_time(),
+        };
+        ret = esp_peer_rtp_packetize(packetizer, data, info->size, info->pts, packet_to_link, &packet_ctx);
+        if (peer->pacer) {
+            // Audio leaves at once, video head of the frame is released here
+            pacer_process_locked(peer, packet_ctx.now_us);
+            // Rest of the frame is due earlier than what main loop is waiting for
+            wake_peer_locked(peer);
+        }
+    }
+    media_lib_mutex_unlock(loopback_lock);
+    return ret;
+}
+
+static void report_connected(loopback_peer_t *peer, esp_peer_audio_stream_info_t *aud_info,
+                             esp_peer_video_stream_info_t *vid_info, bool dc_enabled)
+{
+    esp_peer_cfg_t *cfg = &peer->cfg;
+    if (cfg->on_state) {
+        cfg->on_state(ESP_PEER_STATE_CONNECTED, cfg->ctx);
+    }
+    if (aud_info->codec != ESP_PEER_AUDIO_CODEC_NONE && cfg->on_audio_info) {
+        cfg->on_audio_info(aud_info, cfg->ctx);
+    }
+    if (vid_info->codec != ESP_PEER_VIDEO_CODEC_NONE && cfg->on_video_info) {
+        cfg->on_video_info(vid_info, cfg->ctx);
+    }
+    if (dc_enabled) {
+        if (cfg->on_state) {
+            cfg->on_state(ESP_PEER_STATE_DATA_CHANNEL_CONNECTED, cfg->ctx);
+        }
+        if (cfg->manual_ch_create == false) {
+            esp_peer_data_channel_info_t ch = {
+                .label = LOOPBACK_CHANNEL_LABEL,
+            };
+            if (cfg->on_channel_open) {
+                cfg->on_channel_open(&ch, cfg->ctx);
+            }
+            if (cfg->on_state) {
+                cfg->on_state(ESP_PEER_STATE_DATA_CHANNEL_OPENED, cfg->ctx);
+            }
+        }
+    }
+}
+
+static int rtp_audio_frame(esp_peer_rtp_frame_t *rtp_frame, void *ctx)
+{
+    esp_peer_cfg_t *cfg = &((loopback_peer_t *)ctx)->cfg;
+    if (cfg->on_audio_data) {
+        esp_peer_audio_frame_t frame = {
+            .pts = rtp_frame->pts,
+            .data = rtp_frame->data,
+            .size = rtp_frame->size,
+        };
+        cfg->on_audio_data(&frame, cfg->ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int rtp_video_frame(esp_peer_rtp_frame_t *rtp_frame, void *ctx)
+{
+    esp_peer_cfg_t *cfg = &((loopback_peer_t *)ctx)->cfg;
+    if (cfg->on_video_data) {
+        esp_peer_video_frame_t frame = {
+            .pts = rtp_frame->pts,
+            .data = rtp_frame->data,
+            .size = rtp_frame->size,
+        };
+        cfg->on_video_data(&frame, cfg->ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static esp_peer_rtp_codec_t get_rtp_codec(loopback_media_t media, int codec)
+{
+    if (media == LOOPBACK_MEDIA_AUDIO) {
+        switch (codec) {
+            case ESP_PEER_AUDIO_CODEC_G711A:
+                return ESP_PEER_RTP_CODEC_G711A;
+            case ESP_PEER_AUDIO_CODEC_G711U:
+                return ESP_PEER_RTP_CODEC_G711U;
+            case ESP_PEER_AUDIO_CODEC_OPUS:
+                return ESP_PEER_RTP_CODEC_OPUS;
+            default:
+                return ESP_PEER_RTP_CODEC_NONE;
+        }
+    }
+    switch (codec) {
+        case ESP_PEER_VIDEO_CODEC_H264:
+            return ESP_PEER_RTP_CODEC_H264;
+        case ESP_PEER_VIDEO_CODEC_MJPEG:
+            return ESP_PEER_RTP_CODEC_MJPEG;
+        default:
+            return ESP_PEER_RTP_CODEC_NONE;
+    }
+}
+
+static void close_depacketizers(loopback_peer_t *peer)
+{
+    for (int i = 0; i < LOOPBACK_MEDIA_MAX; i++) {
+        if (peer->depacketizer[i]) {
+            esp_peer_rtp_depacketizer_close(peer->depacketizer[i]);
+            peer->depacketizer[i] = NULL;
+        }
+    }
+    if (peer->fec_dec[LOOPBACK_MEDIA_AUDIO]) {
+        esp_peer_red_decoder_close(peer->fec_dec[LOOPBACK_MEDIA_AUDIO]);
+        peer->fec_dec[LOOPBACK_MEDIA_AUDIO] = NULL;
+    }
+    if (peer->fec_dec[LOOPBACK_MEDIA_VIDEO]) {
+        esp_peer_fec_decoder_close(peer->fec_dec[LOOPBACK_MEDIA_VIDEO]);
+        peer->fec_dec[LOOPBACK_MEDIA_VIDEO] = NULL;
+    }
+    memset(peer->last_fec_stat, 0, sizeof(peer->last_fec_stat));
+}
+
+static void open_depacketizers(loopback_peer_t *peer, esp_peer_audio_stream_info_t *aud_info,
+                               esp_peer_video_stream_info_t *vid_info, bool fec)
+{
+    // Start from clean sequence state on every connection
+    close_depacketizers(peer);
+    esp_peer_rtp_depacketizer_cfg_t cfg = {
+        .codec = get_rtp_codec(LOOPBACK_MEDIA_AUDIO, aud_info->codec),
+    };
+    if (cfg.codec != ESP_PEER_RTP_CODEC_NONE) {
+        esp_peer_rtp_depacketizer_open(&cfg, &peer->depacketizer[LOOPBACK_MEDIA_AUDIO]);
+        if (fec) {
+            esp_peer_red_decoder_cfg_t red_cfg = {
+                .payload_type = LOOPBACK_RED_PT,
+            };
+            esp_peer_red_decoder_open(&red_cfg, &peer->fec_dec[LOOPBACK_MEDIA_AUDIO]);
+        }
+    }
+    cfg.codec = get_rtp_codec(LOOPBACK_MEDIA_VIDEO, vid_info->codec);
+    // Recovered video packet comes after the rest of its FEC group, audio is recovered in order by RED
+    cfg.reorder_num = fec ? LOOPBACK_FEC_REORDER : 0;
+    if (cfg.codec != ESP_PEER_RTP_CODEC_NONE) {
+        esp_peer_rtp_depacketizer_open(&cfg, &peer->depacketizer[LOOPBACK_MEDIA_VIDEO]);
+        if (fec) {
+            esp_peer_fec_decoder_cfg_t fec_cfg = {
+                .payload_type = LOOPBACK_FEC_PT,
+                .max_packet_size = peer->remote->link_cfg.mtu,
+            };
+            esp_peer_fec_decoder_open(&fec_cfg, &peer->fec_dec[LOOPBACK_MEDIA_VIDEO]);
+        }
+    }
+}
+
+static int fec_audio_out(const uint8_t *data, int size, void *ctx)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)ctx;
+    return esp_peer_rtp_depacketize(peer->depacketizer[LOOPBACK_MEDIA_AUDIO], data, size, rtp_audio_frame, peer);
+}
+
+static int fec_video_out(const uint8_t *data, int size, void *ctx)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)ctx;
+    return esp_peer_rtp_depacketize(peer->depacketizer[LOOPBACK_MEDIA_VIDEO], data, size, rtp_video_frame, peer);
+}
+
+static void deliver_rtp_pkt(loopback_peer_t *peer, loopback_pkt_t *pkt)
+{
+    uint8_t *data = (uint8_t *)(pkt + 1);
+    if (pkt->kind == LOOPBACK_PKT_AUDIO) {
+        if (peer->fec_dec[LOOPBACK_MEDIA_AUDIO]) {
+            esp_peer_red_decode(peer->fec_dec[LOOPBACK_MEDIA_AUDIO], data, pkt->size, fec_audio_out, peer);
+        } else if (peer->depacketizer[LOOPBACK_MEDIA_AUDIO]) {
+            fec_audio_out(data, pkt->size, peer);
+        }
+        return;
+    }
+    if (peer->fec_dec[LOOPBACK_MEDIA_VIDEO]) {
+        esp_peer_fec_decode(peer->fec_dec[LOOPBACK_MEDIA_VIDEO], data, pkt->size, fec_video_out, peer);
+    } else if (peer->depacketizer[LOOPBACK_MEDIA_VIDEO]) {
+        fec_video_out(data, pkt->size, peer);
+    }
+}
+
+static uint16_t get_fec_loss_locked(loopback_peer_t *peer, loopback_media_t media)
+{
+    esp_peer_fec_stat_t stat;
+    int ret = (media == LOOPBACK_MEDIA_AUDIO) ? esp_peer_red_decoder_get_stat(peer->fec_dec[media], &stat) :
+              esp_peer_fec_decoder_get_stat(peer->fec_dec[media], &stat);
+    if (ret != ESP_PEER_ERR_NONE) {
+        return 0;
+    }
+    esp_peer_fec_stat_t *last = &peer->last_fec_stat[media];
+    uint32_t lost = stat.lost - last->lost;
+    uint32_t expected = stat.media_packets - last->media_packets + lost;
+    *last = stat;
+    return expected ? (uint16_t)((uint64_t)lost * 1000 / expected) : 0;
+}
+
+static void report_loss_locked(loopback_peer_t *peer, int64_t now)
+{
+    // Act as RTCP receiver report so that sender adapts FEC overhead
+    loopback_peer_t *remote = peer->remote;
+    if (remote == NULL || now - peer->loss_report_us < LOOPBACK_LOSS_REPORT * 1000) {
+        return;
+    }
+    peer->loss_report_us = now;
+    if (peer->fec_dec[LOOPBACK_MEDIA_AUDIO] && remote->fec_enc[LOOPBACK_MEDIA_AUDIO]) {
+        esp_peer_red_encoder_set_loss(remote->fec_enc[LOOPBACK_MEDIA_AUDIO], get_fec_loss_locked(peer, LOOPBACK_MEDIA_AUDIO));
+    }
+    if (peer->fec_dec[LOOPBACK_MEDIA_VIDEO] && remote->fec_enc[LOOPBACK_MEDIA_VIDEO]) {
+        esp_peer_fec_encoder_set_loss(remote->fec_enc[LOOPBACK_MEDIA_VIDEO], get_fec_loss_locked(peer, LOOPBACK_MEDIA_VIDEO));
+    }
+}
+
+static void deliver_pkt(loopback_peer_t *peer, loopback_pkt_t *pkt)
+{
+    esp_peer_cfg_t *cfg = &peer->cfg;
+    uint8_t *data = (uint8_t *)(pkt + 1);
+    if (pkt->rtp) {
+        deliver_rtp_pkt(peer, pkt);
+    } else if (pkt->kind == LOOPBACK_PKT_AUDIO) {
+        if (cfg->on_audio_data) {
+            esp_peer_audio_frame_t frame = {
+                .pts = pkt->pts,
+                .data = data,
+                .size = pkt->size,
+            };
+            cfg->on_audio_data(&frame, cfg->ctx);
+        }
+    } else if (pkt->kind == LOOPBACK_PKT_VIDEO) {
+        if (cfg->on_video_data) {
+            esp_peer_video_frame_t frame = {
+                .pts = pkt->pts,
+                .data = data,
+                .size = pkt->size,
+            };
+            cfg->on_video_data(&frame, cfg->ctx);
+        }
+    } else if (cfg->on_data) {
+        esp_peer_data_frame_t frame = {
+            .type = pkt->data_type,
+            .stream_id = pkt->stream_id,
+            .data = data,
+            .size = pkt->size,
+        };
+        cfg->on_data(&frame, cfg->ctx);
+    }
+}
+
+static void close_packetizers(loopback_peer_t *peer)
+{
+    for (int i = 0; i < LOOPBACK_MEDIA_MAX; i++) {
+        if (peer->packetizer[i]) {
+            esp_peer_rtp_packetizer_close(peer->packetizer[i]);
+            peer->packetizer[i] = NULL;
+        }
+    }
+    if (peer->pacer) {
+        esp_peer_pacer_close(peer->pacer);
+        peer->pacer = NULL;
+    }
+    if (peer->fec_enc[LOOPBACK_MEDIA_AUDIO]) {
+        esp_peer_red_encoder_close(peer->fec_enc[LOOPBACK_MEDIA_AUDIO]);
+        peer->fec_enc[LOOPBACK_MEDIA_AUDIO] = NULL;
+    }
+    if (peer->fec_enc[LOOPBACK_MEDIA_VIDEO]) {
+        esp_peer_fec_encoder_close(peer->fec_enc[LOOPBACK_MEDIA_VIDEO]);
+        peer->fec_enc[LOOPBACK_MEDIA_VIDEO] = NULL;
+    }
+}
+
+static int open_packetizers(loopback_peer_t *peer)
+{
+    esp_peer_cfg_t *cfg = &peer->cfg;
+    esp_peer_rtp_packetizer_cfg_t pack_cfg = {
+        .codec = get_rtp_codec(LOOPBACK_MEDIA_AUDIO, cfg->audio_info.codec),
+        .payload_type = LOOPBACK_AUDIO_PT,
+        .ssrc = loopback_rand(peer),
+        .mtu = peer->link_cfg.mtu,
+    };
+    if ((cfg->audio_dir & ESP_PEER_MEDIA_DIR_SEND_ONLY) && pack_cfg.codec != ESP_PEER_RTP_CODEC_NONE) {
+        if (esp_peer_rtp_packetizer_open(&pack_cfg, &peer->packetizer[LOOPBACK_MEDIA_AUDIO]) != ESP_PEER_ERR_NONE) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+    }
+    pack_cfg.codec = get_rtp_codec(LOOPBACK_MEDIA_VIDEO, cfg->video_info.codec);
+    pack_cfg.payload_type = LOOPBACK_VIDEO_PT;
+    pack_cfg.ssrc = loopback_rand(peer);
+    if (peer->link_cfg.fec) {
+        // Leave room for FEC header so that FEC packet protecting full size packets still fits into MTU
+        pack_cfg.mtu = peer->link_cfg.mtu - ESP_PEER_FEC_HEADER_SIZE;
+    }
+    if ((cfg->video_dir & ESP_PEER_MEDIA_DIR_SEND_ONLY) && pack_cfg.codec != ESP_PEER_RTP_CODEC_NONE) {
+        if (esp_peer_rtp_packetizer_open(&pack_cfg, &peer->packetizer[LOOPBACK_MEDIA_VIDEO]) != ESP_PEER_ERR_NONE) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+    }
+    if (peer->link_cfg.fec && peer->packetizer[LOOPBACK_MEDIA_AUDIO]) {
+        // Redundancy starts disabled and follows loss reported by remote
+        esp_peer_red_encoder_cfg_t red_cfg = {
+            .payload_type = LOOPBACK_RED_PT,
+        };
+        if (esp_peer_red_encoder_open(&red_cfg, &peer->fec_enc[LOOPBACK_MEDIA_AUDIO]) != ESP_PEER_ERR_NONE) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+    }
+    if (peer->link_cfg.fec && peer->packetizer[LOOPBACK_MEDIA_VIDEO]) {
+        esp_peer_fec_encoder_cfg_t fec_cfg = {
+            .payload_type = LOOPBACK_FEC_PT,
+            .ssrc = loopback_rand(peer),
+            .max_packet_size = peer->link_cfg.mtu,
+        };
+        if (esp_peer_fec_encoder_open(&fec_cfg, &peer->fec_enc[LOOPBACK_MEDIA_VIDEO]) != ESP_PEER_ERR_NONE) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+    }
+    if (peer->link_cfg.pacing_rate) {
+        esp_peer_pacer_cfg_t pacer_cfg = {
+            .bitrate = peer->link_cfg.pacing_rate,
+            .max_bitrate = peer->link_cfg.pacing_max_rate,
+            .frame_interval = cfg->video_info.fps > 0 ? 1000 / cfg->video_info.fps : 0,
+            .spread_ratio = peer->link_cfg.pacing_spread,
+        };
+        if (esp_peer_pacer_open(&pacer_cfg, &peer->pacer) != ESP_PEER_ERR_NONE) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_open(esp_peer_cfg_t *cfg, esp_peer_handle_t *handle)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)calloc(1, sizeof(loopback_peer_t));
+    if (peer == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    peer->cfg = *cfg;
+    // Configuration pointers are not kept after open
+    peer->cfg.server_lists = NULL;
+    peer->cfg.server_num = 0;
+    peer->cfg.extra_cfg = NULL;
+    if (cfg->extra_cfg && cfg->extra_size >= (int)sizeof(esp_peer_loopback_cfg_t)) {
+        peer->link_cfg = *(esp_peer_loopback_cfg_t *)cfg->extra_cfg;
+    }
+    if (peer->link_cfg.queue_limit == 0) {
+        peer->link_cfg.queue_limit = LOOPBACK_DEFAULT_QUEUE;
+    }
+    peer->rand_state = peer->link_cfg.seed ? peer->link_cfg.seed : LOOPBACK_DEFAULT_SEED;
+    media_lib_sema_create(&peer->wake_sema);
+    if (peer->wake_sema == NULL || (peer->link_cfg.mtu && open_packetizers(peer) != ESP_PEER_ERR_NONE)) {
+        close_packetizers(peer);
+        if (peer->wake_sema) {
+            media_lib_sema_destroy(peer->wake_sema);
+        }
+        free(peer);
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    int slot = -1;
+    int same_channel = 0;
+    media_lib_mutex_lock(loopback_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    for (int i = 0; i < LOOPBACK_MAX_PEER; i++) {
+        loopback_peer_t *cur = loopback_peers[i];
+        if (cur == NULL) {
+            if (slot < 0) {
+                slot = i;
+            }
+        } else if (cur->link_cfg.channel == peer->link_cfg.channel) {
+            same_channel++;
+            peer->remote = cur;
+        }
+    }
+    if (slot >= 0 && same_channel < 2) {
+        loopback_peers[slot] = peer;
+        if (peer->remote) {
+            peer->remote->remote = peer;
+        }
+    }
+    media_lib_mutex_unlock(loopback_lock);
+    if (slot < 0 || same_channel >= 2) {
+        ESP_LOGE(TAG, "No free link for channel %d", peer->link_cfg.channel);
+        close_packetizers(peer);
+        media_lib_sema_destroy(peer->wake_sema);
+        free(peer);
+        return ESP_PEER_ERR_OVER_LIMITED;
+    }
+    *handle = peer;
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_new_connection(esp_peer_handle_t handle)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    media_lib_mutex_lock(loopback_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    peer->want_connect = true;
+    // Both sides connect in their own main loop
+    wake_peer_locked(peer);
+    wake_peer_locked(peer->remote);
+    media_lib_mutex_unlock(loopback_lock);
+    if (peer->cfg.on_state) {
+        peer->cfg.on_state(ESP_PEER_STATE_NEW_CONNECTION, peer->cfg.ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_update_ice_info(esp_peer_handle_t handle, esp_peer_role_t role, esp_peer_ice_server_cfg_t *server, int server_num)
+{
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_send_msg(esp_peer_handle_t handle, esp_peer_msg_t *msg)
+{
+    // No SDP or candidate exchange needed for in process link
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_send_video(esp_peer_handle_t handle, esp_peer_video_frame_t *info)
+{
+    loopback_pkt_t pkt = {
+        .kind = LOOPBACK_PKT_VIDEO,
+        .pts = info->pts,
+        .size = info->size,
+    };
+    return loopback_send((loopback_peer_t *)handle, &pkt, info->data);
+}
+
+static int loopback_send_audio(esp_peer_handle_t handle, esp_peer_audio_frame_t *info)
+{
+    loopback_pkt_t pkt = {
+        .kind = LOOPBACK_PKT_AUDIO,
+        .pts = info->pts,
+        .size = info->size,
+    };
+    return loopback_send((loopback_peer_t *)handle, &pkt, info->data);
+}
+
+static int loopback_send_data(esp_peer_handle_t handle, esp_peer_data_frame_t *info)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    if (peer->cfg.enable_data_channel == false) {
+        return ESP_PEER_ERR_NOT_SUPPORT;
+    }
+    loopback_pkt_t pkt = {
+        .kind = LOOPBACK_PKT_DATA,
+        .data_type = info->type,
+        .stream_id = info->stream_id,
+        .size = info->size,
+    };
+    return loopback_send(peer, &pkt, info->data);
+}
+
+static int loopback_create_data_channel(esp_peer_handle_t handle, esp_peer_data_channel_cfg_t *ch_cfg)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    if (peer->cfg.enable_data_channel == false || peer->connected == false) {
+        return ESP_PEER_ERR_WRONG_STATE;
+    }
+    esp_peer_data_channel_info_t ch = {
+        .label = ch_cfg->label,
+    };
+    if (peer->cfg.on_channel_open) {
+        peer->cfg.on_channel_open(&ch, peer->cfg.ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_close_data_channel(esp_peer_handle_t handle, const char *label)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    esp_peer_data_channel_info_t ch = {
+        .label = label,
+    };
+    if (peer->cfg.on_channel_close) {
+        peer->cfg.on_channel_close(&ch, peer->cfg.ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_main_loop(esp_peer_handle_t handle)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    esp_peer_audio_stream_info_t aud_info = {};
+    esp_peer_video_stream_info_t vid_info = {};
+    bool dc_enabled = false;
+    loopback_pkt_t *due = NULL;
+    loopback_pkt_t **due_tail = &due;
+
+    media_lib_mutex_lock(loopback_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    loopback_peer_t *remote = peer->remote;
+    bool remote_ready = (remote && remote->want_connect);
+    bool do_connect = peer->want_connect && peer->connected == false && remote_ready;
+    bool do_disconnect = peer->connected && remote_ready == false;
+    if (do_connect) {
+        peer->connected = true;
+        // Report what remote sends and we accept, like SDP negotiation does
+        if ((remote->cfg.audio_dir & ESP_PEER_MEDIA_DIR_SEND_ONLY) && (peer->cfg.audio_dir & ESP_PEER_MEDIA_DIR_RECV_ONLY)) {
+            aud_info = remote->cfg.audio_info;
+        }
+        if ((remote->cfg.video_dir & ESP_PEER_MEDIA_DIR_SEND_ONLY) && (peer->cfg.video_dir & ESP_PEER_MEDIA_DIR_RECV_ONLY)) {
+            vid_info = remote->cfg.video_info;
+        }
+        dc_enabled = peer->cfg.enable_data_channel && remote->cfg.enable_data_channel;
+        // Created under lock so that query never sees a closing one
+        open_depacketizers(peer, &aud_info, &vid_info, remote->link_cfg.mtu && remote->link_cfg.fec);
+        peer->loss_report_us = esp_timer_get_time();
+    }
+    if (do_disconnect) {
+        peer->connected = false;
+        flush_inbound_locked(peer);
+    }
+    int64_t now = esp_timer_get_time();
+    if (peer->pacer && peer->connected) {
+        pacer_process_locked(peer, now);
+    }
+    if (peer->connected) {
+        report_loss_locked(peer, now);
+    }
+    while (peer->connected && peer->inbound && peer->inbound->deliver_us <= now) {
+        loopback_pkt_t *pkt = peer->inbound;
+        peer->inbound = pkt->next;
+        peer->inbound_bytes -= pkt->size;
+        pkt->next = NULL;
+        *due_tail = pkt;
+        due_tail = &pkt->next;
+    }
+    media_lib_mutex_unlock(loopback_lock);
+
+    if (do_connect) {
+        report_connected(peer, &aud_info, &vid_info, dc_enabled);
+    }
+    if (do_disconnect && peer->cfg.on_state) {
+        peer->cfg.on_state(ESP_PEER_STATE_DISCONNECTED, peer->cfg.ctx);
+    }
+    for (loopback_pkt_t *pkt = due; pkt; pkt = pkt->next) {
+        deliver_pkt(peer, pkt);
+        uint32_t delay_ms = (uint32_t)((now - pkt->send_us) / 1000);
+        peer->stat.delivered++;
+        if (delay_ms > peer->stat.max_delay_ms) {
+            peer->stat.max_delay_ms = delay_ms;
+        }
+    }
+    free_pkt_list(due);
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_get_wait_info(esp_peer_handle_t handle, esp_peer_wait_info_t *info)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    uint32_t timeout = LOOPBACK_IDLE_WAIT;
+    media_lib_mutex_lock(loopback_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    bool remote_ready = (peer->remote && peer->remote->want_connect);
+    if (peer->connected != (peer->want_connect && remote_ready)) {
+        // State change pending
+        timeout = 0;
+    } else {
+        int64_t now = esp_timer_get_time();
+        if (peer->inbound) {
+            int64_t wait_us = peer->inbound->deliver_us - now;
+            timeout = wait_us <= 0 ? 0 : MIN(timeout, (uint32_t)((wait_us + 999) / 1000));
+        }
+        if (peer->pacer_due_us) {
+            int64_t wait_us = peer->pacer_due_us - now;
+            timeout = wait_us <= 0 ? 0 : MIN(timeout, (uint32_t)((wait_us + 999) / 1000));
+        }
+        if (peer->connected && (peer->fec_dec[LOOPBACK_MEDIA_AUDIO] || peer->fec_dec[LOOPBACK_MEDIA_VIDEO])) {
+            int64_t wait_us = peer->loss_report_us + LOOPBACK_LOSS_REPORT * 1000 - now;
+            timeout = wait_us <= 0 ? 0 : MIN(timeout, (uint32_t)((wait_us + 999) / 1000));
+        }
+    }
+    media_lib_mutex_unlock(loopback_lock);
+    // No socket, new packet and state change are signaled through semaphore
+    info->fd_num = 0;
+    info->timeout_ms = timeout;
+    info->wake_sema = peer->wake_sema;
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_disconnect(esp_peer_handle_t handle)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    media_lib_mutex_lock(loopback_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    bool was_connected = peer->connected;
+    peer->want_connect = false;
+    peer->connected = false;
+    flush_inbound_locked(peer);
+    wake_peer_locked(peer->remote);
+    media_lib_mutex_unlock(loopback_lock);
+    if (was_connected && peer->cfg.on_state) {
+        peer->cfg.on_state(ESP_PEER_STATE_DISCONNECTED, peer->cfg.ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static void loopback_query(esp_peer_handle_t handle)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    esp_peer_pacer_stat_t pacer_stat = {};
+    esp_peer_rtp_stat_t rtp_stat[LOOPBACK_MEDIA_MAX] = {};
+    esp_peer_fec_stat_t fec_stat[LOOPBACK_MEDIA_MAX] = {};
+    bool has_rtp[LOOPBACK_MEDIA_MAX] = {};
+    bool has_fec[LOOPBACK_MEDIA_MAX] = {};
+    // Depacketizers and decoders are only replaced under lock
+    media_lib_mutex_lock(loopback_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    loopback_stat_t stat = peer->stat;
+    uint32_t queued = peer->remote ? peer->remote->inbound_bytes : 0;
+    if (peer->pacer) {
+        esp_peer_pacer_get_stat(peer->pacer, &pacer_stat, true);
+    }
+    for (int i = 0; i < LOOPBACK_MEDIA_MAX; i++) {
+        has_rtp[i] = peer->depacketizer[i] &&
+                     esp_peer_rtp_depacketizer_get_stat(peer->depacketizer[i], &rtp_stat[i]) == ESP_PEER_ERR_NONE;
+        if (peer->fec_dec[i]) {
+            int ret = (i == LOOPBACK_MEDIA_AUDIO) ? esp_peer_red_decoder_get_stat(peer->fec_dec[i], &fec_stat[i]) :
+                      esp_peer_fec_decoder_get_stat(peer->fec_dec[i], &fec_stat[i]);
+            has_fec[i] = (ret == ESP_PEER_ERR_NONE);
+        }
+    }
+    media_lib_mutex_unlock(loopback_lock);
+    ESP_LOGI(TAG, "Channel %d sent:%d lost:%d overflow:%d queued:%d recv:%d max_delay:%dms",
+             peer->link_cfg.channel, (int)stat.sent, (int)stat.lost, (int)stat.overflow, (int)queued,
+             (int)stat.delivered, (int)stat.max_delay_ms);
+    if (peer->pacer) {
+        ESP_LOGI(TAG, "Pacer audio:%d video:%d dropped:%d queued:%d delay avg:%dms max:%dms",
+                 (int)pacer_stat.audio_packets, (int)pacer_stat.video_packets, (int)pacer_stat.dropped_packets,
+                 (int)pacer_stat.queue_bytes, (int)pacer_stat.avg_queue_delay_ms, (int)pacer_stat.max_queue_delay_ms);
+    }
+    for (int i = 0; i < LOOPBACK_MEDIA_MAX; i++) {
+        const char *media = (i == LOOPBACK_MEDIA_AUDIO) ? "audio" : "video";
+        if (has_rtp[i]) {
+            ESP_LOGI(TAG, "Recv %s packets:%d lost:%d frames:%d dropped:%d", media, (int)rtp_stat[i].packets,
+                     (int)rtp_stat[i].lost, (int)rtp_stat[i].frames, (int)rtp_stat[i].dropped_frames);
+        }
+        if (has_fec[i]) {
+            ESP_LOGI(TAG, "Recv %s FEC:%d lost:%d recovered:%d unrecovered:%d", media, (int)fec_stat[i].fec_packets,
+                     (int)fec_stat[i].lost, (int)fec_stat[i].recovered, (int)fec_stat[i].unrecovered);
+        }
+    }
+}
+
+static int loopback_close(esp_peer_handle_t handle)
+{
+    loopback_peer_t *peer = (loopback_peer_t *)handle;
+    media_lib_mutex_lock(loopback_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    for (int i = 0; i < LOOPBACK_MAX_PEER; i++) {
+        if (loopback_peers[i] == peer) {
+            loopback_peers[i] = NULL;
+        }
+    }
+    if (peer->remote) {
+        peer->remote->remote = NULL;
+        wake_peer_locked(peer->remote);
+    }
+    flush_inbound_locked(peer);
+    media_lib_mutex_unlock(loopback_lock);
+    close_packetizers(peer);
+    close_depacketizers(peer);
+    media_lib_sema_destroy(peer->wake_sema);
+    free(peer);
+    return ESP_PEER_ERR_NONE;
+}
+
+static const esp_peer_ops_t loopback_impl = {
+    .open = loopback_open,
+    .new_connection = loopback_new_connection,
+    .update_ice_info = loopback_update_ice_info,
+    .send_msg = loopback_send_msg,
+    .send_video = loopback_send_video,
+    .send_audio = loopback_send_audio,
+    .send_data = loopback_send_data,
+    .create_data_channel = loopback_create_data_channel,
+    .close_data_channel = loopback_close_data_channel,
+    .main_loop = loopback_main_loop,
+    .disconnect = loopback_disconnect,
+    .query = loopback_query,
+    .close = loopback_close,
+};
+
+static const esp_peer_ops_ext_t loopback_ext = {
+    .size = sizeof(esp_peer_ops_ext_t),
+    .get_wait_info = loopback_get_wait_info,
+};
+
+static void loopback_init(void)
+{
+    media_lib_mutex_create(&loopback_lock);
+    if (loopback_lock) {
+        esp_peer_register_ops_ext(&loopback_impl, &loopback_ext);
+    }
+}
+
+const esp_peer_ops_t *esp_peer_get_loopback_impl(void)
+{
+    // Run only once even when called from several tasks at the same time
+    pthread_once(&loopback_once, loopback_init);
+    return loopback_lock ? &loopback_impl : NULL;
+}
+
+static int loopback_signaling_start(esp_peer_signaling_cfg_t *cfg, esp_peer_signaling_handle_t *handle)
+{
+    loopback_signaling_t *sig = (loopback_signaling_t *)calloc(1, sizeof(loopback_signaling_t));
+    if (sig == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    sig->cfg = *cfg;
+    *handle = sig;
+    esp_peer_signaling_ice_info_t ice_info = {};
+    if (cfg->on_ice_info) {
+        cfg->on_ice_info(&ice_info, cfg->ctx);
+    }
+    if (cfg->on_connected) {
+        cfg->on_connected(cfg->ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_signaling_send_msg(esp_peer_signaling_handle_t handle, esp_peer_signaling_msg_t *msg)
+{
+    if (msg->type == ESP_PEER_SIGNALING_MSG_CUSTOMIZED) {
+        return ESP_PEER_ERR_NOT_SUPPORT;
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+static int loopback_signaling_stop(esp_peer_signaling_handle_t handle)
+{
+    loopback_signaling_t *sig = (loopback_signaling_t *)handle;
+    if (sig->cfg.on_close) {
+        sig->cfg.on_close(sig->cfg.ctx);
+    }
+    free(sig);
+    return ESP_PEER_ERR_NONE;
+}
+
+const esp_peer_signaling_impl_t *esp_signaling_get_loopback_impl(void)
+{
+    static const esp_peer_signaling_impl_t impl = {
+        .start = loopback_signaling_start,
+        .send_msg = loopback_signaling_send_msg,
+        .stop = loopback_signaling_stop,
+    };
+    return &impl;
+}
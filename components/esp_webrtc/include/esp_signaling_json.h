@@ -0,0 +1,146 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_peer_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Signaling JSON tokenizer
+ *
+ * @note  Extracts fields of signaling messages (offer/answer/candidate/bye/customized) in place without heap allocation
+ *        Input need not be NUL terminated, values point into the input buffer
+ *        Only `esp_signaling_json_get_string` and `esp_signaling_json_unescape` modify the buffer:
+ *        string is unescaped in place and NUL terminated at its closing quote
+ *        A modified string breaks later lookups over the text containing it, so locate all values before unescaping
+ */
+
+/**
+ * @brief  JSON value type
+ */
+typedef enum {
+    ESP_SIGNALING_JSON_NONE,   /*!< Invalid value */
+    ESP_SIGNALING_JSON_STRING, /*!< String, `data` excludes the quotes */
+    ESP_SIGNALING_JSON_NUMBER, /*!< Number */
+    ESP_SIGNALING_JSON_BOOL,   /*!< true or false */
+    ESP_SIGNALING_JSON_NULL,   /*!< null */
+    ESP_SIGNALING_JSON_OBJECT, /*!< Object, `data` includes the braces */
+    ESP_SIGNALING_JSON_ARRAY,  /*!< Array, `data` includes the brackets */
+} esp_signaling_json_type_t;
+
+/**
+ * @brief  JSON value located in input buffer
+ */
+typedef struct {
+    esp_signaling_json_type_t type;    /*!< Value type */
+    char                     *data;    /*!< Start of value in input buffer */
+    int                       size;    /*!< Size of value */
+    bool                      escaped; /*!< String contains escape sequence */
+} esp_signaling_json_value_t;
+
+/**
+ * @brief  Find member of JSON object
+ *
+ * @note  Only direct members are matched, nested values are skipped without being tokenized
+ *
+ * @param[in]   json   JSON object text
+ * @param[in]   size   Size of JSON text
+ * @param[in]   key    Member name
+ * @param[out]  value  Member value
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_BAD_DATA     Malformed JSON
+ *       - ESP_PEER_ERR_NOT_EXISTS   Member not found
+ */
+int esp_signaling_json_find(const char *json, int size, const char *key, esp_signaling_json_value_t *value);
+
+/**
+ * @brief  Get element of JSON array
+ *
+ * @param[in]   json   JSON array text
+ * @param[in]   size   Size of JSON text
+ * @param[in]   index  Element index
+ * @param[out]  value  Element value
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_BAD_DATA     Malformed JSON
+ *       - ESP_PEER_ERR_NOT_EXISTS   Index out of range
+ */
+int esp_signaling_json_get_item(const char *json, int size, int index, esp_signaling_json_value_t *value);
+
+/**
+ * @brief  Unescape string value in place and NUL terminate it
+ *
+ * @note  Unescaped string is never longer than escaped one, `value->size` is updated
+ *
+ * @param[in,out]  value  String value
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Not a string
+ *       - ESP_PEER_ERR_BAD_DATA     Bad escape sequence
+ */
+int esp_signaling_json_unescape(esp_signaling_json_value_t *value);
+
+/**
+ * @brief  Find string member of JSON object, unescape it in place and NUL terminate it
+ *
+ * @param[in]   json   JSON object text (modified in place)
+ * @param[in]   size   Size of JSON text
+ * @param[in]   key    Member name
+ * @param[out]  value  String value
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument or member is not string
+ *       - ESP_PEER_ERR_BAD_DATA     Malformed JSON or bad escape sequence
+ *       - ESP_PEER_ERR_NOT_EXISTS   Member not found
+ */
+int esp_signaling_json_get_string(char *json, int size, const char *key, esp_signaling_json_value_t *value);
+
+/**
+ * @brief  Check whether value equals to string
+ *
+ * @param[in]  value  JSON value
+ * @param[in]  str    String to compare
+ *
+ * @return
+ *       - true   Value is string and equal
+ *       - false  Not equal
+ */
+bool esp_signaling_json_equal(esp_signaling_json_value_t *value, const char *str);
+
+#ifdef __cplusplus
+}
+#endif
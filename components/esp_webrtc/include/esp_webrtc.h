@@ -38,6 +38,11 @@ extern "C" {
  */
 typedef void *esp_webrtc_handle_t;
 
+/**
+ * @brief  ESP WebRTC extra viewer handle
+ */
+typedef void *esp_webrtc_viewer_handle_t;
+
 typedef enum {
     ESP_WEBRTC_CUSTOM_DATA_VIA_NONE,
     ESP_WEBRTC_CUSTOM_DATA_VIA_SIGNALING,
@@ -59,10 +64,26 @@ typedef struct {
     bool                         manual_ch_create;        /*!< When set, disable auto create data channel in SCTP client mode if `enable_data_channel` set
                                                                User need manually call `esp_peer_create_data_channel` instead */
     bool                         video_over_data_channel; /*!< Whether send and receive video data through data channel */
+    bool                         video_dc_framing;        /*!< Add header (frame id, pts, fragment offset) for video over data channel
+                                                               Receiver reassembles fragments, drops stale frames and still accepts raw frames
+                                                               Works with unordered and partially reliable data channel */
+    uint16_t                     video_dc_frag_size;      /*!< Maximum video payload per data channel message when framing, default 16KB */
+    uint8_t                      viewer_queue_num;        /*!< Send queue depth (frames) of each extra viewer, default 8
+                                                               When queue is full audio replaces queued video and video waits for next key frame */
+    esp_peer_video_stream_info_t simulcast_info;          /*!< Low resolution simulcast layer for extra viewers, width 0 to disable
+                                                               Captured from secondary capture path with same codec as `video_info` (fps 0 to use `video_info.fps`)
+                                                               Needs capture path which supports `ESP_CAPTURE_PATH_SECONDARY` (simple capture path with `secondary_venc`)
+                                                               Each viewer is forwarded the layer which fits its congestion and estimated bandwidth */
     bool                         no_auto_reconnect;       /*!< Disable auto reconnect
                                                                In room related WebRTC application, connection build up with peer
                                                                If peer leaves, it will auto re-enter same room (send new SDP) after clear up
                                                                Disable reconnect will do nothing after clear up until call `esp_webrtc_enable_peer_connection` */
+    bool                         fast_reconnect;          /*!< Keep capture and render running when peer leaves or connection lost (e.g. Wi-Fi roam)
+                                                               Connection is rebuilt by ICE restart through existing signaling, media resumes with key frame
+                                                               Ignored when `no_auto_reconnect` is set */
+    bool                         early_media;             /*!< Start capture once remote SDP is received instead of after ICE connected
+                                                               Encoder is drained while connecting and latest GOP is kept, sending starts from it once connected
+                                                               without encoder restart, capture stops if connection fails */
     void                        *extra_cfg;               /*!< Extra configuration for peer connection */
     int                          extra_size;              /*!< Size of extra configuration */
     void                        *ctx;                     /*!< User context */
@@ -112,6 +133,45 @@ typedef struct {
     esp_webrtc_peer_cfg_t            peer_cfg;       /*!< Peer connection configuration */
 } esp_webrtc_cfg_t;
 
+/**
+ * @brief  ESP WebRTC extra viewer statistics
+ */
+typedef struct {
+    uint32_t audio_frames;  /*!< Audio frames sent */
+    uint32_t video_frames;  /*!< Video frames sent */
+    uint32_t audio_dropped; /*!< Audio frames dropped for send queue full */
+    uint32_t video_dropped; /*!< Video frames dropped for send queue full or waiting for key frame */
+    uint32_t send_bytes;    /*!< Total bytes sent */
+    uint16_t queue_max;     /*!< Maximum queued frames */
+    uint8_t  layer;         /*!< Video layer forwarded, 0 for `video_info`, 1 for `simulcast_info` */
+    uint8_t  temporal_id;   /*!< Highest temporal layer forwarded, 0 when only base temporal layer (reduced frame rate) is sent
+                                 or stream has no temporal layer */
+} esp_webrtc_viewer_stat_t;
+
+/**
+ * @brief  ESP WebRTC fast reconnect statistics
+ */
+typedef struct {
+    uint32_t reconnect_count; /*!< Times media resumed through fast reconnect */
+    uint32_t last_resume_ms;  /*!< Time from connection lost to first key frame (or audio frame if no video) sent after last reconnect */
+    uint32_t max_resume_ms;   /*!< Maximum resume time */
+} esp_webrtc_reconnect_stat_t;
+
+/**
+ * @brief  ESP WebRTC connection setup statistics
+ *
+ * @note  Time is counted from the first SDP (offer) sent or received for the connection
+ *        Field stays 0 until the related step is reached
+ */
+typedef struct {
+    uint32_t connect_ms;           /*!< Time from offer to ICE connected */
+    uint32_t first_send_ms;        /*!< Time from offer to first media frame sent */
+    uint32_t first_recv_ms;        /*!< Time from offer to first media frame received */
+    uint16_t local_candidates;     /*!< Local candidates sent through signaling */
+    uint16_t remote_candidates;    /*!< Remote candidates applied */
+    uint16_t dup_candidates;       /*!< Duplicated candidates dropped (both directions) */
+} esp_webrtc_setup_stat_t;
+
 /**
  * @brief  WebRTC event type
  */
@@ -242,6 +302,93 @@ int esp_webrtc_send_custom_data(esp_webrtc_handle_t rtc_handle, esp_webrtc_custo
  */
 int esp_webrtc_get_peer_connection(esp_webrtc_handle_t rtc_handle, esp_peer_handle_t *peer_handle);
 
+/**
+ * @brief  Add extra viewer which receives the same encoded audio and video as the main peer connection
+ *
+ * @note  Frames are encoded once, copied into a shared buffer and queued to each viewer
+ *        Every viewer has its own send thread and queue so that a slow viewer does not stall others
+ *        The viewer thread also drives `esp_peer_main_loop` of the peer, user only need handle its signaling
+ *        Media is sent after the main peer connection starts streaming
+ *
+ * @param[in]   rtc_handle  WebRTC handle
+ * @param[in]   peer        Peer connection of the viewer, opened by user and kept open until viewer removed
+ * @param[out]  viewer      Viewer handle
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *      - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int esp_webrtc_add_viewer(esp_webrtc_handle_t rtc_handle, esp_peer_handle_t peer, esp_webrtc_viewer_handle_t *viewer);
+
+/**
+ * @brief  Remove extra viewer
+ *
+ * @note  After return no more data is sent to the peer, user can close it safely
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  viewer      Viewer handle
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_webrtc_remove_viewer(esp_webrtc_handle_t rtc_handle, esp_webrtc_viewer_handle_t viewer);
+
+/**
+ * @brief  Get statistics of extra viewer
+ *
+ * @param[in]   rtc_handle  WebRTC handle
+ * @param[in]   viewer      Viewer handle
+ * @param[out]  stat        Viewer statistics
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_webrtc_get_viewer_stat(esp_webrtc_handle_t rtc_handle, esp_webrtc_viewer_handle_t viewer, esp_webrtc_viewer_stat_t *stat);
+
+/**
+ * @brief  Set estimated bandwidth of extra viewer
+ *
+ * @note  Viewer is forwarded the best video layer (resolution and frame rate) whose measured bitrate fits into it
+ *        Without estimation layer follows send congestion of the viewer only
+ *        Takes effect only when several layers exist: simulcast is set up or H264 encoder emits non-reference frames
+ *
+ * @param[in]  rtc_handle  WebRTC handle
+ * @param[in]  viewer      Viewer handle
+ * @param[in]  bitrate     Estimated bandwidth (unit bps), 0 to clear
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_webrtc_set_viewer_bandwidth(esp_webrtc_handle_t rtc_handle, esp_webrtc_viewer_handle_t viewer, uint32_t bitrate);
+
+/**
+ * @brief  Get fast reconnect statistics
+ *
+ * @param[in]   rtc_handle  WebRTC handle
+ * @param[out]  stat        Reconnect statistics
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_webrtc_get_reconnect_stat(esp_webrtc_handle_t rtc_handle, esp_webrtc_reconnect_stat_t *stat);
+
+/**
+ * @brief  Get connection setup statistics of latest connection
+ *
+ * @param[in]   rtc_handle  WebRTC handle
+ * @param[out]  stat        Setup statistics
+ *
+ * @return
+ *      - ESP_PEER_ERR_NONE         On success
+ *      - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int esp_webrtc_get_setup_stat(esp_webrtc_handle_t rtc_handle, esp_webrtc_setup_stat_t *stat);
+
 /**
  * @brief  Query status of WebRTC
  *
@@ -28,6 +28,7 @@
 #include "esp_peer.h"
 #include "esp_peer_signaling.h"
 #include "esp_peer_whip_signaling.h"
+#include "esp_peer_loopback.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +24,7 @@
 
 #include "esp_peer_signaling.h"
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
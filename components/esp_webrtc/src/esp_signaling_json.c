@@ -0,0 +1,356 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+#include "esp_signaling_json.h"
+
+#define JSON_MAX_DEPTH (32)
+
+static const char *skip_space(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        p++;
+    }
+    return p;
+}
+
+// Return position after closing quote, `p` points to opening quote
+static const char *skip_string(const char *p, const char *end, bool *escaped)
+{
+    for (p++; p < end; p++) {
+        if (*p == '"') {
+            return p + 1;
+        }
+        if (*p == '\\') {
+            if (escaped) {
+                *escaped = true;
+            }
+            p++;
+        }
+    }
+    return NULL;
+}
+
+static const char *skip_value(const char *p, const char *end)
+{
+    if (p >= end) {
+        return NULL;
+    }
+    if (*p == '"') {
+        return skip_string(p, end, NULL);
+    }
+    if (*p == '{' || *p == '[') {
+        // Only brackets need be balanced, members are validated when they are looked up
+        int depth = 0;
+        while (p < end) {
+            char c = *p;
+            if (c == '"') {
+                p = skip_string(p, end, NULL);
+                if (p == NULL) {
+                    return NULL;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                if (++depth > JSON_MAX_DEPTH) {
+                    return NULL;
+                }
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return p + 1;
+                }
+            }
+            p++;
+        }
+        return NULL;
+    }
+    const char *start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+        p++;
+    }
+    return p > start ? p : NULL;
+}
+
+static const char *parse_value(const char *p, const char *end, esp_signaling_json_value_t *value)
+{
+    const char *value_end;
+    value->escaped = false;
+    if (*p == '"') {
+        value_end = skip_string(p, end, &value->escaped);
+        if (value_end == NULL) {
+            return NULL;
+        }
+        value->type = ESP_SIGNALING_JSON_STRING;
+        value->data = (char *)p + 1;
+        value->size = (int)(value_end - p) - 2;
+        return value_end;
+    }
+    value_end = skip_value(p, end);
+    if (value_end == NULL) {
+        return NULL;
+    }
+    switch (*p) {
+        case '{':
+            value->type = ESP_SIGNALING_JSON_OBJECT;
+            break;
+        case '[':
+            value->type = ESP_SIGNALING_JSON_ARRAY;
+            break;
+        case 't':
+        case 'f':
+            value->type = ESP_SIGNALING_JSON_BOOL;
+            break;
+        case 'n':
+            value->type = ESP_SIGNALING_JSON_NULL;
+            break;
+        default:
+            value->type = ESP_SIGNALING_JSON_NUMBER;
+            break;
+    }
+    value->data = (char *)p;
+    value->size = (int)(value_end - p);
+    return value_end;
+}
+
+int esp_signaling_json_find(const char *json, int size, const char *key, esp_signaling_json_value_t *value)
+{
+    if (json == NULL || size <= 0 || key == NULL || value == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    const char *end = json + size;
+    const char *p = skip_space(json, end);
+    if (p >= end || *p != '{') {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    int key_len = strlen(key);
+    p = skip_space(p + 1, end);
+    if (p < end && *p == '}') {
+        return ESP_PEER_ERR_NOT_EXISTS;
+    }
+    while (p < end) {
+        if (*p != '"') {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        const char *name = p + 1;
+        p = skip_string(p, end, NULL);
+        if (p == NULL) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        bool match = (p - 1 - name == key_len) && memcmp(name, key, key_len) == 0;
+        p = skip_space(p, end);
+        if (p >= end || *p != ':') {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        p = skip_space(p + 1, end);
+        if (p >= end) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        if (match) {
+            return parse_value(p, end, value) ? ESP_PEER_ERR_NONE : ESP_PEER_ERR_BAD_DATA;
+        }
+        p = skip_value(p, end);
+        if (p == NULL) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        p = skip_space(p, end);
+        if (p >= end) {
+            break;
+        }
+        if (*p == '}') {
+            return ESP_PEER_ERR_NOT_EXISTS;
+        }
+        if (*p != ',') {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        p = skip_space(p + 1, end);
+    }
+    return ESP_PEER_ERR_BAD_DATA;
+}
+
+int esp_signaling_json_get_item(const char *json, int size, int index, esp_signaling_json_value_t *value)
+{
+    if (json == NULL || size <= 0 || index < 0 || value == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    const char *end = json + size;
+    const char *p = skip_space(json, end);
+    if (p >= end || *p != '[') {
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    p = skip_space(p + 1, end);
+    if (p < end && *p == ']') {
+        return ESP_PEER_ERR_NOT_EXISTS;
+    }
+    for (int i = 0; p < end; i++) {
+        if (i == index) {
+            return parse_value(p, end, value) ? ESP_PEER_ERR_NONE : ESP_PEER_ERR_BAD_DATA;
+        }
+        p = skip_value(p, end);
+        if (p == NULL) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        p = skip_space(p, end);
+        if (p >= end) {
+            break;
+        }
+        if (*p == ']') {
+            return ESP_PEER_ERR_NOT_EXISTS;
+        }
+        if (*p != ',') {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        p = skip_space(p + 1, end);
+    }
+    return ESP_PEER_ERR_BAD_DATA;
+}
+
+static int hex_value(const char *p)
+{
+    int v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') {
+            v |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            v |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            v |= c - 'A' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return v;
+}
+
+static char *put_utf8(char *dst, uint32_t code)
+{
+    if (code < 0x80) {
+        *dst++ = (char)code;
+    } else if (code < 0x800) {
+        *dst++ = (char)(0xC0 | (code >> 6));
+        *dst++ = (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        *dst++ = (char)(0xE0 | (code >> 12));
+        *dst++ = (char)(0x80 | ((code >> 6) & 0x3F));
+        *dst++ = (char)(0x80 | (code & 0x3F));
+    } else {
+        *dst++ = (char)(0xF0 | (code >> 18));
+        *dst++ = (char)(0x80 | ((code >> 12) & 0x3F));
+        *dst++ = (char)(0x80 | ((code >> 6) & 0x3F));
+        *dst++ = (char)(0x80 | (code & 0x3F));
+    }
+    return dst;
+}
+
+int esp_signaling_json_unescape(esp_signaling_json_value_t *value)
+{
+    if (value == NULL || value->type != ESP_SIGNALING_JSON_STRING || value->data == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    char *src = value->data;
+    char *end = src + value->size;
+    char *dst = src;
+    // Output never grows, so unescape can write over input
+    while (value->escaped && src < end) {
+        if (*src != '\\') {
+            *dst++ = *src++;
+            continue;
+        }
+        if (src + 1 >= end) {
+            return ESP_PEER_ERR_BAD_DATA;
+        }
+        char c = src[1];
+        src += 2;
+        switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                *dst++ = c;
+                break;
+            case 'b':
+                *dst++ = '\b';
+                break;
+            case 'f':
+                *dst++ = '\f';
+                break;
+            case 'n':
+                *dst++ = '\n';
+                break;
+            case 'r':
+                *dst++ = '\r';
+                break;
+            case 't':
+                *dst++ = '\t';
+                break;
+            case 'u': {
+                int code = src + 4 <= end ? hex_value(src) : -1;
+                if (code < 0) {
+                    return ESP_PEER_ERR_BAD_DATA;
+                }
+                src += 4;
+                // Combine surrogate pair
+                if (code >= 0xD800 && code < 0xDC00 && src + 6 <= end && src[0] == '\\' && src[1] == 'u') {
+                    int low = hex_value(src + 2);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        src += 6;
+                    }
+                }
+                dst = put_utf8(dst, (uint32_t)code);
+                break;
+            }
+            default:
+                return ESP_PEER_ERR_BAD_DATA;
+        }
+    }
+    if (value->escaped) {
+        value->size = (int)(dst - value->data);
+        value->escaped = false;
+    }
+    // Closing quote (or space freed by unescape) is overwritten
+    value->data[value->size] = '\0';
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_signaling_json_get_string(char *json, int size, const char *key, esp_signaling_json_value_t *value)
+{
+    int ret = esp_signaling_json_find(json, size, key, value);
+    if (ret != ESP_PEER_ERR_NONE) {
+        return ret;
+    }
+    if (value->type != ESP_SIGNALING_JSON_STRING) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    return esp_signaling_json_unescape(value);
+}
+
+bool esp_signaling_json_equal(esp_signaling_json_value_t *value, const char *str)
+{
+    if (value == NULL || str == NULL || value->type != ESP_SIGNALING_JSON_STRING) {
+        return false;
+    }
+    int len = strlen(str);
+    return value->size == len && memcmp(value->data, str, len) == 0;
+}
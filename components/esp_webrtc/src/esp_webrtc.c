@@ -30,10 +30,13 @@
 #include <sys/param.h>
 #include "esp_log.h"
 #include "media_lib_os.h"
+#include "media_lib_socket.h"
 #include "esp_timer.h"
 #include "esp_webrtc.h"
 #include "esp_codec_dev.h"
 #include "esp_webrtc_defaults.h"
+#include "video_dc_frame.h"
+#include "media_fanout.h"
 
 #define AUDIO_FRAME_INTERVAL (20)
 #define STR_SAME(a, b)       (strncmp(a, b, sizeof(b) - 1) == 0)
@@ -46,16 +49,38 @@
     free(ptr);                      \
     ptr = NULL;                     \
 }
+#define PC_POLL_INTERVAL     (10)
+#define PC_MAX_WAIT_INTERVAL (100)
+
 #define PC_EXIT_BIT      (1 << 0)
 #define PC_PAUSED_BIT    (1 << 1)
 #define PC_RESUME_BIT    (1 << 2)
 #define PC_SEND_QUIT_BIT (1 << 3)
 
+#define MAX_CANDIDATE_RECORD (32)
+#define EARLY_CACHE_DURATION (1000)
+
+#define SETUP_WAIT_CONNECT (1 << 0)
+#define SETUP_WAIT_SEND    (1 << 1)
+#define SETUP_WAIT_RECV    (1 << 2)
+#define SETUP_WAIT_ALL     (SETUP_WAIT_CONNECT | SETUP_WAIT_SEND | SETUP_WAIT_RECV)
+
 #define SET_WAIT_BITS(bit) media_lib_event_group_set_bits(rtc->wait_event, bit)
 #define WAIT_FOR_BITS(bit)                                                          \
     media_lib_event_group_wait_bits(rtc->wait_event, bit, MEDIA_LIB_MAX_LOCK_TIME); \
     media_lib_event_group_clr_bits(rtc->wait_event, bit)
 
+typedef struct {
+    uint32_t hash[MAX_CANDIDATE_RECORD];
+    uint8_t  num;
+} candidate_record_t;
+
+typedef struct early_frame_t {
+    struct early_frame_t *next;
+    uint32_t              pts;
+    int                   size;
+} early_frame_t;
+
 typedef struct {
     esp_webrtc_cfg_t             rtc_cfg;
     esp_peer_handle_t            pc;
@@ -73,6 +98,7 @@ typedef struct {
     bool                          send_going;
     esp_webrtc_media_provider_t   media_provider;
     esp_capture_path_handle_t     capture_path;
+    esp_capture_path_handle_t     simulcast_path;
     esp_codec_dev_handle_t        play_handle;
     esp_peer_audio_stream_info_t  recv_aud_info;
     esp_peer_video_stream_info_t  recv_vid_info;
@@ -80,9 +106,36 @@ typedef struct {
     esp_peer_signaling_ice_info_t ice_info;
     bool                          ice_info_loaded;
     bool                          signaling_connected;
+    // Fast reconnect: capture keeps running while main peer is rebuilt
+    bool                          media_hold;
+    bool                          keep_render;
+    bool                          resume_pending;
+    bool                          restart_pending;
+    int64_t                       lost_time;
+    esp_webrtc_reconnect_stat_t   reconnect_stat;
+    // Connection setup: early capture start and trickle candidate deduplication
+    bool                          early_start_pending;
+    bool                          early_hold;
+    // Latest GOP captured while connecting, only accessed from send task
+    bool                          early_draining;
+    bool                          wait_key_start;
+    early_frame_t                *early_frames;
+    early_frame_t                *early_tail;
+    // Setup statistics are updated from send task, peer callbacks and caller thread, guarded by `stat_lock`
+    media_lib_mutex_handle_t      stat_lock;
+    uint8_t                       setup_wait;
+    int64_t                       offer_time;
+    esp_webrtc_setup_stat_t       setup_stat;
+    candidate_record_t            local_cand;
+    candidate_record_t            remote_cand;
 
     uint8_t *aud_fifo;
     uint32_t aud_fifo_size;
+
+    video_dc_sender_handle_t   vdc_sender;
+    video_dc_receiver_handle_t vdc_recv;
+    uint32_t                   vid_skip_num;
+    media_fanout_handle_t      fanout;
     // For debug only
     uint32_t vid_send_pts;
     uint32_t aud_send_pts;
@@ -101,6 +154,320 @@ static const char *TAG = "webrtc";
 
 bool webrtc_tracing = false;
 
+static bool is_video_key_frame(esp_peer_video_codec_t codec, uint8_t *data, int size)
+{
+    if (codec != ESP_PEER_VIDEO_CODEC_H264) {
+        // MJPEG frames are all independent
+        return true;
+    }
+    for (int i = 0; i + 3 < size; i++) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) {
+            uint8_t nal_type = data[i + 3] & 0x1F;
+            if (nal_type == 5 || nal_type == 7) {
+                return true;
+            }
+            if (nal_type == 1) {
+                return false;
+            }
+            i += 2;
+        }
+    }
+    return false;
+}
+
+static uint8_t get_h264_temporal_id(uint8_t *data, int size)
+{
+    for (int i = 0; i + 3 < size; i++) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) {
+            uint8_t nal_type = data[i + 3] & 0x1F;
+            if (nal_type == 1 || nal_type == 5) {
+                // Non-reference slice (nal_ref_idc 0), only emitted by encoders configured with temporal layers
+                return (data[i + 3] & 0x60) ? 0 : 1;
+            }
+            i += 2;
+        }
+    }
+    return 0;
+}
+
+static void fanout_send_video(webrtc_t *rtc, uint8_t layer, esp_capture_stream_frame_t *video_frame)
+{
+    esp_peer_video_codec_t codec = rtc->rtc_cfg.peer_cfg.video_info.codec;
+    media_fanout_frame_t fanout_frame = {
+        .type = MEDIA_FANOUT_FRAME_VIDEO,
+        .key_frame = is_video_key_frame(codec, video_frame->data, video_frame->size),
+        .layer = layer,
+        .pts = video_frame->pts,
+        .data = video_frame->data,
+        .size = video_frame->size,
+    };
+    // H264 key frame is always in base layer, other codecs carry no temporal layer information
+    if (fanout_frame.key_frame == false && codec == ESP_PEER_VIDEO_CODEC_H264) {
+        fanout_frame.temporal_id = get_h264_temporal_id(video_frame->data, video_frame->size);
+    }
+    media_fanout_send(rtc->fanout, &fanout_frame);
+    // Joined viewer or viewer which dropped referenced frames can only resume from key frame
+    uint8_t key_request = media_fanout_get_key_request(rtc->fanout);
+    if (key_request & (1 << 0)) {
+        esp_capture_request_key_frame(rtc->capture_path);
+    }
+    if ((key_request & (1 << 1)) && rtc->simulcast_path) {
+        esp_capture_request_key_frame(rtc->simulcast_path);
+    }
+}
+
+static int video_dc_send(uint8_t *data, int size, void *ctx)
+{
+    webrtc_t *rtc = (webrtc_t *)ctx;
+    esp_peer_data_frame_t data_frame = {
+        .type = ESP_PEER_DATA_CHANNEL_DATA,
+        .data = data,
+        .size = size,
+    };
+    return esp_peer_send_data(rtc->pc, &data_frame);
+}
+
+static int send_video_over_data_channel(webrtc_t *rtc, esp_capture_stream_frame_t *video_frame)
+{
+    if (rtc->vdc_sender == NULL) {
+        esp_peer_data_frame_t data_frame = {
+            .type = ESP_PEER_DATA_CHANNEL_DATA,
+            .data = video_frame->data,
+            .size = video_frame->size,
+        };
+        return esp_peer_send_data(rtc->pc, &data_frame);
+    }
+    video_dc_frame_t frame = {
+        .pts = video_frame->pts,
+        .key_frame = is_video_key_frame(rtc->rtc_cfg.peer_cfg.video_info.codec, video_frame->data, video_frame->size),
+        .data = video_frame->data,
+        .size = video_frame->size,
+    };
+    return video_dc_sender_send(rtc->vdc_sender, &frame, video_dc_send, rtc);
+}
+
+static void media_resumed(webrtc_t *rtc)
+{
+    esp_webrtc_reconnect_stat_t *stat = &rtc->reconnect_stat;
+    rtc->resume_pending = false;
+    // Stream information of rebuilt connection is reported before connected, later changes need render setup again
+    rtc->keep_render = false;
+    stat->reconnect_count++;
+    stat->last_resume_ms = (uint32_t)((esp_timer_get_time() - rtc->lost_time) / 1000);
+    if (stat->last_resume_ms > stat->max_resume_ms) {
+        stat->max_resume_ms = stat->last_resume_ms;
+    }
+    ESP_LOGI(TAG, "Media resumed %dms after connection lost", (int)stat->last_resume_ms);
+}
+
+static void setup_begin(webrtc_t *rtc)
+{
+    media_lib_mutex_lock(rtc->stat_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    // Both offer and answer go through here, count from whichever comes first
+    if (rtc->setup_wait == 0) {
+        memset(&rtc->setup_stat, 0, sizeof(esp_webrtc_setup_stat_t));
+        rtc->setup_wait = SETUP_WAIT_ALL;
+        rtc->offer_time = esp_timer_get_time();
+    }
+    media_lib_mutex_unlock(rtc->stat_lock);
+}
+
+static void setup_cancel(webrtc_t *rtc)
+{
+    media_lib_mutex_lock(rtc->stat_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    rtc->setup_wait = 0;
+    media_lib_mutex_unlock(rtc->stat_lock);
+}
+
+static void setup_count(webrtc_t *rtc, uint16_t *counter)
+{
+    media_lib_mutex_lock(rtc->stat_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    (*counter)++;
+    media_lib_mutex_unlock(rtc->stat_lock);
+}
+
+static void setup_reached(webrtc_t *rtc, uint8_t step)
+{
+    media_lib_mutex_lock(rtc->stat_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if ((rtc->setup_wait & step) == 0) {
+        media_lib_mutex_unlock(rtc->stat_lock);
+        return;
+    }
+    rtc->setup_wait &= ~step;
+    uint32_t elapse = (uint32_t)((esp_timer_get_time() - rtc->offer_time) / 1000);
+    if (step == SETUP_WAIT_CONNECT) {
+        rtc->setup_stat.connect_ms = elapse;
+    } else if (step == SETUP_WAIT_SEND) {
+        rtc->setup_stat.first_send_ms = elapse;
+    } else {
+        rtc->setup_stat.first_recv_ms = elapse;
+    }
+    media_lib_mutex_unlock(rtc->stat_lock);
+    if (step == SETUP_WAIT_CONNECT) {
+        ESP_LOGI(TAG, "Connected %dms after offer", (int)elapse);
+    } else if (step == SETUP_WAIT_SEND) {
+        ESP_LOGI(TAG, "First frame sent %dms after offer", (int)elapse);
+    } else {
+        ESP_LOGI(TAG, "First frame received %dms after offer", (int)elapse);
+    }
+}
+
+static void trim_candidate(const char **cand, int *size)
+{
+    const char *s = *cand;
+    int n = *size;
+    if (n > 2 && s[0] == 'a' && s[1] == '=') {
+        s += 2;
+        n -= 2;
+    }
+    while (n > 0 && (s[n - 1] == '\r' || s[n - 1] == '\n' || s[n - 1] == ' ' || s[n - 1] == '\0')) {
+        n--;
+    }
+    *cand = s;
+    *size = n;
+}
+
+static bool record_candidate(candidate_record_t *record, const char *cand, int size)
+{
+    trim_candidate(&cand, &size);
+    // FNV-1a hash, collision among few candidates of one session is negligible
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < size; i++) {
+        hash ^= (uint8_t)cand[i];
+        hash *= 16777619u;
+    }
+    for (int i = 0; i < record->num; i++) {
+        if (record->hash[i] == hash) {
+            return false;
+        }
+    }
+    // Record full, let candidate go and rely on peer to ignore duplication
+    if (record->num < MAX_CANDIDATE_RECORD) {
+        record->hash[record->num++] = hash;
+    }
+    return true;
+}
+
+static void record_sdp_candidates(candidate_record_t *record, const char *sdp)
+{
+    const char *line = sdp;
+    while (line && *line) {
+        const char *end = strpbrk(line, "\r\n");
+        int size = end ? (int)(end - line) : (int)strlen(line);
+        if (STR_SAME(line, "a=candidate:")) {
+            record_candidate(record, line, size);
+        }
+        line = end ? end + 1 : NULL;
+    }
+}
+
+static void send_main_video(webrtc_t *rtc, esp_capture_stream_frame_t *video_frame)
+{
+    setup_reached(rtc, SETUP_WAIT_SEND);
+    if (rtc->resume_pending &&
+        is_video_key_frame(rtc->rtc_cfg.peer_cfg.video_info.codec, video_frame->data, video_frame->size)) {
+        media_resumed(rtc);
+    }
+    if (rtc->rtc_cfg.peer_cfg.enable_data_channel && rtc->rtc_cfg.peer_cfg.video_over_data_channel) {
+        send_video_over_data_channel(rtc, video_frame);
+    } else {
+        esp_peer_video_frame_t video_send_frame = {
+            .pts = video_frame->pts,
+            .data = video_frame->data,
+            .size = video_frame->size,
+        };
+        // Call the video send callback if provided (for SEI injection, etc.)
+        bool should_send = true;
+        if (rtc->rtc_cfg.peer_cfg.on_video_send) {
+            uint8_t *modified_data = rtc->rtc_cfg.peer_cfg.on_video_send(&video_send_frame, rtc->rtc_cfg.peer_cfg.ctx);
+            if (modified_data == NULL) {
+                // Callback returned NULL - drop the frame
+                should_send = false;
+            } else if (modified_data != video_send_frame.data) {
+                // Callback returned modified data - create a copy of the frame info
+                // to avoid modifying the original capture frame
+                video_send_frame.data = modified_data;
+                // Size might have changed - callback should update video_send_frame.size if needed
+            }
+            // If modified_data == video_send_frame.data, the original frame will be used
+        }
+                
+        if (should_send) {
+            esp_peer_send_video(rtc->pc, &video_send_frame);
+        }
+    }
+    rtc->vid_send_pts = video_frame->pts;
+    rtc->vid_send_num++;
+    rtc->vid_send_size += video_frame->size;
+    if (webrtc_tracing) {
+        printf("V\n");
+    }
+}
+
+static void free_early_frames(webrtc_t *rtc)
+{
+    while (rtc->early_frames) {
+        early_frame_t *frame = rtc->early_frames;
+        rtc->early_frames = frame->next;
+        free(frame);
+    }
+    rtc->early_tail = NULL;
+}
+
+static void cache_early_video(webrtc_t *rtc, esp_capture_stream_frame_t *video_frame)
+{
+    rtc->early_draining = true;
+    if (is_video_key_frame(rtc->rtc_cfg.peer_cfg.video_info.codec, video_frame->data, video_frame->size)) {
+        // Decoding only needs frames since latest key frame
+        free_early_frames(rtc);
+    } else if (rtc->early_frames == NULL) {
+        return;
+    } else if (video_frame->pts - rtc->early_frames->pts > EARLY_CACHE_DURATION) {
+        // Connecting takes long, sending such stale GOP adds latency, wait for next key frame instead
+        free_early_frames(rtc);
+        return;
+    }
+    early_frame_t *frame = (early_frame_t *)malloc(sizeof(early_frame_t) + video_frame->size);
+    if (frame == NULL) {
+        // Broken GOP can not be decoded
+        free_early_frames(rtc);
+        return;
+    }
+    frame->next = NULL;
+    frame->pts = video_frame->pts;
+    frame->size = video_frame->size;
+    memcpy(frame + 1, video_frame->data, video_frame->size);
+    if (rtc->early_tail) {
+        rtc->early_tail->next = frame;
+    } else {
+        rtc->early_frames = frame;
+    }
+    rtc->early_tail = frame;
+}
+
+static void send_early_video(webrtc_t *rtc)
+{
+    rtc->early_draining = false;
+    if (rtc->early_frames == NULL) {
+        // No usable GOP kept, restart from key frame as last resort
+        rtc->wait_key_start = true;
+        esp_capture_request_key_frame(rtc->capture_path);
+        return;
+    }
+    ESP_LOGI(TAG, "Send from key frame captured %dms ago",
+             (int)(rtc->early_tail->pts - rtc->early_frames->pts));
+    for (early_frame_t *frame = rtc->early_frames; frame; frame = frame->next) {
+        esp_capture_stream_frame_t video_frame = {
+            .stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO,
+            .pts = frame->pts,
+            .data = (uint8_t *)(frame + 1),
+            .size = frame->size,
+        };
+        send_main_video(rtc, &video_frame);
+    }
+    free_early_frames(rtc);
+}
+
 static void _media_send(void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
@@ -115,7 +482,23 @@ static void _media_send(void *ctx)
                 .data = audio_frame.data,
                 .size = audio_frame.size,
             };
-            esp_peer_send_audio(rtc->pc, &audio_send_frame);
+            // Audio captured while connecting is dropped, it has no dependency on earlier frames
+            if (rtc->media_hold == false && rtc->early_hold == false) {
+                esp_peer_send_audio(rtc->pc, &audio_send_frame);
+                setup_reached(rtc, SETUP_WAIT_SEND);
+                if (rtc->resume_pending && rtc->rtc_cfg.peer_cfg.video_info.codec == ESP_PEER_VIDEO_CODEC_NONE) {
+                    media_resumed(rtc);
+                }
+            }
+            if (rtc->fanout) {
+                media_fanout_frame_t fanout_frame = {
+                    .type = MEDIA_FANOUT_FRAME_AUDIO,
+                    .pts = audio_frame.pts,
+                    .data = audio_frame.data,
+                    .size = audio_frame.size,
+                };
+                media_fanout_send(rtc->fanout, &fanout_frame);
+            }
             esp_capture_release_path_frame(rtc->capture_path, &audio_frame);
             rtc->aud_send_pts = audio_frame.pts;
             rtc->aud_send_num++;
@@ -130,46 +513,54 @@ static void _media_send(void *ctx)
             .stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO,
         };
         int ret = esp_capture_acquire_path_frame(rtc->capture_path, &video_frame, true);
-        if (ret == ESP_CAPTURE_ERR_OK) {
-            if (rtc->rtc_cfg.peer_cfg.enable_data_channel && rtc->rtc_cfg.peer_cfg.video_over_data_channel) {
-                esp_peer_data_frame_t data_frame = {
-                    .type = ESP_PEER_DATA_CHANNEL_DATA,
-                    .data = video_frame.data,
-                    .size = video_frame.size,
-                };
-                esp_peer_send_data(rtc->pc, &data_frame);
-            } else {
-                esp_peer_video_frame_t video_send_frame = {
-                    .pts = video_frame.pts,
-                    .data = video_frame.data,
-                    .size = video_frame.size,
-                };
-                // Call the video send callback if provided (for SEI injection, etc.)
-                bool should_send = true;
-                if (rtc->rtc_cfg.peer_cfg.on_video_send) {
-                    uint8_t *modified_data = rtc->rtc_cfg.peer_cfg.on_video_send(&video_send_frame, rtc->rtc_cfg.peer_cfg.ctx);
-                    if (modified_data == NULL) {
-                        // Callback returned NULL - drop the frame
-                        should_send = false;
-                    } else if (modified_data != video_send_frame.data) {
-                        // Callback returned modified data - create a copy of the frame info
-                        // to avoid modifying the original capture frame
-                        video_send_frame.data = modified_data;
-                        // Size might have changed - callback should update video_send_frame.size if needed
-                    }
-                    // If modified_data == video_send_frame.data, the original frame will be used
-                }
-                
-                if (should_send) {
-                    esp_peer_send_video(rtc->pc, &video_send_frame);
-                }
+        if (ret == ESP_CAPTURE_ERR_OK && rtc->vdc_sender && rtc->rtc_cfg.peer_cfg.video_info.codec == ESP_PEER_VIDEO_CODEC_MJPEG) {
+            // Send latest frame only when data channel backs up so that latency keep bounded
+            esp_capture_stream_frame_t newer_frame = {
+                .stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO,
+            };
+            while (esp_capture_acquire_path_frame(rtc->capture_path, &newer_frame, true) == ESP_CAPTURE_ERR_OK) {
+                esp_capture_release_path_frame(rtc->capture_path, &video_frame);
+                video_frame = newer_frame;
+                rtc->vid_skip_num++;
+            }
+        }
+        if (rtc->early_hold == false && rtc->media_hold == false && rtc->early_draining) {
+            // Just connected, frames kept while connecting go first
+            send_early_video(rtc);
+        }
+        if (ret == ESP_CAPTURE_ERR_OK && rtc->early_hold) {
+            // Connecting, keep encoder running and drain it
+            cache_early_video(rtc, &video_frame);
+            if (rtc->fanout) {
+                fanout_send_video(rtc, 0, &video_frame);
             }
             esp_capture_release_path_frame(rtc->capture_path, &video_frame);
-            rtc->vid_send_pts = video_frame.pts;
-            rtc->vid_send_num++;
-            rtc->vid_send_size += video_frame.size;
-            if (webrtc_tracing) {
-                printf("V\n");
+        } else if (ret == ESP_CAPTURE_ERR_OK && rtc->media_hold) {
+            // Main peer is reconnecting, extra viewers still get the frame
+            if (rtc->fanout) {
+                fanout_send_video(rtc, 0, &video_frame);
+            }
+            esp_capture_release_path_frame(rtc->capture_path, &video_frame);
+        } else if (ret == ESP_CAPTURE_ERR_OK) {
+            if (rtc->wait_key_start &&
+                is_video_key_frame(rtc->rtc_cfg.peer_cfg.video_info.codec, video_frame.data, video_frame.size)) {
+                rtc->wait_key_start = false;
+            }
+            if (rtc->wait_key_start == false) {
+                send_main_video(rtc, &video_frame);
+            }
+            if (rtc->fanout) {
+                fanout_send_video(rtc, 0, &video_frame);
+            }
+            esp_capture_release_path_frame(rtc->capture_path, &video_frame);
+        }
+        if (rtc->simulcast_path) {
+            // Simulcast layer goes to extra viewers only, keep draining it when no viewer
+            while (esp_capture_acquire_path_frame(rtc->simulcast_path, &video_frame, true) == ESP_CAPTURE_ERR_OK) {
+                if (rtc->fanout) {
+                    fanout_send_video(rtc, 1, &video_frame);
+                }
+                esp_capture_release_path_frame(rtc->simulcast_path, &video_frame);
             }
         }
     }
@@ -195,6 +586,7 @@ static int start_stream(webrtc_t *rtc)
         ret = media_lib_thread_create_from_scheduler(&handle, "pc_send", media_send_task, rtc);
         if (ret != 0) {
             rtc->send_going = false;
+            esp_capture_stop(rtc->media_provider.capture);
         }
     } else {
         ESP_LOGE(TAG, "Fail to start capture ret:%d", ret);
@@ -202,17 +594,85 @@ static int start_stream(webrtc_t *rtc)
     return ret;
 }
 
+static void prestart_capture(webrtc_t *rtc)
+{
+    if (rtc->send_going) {
+        return;
+    }
+    // Send task drains encoder while connecting so that no restart is needed once connected
+    rtc->early_hold = true;
+    int ret = start_stream(rtc);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGW(TAG, "Fail to start capture early ret:%d", ret);
+        rtc->early_hold = false;
+        return;
+    }
+    ESP_LOGI(TAG, "Capture started before connected");
+}
+
+static bool fast_reconnect_enabled(webrtc_t *rtc)
+{
+    return rtc->rtc_cfg.peer_cfg.fast_reconnect && rtc->rtc_cfg.peer_cfg.no_auto_reconnect == false;
+}
+
+static bool hold_stream(webrtc_t *rtc)
+{
+    // Never connected when still holding early media, nothing to resume
+    if (rtc->send_going == false || rtc->early_hold) {
+        return false;
+    }
+    if (rtc->media_hold == false) {
+        ESP_LOGI(TAG, "Hold stream for reconnect");
+        rtc->media_hold = true;
+        rtc->resume_pending = false;
+        rtc->keep_render = true;
+        rtc->lost_time = esp_timer_get_time();
+        // Measure setup of the rebuilt connection
+        setup_cancel(rtc);
+    }
+    return true;
+}
+
+static void resume_stream(webrtc_t *rtc)
+{
+    rtc->media_hold = false;
+    rtc->resume_pending = true;
+    // Remote decoder lost its reference, do not wait for next GOP
+    if (rtc->rtc_cfg.peer_cfg.video_info.codec != ESP_PEER_VIDEO_CODEC_NONE && rtc->capture_path) {
+        int ret = esp_capture_request_key_frame(rtc->capture_path);
+        if (ret != ESP_CAPTURE_ERR_OK) {
+            ESP_LOGW(TAG, "Key frame request not supported ret %d, wait for next key frame", ret);
+        }
+    }
+}
+
 static int stop_stream(webrtc_t *rtc)
 {
+    rtc->media_hold = false;
+    rtc->resume_pending = false;
+    rtc->keep_render = false;
     if (rtc->send_going) {
         rtc->send_going = false;
         WAIT_FOR_BITS(PC_SEND_QUIT_BIT);
     }
     esp_capture_stop(rtc->media_provider.capture);
+    rtc->early_start_pending = false;
+    rtc->early_hold = false;
+    rtc->early_draining = false;
+    rtc->wait_key_start = false;
+    free_early_frames(rtc);
+    setup_cancel(rtc);
     av_render_reset(rtc->play_handle);
     return 0;
 }
 
+static int new_session(webrtc_t *rtc)
+{
+    // Remote candidates may come before remote SDP (e.g. doorbell server), so forget them here instead of on SDP
+    rtc->remote_cand.num = 0;
+    return esp_peer_new_connection(rtc->pc);
+}
+
 static void pc_notify_app(webrtc_t *rtc, esp_webrtc_event_type_t event_type)
 {
     esp_webrtc_event_t event = {
@@ -235,12 +695,31 @@ static int pc_on_state(esp_peer_state_t state, void *ctx)
     }
 
     if (state == ESP_PEER_STATE_CONNECTED) {
-        start_stream(rtc);
+        setup_reached(rtc, SETUP_WAIT_CONNECT);
+        if (rtc->media_hold) {
+            resume_stream(rtc);
+        } else if (rtc->early_hold) {
+            // Send task starts from kept key frame, encoder is not restarted
+            rtc->early_hold = false;
+        } else {
+            start_stream(rtc);
+        }
         pc_notify_app(rtc, ESP_WEBRTC_EVENT_CONNECTED);
     } else if (state == ESP_PEER_STATE_DISCONNECTED) {
-        stop_stream(rtc);
+        if (fast_reconnect_enabled(rtc) && hold_stream(rtc)) {
+            // Connection lost without BYE (e.g. network roam), restart ICE from main loop
+            rtc->restart_pending = true;
+        } else {
+            stop_stream(rtc);
+        }
         pc_notify_app(rtc, ESP_WEBRTC_EVENT_DISCONNECTED);
     } else if (state == ESP_PEER_STATE_CONNECT_FAILED) {
+        setup_cancel(rtc);
+        rtc->early_start_pending = false;
+        if (rtc->early_hold) {
+            // Capture started early but no connection to feed
+            stop_stream(rtc);
+        }
         // Run in mainloop task
         pc_notify_app(rtc, ESP_WEBRTC_EVENT_CONNECT_FAILED);
     } else if (state == ESP_PEER_STATE_DATA_CHANNEL_CONNECTED) {
@@ -258,10 +737,62 @@ static int pc_on_state(esp_peer_state_t state, void *ctx)
 static int pc_on_msg(esp_peer_msg_t *info, void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
+    if (info->type == ESP_PEER_MSG_TYPE_SDP) {
+        setup_begin(rtc);
+        // Candidates carried in SDP need not trickle again
+        rtc->local_cand.num = 0;
+        record_sdp_candidates(&rtc->local_cand, (char *)info->data);
+    } else if (info->type == ESP_PEER_MSG_TYPE_CANDIDATE) {
+        if (record_candidate(&rtc->local_cand, (char *)info->data, info->size) == false) {
+            setup_count(rtc, &rtc->setup_stat.dup_candidates);
+            return ESP_PEER_ERR_NONE;
+        }
+        setup_count(rtc, &rtc->setup_stat.local_candidates);
+    }
     ESP_LOGI(TAG, "Send client sdp: %s\n", info->data);
     return esp_peer_signaling_send_msg(rtc->signaling, (esp_peer_signaling_msg_t *)info);
 }
 
+static void pc_wait_for_event(webrtc_t *rtc)
+{
+    esp_peer_wait_info_t info = {};
+    if (esp_peer_get_wait_info(rtc->pc, &info) != ESP_PEER_ERR_NONE) {
+        media_lib_thread_sleep(PC_POLL_INTERVAL);
+        return;
+    }
+    if (info.timeout_ms == 0) {
+        return;
+    }
+    // Wake up periodically so that pause and stop request can be handled in time
+    uint32_t timeout = MIN(info.timeout_ms, PC_MAX_WAIT_INTERVAL);
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    int max_fd = -1;
+    for (int i = 0; i < info.fd_num && i < ESP_PEER_MAX_WAIT_FD; i++) {
+        if (info.fds[i] >= 0) {
+            FD_SET(info.fds[i], &read_set);
+            max_fd = MAX(max_fd, info.fds[i]);
+        }
+    }
+    if (max_fd < 0) {
+        if (info.wake_sema) {
+            // Realization gives semaphore when new work queued, wake up at once instead of at next poll
+            media_lib_sema_lock((media_lib_sema_handle_t)info.wake_sema, timeout);
+        } else {
+            media_lib_thread_sleep(timeout);
+        }
+        return;
+    }
+    media_lib_timeval tv = {
+        .tv_sec = timeout / 1000,
+        .tv_usec = (timeout % 1000) * 1000,
+    };
+    if (media_lib_socket_select(max_fd + 1, &read_set, NULL, NULL, &tv) < 0) {
+        // Socket may be closed during disconnect, avoid busy loop
+        media_lib_thread_sleep(PC_POLL_INTERVAL);
+    }
+}
+
 static void pc_task(void *arg)
 {
     webrtc_t *rtc = (webrtc_t *)arg;
@@ -272,8 +803,17 @@ static void pc_task(void *arg)
             WAIT_FOR_BITS(PC_RESUME_BIT);
             continue;
         }
+        if (rtc->restart_pending) {
+            rtc->restart_pending = false;
+            ESP_LOGI(TAG, "Restart ICE");
+            new_session(rtc);
+        }
+        if (rtc->early_start_pending) {
+            rtc->early_start_pending = false;
+            prestart_capture(rtc);
+        }
         esp_peer_main_loop(rtc->pc);
-        media_lib_thread_sleep(10);
+        pc_wait_for_event(rtc);
     }
     SET_WAIT_BITS(PC_EXIT_BIT);
     media_lib_thread_destroy(NULL);
@@ -301,10 +841,15 @@ static void convert_dec_vid_info(esp_peer_video_stream_info_t *info, av_render_v
 static int pc_on_video_info(esp_peer_video_stream_info_t *info, void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
+    if (rtc->keep_render && info->codec == rtc->recv_vid_info.codec && info->width == rtc->recv_vid_info.width &&
+        info->height == rtc->recv_vid_info.height && info->fps == rtc->recv_vid_info.fps) {
+        // Decoder kept across reconnect, no need to recreate
+        return 0;
+    }
     av_render_video_info_t video_info = {};
     convert_dec_vid_info(info, &video_info);
     av_render_add_video_stream(rtc->play_handle, &video_info);
-    rtc->recv_vid_info.codec = info->codec;
+    rtc->recv_vid_info = *info;
     return 0;
 }
 
@@ -337,6 +882,10 @@ static void convert_dec_aud_info(esp_peer_audio_stream_info_t *info, av_render_a
 static int pc_on_audio_info(esp_peer_audio_stream_info_t *info, void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
+    if (rtc->keep_render && info->codec == rtc->recv_aud_info.codec &&
+        info->sample_rate == rtc->recv_aud_info.sample_rate && info->channel == rtc->recv_aud_info.channel) {
+        return 0;
+    }
     rtc->recv_aud_info = *info;
     av_render_audio_info_t audio_info = {};
     convert_dec_aud_info(info, &audio_info);
@@ -352,6 +901,7 @@ static int pc_on_audio_data(esp_peer_audio_frame_t *info, void *ctx)
     if (rtc->running == false || rtc->recv_aud_info.codec == ESP_PEER_AUDIO_CODEC_NONE) {
         return 0;
     }
+    setup_reached(rtc, SETUP_WAIT_RECV);
     rtc->aud_recv_pts = info->pts;
     rtc->aud_recv_num++;
     rtc->aud_recv_size += info->size;
@@ -370,6 +920,7 @@ static int pc_on_video_data(esp_peer_video_frame_t *info, void *ctx)
     if (rtc->running == false) {
         return 0;
     }
+    setup_reached(rtc, SETUP_WAIT_RECV);
     rtc->vid_recv_num++;
     rtc->vid_recv_size += info->size;
     av_render_video_data_t video_data = {
@@ -381,6 +932,19 @@ static int pc_on_video_data(esp_peer_video_frame_t *info, void *ctx)
     return 0;
 }
 
+static int pc_on_video_dc_frame(video_dc_frame_t *frame, void *ctx)
+{
+    webrtc_t *rtc = (webrtc_t *)ctx;
+    setup_reached(rtc, SETUP_WAIT_RECV);
+    av_render_video_data_t video_data = {
+        .pts = frame->pts,
+        .data = frame->data,
+        .size = frame->size,
+    };
+    av_render_add_video_data(rtc->play_handle, &video_data);
+    return 0;
+}
+
 static int pc_on_data(esp_peer_data_frame_t *frame, void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
@@ -404,6 +968,11 @@ static int pc_on_data(esp_peer_data_frame_t *frame, void *ctx)
         convert_dec_vid_info(&rtc->recv_vid_info, &video_info);
         av_render_add_video_stream(rtc->play_handle, &video_info);
     }
+    if (rtc->vdc_recv &&
+        video_dc_receiver_feed(rtc->vdc_recv, frame->data, frame->size, pc_on_video_dc_frame, rtc) != ESP_PEER_ERR_NOT_SUPPORT) {
+        return 0;
+    }
+    // Peer send raw frame without framing
     av_render_video_data_t video_data = {
         .data = frame->data,
         .size = frame->size,
@@ -505,6 +1074,14 @@ static int pc_close(webrtc_t *rtc)
         esp_peer_close(rtc->pc);
         rtc->pc = NULL;
     }
+    if (rtc->vdc_sender) {
+        video_dc_sender_close(rtc->vdc_sender);
+        rtc->vdc_sender = NULL;
+    }
+    if (rtc->vdc_recv) {
+        video_dc_receiver_close(rtc->vdc_recv);
+        rtc->vdc_recv = NULL;
+    }
     if (rtc->wait_event) {
         media_lib_event_group_destroy(rtc->wait_event);
         rtc->wait_event = NULL;
@@ -530,6 +1107,35 @@ static int pc_on_channel_close(esp_peer_data_channel_info_t *ch, void *ctx)
     return 0;
 }
 
+static void setup_simulcast_path(webrtc_t *rtc, esp_capture_sink_cfg_t *primary_cfg)
+{
+    esp_peer_video_stream_info_t *low_info = &rtc->rtc_cfg.peer_cfg.simulcast_info;
+    rtc->simulcast_path = NULL;
+    if (low_info->width == 0 || low_info->height == 0 || primary_cfg->video_info.codec == ESP_CAPTURE_CODEC_TYPE_NONE ||
+        (rtc->rtc_cfg.peer_cfg.enable_data_channel && rtc->rtc_cfg.peer_cfg.video_over_data_channel)) {
+        return;
+    }
+    esp_capture_sink_cfg_t sink_cfg = {
+        .video_info = primary_cfg->video_info,
+    };
+    sink_cfg.video_info.width = low_info->width;
+    sink_cfg.video_info.height = low_info->height;
+    if (low_info->fps) {
+        sink_cfg.video_info.fps = low_info->fps;
+    }
+    int ret = esp_capture_setup_path(rtc->media_provider.capture, ESP_CAPTURE_PATH_SECONDARY, &sink_cfg, &rtc->simulcast_path);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        // Capture path may have primary path only (e.g. simple path without secondary encoder), viewers then get `video_info` stream only
+        ESP_LOGW(TAG, "Simulcast layer %dx%d not supported ret %d", (int)low_info->width, (int)low_info->height, ret);
+        rtc->simulcast_path = NULL;
+    } else {
+        esp_capture_enable_path(rtc->simulcast_path, ESP_CAPTURE_RUN_TYPE_ALWAYS);
+    }
+    if (rtc->fanout) {
+        media_fanout_set_video_layers(rtc->fanout, rtc->simulcast_path ? 2 : 1);
+    }
+}
+
 static int pc_start(webrtc_t *rtc, esp_peer_ice_server_cfg_t *server_info, int server_num)
 {
     if (rtc->pc) {
@@ -562,7 +1168,16 @@ static int pc_start(webrtc_t *rtc, esp_peer_ice_server_cfg_t *server_info, int s
     if (rtc->rtc_cfg.peer_cfg.enable_data_channel == false || rtc->rtc_cfg.peer_cfg.video_over_data_channel == false) {
         memcpy(&peer_cfg.video_info, &rtc->rtc_cfg.peer_cfg.video_info, sizeof(esp_peer_video_stream_info_t));
     }
-    int ret = esp_peer_open(&peer_cfg, esp_peer_get_default_impl(), &rtc->pc);
+    if (rtc->rtc_cfg.peer_cfg.enable_data_channel && rtc->rtc_cfg.peer_cfg.video_over_data_channel &&
+        rtc->rtc_cfg.peer_cfg.video_dc_framing) {
+        rtc->vdc_sender = video_dc_sender_open(rtc->rtc_cfg.peer_cfg.video_dc_frag_size);
+        rtc->vdc_recv = video_dc_receiver_open();
+        if (rtc->vdc_sender == NULL || rtc->vdc_recv == NULL) {
+            ESP_LOGE(TAG, "No memory for video over data channel");
+            return ESP_PEER_ERR_NO_MEM;
+        }
+    }
+    int ret = esp_peer_open(&peer_cfg, rtc->rtc_cfg.peer_impl, &rtc->pc);
     if (ret != ESP_PEER_ERR_NONE) {
         ESP_LOGE(TAG, "Fail to open peer ret %d", ret);
         return ret;
@@ -600,6 +1215,7 @@ static int pc_start(webrtc_t *rtc, esp_peer_ice_server_cfg_t *server_info, int s
     }
     esp_capture_setup_path(rtc->media_provider.capture, ESP_CAPTURE_PATH_PRIMARY, &sink_cfg, &rtc->capture_path);
     esp_capture_enable_path(rtc->capture_path, ESP_CAPTURE_RUN_TYPE_ALWAYS);
+    setup_simulcast_path(rtc, &sink_cfg);
     return ret;
 }
 
@@ -637,11 +1253,52 @@ static int signal_connected(void *ctx)
     }
     if (rtc->pc) {
         // Create offer so that fetch ice candidate
-        esp_peer_new_connection(rtc->pc);
+        new_session(rtc);
     }
     return 0;
 }
 
+static int send_remote_candidates(webrtc_t *rtc, char *cand, int size)
+{
+    // One message may carry a batch of candidates one per line
+    int ret = ESP_PEER_ERR_NONE;
+    char *end = cand + size;
+    while (cand < end) {
+        char *line_end = cand;
+        while (line_end < end && *line_end != '\r' && *line_end != '\n') {
+            line_end++;
+        }
+        int line_size = (int)(line_end - cand);
+        if (line_size > 0 && *cand) {
+            if (record_candidate(&rtc->remote_cand, cand, line_size) == false) {
+                setup_count(rtc, &rtc->setup_stat.dup_candidates);
+            } else {
+                // Peer takes string, terminate line in place and restore after
+                char sep = line_end < end ? *line_end : 0;
+                if (line_end < end) {
+                    *line_end = 0;
+                }
+                esp_peer_msg_t peer_msg = {
+                    .type = ESP_PEER_MSG_TYPE_CANDIDATE,
+                    .data = (uint8_t *)cand,
+                    .size = line_size,
+                };
+                int err = esp_peer_send_msg(rtc->pc, &peer_msg);
+                if (line_end < end) {
+                    *line_end = sep;
+                }
+                if (err != ESP_PEER_ERR_NONE) {
+                    ret = err;
+                } else {
+                    setup_count(rtc, &rtc->setup_stat.remote_candidates);
+                }
+            }
+        }
+        cand = line_end + 1;
+    }
+    return ret;
+}
+
 static int signal_new_msg(esp_peer_signaling_msg_t *msg, void *ctx)
 {
     webrtc_t *rtc = (webrtc_t *)ctx;
@@ -655,11 +1312,16 @@ static int signal_new_msg(esp_peer_signaling_msg_t *msg, void *ctx)
                 WAIT_FOR_BITS(PC_PAUSED_BIT);
             }
             esp_peer_disconnect(rtc->pc);
-            rtc->recv_vid_info.codec = ESP_PEER_VIDEO_CODEC_NONE;
-            stop_stream(rtc);
+            if (fast_reconnect_enabled(rtc) && hold_stream(rtc)) {
+                ESP_LOGI(TAG, "Keep capture and render for fast reconnect");
+            } else {
+                rtc->recv_vid_info.codec = ESP_PEER_VIDEO_CODEC_NONE;
+                stop_stream(rtc);
+            }
             if (rtc->rtc_cfg.peer_cfg.no_auto_reconnect == false) {
-                // Reconnect
-                ret = esp_peer_new_connection(rtc->pc);
+                // Reconnect, new offer carries fresh ICE credentials
+                rtc->restart_pending = false;
+                ret = new_session(rtc);
                 if (rtc->pause) {
                     // resume main loop
                     rtc->pause = false;
@@ -681,13 +1343,22 @@ static int signal_new_msg(esp_peer_signaling_msg_t *msg, void *ctx)
             return 0;
         }
         char *sdp = (char *)msg->data;
+        if (msg->type == ESP_PEER_SIGNALING_MSG_CANDIDATE || STR_SAME(sdp, "candidate:")) {
+            return send_remote_candidates(rtc, sdp, msg->size);
+        }
         esp_peer_msg_t peer_msg = {
             .type = msg->type,
             .data = msg->data,
             .size = msg->size,
         };
-        if (STR_SAME(sdp, "candidate:")) {
-            peer_msg.type = ESP_PEER_MSG_TYPE_CANDIDATE;
+        if (msg->type == ESP_PEER_SIGNALING_MSG_SDP) {
+            setup_begin(rtc);
+            // Candidates carried in SDP need not trickle again
+            record_sdp_candidates(&rtc->remote_cand, sdp);
+            if (rtc->rtc_cfg.peer_cfg.early_media) {
+                // Start capture in main loop while ICE checks are going
+                rtc->early_start_pending = true;
+            }
         }
         return esp_peer_send_msg(rtc->pc, &peer_msg);
     }
@@ -711,6 +1382,11 @@ int esp_webrtc_open(esp_webrtc_cfg_t *cfg, esp_webrtc_handle_t *handle)
     if (rtc == NULL) {
         return ESP_PEER_ERR_NO_MEM;
     }
+    media_lib_mutex_create(&rtc->stat_lock);
+    if (rtc->stat_lock == NULL) {
+        free(rtc);
+        return ESP_PEER_ERR_NO_MEM;
+    }
     // TODO deep copy of other settings
     rtc->rtc_cfg = *cfg;
     rtc->rtc_cfg.peer_cfg.server_num = 0;
@@ -758,7 +1434,7 @@ int esp_webrtc_enable_peer_connection(esp_webrtc_handle_t handle, bool enable)
         }
         // Signaling already connected
         if (rtc->signaling_connected) {
-            ret = esp_peer_new_connection(rtc->pc);
+            ret = new_session(rtc);
             // Let mainloop resume
             if (rtc->pause) {
                 rtc->pause = false;
@@ -865,6 +1541,62 @@ int esp_webrtc_get_peer_connection(esp_webrtc_handle_t handle, esp_peer_handle_t
     return ESP_PEER_ERR_NONE;
 }
 
+int esp_webrtc_add_viewer(esp_webrtc_handle_t handle, esp_peer_handle_t peer, esp_webrtc_viewer_handle_t *viewer)
+{
+    if (handle == NULL || peer == NULL || viewer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    if (rtc->fanout == NULL) {
+        rtc->fanout = media_fanout_open(rtc->rtc_cfg.peer_cfg.viewer_queue_num);
+        if (rtc->fanout == NULL) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+        media_fanout_set_video_layers(rtc->fanout, rtc->simulcast_path ? 2 : 1);
+    }
+    return media_fanout_add_viewer(rtc->fanout, peer, (media_fanout_viewer_handle_t *)viewer);
+}
+
+int esp_webrtc_remove_viewer(esp_webrtc_handle_t handle, esp_webrtc_viewer_handle_t viewer)
+{
+    if (handle == NULL || viewer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    return media_fanout_remove_viewer(rtc->fanout, (media_fanout_viewer_handle_t)viewer);
+}
+
+int esp_webrtc_get_viewer_stat(esp_webrtc_handle_t handle, esp_webrtc_viewer_handle_t viewer, esp_webrtc_viewer_stat_t *stat)
+{
+    if (handle == NULL || viewer == NULL || stat == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    media_fanout_stat_t fanout_stat;
+    int ret = media_fanout_get_stat(rtc->fanout, (media_fanout_viewer_handle_t)viewer, &fanout_stat, false);
+    if (ret != ESP_PEER_ERR_NONE) {
+        return ret;
+    }
+    stat->audio_frames = fanout_stat.audio_frames;
+    stat->video_frames = fanout_stat.video_frames;
+    stat->audio_dropped = fanout_stat.audio_dropped;
+    stat->video_dropped = fanout_stat.video_dropped;
+    stat->send_bytes = fanout_stat.send_bytes;
+    stat->queue_max = fanout_stat.queue_max;
+    stat->layer = fanout_stat.layer;
+    stat->temporal_id = fanout_stat.temporal_id;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_set_viewer_bandwidth(esp_webrtc_handle_t handle, esp_webrtc_viewer_handle_t viewer, uint32_t bitrate)
+{
+    if (handle == NULL || viewer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    return media_fanout_set_viewer_bandwidth(rtc->fanout, (media_fanout_viewer_handle_t)viewer, bitrate);
+}
+
 int esp_webrtc_restart(esp_webrtc_handle_t handle)
 {
     if (handle == NULL) {
@@ -874,6 +1606,28 @@ int esp_webrtc_restart(esp_webrtc_handle_t handle)
     return ESP_PEER_ERR_NONE;
 }
 
+int esp_webrtc_get_reconnect_stat(esp_webrtc_handle_t handle, esp_webrtc_reconnect_stat_t *stat)
+{
+    if (handle == NULL || stat == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    *stat = rtc->reconnect_stat;
+    return ESP_PEER_ERR_NONE;
+}
+
+int esp_webrtc_get_setup_stat(esp_webrtc_handle_t handle, esp_webrtc_setup_stat_t *stat)
+{
+    if (handle == NULL || stat == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    webrtc_t *rtc = (webrtc_t *)handle;
+    media_lib_mutex_lock(rtc->stat_lock, MEDIA_LIB_MAX_LOCK_TIME);
+    *stat = rtc->setup_stat;
+    media_lib_mutex_unlock(rtc->stat_lock);
+    return ESP_PEER_ERR_NONE;
+}
+
 int esp_webrtc_query(esp_webrtc_handle_t handle)
 {
     if (handle == NULL) {
@@ -895,6 +1649,16 @@ int esp_webrtc_query(esp_webrtc_handle_t handle)
                 (int)rtc->aud_recv_pts, (int)rtc->aud_recv_num, (int)rtc->aud_recv_size,
                 (int)rtc->vid_recv_num, (int)rtc->vid_recv_size);
     }
+    if (rtc->vdc_sender) {
+        video_dc_stat_t send_stat, recv_stat;
+        video_dc_sender_get_stat(rtc->vdc_sender, &send_stat, true);
+        video_dc_receiver_get_stat(rtc->vdc_recv, &recv_stat, true);
+        ESP_LOGI(TAG, "Video DC send:%d drop:%d skip:%d recv:%d drop:%d stale:%d wait_key:%d",
+                (int)send_stat.frames, (int)send_stat.dropped, (int)rtc->vid_skip_num,
+                (int)recv_stat.frames, (int)recv_stat.dropped, (int)recv_stat.stale, (int)recv_stat.skip_wait);
+        rtc->vid_skip_num = 0;
+    }
+    media_fanout_query(rtc->fanout);
     esp_peer_query(rtc->pc);
     printf("\n");
     // Clear send and receive info
@@ -933,10 +1697,15 @@ int esp_webrtc_close(esp_webrtc_handle_t handle)
     }
     webrtc_t *rtc = (webrtc_t *)handle;
     esp_webrtc_stop(handle);
+    if (rtc->fanout) {
+        media_fanout_close(rtc->fanout);
+        rtc->fanout = NULL;
+    }
     free_server_cfg(rtc);
     SAFE_FREE(rtc->rtc_cfg.peer_cfg.extra_cfg);
     SAFE_FREE(rtc->rtc_cfg.signaling_cfg.extra_cfg);
     SAFE_FREE(rtc->aud_fifo);
+    media_lib_mutex_destroy(rtc->stat_lock);
     free(rtc);
     return ESP_PEER_ERR_NONE;
 }
@@ -0,0 +1,719 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "media_lib_os.h"
+#include "media_fanout.h"
+
+#define TAG "FANOUT"
+
+#define FANOUT_POLL_INTERVAL    (10)
+#define FANOUT_MAX_WAIT         (100)
+#define FANOUT_LAYER_WINDOW     (1000)
+#define FANOUT_UPGRADE_WINDOWS  (5)
+#define FANOUT_MAX_UPGRADE_WIN  (60)
+#define FANOUT_PROBE_WINDOWS    (3)
+#define FANOUT_KEY_REQ_INTERVAL (1000)
+#define FANOUT_KEY_WAIT         (500)
+#define FANOUT_LEVEL_NUM        (MEDIA_FANOUT_MAX_VIDEO_LAYER * 2)
+#define FANOUT_LEVEL_LAYER(l)   ((l) >> 1)
+#define FANOUT_LEVEL_BASE(l)    ((l) & 1)
+
+typedef struct {
+    int                  ref;
+    media_fanout_frame_t frame;
+} fanout_buf_t;
+
+struct media_fanout_viewer_t {
+    struct media_fanout_viewer_t *next;
+    struct media_fanout_t        *fanout;
+    esp_peer_handle_t             pc;
+    fanout_buf_t                **queue;
+    uint8_t                       rp;
+    uint8_t                       num;
+    bool                          wait_key;
+    bool                          wait_key_timed; // Start of key frame wait is recorded
+    uint32_t                      wait_key_pts;
+    bool                          running;
+    uint8_t                       layer;     // Spatial layer being forwarded
+    uint8_t                       level;     // Level chosen by send congestion
+    uint8_t                       bw_level;  // Best level fitting into estimated bandwidth
+    uint8_t                       clean_win; // Windows passed without congestion
+    uint8_t                       upgrade_win; // Clean windows needed before probing one level up
+    uint8_t                       since_up;  // Windows passed since last probe
+    bool                          congested;
+    bool                          hold;
+    uint32_t                      bandwidth;
+    media_lib_sema_handle_t       data_sema;
+    media_lib_sema_handle_t       peer_sema; // Wake semaphore reported by peer, given on new data as well
+    media_lib_sema_handle_t       exit_sema;
+    media_fanout_stat_t           stat;
+};
+
+struct media_fanout_t {
+    media_lib_mutex_handle_t      lock;
+    uint8_t                       queue_num;
+    struct media_fanout_viewer_t *viewers;
+    uint8_t                       layer_num;
+    // Layer statistics of current window, a level is (spatial layer, base temporal layer only)
+    bool                          win_started;
+    uint32_t                      win_start;
+    uint32_t                      win_bytes[MEDIA_FANOUT_MAX_VIDEO_LAYER];
+    uint32_t                      win_base_bytes[MEDIA_FANOUT_MAX_VIDEO_LAYER];
+    bool                          win_temporal[MEDIA_FANOUT_MAX_VIDEO_LAYER];
+    bool                          has_temporal[MEDIA_FANOUT_MAX_VIDEO_LAYER];
+    uint32_t                      level_rate[FANOUT_LEVEL_NUM];
+    uint8_t                       key_request; // Bit mask of layers to request key frame from encoder
+    bool                          key_req_sent[MEDIA_FANOUT_MAX_VIDEO_LAYER];
+    uint32_t                      key_req_pts[MEDIA_FANOUT_MAX_VIDEO_LAYER];
+};
+
+static void release_buf_locked(fanout_buf_t *buf)
+{
+    buf->ref--;
+    if (buf->ref == 0) {
+        free(buf);
+    }
+}
+
+static bool level_valid(struct media_fanout_t *fanout, uint8_t level)
+{
+    uint8_t layer = FANOUT_LEVEL_LAYER(level);
+    if (layer >= fanout->layer_num) {
+        return false;
+    }
+    // Dropping enhancement temporal layer only makes sense when stream has one
+    return FANOUT_LEVEL_BASE(level) == 0 || fanout->has_temporal[layer];
+}
+
+static uint8_t level_lower(struct media_fanout_t *fanout, uint8_t level)
+{
+    for (uint8_t l = level + 1; l < FANOUT_LEVEL_NUM; l++) {
+        if (level_valid(fanout, l)) {
+            return l;
+        }
+    }
+    return level;
+}
+
+static uint8_t level_higher(struct media_fanout_t *fanout, uint8_t level)
+{
+    for (int l = (int)level - 1; l >= 0; l--) {
+        if (level_valid(fanout, l)) {
+            return (uint8_t)l;
+        }
+    }
+    return level;
+}
+
+static uint8_t level_fix(struct media_fanout_t *fanout, uint8_t level)
+{
+    if (level_valid(fanout, level)) {
+        return level;
+    }
+    if (FANOUT_LEVEL_LAYER(level) < fanout->layer_num) {
+        return level & ~1;
+    }
+    return (fanout->layer_num - 1) * 2 + (fanout->has_temporal[fanout->layer_num - 1] ? 1 : 0);
+}
+
+static uint8_t viewer_target_level(struct media_fanout_viewer_t *viewer)
+{
+    return level_fix(viewer->fanout, viewer->level > viewer->bw_level ? viewer->level : viewer->bw_level);
+}
+
+static void viewer_update_bw_level(struct media_fanout_viewer_t *viewer)
+{
+    struct media_fanout_t *fanout = viewer->fanout;
+    viewer->bw_level = 0;
+    if (viewer->bandwidth == 0) {
+        return;
+    }
+    // Pick best level which fits, otherwise the lowest one
+    for (uint8_t l = 0; l < FANOUT_LEVEL_NUM; l++) {
+        if (level_valid(fanout, l) == false) {
+            continue;
+        }
+        viewer->bw_level = l;
+        if (fanout->level_rate[l] <= viewer->bandwidth) {
+            break;
+        }
+    }
+}
+
+static void layer_window_update_locked(struct media_fanout_t *fanout, uint32_t duration)
+{
+    for (int i = 0; i < MEDIA_FANOUT_MAX_VIDEO_LAYER; i++) {
+        fanout->level_rate[i * 2] = (uint32_t)((uint64_t)fanout->win_bytes[i] * 8 * 1000 / duration);
+        fanout->level_rate[i * 2 + 1] = (uint32_t)((uint64_t)fanout->win_base_bytes[i] * 8 * 1000 / duration);
+        fanout->has_temporal[i] = fanout->win_temporal[i];
+        fanout->win_bytes[i] = 0;
+        fanout->win_base_bytes[i] = 0;
+        fanout->win_temporal[i] = false;
+    }
+    for (struct media_fanout_viewer_t *viewer = fanout->viewers; viewer; viewer = viewer->next) {
+        uint8_t level = level_fix(fanout, viewer->level);
+        // Queued frames of previous level still drain after stepping down, or layer switch is waiting for key frame
+        bool settling = viewer->hold || viewer->layer != FANOUT_LEVEL_LAYER(viewer_target_level(viewer));
+        viewer->hold = false;
+        if (viewer->congested && settling) {
+            viewer->clean_win = 0;
+        } else if (viewer->congested) {
+            // Failed probe backs off exponentially so that viewer does not oscillate around its capacity
+            if (viewer->since_up < FANOUT_PROBE_WINDOWS) {
+                viewer->upgrade_win = viewer->upgrade_win * 2 > FANOUT_MAX_UPGRADE_WIN ? FANOUT_MAX_UPGRADE_WIN : viewer->upgrade_win * 2;
+            }
+            level = level_lower(fanout, level);
+            viewer->clean_win = 0;
+            viewer->since_up = FANOUT_PROBE_WINDOWS;
+            viewer->hold = true;
+        } else {
+            if (viewer->since_up < FANOUT_PROBE_WINDOWS && ++viewer->since_up == FANOUT_PROBE_WINDOWS) {
+                viewer->upgrade_win = FANOUT_UPGRADE_WINDOWS;
+            }
+            if (viewer->clean_win < UINT8_MAX) {
+                viewer->clean_win++;
+            }
+            if (viewer->clean_win >= viewer->upgrade_win && level_higher(fanout, level) != level) {
+                level = level_higher(fanout, level);
+                viewer->clean_win = 0;
+                viewer->since_up = 0;
+            }
+        }
+        if (level != viewer->level) {
+            ESP_LOGI(TAG, "Viewer %p change to layer %d%s", viewer, FANOUT_LEVEL_LAYER(level),
+                     FANOUT_LEVEL_BASE(level) ? " base temporal layer" : "");
+        }
+        viewer->level = level;
+        viewer->congested = false;
+        viewer_update_bw_level(viewer);
+    }
+}
+
+static void layer_account_locked(struct media_fanout_t *fanout, media_fanout_frame_t *frame)
+{
+    if (fanout->win_started == false || frame->pts < fanout->win_start) {
+        fanout->win_started = true;
+        fanout->win_start = frame->pts;
+    } else if (frame->pts - fanout->win_start >= FANOUT_LAYER_WINDOW) {
+        layer_window_update_locked(fanout, frame->pts - fanout->win_start);
+        fanout->win_start = frame->pts;
+    }
+    uint8_t layer = frame->layer;
+    fanout->win_bytes[layer] += frame->size;
+    if (frame->temporal_id == 0) {
+        fanout->win_base_bytes[layer] += frame->size;
+    } else {
+        fanout->win_temporal[layer] = true;
+    }
+}
+
+static fanout_buf_t *viewer_pop_locked(struct media_fanout_viewer_t *viewer)
+{
+    if (viewer->num == 0) {
+        return NULL;
+    }
+    fanout_buf_t *buf = viewer->queue[viewer->rp];
+    viewer->rp = (viewer->rp + 1) % viewer->fanout->queue_num;
+    viewer->num--;
+    return buf;
+}
+
+static void viewer_wait_key_locked(struct media_fanout_viewer_t *viewer)
+{
+    if (viewer->wait_key == false) {
+        viewer->wait_key = true;
+        // Timed from next video frame, fan-out has no clock of its own
+        viewer->wait_key_timed = false;
+    }
+}
+
+static void viewer_remove_locked(struct media_fanout_viewer_t *viewer, int i)
+{
+    uint8_t queue_num = viewer->fanout->queue_num;
+    fanout_buf_t *buf = viewer->queue[(viewer->rp + i) % queue_num];
+    // Shift later frames forward to keep sending order
+    for (int j = i; j + 1 < viewer->num; j++) {
+        viewer->queue[(viewer->rp + j) % queue_num] = viewer->queue[(viewer->rp + j + 1) % queue_num];
+    }
+    viewer->num--;
+    release_buf_locked(buf);
+}
+
+static bool viewer_evict_video_locked(struct media_fanout_viewer_t *viewer)
+{
+    uint8_t queue_num = viewer->fanout->queue_num;
+    int i = 0;
+    for (; i < viewer->num; i++) {
+        if (viewer->queue[(viewer->rp + i) % queue_num]->frame.type == MEDIA_FANOUT_FRAME_VIDEO) {
+            break;
+        }
+    }
+    if (i == viewer->num) {
+        return false;
+    }
+    // Non-reference frame can be dropped alone
+    bool referenced = viewer->queue[(viewer->rp + i) % queue_num]->frame.temporal_id == 0;
+    viewer_remove_locked(viewer, i);
+    viewer->stat.video_dropped++;
+    if (referenced == false) {
+        return true;
+    }
+    // Later frames reference the dropped one, drop them till next key frame
+    while (i < viewer->num) {
+        media_fanout_frame_t *frame = &viewer->queue[(viewer->rp + i) % queue_num]->frame;
+        if (frame->type != MEDIA_FANOUT_FRAME_VIDEO) {
+            i++;
+            continue;
+        }
+        if (frame->key_frame) {
+            return true;
+        }
+        viewer_remove_locked(viewer, i);
+        viewer->stat.video_dropped++;
+    }
+    viewer_wait_key_locked(viewer);
+    return true;
+}
+
+static bool viewer_push_locked(struct media_fanout_viewer_t *viewer, fanout_buf_t *buf)
+{
+    media_fanout_frame_t *frame = &buf->frame;
+    bool is_video = (frame->type == MEDIA_FANOUT_FRAME_VIDEO);
+    if (is_video) {
+        uint8_t level = viewer_target_level(viewer);
+        if (frame->layer != viewer->layer) {
+            // Switch spatial layer only on key frame of target layer
+            if (frame->layer != FANOUT_LEVEL_LAYER(level) || frame->key_frame == false) {
+                return false;
+            }
+            viewer->layer = frame->layer;
+        }
+        if (FANOUT_LEVEL_BASE(level) && frame->temporal_id > 0) {
+            return false;
+        }
+        if (frame->key_frame) {
+            viewer->wait_key = false;
+        } else if (viewer->wait_key) {
+            if (viewer->wait_key_timed == false || frame->pts < viewer->wait_key_pts) {
+                viewer->wait_key_timed = true;
+                viewer->wait_key_pts = frame->pts;
+            }
+            viewer->stat.video_dropped++;
+            return false;
+        }
+    }
+    if (viewer->num >= viewer->fanout->queue_num) {
+        viewer->congested = true;
+        if (is_video) {
+            viewer->stat.video_dropped++;
+            if (frame->temporal_id == 0) {
+                viewer_wait_key_locked(viewer);
+            }
+            return false;
+        }
+        // Audio goes ahead of queued video
+        if (viewer_evict_video_locked(viewer) == false) {
+            viewer->stat.audio_dropped++;
+            return false;
+        }
+    }
+    viewer->queue[(viewer->rp + viewer->num) % viewer->fanout->queue_num] = buf;
+    viewer->num++;
+    buf->ref++;
+    if (viewer->num > viewer->stat.queue_max) {
+        viewer->stat.queue_max = viewer->num;
+    }
+    // Queue backs up before frames get dropped, treat it as congestion already
+    if (viewer->num * 4 > viewer->fanout->queue_num * 3) {
+        viewer->congested = true;
+    }
+    return true;
+}
+
+static void viewer_send(struct media_fanout_viewer_t *viewer, media_fanout_frame_t *frame)
+{
+    if (frame->type == MEDIA_FANOUT_FRAME_AUDIO) {
+        esp_peer_audio_frame_t audio_frame = {
+            .pts = frame->pts,
+            .data = frame->data,
+            .size = frame->size,
+        };
+        esp_peer_send_audio(viewer->pc, &audio_frame);
+    } else {
+        esp_peer_video_frame_t video_frame = {
+            .pts = frame->pts,
+            .data = frame->data,
+            .size = frame->size,
+        };
+        esp_peer_send_video(viewer->pc, &video_frame);
+    }
+}
+
+static void viewer_sent_locked(struct media_fanout_viewer_t *viewer, media_fanout_frame_t *frame)
+{
+    if (frame->type == MEDIA_FANOUT_FRAME_AUDIO) {
+        viewer->stat.audio_frames++;
+    } else {
+        viewer->stat.video_frames++;
+    }
+    viewer->stat.send_bytes += frame->size;
+}
+
+static void viewer_wait(struct media_fanout_viewer_t *viewer)
+{
+    struct media_fanout_t *fanout = viewer->fanout;
+    esp_peer_wait_info_t info = {};
+    uint32_t timeout = FANOUT_POLL_INTERVAL;
+    if (esp_peer_get_wait_info(viewer->pc, &info) == ESP_PEER_ERR_NONE) {
+        if (info.timeout_ms == 0) {
+            return;
+        }
+        timeout = info.timeout_ms < FANOUT_MAX_WAIT ? info.timeout_ms : FANOUT_MAX_WAIT;
+        // Sockets can not be waited together with queued frames, keep polling them
+        if (info.fd_num && timeout > FANOUT_POLL_INTERVAL) {
+            timeout = FANOUT_POLL_INTERVAL;
+        }
+    }
+    media_lib_sema_handle_t sema = viewer->data_sema;
+    if (info.fd_num == 0 && info.wake_sema) {
+        // Wait on peer semaphore so that both peer work and new frames wake up viewer at once
+        media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+        viewer->peer_sema = (media_lib_sema_handle_t)info.wake_sema;
+        bool skip_wait = viewer->num > 0 || viewer->running == false;
+        media_lib_mutex_unlock(fanout->lock);
+        if (skip_wait) {
+            return;
+        }
+        sema = viewer->peer_sema;
+    }
+    media_lib_sema_lock(sema, timeout);
+}
+
+static void viewer_task(void *arg)
+{
+    struct media_fanout_viewer_t *viewer = (struct media_fanout_viewer_t *)arg;
+    struct media_fanout_t *fanout = viewer->fanout;
+    while (viewer->running) {
+        while (viewer->running) {
+            media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+            fanout_buf_t *buf = viewer_pop_locked(viewer);
+            media_lib_mutex_unlock(fanout->lock);
+            if (buf == NULL) {
+                break;
+            }
+            viewer_send(viewer, &buf->frame);
+            media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+            viewer_sent_locked(viewer, &buf->frame);
+            release_buf_locked(buf);
+            media_lib_mutex_unlock(fanout->lock);
+        }
+        esp_peer_main_loop(viewer->pc);
+        if (viewer->running) {
+            viewer_wait(viewer);
+        }
+    }
+    media_lib_sema_unlock(viewer->exit_sema);
+    media_lib_thread_destroy(NULL);
+}
+
+static void viewer_destroy(struct media_fanout_viewer_t *viewer)
+{
+    if (viewer->data_sema) {
+        media_lib_sema_destroy(viewer->data_sema);
+    }
+    if (viewer->exit_sema) {
+        media_lib_sema_destroy(viewer->exit_sema);
+    }
+    free(viewer->queue);
+    free(viewer);
+}
+
+media_fanout_handle_t media_fanout_open(uint8_t queue_num)
+{
+    struct media_fanout_t *fanout = (struct media_fanout_t *)calloc(1, sizeof(struct media_fanout_t));
+    if (fanout == NULL) {
+        return NULL;
+    }
+    media_lib_mutex_create(&fanout->lock);
+    if (fanout->lock == NULL) {
+        free(fanout);
+        return NULL;
+    }
+    fanout->queue_num = queue_num ? queue_num : MEDIA_FANOUT_DEFAULT_QUEUE;
+    fanout->layer_num = 1;
+    return fanout;
+}
+
+int media_fanout_add_viewer(media_fanout_handle_t fanout, esp_peer_handle_t pc, media_fanout_viewer_handle_t *viewer)
+{
+    if (fanout == NULL || pc == NULL || viewer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    struct media_fanout_viewer_t *new_viewer = (struct media_fanout_viewer_t *)calloc(1, sizeof(struct media_fanout_viewer_t));
+    if (new_viewer == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    new_viewer->fanout = fanout;
+    new_viewer->pc = pc;
+    new_viewer->upgrade_win = FANOUT_UPGRADE_WINDOWS;
+    new_viewer->since_up = FANOUT_PROBE_WINDOWS;
+    new_viewer->queue = (fanout_buf_t **)calloc(fanout->queue_num, sizeof(fanout_buf_t *));
+    media_lib_sema_create(&new_viewer->data_sema);
+    media_lib_sema_create(&new_viewer->exit_sema);
+    if (new_viewer->queue == NULL || new_viewer->data_sema == NULL || new_viewer->exit_sema == NULL) {
+        viewer_destroy(new_viewer);
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    new_viewer->running = true;
+    media_lib_thread_handle_t thread = NULL;
+    if (media_lib_thread_create_from_scheduler(&thread, "pc_viewer", viewer_task, new_viewer) != 0) {
+        ESP_LOGE(TAG, "Fail to create viewer thread");
+        viewer_destroy(new_viewer);
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    // Viewer can only decode from key frame
+    viewer_wait_key_locked(new_viewer);
+    new_viewer->next = fanout->viewers;
+    fanout->viewers = new_viewer;
+    media_lib_mutex_unlock(fanout->lock);
+    *viewer = new_viewer;
+    return ESP_PEER_ERR_NONE;
+}
+
+int media_fanout_remove_viewer(media_fanout_handle_t fanout, media_fanout_viewer_handle_t viewer)
+{
+    if (fanout == NULL || viewer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    bool found = false;
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    struct media_fanout_viewer_t **cur = &fanout->viewers;
+    while (*cur) {
+        if (*cur == viewer) {
+            *cur = viewer->next;
+            found = true;
+            break;
+        }
+        cur = &(*cur)->next;
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    if (found == false) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    viewer->running = false;
+    media_lib_sema_handle_t peer_sema = viewer->peer_sema;
+    media_lib_mutex_unlock(fanout->lock);
+    media_lib_sema_unlock(viewer->data_sema);
+    if (peer_sema) {
+        media_lib_sema_unlock(peer_sema);
+    }
+    media_lib_sema_lock(viewer->exit_sema, MEDIA_LIB_MAX_LOCK_TIME);
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    fanout_buf_t *buf;
+    while ((buf = viewer_pop_locked(viewer)) != NULL) {
+        release_buf_locked(buf);
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    viewer_destroy(viewer);
+    return ESP_PEER_ERR_NONE;
+}
+
+int media_fanout_set_video_layers(media_fanout_handle_t fanout, uint8_t layer_num)
+{
+    if (fanout == NULL || layer_num == 0 || layer_num > MEDIA_FANOUT_MAX_VIDEO_LAYER) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    fanout->layer_num = layer_num;
+    media_lib_mutex_unlock(fanout->lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+int media_fanout_set_viewer_bandwidth(media_fanout_handle_t fanout, media_fanout_viewer_handle_t viewer, uint32_t bitrate)
+{
+    if (fanout == NULL || viewer == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    int ret = ESP_PEER_ERR_INVALID_ARG;
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    for (struct media_fanout_viewer_t *cur = fanout->viewers; cur; cur = cur->next) {
+        if (cur == viewer) {
+            viewer->bandwidth = bitrate;
+            viewer_update_bw_level(viewer);
+            ret = ESP_PEER_ERR_NONE;
+            break;
+        }
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    return ret;
+}
+
+static bool viewer_need_key_locked(struct media_fanout_viewer_t *viewer, media_fanout_frame_t *frame)
+{
+    if (viewer->wait_key == false || viewer->wait_key_timed == false || viewer->layer != frame->layer ||
+        frame->pts < viewer->wait_key_pts) {
+        return false;
+    }
+    // Natural key frame of the stream likely arrives soon, do not restart encoder shared by all viewers
+    if (frame->pts - viewer->wait_key_pts < FANOUT_KEY_WAIT) {
+        return false;
+    }
+    // Big key frame would overflow again before queue of congested viewer drained
+    return viewer->num * 4 <= viewer->fanout->queue_num;
+}
+
+static void key_request_locked(struct media_fanout_t *fanout, media_fanout_frame_t *frame)
+{
+    uint8_t layer = frame->layer;
+    if (frame->key_frame) {
+        return;
+    }
+    // Limit request rate so that a congested viewer does not flood all viewers with key frames
+    if (fanout->key_req_sent[layer] && frame->pts >= fanout->key_req_pts[layer] &&
+        frame->pts - fanout->key_req_pts[layer] < FANOUT_KEY_REQ_INTERVAL) {
+        return;
+    }
+    bool need_key = false;
+    for (struct media_fanout_viewer_t *viewer = fanout->viewers; viewer && need_key == false; viewer = viewer->next) {
+        need_key = viewer_need_key_locked(viewer, frame);
+    }
+    if (need_key == false) {
+        return;
+    }
+    fanout->key_request |= (1 << layer);
+    fanout->key_req_sent[layer] = true;
+    fanout->key_req_pts[layer] = frame->pts;
+}
+
+int media_fanout_send(media_fanout_handle_t fanout, media_fanout_frame_t *frame)
+{
+    if (fanout == NULL || frame == NULL || frame->data == NULL || frame->size <= 0 ||
+        (frame->type == MEDIA_FANOUT_FRAME_VIDEO && frame->layer >= fanout->layer_num)) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    if (fanout->viewers == NULL) {
+        return ESP_PEER_ERR_NONE;
+    }
+    fanout_buf_t *buf = (fanout_buf_t *)malloc(sizeof(fanout_buf_t) + frame->size);
+    if (buf == NULL) {
+        return ESP_PEER_ERR_NO_MEM;
+    }
+    // Hold one reference during dispatch
+    buf->ref = 1;
+    buf->frame = *frame;
+    buf->frame.data = (uint8_t *)(buf + 1);
+    memcpy(buf->frame.data, frame->data, frame->size);
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    if (frame->type == MEDIA_FANOUT_FRAME_VIDEO) {
+        layer_account_locked(fanout, frame);
+    }
+    struct media_fanout_viewer_t *viewer = fanout->viewers;
+    while (viewer) {
+        if (viewer_push_locked(viewer, buf)) {
+            media_lib_sema_unlock(viewer->data_sema);
+            if (viewer->peer_sema) {
+                media_lib_sema_unlock(viewer->peer_sema);
+            }
+        }
+        viewer = viewer->next;
+    }
+    if (frame->type == MEDIA_FANOUT_FRAME_VIDEO) {
+        key_request_locked(fanout, frame);
+    }
+    release_buf_locked(buf);
+    media_lib_mutex_unlock(fanout->lock);
+    return ESP_PEER_ERR_NONE;
+}
+
+uint8_t media_fanout_get_key_request(media_fanout_handle_t fanout)
+{
+    if (fanout == NULL) {
+        return 0;
+    }
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    uint8_t key_request = fanout->key_request;
+    fanout->key_request = 0;
+    media_lib_mutex_unlock(fanout->lock);
+    return key_request;
+}
+
+int media_fanout_get_stat(media_fanout_handle_t fanout, media_fanout_viewer_handle_t viewer, media_fanout_stat_t *stat, bool reset)
+{
+    if (fanout == NULL || viewer == NULL || stat == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    int ret = ESP_PEER_ERR_INVALID_ARG;
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    for (struct media_fanout_viewer_t *cur = fanout->viewers; cur; cur = cur->next) {
+        if (cur == viewer) {
+            uint8_t level = viewer_target_level(viewer);
+            viewer->stat.layer = viewer->layer;
+            viewer->stat.temporal_id = (FANOUT_LEVEL_BASE(level) || fanout->has_temporal[viewer->layer] == false) ? 0 : 1;
+            *stat = viewer->stat;
+            if (reset) {
+                memset(&viewer->stat, 0, sizeof(media_fanout_stat_t));
+            }
+            ret = ESP_PEER_ERR_NONE;
+            break;
+        }
+    }
+    media_lib_mutex_unlock(fanout->lock);
+    return ret;
+}
+
+void media_fanout_query(media_fanout_handle_t fanout)
+{
+    if (fanout == NULL) {
+        return;
+    }
+    int idx = 0;
+    media_lib_mutex_lock(fanout->lock, MEDIA_LIB_MAX_LOCK_TIME);
+    for (struct media_fanout_viewer_t *viewer = fanout->viewers; viewer; viewer = viewer->next) {
+        media_fanout_stat_t *stat = &viewer->stat;
+        uint8_t level = viewer_target_level(viewer);
+        ESP_LOGI(TAG, "Viewer %d send A:%d V:%d bytes:%d drop A:%d V:%d queue:%d/%d layer:%d%s",
+                 idx++, (int)stat->audio_frames, (int)stat->video_frames, (int)stat->send_bytes,
+                 (int)stat->audio_dropped, (int)stat->video_dropped, (int)stat->queue_max, (int)fanout->queue_num,
+                 (int)viewer->layer, FANOUT_LEVEL_BASE(level) ? " base" : "");
+        memset(stat, 0, sizeof(media_fanout_stat_t));
+    }
+    media_lib_mutex_unlock(fanout->lock);
+}
+
+void media_fanout_close(media_fanout_handle_t fanout)
+{
+    if (fanout == NULL) {
+        return;
+    }
+    while (fanout->viewers) {
+        media_fanout_remove_viewer(fanout, fanout->viewers);
+    }
+    media_lib_mutex_destroy(fanout->lock);
+    free(fanout);
+}
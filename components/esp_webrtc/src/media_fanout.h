@@ -0,0 +1,227 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_peer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Media fan-out
+ *
+ * @note  Encoded frames are copied once into a reference counted buffer and queued to every viewer
+ *        Each viewer owns a send thread and a bounded queue, so a slow viewer only drops its own frames
+ */
+#define MEDIA_FANOUT_DEFAULT_QUEUE (8)
+
+/**
+ * @brief  Maximum spatial (simulcast) video layers
+ *
+ * @note  Layer 0 has the highest resolution, every viewer is forwarded one spatial layer and optionally only its base
+ *        temporal layer (only offered when frames with `temporal_id` over 0 are seen).
+ *        Layer is chosen per viewer from its send congestion and estimated bandwidth,
+ *        switching spatial layer only happens on key frame of the target layer so no re-encoding is needed
+ */
+#define MEDIA_FANOUT_MAX_VIDEO_LAYER (2)
+
+/**
+ * @brief  Media fan-out handle
+ */
+typedef struct media_fanout_t *media_fanout_handle_t;
+
+/**
+ * @brief  Media fan-out viewer handle
+ */
+typedef struct media_fanout_viewer_t *media_fanout_viewer_handle_t;
+
+/**
+ * @brief  Media fan-out frame type
+ */
+typedef enum {
+    MEDIA_FANOUT_FRAME_AUDIO = 0, /*!< Audio frame */
+    MEDIA_FANOUT_FRAME_VIDEO = 1, /*!< Video frame */
+} media_fanout_frame_type_t;
+
+/**
+ * @brief  Media fan-out frame
+ */
+typedef struct {
+    media_fanout_frame_type_t type;      /*!< Frame type */
+    bool                      key_frame;   /*!< Video frame can be decoded independently */
+    uint8_t                   layer;       /*!< Spatial layer of video frame, 0 for highest resolution */
+    uint8_t                   temporal_id; /*!< Temporal layer of video frame, frames over 0 are not referenced and can be dropped */
+    uint32_t                  pts;         /*!< Frame presentation timestamp (unit ms) */
+    uint8_t                  *data;        /*!< Frame data */
+    int                       size;        /*!< Frame size */
+} media_fanout_frame_t;
+
+/**
+ * @brief  Media fan-out viewer statistics
+ */
+typedef struct {
+    uint32_t audio_frames;  /*!< Audio frames sent */
+    uint32_t video_frames;  /*!< Video frames sent */
+    uint32_t audio_dropped; /*!< Audio frames dropped for queue full */
+    uint32_t video_dropped; /*!< Video frames dropped for queue full or waiting for key frame */
+    uint32_t send_bytes;    /*!< Total bytes sent */
+    uint16_t queue_max;     /*!< Maximum queued frames */
+    uint8_t  layer;         /*!< Spatial layer currently forwarded */
+    uint8_t  temporal_id;   /*!< Highest temporal layer currently forwarded */
+} media_fanout_stat_t;
+
+/**
+ * @brief  Open media fan-out
+ *
+ * @param[in]  queue_num  Maximum queued frames of each viewer, 0 to use `MEDIA_FANOUT_DEFAULT_QUEUE`
+ *
+ * @return
+ *       - NULL    Not enough memory
+ *       - Others  Media fan-out handle
+ */
+media_fanout_handle_t media_fanout_open(uint8_t queue_num);
+
+/**
+ * @brief  Add viewer to media fan-out
+ *
+ * @note  Viewer thread sends queued frames to the peer and drives `esp_peer_main_loop` of it
+ *        It blocks until new frame queued or next deadline reported by `esp_peer_get_wait_info`
+ *        Peer is still owned by caller, it must be kept open until viewer removed
+ *
+ * @param[in]   fanout  Media fan-out handle
+ * @param[in]   pc      Peer connection of the viewer
+ * @param[out]  viewer  Viewer handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int media_fanout_add_viewer(media_fanout_handle_t fanout, esp_peer_handle_t pc, media_fanout_viewer_handle_t *viewer);
+
+/**
+ * @brief  Remove viewer from media fan-out, wait for viewer thread quit and drop queued frames
+ *
+ * @param[in]  fanout  Media fan-out handle
+ * @param[in]  viewer  Viewer handle
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument or viewer not found
+ */
+int media_fanout_remove_viewer(media_fanout_handle_t fanout, media_fanout_viewer_handle_t viewer);
+
+/**
+ * @brief  Set number of spatial video layers sent through `media_fanout_send`
+ *
+ * @param[in]  fanout     Media fan-out handle
+ * @param[in]  layer_num  Number of spatial layers (1 to `MEDIA_FANOUT_MAX_VIDEO_LAYER`)
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ */
+int media_fanout_set_video_layers(media_fanout_handle_t fanout, uint8_t layer_num);
+
+/**
+ * @brief  Set estimated bandwidth of viewer
+ *
+ * @note  Viewer is forwarded the best layer whose measured bitrate fits into the bandwidth
+ *        Send congestion (queue backs up or frames dropped) still moves viewer to lower layer
+ *
+ * @param[in]  fanout   Media fan-out handle
+ * @param[in]  viewer   Viewer handle
+ * @param[in]  bitrate  Estimated bandwidth (unit bps), 0 to follow send congestion only
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument or viewer not found
+ */
+int media_fanout_set_viewer_bandwidth(media_fanout_handle_t fanout, media_fanout_viewer_handle_t viewer, uint32_t bitrate);
+
+/**
+ * @brief  Queue frame to all viewers
+ *
+ * @note  Frame data is copied once, caller can release it after return
+ *
+ * @param[in]  fanout  Media fan-out handle
+ * @param[in]  frame   Frame to send
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success (also when no viewer added)
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument
+ *       - ESP_PEER_ERR_NO_MEM       Not enough memory
+ */
+int media_fanout_send(media_fanout_handle_t fanout, media_fanout_frame_t *frame);
+
+/**
+ * @brief  Get and clear pending key frame requests
+ *
+ * @note  Encoder is shared by all viewers, so a viewer which joins or dropped referenced video frames
+ *        first waits for natural key frame of the stream. A layer is only requested after such viewer waited
+ *        for 500ms and its queue has drained, caller should ask encoder of the layer for a key frame then
+ *        Requests of one layer are sent at most once per second
+ *
+ * @param[in]  fanout  Media fan-out handle
+ *
+ * @return
+ *       - Bit mask of spatial layers which need a key frame (bit 0 for layer 0)
+ */
+uint8_t media_fanout_get_key_request(media_fanout_handle_t fanout);
+
+/**
+ * @brief  Get statistics of viewer
+ *
+ * @param[in]   fanout  Media fan-out handle
+ * @param[in]   viewer  Viewer handle
+ * @param[out]  stat    Statistics
+ * @param[in]   reset   Clear statistics after read
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_INVALID_ARG  Invalid argument or viewer not found
+ */
+int media_fanout_get_stat(media_fanout_handle_t fanout, media_fanout_viewer_handle_t viewer, media_fanout_stat_t *stat, bool reset);
+
+/**
+ * @brief  Log statistics of all viewers then clear them
+ *
+ * @param[in]  fanout  Media fan-out handle
+ */
+void media_fanout_query(media_fanout_handle_t fanout);
+
+/**
+ * @brief  Remove all viewers and close media fan-out
+ *
+ * @param[in]  fanout  Media fan-out handle
+ */
+void media_fanout_close(media_fanout_handle_t fanout);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,332 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_peer_types.h"
+#include "video_dc_frame.h"
+
+#define TAG "VIDEO_DC"
+
+#define VIDEO_DC_MAGIC       (0x56)
+#define VIDEO_DC_FLAG_KEY    (1 << 0)
+#define VIDEO_DC_SLOT_NUM    (2)
+#define VIDEO_DC_MAX_FRAME   (1024 * 1024)
+#define ID_BEFORE(a, b)      ((int16_t)((a) - (b)) < 0)
+
+struct video_dc_sender_t {
+    uint16_t        frag_size;
+    uint16_t        frame_id;
+    uint8_t        *buf;
+    video_dc_stat_t stat;
+};
+
+typedef struct {
+    bool      used;
+    uint16_t  frame_id;
+    uint8_t   flags;
+    uint32_t  pts;
+    uint32_t  size;
+    uint32_t  got;
+    uint8_t  *data;
+    uint32_t  cap;
+    uint32_t *frags;      /* Sorted offsets of received fragments */
+    uint32_t  frag_num;
+    uint32_t  frag_cap;
+} video_dc_slot_t;
+
+struct video_dc_receiver_t {
+    video_dc_slot_t slots[VIDEO_DC_SLOT_NUM];
+    bool            has_last;
+    bool            wait_key;
+    uint16_t        last_id;
+    video_dc_stat_t stat;
+};
+
+static inline void put_be16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+static inline void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+static inline uint16_t get_be16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline uint32_t get_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+video_dc_sender_handle_t video_dc_sender_open(uint16_t frag_size)
+{
+    video_dc_sender_handle_t sender = calloc(1, sizeof(struct video_dc_sender_t));
+    if (sender == NULL) {
+        return NULL;
+    }
+    sender->frag_size = frag_size ? frag_size : VIDEO_DC_DEFAULT_FRAG;
+    sender->buf = malloc(VIDEO_DC_HEADER_SIZE + sender->frag_size);
+    if (sender->buf == NULL) {
+        free(sender);
+        return NULL;
+    }
+    return sender;
+}
+
+int video_dc_sender_send(video_dc_sender_handle_t sender, video_dc_frame_t *frame, video_dc_send_cb_t send, void *ctx)
+{
+    if (sender == NULL || frame == NULL || frame->size <= 0 || send == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    uint8_t *hdr = sender->buf;
+    hdr[0] = VIDEO_DC_MAGIC;
+    hdr[1] = frame->key_frame ? VIDEO_DC_FLAG_KEY : 0;
+    put_be16(hdr + 2, sender->frame_id++);
+    put_be32(hdr + 4, frame->pts);
+    put_be32(hdr + 8, (uint32_t)frame->size);
+    for (int offset = 0; offset < frame->size; offset += sender->frag_size) {
+        int payload = frame->size - offset;
+        if (payload > sender->frag_size) {
+            payload = sender->frag_size;
+        }
+        put_be32(hdr + 12, (uint32_t)offset);
+        memcpy(hdr + VIDEO_DC_HEADER_SIZE, frame->data + offset, payload);
+        int ret = send(hdr, VIDEO_DC_HEADER_SIZE + payload, ctx);
+        if (ret != ESP_PEER_ERR_NONE) {
+            // Remaining fragments are useless, receiver drop it once newer frame finished
+            sender->stat.dropped++;
+            return ret;
+        }
+    }
+    sender->stat.frames++;
+    return ESP_PEER_ERR_NONE;
+}
+
+void video_dc_sender_get_stat(video_dc_sender_handle_t sender, video_dc_stat_t *stat, bool reset)
+{
+    if (sender == NULL) {
+        memset(stat, 0, sizeof(video_dc_stat_t));
+        return;
+    }
+    *stat = sender->stat;
+    if (reset) {
+        memset(&sender->stat, 0, sizeof(video_dc_stat_t));
+    }
+}
+
+void video_dc_sender_close(video_dc_sender_handle_t sender)
+{
+    if (sender) {
+        free(sender->buf);
+        free(sender);
+    }
+}
+
+video_dc_receiver_handle_t video_dc_receiver_open(void)
+{
+    return calloc(1, sizeof(struct video_dc_receiver_t));
+}
+
+static video_dc_slot_t *get_slot(video_dc_receiver_handle_t recv, uint16_t frame_id)
+{
+    video_dc_slot_t *oldest = NULL;
+    for (int i = 0; i < VIDEO_DC_SLOT_NUM; i++) {
+        video_dc_slot_t *slot = &recv->slots[i];
+        if (slot->used && slot->frame_id == frame_id) {
+            return slot;
+        }
+    }
+    for (int i = 0; i < VIDEO_DC_SLOT_NUM; i++) {
+        video_dc_slot_t *slot = &recv->slots[i];
+        if (slot->used == false) {
+            return slot;
+        }
+        if (oldest == NULL || ID_BEFORE(slot->frame_id, oldest->frame_id)) {
+            oldest = slot;
+        }
+    }
+    // All slots busy, evict oldest incomplete frame
+    oldest->used = false;
+    recv->stat.dropped++;
+    return oldest;
+}
+
+static int add_fragment(video_dc_slot_t *slot, uint32_t offset, bool *added)
+{
+    // Fragments mostly arrive in order, so check the tail first then binary search
+    int pos = slot->frag_num;
+    if (pos && slot->frags[pos - 1] >= offset) {
+        int low = 0, high = (int)slot->frag_num - 1;
+        while (low <= high) {
+            int mid = (low + high) / 2;
+            if (slot->frags[mid] == offset) {
+                *added = false;
+                return ESP_PEER_ERR_NONE;
+            }
+            if (slot->frags[mid] < offset) {
+                low = mid + 1;
+            } else {
+                high = mid - 1;
+            }
+        }
+        pos = low;
+    }
+    if (slot->frag_num >= slot->frag_cap) {
+        uint32_t cap = slot->frag_cap ? slot->frag_cap * 2 : 16;
+        uint32_t *frags = realloc(slot->frags, cap * sizeof(uint32_t));
+        if (frags == NULL) {
+            return ESP_PEER_ERR_NO_MEM;
+        }
+        slot->frags = frags;
+        slot->frag_cap = cap;
+    }
+    memmove(slot->frags + pos + 1, slot->frags + pos, (slot->frag_num - pos) * sizeof(uint32_t));
+    slot->frags[pos] = offset;
+    slot->frag_num++;
+    *added = true;
+    return ESP_PEER_ERR_NONE;
+}
+
+static void deliver_frame(video_dc_receiver_handle_t recv, video_dc_slot_t *slot, video_dc_frame_cb_t on_frame, void *ctx)
+{
+    bool key_frame = (slot->flags & VIDEO_DC_FLAG_KEY) != 0;
+    if (recv->has_last && slot->frame_id != (uint16_t)(recv->last_id + 1)) {
+        // Frames in between are lost, following delta frames are not decodable
+        recv->wait_key = true;
+    }
+    recv->has_last = true;
+    recv->last_id = slot->frame_id;
+    slot->used = false;
+    // Older incomplete frames can never be shown now
+    for (int i = 0; i < VIDEO_DC_SLOT_NUM; i++) {
+        video_dc_slot_t *other = &recv->slots[i];
+        if (other->used && ID_BEFORE(other->frame_id, slot->frame_id)) {
+            other->used = false;
+            recv->stat.dropped++;
+        }
+    }
+    if (recv->wait_key && key_frame == false) {
+        recv->stat.skip_wait++;
+        return;
+    }
+    recv->wait_key = false;
+    recv->stat.frames++;
+    video_dc_frame_t frame = {
+        .pts = slot->pts,
+        .key_frame = key_frame,
+        .data = slot->data,
+        .size = (int)slot->size,
+    };
+    on_frame(&frame, ctx);
+}
+
+int video_dc_receiver_feed(video_dc_receiver_handle_t recv, uint8_t *data, int size, video_dc_frame_cb_t on_frame, void *ctx)
+{
+    if (recv == NULL || data == NULL || on_frame == NULL) {
+        return ESP_PEER_ERR_INVALID_ARG;
+    }
+    if (size <= VIDEO_DC_HEADER_SIZE || data[0] != VIDEO_DC_MAGIC) {
+        return ESP_PEER_ERR_NOT_SUPPORT;
+    }
+    uint16_t frame_id = get_be16(data + 2);
+    uint32_t frame_size = get_be32(data + 8);
+    uint32_t offset = get_be32(data + 12);
+    uint32_t payload = size - VIDEO_DC_HEADER_SIZE;
+    if (frame_size > VIDEO_DC_MAX_FRAME || offset + payload > frame_size) {
+        ESP_LOGW(TAG, "Bad fragment frame %d offset %d size %d", (int)frame_size, (int)offset, (int)payload);
+        return ESP_PEER_ERR_BAD_DATA;
+    }
+    if (recv->has_last && ID_BEFORE(frame_id, recv->last_id + 1)) {
+        recv->stat.stale++;
+        return ESP_PEER_ERR_NONE;
+    }
+    video_dc_slot_t *slot = get_slot(recv, frame_id);
+    if (slot->used == false) {
+        if (slot->cap < frame_size) {
+            uint8_t *buf = realloc(slot->data, frame_size);
+            if (buf == NULL) {
+                ESP_LOGE(TAG, "No memory for frame size %d", (int)frame_size);
+                return ESP_PEER_ERR_NO_MEM;
+            }
+            slot->data = buf;
+            slot->cap = frame_size;
+        }
+        slot->used = true;
+        slot->frame_id = frame_id;
+        slot->flags = data[1];
+        slot->pts = get_be32(data + 4);
+        slot->size = frame_size;
+        slot->got = 0;
+        slot->frag_num = 0;
+    }
+    // Duplicated or retransmitted fragment must not be counted twice
+    bool added = false;
+    int ret = add_fragment(slot, offset, &added);
+    if (ret != ESP_PEER_ERR_NONE) {
+        return ret;
+    }
+    if (added == false) {
+        return ESP_PEER_ERR_NONE;
+    }
+    memcpy(slot->data + offset, data + VIDEO_DC_HEADER_SIZE, payload);
+    slot->got += payload;
+    if (slot->got >= slot->size) {
+        deliver_frame(recv, slot, on_frame, ctx);
+    }
+    return ESP_PEER_ERR_NONE;
+}
+
+void video_dc_receiver_get_stat(video_dc_receiver_handle_t recv, video_dc_stat_t *stat, bool reset)
+{
+    if (recv == NULL) {
+        memset(stat, 0, sizeof(video_dc_stat_t));
+        return;
+    }
+    *stat = recv->stat;
+    if (reset) {
+        memset(&recv->stat, 0, sizeof(video_dc_stat_t));
+    }
+}
+
+void video_dc_receiver_close(video_dc_receiver_handle_t recv)
+{
+    if (recv == NULL) {
+        return;
+    }
+    for (int i = 0; i < VIDEO_DC_SLOT_NUM; i++) {
+        free(recv->slots[i].data);
+        free(recv->slots[i].frags);
+    }
+    free(recv);
+}
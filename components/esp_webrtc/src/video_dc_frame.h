@@ -0,0 +1,108 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Video over data channel framing
+ *
+ * @note  Each data channel message carries a fixed header followed by one fragment of a video frame:
+ *          magic(1) flags(1) frame_id(2) pts(4) frame_size(4) offset(4), all in big endian
+ *        Fragment is placed by offset so it works on unordered and partially reliable channel
+ */
+#define VIDEO_DC_HEADER_SIZE   (16)
+#define VIDEO_DC_DEFAULT_FRAG  (16 * 1024)
+
+/**
+ * @brief  Video over data channel sender handle
+ */
+typedef struct video_dc_sender_t *video_dc_sender_handle_t;
+
+/**
+ * @brief  Video over data channel receiver handle
+ */
+typedef struct video_dc_receiver_t *video_dc_receiver_handle_t;
+
+/**
+ * @brief  Reassembled video frame
+ */
+typedef struct {
+    uint32_t  pts;       /*!< Frame presentation timestamp (unit ms) */
+    bool      key_frame; /*!< Whether frame can be decoded independently */
+    uint8_t  *data;      /*!< Frame data */
+    int       size;      /*!< Frame size */
+} video_dc_frame_t;
+
+/**
+ * @brief  Video over data channel statistics
+ */
+typedef struct {
+    uint32_t frames;    /*!< Frames sent or delivered */
+    uint32_t dropped;   /*!< Frames dropped for send fail or incomplete when newer frame finished */
+    uint32_t stale;     /*!< Fragments discarded for frame older than delivered one */
+    uint32_t skip_wait; /*!< Frames skipped when wait for key frame after loss */
+} video_dc_stat_t;
+
+typedef int (*video_dc_send_cb_t)(uint8_t *data, int size, void *ctx);
+typedef int (*video_dc_frame_cb_t)(video_dc_frame_t *frame, void *ctx);
+
+video_dc_sender_handle_t video_dc_sender_open(uint16_t frag_size);
+
+/**
+ * @brief  Split frame into fragments with header and send them through `send`
+ *
+ * @note  Left fragments are dropped once `send` fail so that receiver can discard the frame quickly
+ */
+int video_dc_sender_send(video_dc_sender_handle_t sender, video_dc_frame_t *frame, video_dc_send_cb_t send, void *ctx);
+
+void video_dc_sender_get_stat(video_dc_sender_handle_t sender, video_dc_stat_t *stat, bool reset);
+
+void video_dc_sender_close(video_dc_sender_handle_t sender);
+
+video_dc_receiver_handle_t video_dc_receiver_open(void);
+
+/**
+ * @brief  Feed one data channel message, `on_frame` is called when a whole frame is reassembled
+ *
+ * @return
+ *       - ESP_PEER_ERR_NONE         On success
+ *       - ESP_PEER_ERR_NOT_SUPPORT  Message is not framed (sent by peer without framing)
+ *       - Others                    Failed to handle message
+ */
+int video_dc_receiver_feed(video_dc_receiver_handle_t recv, uint8_t *data, int size, video_dc_frame_cb_t on_frame, void *ctx);
+
+void video_dc_receiver_get_stat(video_dc_receiver_handle_t recv, video_dc_stat_t *stat, bool reset);
+
+void video_dc_receiver_close(video_dc_receiver_handle_t recv);
+
+#ifdef __cplusplus
+}
+#endif
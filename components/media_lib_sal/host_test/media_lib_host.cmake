@@ -0,0 +1,12 @@
+# POSIX port of media_lib for host tests of other components
+#   include(<path>/media_lib_sal/host_test/media_lib_host.cmake)
+#   add_executable(my_test my_test.c ${MEDIA_LIB_HOST_SRCS})
+#   target_include_directories(my_test PRIVATE ${MEDIA_LIB_HOST_INCS})
+#   target_link_libraries(my_test PRIVATE Threads::Threads)
+# Test need call `media_lib_add_default_os_adapter` before use
+set(MEDIA_LIB_DIR ${CMAKE_CURRENT_LIST_DIR}/..)
+set(MEDIA_LIB_HOST_SRCS ${MEDIA_LIB_DIR}/media_lib_os.c ${MEDIA_LIB_DIR}/media_lib_common.c
+    ${MEDIA_LIB_DIR}/port/data_queue.c ${MEDIA_LIB_DIR}/port/msg_q.c ${CMAKE_CURRENT_LIST_DIR}/media_lib_os_posix.c)
+set(MEDIA_LIB_HOST_INCS ${MEDIA_LIB_DIR}/include ${MEDIA_LIB_DIR}/include/port ${MEDIA_LIB_DIR}
+    ${CMAKE_CURRENT_LIST_DIR}/stub)
+find_package(Threads REQUIRED)
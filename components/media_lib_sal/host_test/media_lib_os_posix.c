@@ -0,0 +1,368 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "media_lib_adapter.h"
+#include "media_lib_os_reg.h"
+#include "media_lib_os.h"
+
+/* POSIX port of media_lib OS wrapper so that components can run in host tests */
+
+#define RETURN_ON_NULL_HANDLE(h)                                               \
+    if (h == NULL) {                                                           \
+        return ESP_ERR_INVALID_ARG;                                            \
+    }
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    int             count;
+} posix_sema_t;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    uint32_t        bits;
+} posix_event_group_t;
+
+typedef struct {
+    void (*body)(void *arg);
+    void *arg;
+} posix_thread_arg_t;
+
+static void get_deadline(struct timespec *ts, uint32_t timeout)
+{
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (long)(timeout % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+static void *_malloc_align(size_t size, uint8_t align)
+{
+    if (!align || ((align & (align - 1)) != 0)) {
+        return NULL;
+    }
+    size += align;
+    uint8_t *buf = (uint8_t *)malloc(size);
+    if (buf == NULL) {
+        return NULL;
+    }
+    uint8_t *aligned = (uint8_t *)(((size_t)buf + align) & (~(size_t)(align - 1)));
+    aligned[-1] = (uint8_t)(size_t)(aligned - buf);
+    return aligned;
+}
+
+static void _free_align(void *addr)
+{
+    if (addr == NULL) {
+        return;
+    }
+    uint8_t *aligned = (uint8_t *)addr;
+    free(aligned - aligned[-1]);
+}
+
+static int _get_stack_frame(void **addr, int n)
+{
+    return 0;
+}
+
+static void *thread_entry(void *arg)
+{
+    posix_thread_arg_t thread_arg = *(posix_thread_arg_t *)arg;
+    free(arg);
+    thread_arg.body(thread_arg.arg);
+    return NULL;
+}
+
+static int _thread_create(media_lib_thread_handle_t *handle, const char *name,
+                          void (*body)(void *arg), void *arg, uint32_t stack_size,
+                          int prio, int core)
+{
+    posix_thread_arg_t *thread_arg = (posix_thread_arg_t *)malloc(sizeof(posix_thread_arg_t));
+    if (thread_arg == NULL) {
+        return ESP_FAIL;
+    }
+    thread_arg->body = body;
+    thread_arg->arg = arg;
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    // Thread always ends by itself through `media_lib_thread_destroy(NULL)` or return
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int ret = pthread_create(&thread, &attr, thread_entry, thread_arg);
+    pthread_attr_destroy(&attr);
+    if (ret != 0) {
+        free(thread_arg);
+        return ESP_FAIL;
+    }
+    if (handle) {
+        *handle = (media_lib_thread_handle_t)thread;
+    }
+    return ESP_OK;
+}
+
+static void _thread_destroy(media_lib_thread_handle_t handle)
+{
+    // Only support destroy self
+    if (handle == NULL || pthread_equal((pthread_t)handle, pthread_self())) {
+        pthread_exit(NULL);
+    }
+}
+
+static bool _thread_set_priority(media_lib_thread_handle_t handle, int prio)
+{
+    return true;
+}
+
+static void _thread_sleep(uint32_t ms)
+{
+    usleep(ms * 1000);
+}
+
+static int _sema_create(media_lib_sema_handle_t *sema)
+{
+    RETURN_ON_NULL_HANDLE(sema);
+    posix_sema_t *s = (posix_sema_t *)calloc(1, sizeof(posix_sema_t));
+    if (s == NULL) {
+        return ESP_FAIL;
+    }
+    pthread_mutex_init(&s->mutex, NULL);
+    pthread_cond_init(&s->cond, NULL);
+    *sema = s;
+    return ESP_OK;
+}
+
+static int _sema_lock_timeout(media_lib_sema_handle_t sema, uint32_t timeout)
+{
+    RETURN_ON_NULL_HANDLE(sema);
+    posix_sema_t *s = (posix_sema_t *)sema;
+    struct timespec ts;
+    get_deadline(&ts, timeout);
+    int ret = 0;
+    pthread_mutex_lock(&s->mutex);
+    while (s->count == 0 && ret == 0) {
+        if (timeout == MEDIA_LIB_MAX_LOCK_TIME) {
+            pthread_cond_wait(&s->cond, &s->mutex);
+        } else {
+            ret = pthread_cond_timedwait(&s->cond, &s->mutex, &ts);
+        }
+    }
+    bool taken = (s->count > 0);
+    if (taken) {
+        s->count--;
+    }
+    pthread_mutex_unlock(&s->mutex);
+    return taken ? ESP_OK : ESP_FAIL;
+}
+
+static int _sema_unlock(media_lib_sema_handle_t sema)
+{
+    RETURN_ON_NULL_HANDLE(sema);
+    posix_sema_t *s = (posix_sema_t *)sema;
+    pthread_mutex_lock(&s->mutex);
+    // Same as binary semaphore of FreeRTOS port
+    s->count = 1;
+    pthread_cond_signal(&s->cond);
+    pthread_mutex_unlock(&s->mutex);
+    return ESP_OK;
+}
+
+static int _sema_destroy(media_lib_sema_handle_t sema)
+{
+    RETURN_ON_NULL_HANDLE(sema);
+    posix_sema_t *s = (posix_sema_t *)sema;
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->mutex);
+    free(s);
+    return ESP_OK;
+}
+
+static int _mutex_create(media_lib_mutex_handle_t *mutex)
+{
+    RETURN_ON_NULL_HANDLE(mutex);
+    pthread_mutex_t *m = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t));
+    if (m == NULL) {
+        return ESP_FAIL;
+    }
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(m, &attr);
+    pthread_mutexattr_destroy(&attr);
+    *mutex = m;
+    return ESP_OK;
+}
+
+static int _mutex_lock_timeout(media_lib_mutex_handle_t mutex, uint32_t timeout)
+{
+    RETURN_ON_NULL_HANDLE(mutex);
+    if (timeout == MEDIA_LIB_MAX_LOCK_TIME) {
+        return pthread_mutex_lock((pthread_mutex_t *)mutex) == 0 ? ESP_OK : ESP_FAIL;
+    }
+    struct timespec ts;
+    get_deadline(&ts, timeout);
+    return pthread_mutex_timedlock((pthread_mutex_t *)mutex, &ts) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static int _mutex_unlock(media_lib_mutex_handle_t mutex)
+{
+    RETURN_ON_NULL_HANDLE(mutex);
+    pthread_mutex_unlock((pthread_mutex_t *)mutex);
+    return ESP_OK;
+}
+
+static int _mutex_destroy(media_lib_mutex_handle_t mutex)
+{
+    RETURN_ON_NULL_HANDLE(mutex);
+    pthread_mutex_destroy((pthread_mutex_t *)mutex);
+    free(mutex);
+    return ESP_OK;
+}
+
+static int _enter_critical(void)
+{
+    return ESP_OK;
+}
+
+static int _leave_critical(void)
+{
+    return ESP_OK;
+}
+
+static int _event_group_create(media_lib_event_grp_handle_t *group)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    posix_event_group_t *g = (posix_event_group_t *)calloc(1, sizeof(posix_event_group_t));
+    if (g == NULL) {
+        return ESP_FAIL;
+    }
+    pthread_mutex_init(&g->mutex, NULL);
+    pthread_cond_init(&g->cond, NULL);
+    *group = g;
+    return ESP_OK;
+}
+
+static uint32_t _event_group_set_bits(media_lib_event_grp_handle_t group, uint32_t bits)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    posix_event_group_t *g = (posix_event_group_t *)group;
+    pthread_mutex_lock(&g->mutex);
+    g->bits |= bits;
+    uint32_t cur = g->bits;
+    pthread_cond_broadcast(&g->cond);
+    pthread_mutex_unlock(&g->mutex);
+    return cur;
+}
+
+static uint32_t _event_group_clr_bits(media_lib_event_grp_handle_t group, uint32_t bits)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    posix_event_group_t *g = (posix_event_group_t *)group;
+    pthread_mutex_lock(&g->mutex);
+    // Return bits before clear same as FreeRTOS
+    uint32_t cur = g->bits;
+    g->bits &= ~bits;
+    pthread_mutex_unlock(&g->mutex);
+    return cur;
+}
+
+static uint32_t _event_group_wait_bits(media_lib_event_grp_handle_t group,
+                                       uint32_t bits, uint32_t timeout)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    posix_event_group_t *g = (posix_event_group_t *)group;
+    struct timespec ts;
+    get_deadline(&ts, timeout);
+    int ret = 0;
+    pthread_mutex_lock(&g->mutex);
+    // Wait for all bits without clear on exit
+    while ((g->bits & bits) != bits && ret == 0) {
+        if (timeout == MEDIA_LIB_MAX_LOCK_TIME) {
+            pthread_cond_wait(&g->cond, &g->mutex);
+        } else {
+            ret = pthread_cond_timedwait(&g->cond, &g->mutex, &ts);
+        }
+    }
+    uint32_t cur = g->bits;
+    pthread_mutex_unlock(&g->mutex);
+    return cur;
+}
+
+static int _event_group_destroy(media_lib_event_grp_handle_t group)
+{
+    RETURN_ON_NULL_HANDLE(group);
+    posix_event_group_t *g = (posix_event_group_t *)group;
+    pthread_cond_destroy(&g->cond);
+    pthread_mutex_destroy(&g->mutex);
+    free(g);
+    return ESP_OK;
+}
+
+esp_err_t media_lib_add_default_os_adapter(void)
+{
+    media_lib_os_t os_lib = {
+        .malloc = malloc,
+        .free = free,
+        .calloc = calloc,
+        .realloc = realloc,
+        .malloc_align = _malloc_align,
+        .free_align = _free_align,
+        .strdup = strdup,
+        .get_stack_frame = _get_stack_frame,
+
+        .thread_create = _thread_create,
+        .thread_destroy = _thread_destroy,
+        .thread_set_prio = _thread_set_priority,
+        .thread_sleep = _thread_sleep,
+
+        .sema_create = _sema_create,
+        .sema_lock   = _sema_lock_timeout,
+        .sema_unlock = _sema_unlock,
+        .sema_destroy = _sema_destroy,
+
+        .mutex_create = _mutex_create,
+        .mutex_lock =   _mutex_lock_timeout,
+        .mutex_unlock = _mutex_unlock,
+        .mutex_destroy = _mutex_destroy,
+
+        .enter_critical = _enter_critical,
+        .leave_critical = _leave_critical,
+
+        .group_create = _event_group_create,
+        .group_set_bits = _event_group_set_bits,
+        .group_clr_bits = _event_group_clr_bits,
+        .group_wait_bits = _event_group_wait_bits,
+        .group_destroy = _event_group_destroy,
+    };
+    return media_lib_os_register(&os_lib);
+}
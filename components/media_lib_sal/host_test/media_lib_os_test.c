@@ -0,0 +1,117 @@
+/**
+ * ESPRESSIF MIT License
+ *
+ * Copyright (c) 2025 <ESPRESSIF SYSTEMS (SHANGHAI) CO., LTD>
+ *
+ * Permission is hereby granted for use on all ESPRESSIF SYSTEMS products, in which case,
+ * it is free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "media_lib_adapter.h"
+#include "media_lib_os.h"
+#include "data_queue.h"
+
+#define CHECK(cond, ...) do {                       \
+    if (!(cond)) {                                  \
+        printf("FAIL %s:%d ", __FILE__, __LINE__);  \
+        printf(__VA_ARGS__);                        \
+        printf("\n");                               \
+        exit(1);                                    \
+    }                                               \
+} while (0)
+
+#define TEST_EVENT_BIT (1 << 2)
+
+typedef struct {
+    media_lib_sema_handle_t      sema;
+    media_lib_event_grp_handle_t group;
+    data_queue_t                *q;
+    media_lib_sema_handle_t      done;
+} test_ctx_t;
+
+static uint32_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void notify_thread(void *arg)
+{
+    test_ctx_t *ctx = (test_ctx_t *)arg;
+    media_lib_thread_sleep(20);
+    media_lib_sema_unlock(ctx->sema);
+    media_lib_event_group_set_bits(ctx->group, TEST_EVENT_BIT);
+    void *data = data_queue_get_buffer(ctx->q, 16);
+    data_queue_send_buffer(ctx->q, data ? 16 : 0);
+    media_lib_sema_unlock(ctx->done);
+    media_lib_thread_destroy(NULL);
+}
+
+int main(void)
+{
+    CHECK(media_lib_add_default_os_adapter() == ESP_OK, "register os adapter");
+    test_ctx_t ctx = {};
+    media_lib_sema_create(&ctx.sema);
+    media_lib_sema_create(&ctx.done);
+    media_lib_event_group_create(&ctx.group);
+    ctx.q = data_queue_init(1024);
+    CHECK(ctx.sema && ctx.done && ctx.group && ctx.q, "create objects");
+
+    // Timeout without signal
+    uint32_t start = now_ms();
+    CHECK(media_lib_sema_lock(ctx.sema, 30) != ESP_OK, "sema taken without signal");
+    CHECK(now_ms() - start >= 25, "sema returned early");
+    CHECK((media_lib_event_group_wait_bits(ctx.group, TEST_EVENT_BIT, 10) & TEST_EVENT_BIT) == 0, "bit set");
+    CHECK(data_queue_wait_data_timeout(ctx.q, 10) == 1, "queue wait should timeout");
+
+    // Woken by other thread
+    media_lib_thread_handle_t thread = NULL;
+    CHECK(media_lib_thread_create_from_scheduler(&thread, "notify", notify_thread, &ctx) == ESP_OK, "create thread");
+    CHECK(media_lib_sema_lock(ctx.sema, 1000) == ESP_OK, "sema not signaled");
+    CHECK(media_lib_event_group_wait_bits(ctx.group, TEST_EVENT_BIT, 1000) & TEST_EVENT_BIT, "bit not set");
+    CHECK(data_queue_wait_data_timeout(ctx.q, 1000) == 0, "queue data not received");
+    CHECK(media_lib_sema_lock(ctx.done, 1000) == ESP_OK, "thread not finished");
+    // Binary semaphore not accumulate
+    media_lib_sema_unlock(ctx.sema);
+    media_lib_sema_unlock(ctx.sema);
+    CHECK(media_lib_sema_lock(ctx.sema, 0) == ESP_OK, "sema not given");
+    CHECK(media_lib_sema_lock(ctx.sema, 0) != ESP_OK, "sema counted twice");
+
+    // Recursive mutex
+    media_lib_mutex_handle_t mutex = NULL;
+    media_lib_mutex_create(&mutex);
+    CHECK(media_lib_mutex_lock(mutex, MEDIA_LIB_MAX_LOCK_TIME) == ESP_OK, "lock mutex");
+    CHECK(media_lib_mutex_lock(mutex, 10) == ESP_OK, "lock mutex recursively");
+    media_lib_mutex_unlock(mutex);
+    media_lib_mutex_unlock(mutex);
+    media_lib_mutex_destroy(mutex);
+
+    // Quit wakes waiter
+    data_queue_wakeup(ctx.q);
+    CHECK(data_queue_wait_data_timeout(ctx.q, 1000) <= 0, "wait not return after wakeup");
+    data_queue_deinit(ctx.q);
+    media_lib_event_group_destroy(ctx.group);
+    media_lib_sema_destroy(ctx.sema);
+    media_lib_sema_destroy(ctx.done);
+    printf("Media lib OS test passed\n");
+    return 0;
+}
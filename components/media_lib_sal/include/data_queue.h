@@ -25,6 +25,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -113,6 +114,19 @@ int data_queue_send_buffer(data_queue_t *q, int size);
  */
 int data_queue_read_lock(data_queue_t *q, void **buffer, int *size);
 
+/**
+ * @brief         Wait until data arrives in queue or timeout
+ *
+ * @note          Data is not read, call `data_queue_read_lock` afterwards to get it without block
+ *
+ * @param         q: Data queue instance
+ * @param         timeout_ms: Maximum wait time in milliseconds
+ * @return        - 0: Have data in queue
+ *                - 1: Timeout without data
+ *                - -1: Queue quit or invalid argument
+ */
+int data_queue_wait_data_timeout(data_queue_t *q, uint32_t timeout_ms);
+
 /**
  * @brief         Release data be read and decrease reference count
  *
@@ -359,6 +359,30 @@ int data_queue_read_lock(data_queue_t *q, void **buffer, int *size)
     return ret;
 }
 
+int data_queue_wait_data_timeout(data_queue_t *q, uint32_t timeout_ms)
+{
+    if (q == NULL) {
+        return -1;
+    }
+    _MUTEX_LOCK(q->lock);
+    if (!q->quit && _data_queue_have_data_from_last(q) == false) {
+        q->user++;
+        _MUTEX_UNLOCK(q->lock);
+        // Bits set before wait are kept, so data arriving after the check is not missed
+        media_lib_event_group_wait_bits((media_lib_event_grp_handle_t) q->event, DATA_Q_DATA_ARRIVE_BITS, timeout_ms);
+        media_lib_event_group_clr_bits(q->event, DATA_Q_DATA_ARRIVE_BITS);
+        _MUTEX_LOCK(q->lock);
+        q->user--;
+        data_queue_release_user(q);
+    }
+    int ret = -1;
+    if (!q->quit) {
+        ret = _data_queue_have_data_from_last(q) ? 0 : 1;
+    }
+    _MUTEX_UNLOCK(q->lock);
+    return ret;
+}
+
 int data_queue_peek_unlock(data_queue_t *q)
 {
     int ret = -1;
@@ -24,6 +24,15 @@ extern "C" {
 #define TEST_BOARD_NAME "S3_Korvo_V2"
 #endif
 
+/**
+ * @brief  Audio playback format of the board codec
+ *
+ * @note  Remote audio and local music are mixed in this format, each player resamples its source into it
+ *        Keep it no lower than the highest source rate so that no source is downsampled
+ */
+#define AUDIO_PLAYBACK_SAMPLE_RATE 48000
+#define AUDIO_PLAYBACK_CHANNEL     1
+
 /**
  * @brief  Video resolution settings
  */
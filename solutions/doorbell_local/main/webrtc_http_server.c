@@ -31,6 +31,45 @@ static bool event_stream_connected = false;
 static bool event_stream_stopping  = false;
 static httpd_req_t *event_stream_req = NULL;
 
+static char *join_candidates(char *sdp)
+{
+    // Gather all candidates into one message separated by new line, receiver splits them
+    char *cands = malloc(strlen(sdp) + 1);
+    if (cands == NULL) {
+        return NULL;
+    }
+    int size = 0;
+    char *line = sdp;
+    while (line && *line) {
+        char *end = strpbrk(line, "\r\n");
+        int len = end ? (int)(end - line) : (int)strlen(line);
+        if (strncmp(line, "a=candidate:", 12) == 0) {
+            if (size) {
+                cands[size++] = '\n';
+            }
+            memcpy(cands + size, line + 2, len - 2);
+            size += len - 2;
+        }
+        line = end ? end + 1 : NULL;
+    }
+    cands[size] = '\0';
+    if (size == 0) {
+        free(cands);
+        return NULL;
+    }
+    return cands;
+}
+
+static void notify_candidates(char *cands)
+{
+    esp_peer_signaling_msg_t candidate_msg = {
+        .type = ESP_PEER_SIGNALING_MSG_CANDIDATE,
+        .data = (uint8_t *)cands,
+        .size = strlen(cands),
+    };
+    sig_cfg.on_msg(&candidate_msg, sig_cfg.ctx);
+}
+
 static int send_event_stream_msg(httpd_req_t *req, char *data)
 {
     int len = strlen(data) + strlen("data: ") + strlen("\n\n") + 1;
@@ -183,23 +222,11 @@ static esp_err_t webrtc_signal_post_handler(httpd_req_t *req)
         msg.data = (uint8_t *)sdp->valuestring;
         msg.size = strlen(sdp->valuestring);
 
-        // Extract ICE candidates from SDP and send them separately
-        char *sdp_str = strdup(sdp->valuestring);
-        if (sdp_str) {
-            char *line = strtok(sdp_str, "\r\n");
-            while (line != NULL) {
-                if (strncmp(line, "a=candidate:", 11) == 0) {
-                    esp_peer_signaling_msg_t candidate_msg = { 0 };
-                    candidate_msg.type = ESP_PEER_SIGNALING_MSG_CANDIDATE;
-                    candidate_msg.data = (uint8_t *)line;
-                    candidate_msg.size = strlen(line);
-
-                    // Send candidate to peer
-                    sig_cfg.on_msg(&candidate_msg, sig_cfg.ctx);
-                }
-                line = strtok(NULL, "\r\n");
-            }
-            free(sdp_str);
+        // Extract ICE candidates from SDP and send them in one batch
+        char *cands = join_candidates(sdp->valuestring);
+        if (cands) {
+            notify_candidates(cands);
+            free(cands);
         }
     } else if (strcmp(type->valuestring, "candidate") == 0) {
         cJSON *candidate = cJSON_GetObjectItem(root, "candidate");
@@ -211,6 +238,40 @@ static esp_err_t webrtc_signal_post_handler(httpd_req_t *req)
         msg.type = ESP_PEER_SIGNALING_MSG_CANDIDATE;
         msg.data = (uint8_t *)candidate->valuestring;
         msg.size = strlen(candidate->valuestring);
+    } else if (strcmp(type->valuestring, "candidates") == 0) {
+        // Candidates batched by browser, forward them in one message
+        cJSON *list = cJSON_GetObjectItem(root, "candidates");
+        int num = cJSON_GetArraySize(list);
+        int size = 0;
+        for (int i = 0; i < num; i++) {
+            cJSON *item = cJSON_GetArrayItem(list, i);
+            if (item && item->valuestring) {
+                size += strlen(item->valuestring) + 1;
+            }
+        }
+        if (size == 0) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing candidates");
+            ret = ESP_FAIL;
+            goto _exit;
+        }
+        char *cands = malloc(size);
+        if (cands == NULL) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "No memory");
+            ret = ESP_FAIL;
+            goto _exit;
+        }
+        cands[0] = '\0';
+        for (int i = 0; i < num; i++) {
+            cJSON *item = cJSON_GetArrayItem(list, i);
+            if (item && item->valuestring) {
+                if (cands[0]) {
+                    strcat(cands, "\n");
+                }
+                strcat(cands, item->valuestring);
+            }
+        }
+        notify_candidates(cands);
+        free(cands);
     } else if (strcmp(type->valuestring, "bye") == 0) {
         msg.type = ESP_PEER_SIGNALING_MSG_BYE;
     } else if (strcmp(type->valuestring, "customized") == 0) {
@@ -355,27 +416,34 @@ static esp_err_t webrtc_http_server_init(esp_peer_signaling_cfg_t *cfg, esp_peer
     return ESP_OK;
 }
 
-static int webrtc_http_server_send_msg(esp_peer_signaling_handle_t sig, esp_peer_signaling_msg_t *msg);
-
-static int resend_all_candidate(esp_peer_signaling_handle_t sig, char *str)
+static int resend_all_candidate(char *str)
 {
-    char *sdp_str = strdup(str);
-    if (sdp_str) {
-        char *line = strtok(sdp_str, "\r\n");
-        while (line != NULL) {
-            if (strncmp(line, "a=candidate:", 11) == 0) {
-                // Create candidate message
-                char *cand = line + 2;
-                esp_peer_signaling_msg_t candidate_msg = { 0 };
-                candidate_msg.type = ESP_PEER_SIGNALING_MSG_CANDIDATE;
-                candidate_msg.data = (uint8_t *)cand;
-                candidate_msg.size = strlen(cand);
-                // Send candidate to peer
-                webrtc_http_server_send_msg(sig, &candidate_msg);
-            }
-            line = strtok(NULL, "\r\n");
-        }
-        free(sdp_str);
+    // One event for all candidates so that they arrive together and do not flood the queue
+    char *cands = join_candidates(str);
+    if (cands == NULL) {
+        return 0;
+    }
+    cJSON *msg_root = cJSON_CreateObject();
+    cJSON *list = cJSON_CreateArray();
+    if (msg_root == NULL || list == NULL) {
+        cJSON_Delete(msg_root);
+        cJSON_Delete(list);
+        free(cands);
+        return -1;
+    }
+    cJSON_AddStringToObject(msg_root, "type", "candidates");
+    cJSON_AddItemToObject(msg_root, "candidates", list);
+    char *line = strtok(cands, "\n");
+    while (line != NULL) {
+        cJSON_AddItemToArray(list, cJSON_CreateString(line));
+        line = strtok(NULL, "\n");
+    }
+    free(cands);
+    char *json_str = cJSON_PrintUnformatted(msg_root);
+    cJSON_Delete(msg_root);
+    if (json_str && xQueueSend(signaling_queue, &json_str, pdMS_TO_TICKS(100)) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to send candidates to signaling queue");
+        free(json_str);
     }
     return 0;
 }
@@ -422,7 +490,7 @@ static int webrtc_http_server_send_msg(esp_peer_signaling_handle_t sig, esp_peer
         }
     }
     if (msg->type == ESP_PEER_SIGNALING_MSG_SDP) {
-        resend_all_candidate(sig, (char *)msg->data);
+        resend_all_candidate((char *)msg->data);
     }
     return 0;
 }
@@ -22,6 +22,7 @@
 #include "esp_audio_enc_default.h"
 #include "esp_capture_defaults.h"
 #include "esp_log.h"
+#include <stdlib.h>
 
 #define RET_ON_NULL(ptr, v) do {                                \
     if (ptr == NULL) {                                          \
@@ -35,6 +36,7 @@
 typedef struct {
     esp_capture_path_handle_t   capture_handle;
     esp_capture_aenc_if_t      *aud_enc;
+    esp_capture_audio_src_if_t *aec_src;
     esp_capture_audio_src_if_t *aud_src;
     esp_capture_path_if_t      *path_if;
 } capture_system_t;
@@ -60,8 +62,23 @@ static int build_capture_system(void)
 #endif
     };
     // capture_sys.aud_src = esp_capture_new_audio_codec_src(&codec_cfg);
-    capture_sys.aud_src = esp_capture_new_audio_aec_src(&codec_cfg);
+    capture_sys.aec_src = esp_capture_new_audio_aec_src(&codec_cfg);
+    RET_ON_NULL(capture_sys.aec_src, -1);
+    // Level AEC output before encoding, report stage cost every 10s
+    esp_capture_audio_proc_src_cfg_t proc_cfg = {
+        .src = capture_sys.aec_src,
+        .stat_interval = 10000,
+    };
+    capture_sys.aud_src = esp_capture_new_audio_proc_src(&proc_cfg);
     RET_ON_NULL(capture_sys.aud_src, -1);
+    esp_capture_audio_proc_if_t *agc = esp_capture_new_audio_agc_proc(NULL);
+    RET_ON_NULL(agc, -1);
+    int ret = esp_capture_audio_proc_src_add_stage(capture_sys.aud_src, "AGC", agc);
+    if (ret != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGE(TAG, "Fail to add AGC stage ret %d", ret);
+        free(agc);
+        return -1;
+    }
     esp_capture_simple_path_cfg_t simple_cfg = {
         .aenc = capture_sys.aud_enc,
     };
@@ -93,6 +110,7 @@ static int build_player_system()
         .audio_raw_fifo_size = 8 * 4096,
         .audio_render_fifo_size = 100 * 1024,
         .allow_drop_data = false,
+        .enable_plc = true,
     };
     player_sys.player = av_render_open(&render_cfg);
     if (player_sys.player == NULL) {
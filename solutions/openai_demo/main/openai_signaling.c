@@ -11,6 +11,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "https_client.h"
+#include "esp_signaling_json.h"
 #include "common.h"
 #include "esp_log.h"
 #include <cJSON.h>
@@ -26,8 +27,6 @@
     p = NULL;                   \
 }
 
-#define GET_KEY_END(str, key) get_key_end(str, key, sizeof(key) - 1)
-
 typedef struct {
     esp_peer_signaling_cfg_t cfg;
     uint8_t                 *remote_sdp;
@@ -35,35 +34,21 @@ typedef struct {
     char                    *ephemeral_token;
 } openai_signaling_t;
 
-static char *get_key_end(char *str, char *key, int len)
-{
-    char *p = strstr(str, key);
-    if (p == NULL) {
-        return NULL;
-    }
-    return p + len;
-}
-
 static void session_answer(http_resp_t *resp, void *ctx)
 {
     openai_signaling_t *sig = (openai_signaling_t *)ctx;
-    char *token = GET_KEY_END((char *)resp->data, "\"client_secret\"");
-    if (token == NULL) {
-        return;
-    }
-    char *secret = GET_KEY_END(token, "\"value\"");
-    if (secret == NULL) {
+    esp_signaling_json_value_t secret, value;
+    if (esp_signaling_json_find(resp->data, resp->size, "client_secret", &secret) != ESP_PEER_ERR_NONE
+        || secret.type != ESP_SIGNALING_JSON_OBJECT) {
+        ESP_LOGE(TAG, "No client secret in session response");
         return;
     }
-    char *s = strchr(secret, '"');
-    if (s == NULL) {
+    // Secret object lies in response buffer, unescape in place
+    if (esp_signaling_json_get_string(secret.data, secret.size, "value", &value) != ESP_PEER_ERR_NONE) {
+        ESP_LOGE(TAG, "Bad client secret in session response");
         return;
     }
-    s++;
-    char *e = strchr(s, '"');
-    *e = 0;
-    sig->ephemeral_token = strdup(s);
-    *e = '"';
+    sig->ephemeral_token = strdup(value.data);
 }
 
 static void get_ephemeral_token(openai_signaling_t *sig, char *token, char *voice)
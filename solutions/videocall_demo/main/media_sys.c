@@ -30,6 +30,8 @@
 
 #define TAG "MEDIA_SYS"
 
+#define MUSIC_DUCK_GAIN (0.3f)
+
 #define RET_ON_NULL(ptr, v) do {                                \
     if (ptr == NULL) {                                          \
         ESP_LOGE(TAG, "Memory allocate fail on %d", __LINE__);  \
@@ -50,6 +52,8 @@ typedef struct {
     audio_render_handle_t audio_render;
     video_render_handle_t video_render;
     av_render_handle_t    player;
+    audio_mixer_players_t mixed;
+    av_render_handle_t    music_player;
 } player_system_t;
 
 static capture_system_t capture_sys;
@@ -186,20 +190,44 @@ static int build_player_system()
         ESP_LOGE(TAG, "Fail to create video render");
         return -1;
     }
-    av_render_cfg_t render_cfg = {
-        .audio_render = player_sys.audio_render,
-        .video_render = player_sys.video_render,
-        .audio_raw_fifo_size = 4096,
-        .audio_render_fifo_size = 6 * 1024,
-        .video_raw_fifo_size = 500 * 1024,
-        .allow_drop_data = false,
-        //.video_render_fifo_size = 4*1024,
+    // Remote speech has higher priority and ducks music when both are playing
+    // Local music uses its own player so that it can play together with remote audio
+    av_render_cfg_t render_cfg[] = {
+        {
+            .video_render = player_sys.video_render,
+            .audio_raw_fifo_size = 4096,
+            .audio_render_fifo_size = 6 * 1024,
+            .video_raw_fifo_size = 500 * 1024,
+            .allow_drop_data = false,
+            .enable_plc = true,
+            //.video_render_fifo_size = 4*1024,
+        },
+        {
+            .audio_raw_fifo_size = 4096,
+            .audio_render_fifo_size = 6 * 1024,
+        },
     };
-    player_sys.player = av_render_open(&render_cfg);
-    if (player_sys.player == NULL) {
-        ESP_LOGE(TAG, "Fail to create player");
+    audio_mixer_input_cfg_t input_cfg[] = {
+        { .priority = 1, .gain = 1.0f, .duck_gain = 1.0f },
+        { .priority = 0, .gain = 1.0f, .duck_gain = MUSIC_DUCK_GAIN },
+    };
+    audio_mixer_players_cfg_t mixed_cfg = {
+        .out_render = player_sys.audio_render,
+        .out_info = {
+            .sample_rate = AUDIO_PLAYBACK_SAMPLE_RATE,
+            .channel = AUDIO_PLAYBACK_CHANNEL,
+            .bits_per_sample = 16,
+        },
+        .player_num = 2,
+        .player_cfg = render_cfg,
+        .input_cfg = input_cfg,
+    };
+    if (av_render_open_mixed_players(&mixed_cfg, &player_sys.mixed) != 0) {
+        ESP_LOGE(TAG, "Fail to create players");
         return -1;
     }
+    player_sys.player = player_sys.mixed.players[0];
+    player_sys.music_player = player_sys.mixed.players[1];
     return 0;
 }
 
@@ -289,7 +317,7 @@ static void music_play_thread(void *arg)
     av_render_audio_info_t render_aud_info = {
         .codec = AV_RENDER_AUDIO_CODEC_AAC,
     };
-    av_render_add_audio_stream(player_sys.player, &render_aud_info);
+    av_render_add_audio_stream(player_sys.music_player, &render_aud_info);
     int music_pos = 0;
     while (!music_stopping && music_duration >= 0) {
         uint32_t start_time = esp_timer_get_time() / 1000;
@@ -308,7 +336,7 @@ static void music_play_thread(void *arg)
                 .data = (uint8_t *)adts_header,
                 .size = send_size,
             };
-            int ret = av_render_add_audio_data(player_sys.player, &audio_data);
+            int ret = av_render_add_audio_data(player_sys.music_player, &audio_data);
             if (ret != 0) {
                 break;
             }
@@ -320,7 +348,7 @@ static void music_play_thread(void *arg)
             if (music_duration == 0) {
                 av_render_fifo_stat_t stat = { 0 };
                 while (!music_stopping) {
-                    av_render_get_audio_fifo_level(player_sys.player, &stat);
+                    av_render_get_audio_fifo_level(player_sys.music_player, &stat);
                     if (stat.data_size > 0) {
                         media_lib_thread_sleep(50);
                         continue;
@@ -335,7 +363,7 @@ static void music_play_thread(void *arg)
             music_duration -= end_time - start_time;
         }
     }
-    av_render_reset(player_sys.player);
+    av_render_reset(player_sys.music_player);
     music_stopping = false;
     music_playing = false;
     media_lib_thread_destroy(NULL);
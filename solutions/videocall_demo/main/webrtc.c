@@ -235,6 +235,7 @@ int start_webrtc(char *url)
             .enable_data_channel = DATA_CHANNEL_ENABLED,
             .no_auto_reconnect = true,       // No auto connect peer when signaling connected
             .video_over_data_channel = true, // MJPEG video transfer over data channel
+            .video_dc_framing = true,        // Carry pts and drop stale frames, both peers run this demo
             .extra_cfg = &peer_default_cfg,
             .extra_size = sizeof(peer_default_cfg),
         },